@@ -0,0 +1,64 @@
+/*
+ * Allocation Counter for the host build
+ * malloc/calloc/realloc/free are wrapped at link time (-Wl,--wrap) for the codec objects
+ */
+
+#include "alloc_count.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+// Single-threaded harnesses only
+static bool s_counting = false;
+static alloc_count_t s_count;
+
+void *__wrap_malloc(size_t size)
+{
+    if (s_counting) {
+        s_count.allocs++;
+        s_count.bytes += size;
+    }
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    if (s_counting) {
+        s_count.allocs++;
+        s_count.bytes += (uint64_t)count * size;
+    }
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    if (s_counting) {
+        s_count.allocs++;
+        s_count.bytes += size;
+    }
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    if (s_counting && ptr != NULL) {
+        s_count.frees++;
+    }
+    __real_free(ptr);
+}
+
+void alloc_count_begin(void)
+{
+    s_count = (alloc_count_t){0};
+    s_counting = true;
+}
+
+alloc_count_t alloc_count_end(void)
+{
+    s_counting = false;
+    return s_count;
+}
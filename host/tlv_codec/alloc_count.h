@@ -0,0 +1,39 @@
+/*
+ * Allocation Counter for the host build
+ * malloc/calloc/realloc/free are wrapped at link time (-Wl,--wrap) for the codec objects
+ */
+
+#ifndef TLV_ALLOC_COUNT_H
+#define TLV_ALLOC_COUNT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocations seen while counting
+ */
+typedef struct {
+    uint64_t allocs;                // malloc, calloc and realloc calls
+    uint64_t frees;                 // free calls with a non-NULL pointer
+    uint64_t bytes;                 // Bytes requested
+} alloc_count_t;
+
+/**
+ * @brief Reset the counters and start counting
+ */
+void alloc_count_begin(void);
+
+/**
+ * @brief Stop counting and return what was seen since alloc_count_begin()
+ */
+alloc_count_t alloc_count_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLV_ALLOC_COUNT_H
@@ -0,0 +1,108 @@
+/*
+ * TLV Packet Corpus for the host build
+ * Loads packets written one per line as hex bytes ('#' starts a comment)
+ */
+
+#include "corpus.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int hex_value(int c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = tolower(c);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Parse one line; returns 0 with len 0 for blank or comment lines
+static int parse_line(const char *line, tlv_corpus_packet_t *packet)
+{
+    int high = -1;
+
+    packet->len = 0;
+    for (const char *p = line; *p != '\0' && *p != '#'; p++) {
+        if (isspace((unsigned char)*p)) {
+            if (high >= 0) {
+                return -1;  // Odd number of hex digits in a byte
+            }
+            continue;
+        }
+        int nibble = hex_value((unsigned char)*p);
+        if (nibble < 0) {
+            return -1;
+        }
+        if (high < 0) {
+            high = nibble;
+            continue;
+        }
+        if (packet->len >= TLV_CORPUS_PACKET_MAX) {
+            return -1;
+        }
+        packet->data[packet->len++] = (uint8_t)((high << 4) | nibble);
+        high = -1;
+    }
+    return (high >= 0) ? -1 : 0;
+}
+
+int tlv_corpus_load(const char *path, tlv_corpus_t *corpus)
+{
+    memset(corpus, 0, sizeof(*corpus));
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Can't open corpus %s\n", path);
+        return -1;
+    }
+
+    corpus->packets = calloc(TLV_CORPUS_MAX_PACKETS, sizeof(tlv_corpus_packet_t));
+    if (corpus->packets == NULL) {
+        fclose(file);
+        return -1;
+    }
+
+    char line[2048];
+    int line_no = 0;
+    int ret = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_no++;
+        if (corpus->count >= TLV_CORPUS_MAX_PACKETS) {
+            fprintf(stderr, "%s:%d: more than %d packets\n", path, line_no, TLV_CORPUS_MAX_PACKETS);
+            ret = -1;
+            break;
+        }
+        tlv_corpus_packet_t *packet = &corpus->packets[corpus->count];
+        if (parse_line(line, packet) != 0) {
+            fprintf(stderr, "%s:%d: malformed hex or packet over %d bytes\n", path, line_no, TLV_CORPUS_PACKET_MAX);
+            ret = -1;
+            break;
+        }
+        if (packet->len > 0) {
+            packet->line = line_no;
+            corpus->count++;
+        }
+    }
+    fclose(file);
+
+    if (ret == 0 && corpus->count == 0) {
+        fprintf(stderr, "%s: no packets\n", path);
+        ret = -1;
+    }
+    if (ret != 0) {
+        tlv_corpus_free(corpus);
+    }
+    return ret;
+}
+
+void tlv_corpus_free(tlv_corpus_t *corpus)
+{
+    free(corpus->packets);
+    corpus->packets = NULL;
+    corpus->count = 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * TLV Packet Corpus for the host build
+ * Loads packets written one per line as hex bytes ('#' starts a comment)
+ */
+
+#ifndef TLV_CORPUS_H
+#define TLV_CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TLV_CORPUS_PACKET_MAX   250     // ESP_NOW_MAX_DATA_LEN
+#define TLV_CORPUS_MAX_PACKETS  1024
+
+/**
+ * @brief One corpus packet
+ */
+typedef struct {
+    uint8_t data[TLV_CORPUS_PACKET_MAX];
+    size_t len;
+    int line;                       // Source line, for error messages
+} tlv_corpus_packet_t;
+
+/**
+ * @brief Loaded corpus
+ */
+typedef struct {
+    tlv_corpus_packet_t *packets;
+    size_t count;
+} tlv_corpus_t;
+
+/**
+ * @brief Load a corpus file
+ * @return 0 on success, -1 if the file can't be read or a line is malformed
+ */
+int tlv_corpus_load(const char *path, tlv_corpus_t *corpus);
+
+/**
+ * @brief Release a loaded corpus
+ */
+void tlv_corpus_free(tlv_corpus_t *corpus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLV_CORPUS_H
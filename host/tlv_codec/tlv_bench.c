@@ -0,0 +1,187 @@
+/*
+ * TLV Codec Benchmark for the host build
+ * Runs the receive hot path over a packet corpus and reports packets/s, ns/TLV and allocations
+ */
+
+#include "alloc_count.h"
+#include "corpus.h"
+#include "tlv_codec.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_ENTRIES       32      // TLV_DECODE_MAX_ENTRIES in espnow_manager.c
+#define BENCH_DEFAULT_PACKETS   2000000
+#define BENCH_TELEMETRY_MAX     64      // DISCOVERY_TELEMETRY_MAX in espnow_manager.c
+
+// Results of one phase
+typedef struct {
+    const char *name;
+    uint64_t packets;
+    uint64_t tlvs;
+    uint64_t elapsed_ns;
+    alloc_count_t allocs;
+} bench_phase_t;
+
+static volatile uint32_t s_sink;    // Keeps the measured loops from being optimized away
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// tlv_codec_decode() alone, as in espnow_data_parse()
+static void bench_decode(const tlv_corpus_t *corpus, uint64_t packets, bench_phase_t *phase)
+{
+    tlv_decoded_entry_t entries[BENCH_MAX_ENTRIES];
+    uint32_t acc = 0;
+
+    alloc_count_begin();
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < packets; i++) {
+        const tlv_corpus_packet_t *packet = &corpus->packets[i % corpus->count];
+        int count = tlv_codec_decode(packet->data, packet->len, entries, BENCH_MAX_ENTRIES, NULL);
+        phase->tlvs += (uint64_t)count;
+        acc += (uint32_t)count;
+    }
+    phase->elapsed_ns = now_ns() - start;
+    phase->allocs = alloc_count_end();
+    phase->packets = packets;
+    s_sink = acc;
+}
+
+// Decode plus the column writes of store_device_tlv_data(): scaled numerics, bounded blob copies
+static void bench_decode_store(const tlv_corpus_t *corpus, uint64_t packets, bench_phase_t *phase)
+{
+    tlv_decoded_entry_t entries[BENCH_MAX_ENTRIES];
+    float numeric[TLV_NUM_FIELD_COUNT] = {0};
+    uint8_t blobs[TLV_BLOB_KNOWN_COUNT][32];
+    uint32_t acc = 0;
+
+    alloc_count_begin();
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < packets; i++) {
+        const tlv_corpus_packet_t *packet = &corpus->packets[i % corpus->count];
+        int count = tlv_codec_decode(packet->data, packet->len, entries, BENCH_MAX_ENTRIES, NULL);
+        for (int j = 0; j < count; j++) {
+            const tlv_decoded_entry_t *entry = &entries[j];
+            if (entry->desc == NULL || !entry->valid) {
+                continue;
+            }
+            if (TLV_ENC_IS_NUMERIC(entry->desc->encoding)) {
+                numeric[entry->desc->index] = tlv_codec_scaled_value(entry->desc, entry->raw);
+            } else {
+                size_t len = (entry->length < sizeof(blobs[0])) ? entry->length : sizeof(blobs[0]);
+                memcpy(blobs[entry->desc->index], entry->value, len);
+                acc += blobs[entry->desc->index][0];
+            }
+        }
+        phase->tlvs += (uint64_t)count;
+    }
+    phase->elapsed_ns = now_ns() - start;
+    phase->allocs = alloc_count_end();
+    phase->packets = packets;
+    for (int i = 0; i < TLV_NUM_FIELD_COUNT; i++) {
+        acc += (uint32_t)numeric[i];
+    }
+    s_sink = acc;
+}
+
+// tlv_builder_t writing the discovery telemetry of device_discovery_telemetry_build()
+static void bench_encode(uint64_t packets, bench_phase_t *phase)
+{
+    uint8_t buf[BENCH_TELEMETRY_MAX];
+    uint32_t acc = 0;
+
+    alloc_count_begin();
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < packets; i++) {
+        tlv_builder_t builder;
+        tlv_builder_init(&builder, buf, sizeof(buf));
+        tlv_builder_put_string(&builder, TLV_TYPE_DEVICE_ID, "M5Stick-123456", 31);
+        tlv_builder_put_u32(&builder, TLV_TYPE_UPTIME, (uint32_t)i);
+        tlv_builder_put_u32(&builder, TLV_TYPE_FREE_MEMORY, 143212);
+        tlv_builder_put_f32(&builder, TLV_TYPE_BATTERY_VOLTAGE, 4.07f);
+        tlv_builder_put_u16(&builder, TLV_TYPE_BATTERY_LEVEL, 83);
+        tlv_builder_put_i32(&builder, TLV_TYPE_BATTERY_CURRENT, -61);
+        tlv_builder_put_f32(&builder, TLV_TYPE_VBUS_VOLTAGE, 0.0f);
+        tlv_builder_put_f32(&builder, TLV_TYPE_TEMPERATURE, 38.2f);
+        tlv_builder_put_u16(&builder, TLV_TYPE_STATUS_FLAGS, STATUS_FLAG_POWER_ON | STATUS_FLAG_ESP_NOW_ACTIVE);
+        acc += (uint32_t)builder.len + buf[builder.len - 1];
+    }
+    phase->elapsed_ns = now_ns() - start;
+    phase->allocs = alloc_count_end();
+    phase->packets = packets;
+    phase->tlvs = packets * 9;
+    s_sink = acc;
+}
+
+static void print_phase(const bench_phase_t *phase)
+{
+    double seconds = (double)phase->elapsed_ns / 1e9;
+    double pkt_per_s = (seconds > 0) ? (double)phase->packets / seconds : 0;
+    double ns_per_tlv = (phase->tlvs > 0) ? (double)phase->elapsed_ns / (double)phase->tlvs : 0;
+
+    printf("%-13s %10" PRIu64 " pkt %11" PRIu64 " TLV %12.0f pkt/s %7.2f ns/TLV %6" PRIu64 " allocs\n",
+           phase->name, phase->packets, phase->tlvs, pkt_per_s, ns_per_tlv, phase->allocs.allocs);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s <corpus.txt> [packets]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        usage(argv[0]);
+        return 2;
+    }
+    uint64_t packets = BENCH_DEFAULT_PACKETS;
+    if (argc == 3) {
+        char *end = NULL;
+        packets = strtoull(argv[2], &end, 10);
+        if (end == argv[2] || *end != '\0' || packets == 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    tlv_corpus_t corpus;
+    if (tlv_corpus_load(argv[1], &corpus) != 0) {
+        return 2;
+    }
+    tlv_codec_init();
+
+    size_t corpus_bytes = 0;
+    for (size_t i = 0; i < corpus.count; i++) {
+        corpus_bytes += corpus.packets[i].len;
+    }
+    printf("Corpus %s: %zu packets, %zu bytes\n", argv[1], corpus.count, corpus_bytes);
+
+    bench_phase_t phases[] = {
+        { .name = "decode" },
+        { .name = "decode+store" },
+        { .name = "encode" },
+    };
+    bench_decode(&corpus, packets, &phases[0]);
+    bench_decode_store(&corpus, packets, &phases[1]);
+    bench_encode(packets, &phases[2]);
+
+    int ret = 0;
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        print_phase(&phases[i]);
+        if (phases[i].allocs.allocs > 0) {
+            fprintf(stderr, "%s allocated %" PRIu64 " times (%" PRIu64 " bytes); the codec must not allocate\n",
+                    phases[i].name, phases[i].allocs.allocs, phases[i].allocs.bytes);
+            ret = 1;
+        }
+    }
+
+    tlv_corpus_free(&corpus);
+    return ret;
+}
@@ -0,0 +1,121 @@
+/*
+ * TLV Codec Fuzz Target for the host build
+ * libFuzzer entry point; checks decoder bounds and round trips on arbitrary length fields
+ */
+
+#include "tlv_fuzz.h"
+#include "tlv_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_INPUT      250     // ESP_NOW_MAX_DATA_LEN; decoded offsets are 16-bit
+#define FUZZ_MAX_ENTRIES    (FUZZ_MAX_INPUT / 2)
+
+#define FUZZ_CHECK(cond) do {                                                   \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+// Decode with a given entry capacity and check every entry stays inside the input
+static void fuzz_decode(const uint8_t *data, size_t size, int max_entries)
+{
+    tlv_decoded_entry_t entries[FUZZ_MAX_ENTRIES];
+    tlv_decode_result_t result;
+    uint8_t reencoded[2 + UINT8_MAX];
+    char text[96];
+
+    int count = tlv_codec_decode(data, size, entries, max_entries, &result);
+    FUZZ_CHECK(count >= 0 && count <= max_entries);
+    FUZZ_CHECK(result.offset <= size);
+
+    size_t expected_offset = 0;
+    for (int i = 0; i < count; i++) {
+        const tlv_decoded_entry_t *entry = &entries[i];
+        FUZZ_CHECK(entry->offset == expected_offset);
+        FUZZ_CHECK(entry->value == data + entry->offset + 2);
+        FUZZ_CHECK((size_t)entry->offset + TLV_TOTAL_SIZE(entry->length) <= size);
+        FUZZ_CHECK(entry->desc == tlv_codec_find_field(entry->type));
+
+        // Re-encoding a decoded entry reproduces its wire bytes exactly
+        size_t written = tlv_codec_encode_entry(entry, reencoded, sizeof(reencoded));
+        FUZZ_CHECK(written == (size_t)TLV_TOTAL_SIZE(entry->length));
+        FUZZ_CHECK(memcmp(reencoded, data + entry->offset, written) == 0);
+
+        tlv_codec_format_entry(entry, text, sizeof(text));
+        FUZZ_CHECK(strlen(text) < sizeof(text));
+        expected_offset += TLV_TOTAL_SIZE(entry->length);
+    }
+    FUZZ_CHECK(result.offset == expected_offset);
+
+    switch (result.stop) {
+        case TLV_DECODE_COMPLETE:
+            FUZZ_CHECK(result.offset == size);
+            break;
+        case TLV_DECODE_SHORT_HEADER:
+            FUZZ_CHECK(size - result.offset == 1);
+            break;
+        case TLV_DECODE_OVERRUN:
+            FUZZ_CHECK(result.entry_size == (size_t)TLV_TOTAL_SIZE(data[result.offset + 1]));
+            FUZZ_CHECK(result.offset + result.entry_size > size);
+            break;
+        case TLV_DECODE_ENTRY_LIMIT:
+            FUZZ_CHECK(count == max_entries && result.offset < size);
+            break;
+        default:
+            FUZZ_CHECK(!"unknown stop reason");
+    }
+}
+
+// Replay the input as builder calls: [capacity] then {type, length} pairs with value bytes
+static void fuzz_builder(const uint8_t *data, size_t size)
+{
+    uint8_t buf[UINT8_MAX];
+    tlv_decoded_entry_t entries[FUZZ_MAX_ENTRIES];
+    tlv_decode_result_t result;
+
+    if (size == 0) {
+        return;
+    }
+    tlv_builder_t builder;
+    tlv_builder_init(&builder, buf, data[0]);
+
+    size_t offset = 1;
+    int puts = 0;
+    while (offset + 2 <= size && puts < FUZZ_MAX_ENTRIES) {
+        uint8_t type = data[offset];
+        uint8_t length = data[offset + 1];
+        offset += 2;
+        size_t available = size - offset;
+        size_t value_len = (length < available) ? length : available;
+
+        size_t len_before = builder.len;
+        bool was_overflow = builder.overflow;
+        bool ok = tlv_builder_put_bytes(&builder, type, data + offset, value_len);
+        offset += value_len;
+        puts++;
+
+        // Overflow is sticky and a refused put leaves the buffer untouched
+        FUZZ_CHECK(!(was_overflow && ok));
+        FUZZ_CHECK(ok ? builder.len == len_before + TLV_TOTAL_SIZE(value_len) : builder.len == len_before);
+        FUZZ_CHECK(ok != builder.overflow);
+        FUZZ_CHECK(builder.len <= builder.capacity);
+    }
+
+    // Whatever was written is a complete prefix that decodes cleanly
+    tlv_codec_decode(buf, builder.len, entries, FUZZ_MAX_ENTRIES, &result);
+    FUZZ_CHECK(result.stop == TLV_DECODE_COMPLETE && result.offset == builder.len);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size > FUZZ_MAX_INPUT) {
+        return 0;
+    }
+    fuzz_decode(data, size, FUZZ_MAX_ENTRIES);
+    fuzz_decode(data, size, 2);     // Hits TLV_DECODE_ENTRY_LIMIT on most inputs
+    fuzz_builder(data, size);
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * TLV Codec Fuzz Target for the host build
+ * libFuzzer entry point, also driven by tlv_fuzz_replay where libFuzzer is unavailable
+ */
+
+#ifndef TLV_FUZZ_H
+#define TLV_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run one input through the decoder and builder checks; aborts on a violation
+ * @return Always 0 (libFuzzer convention)
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLV_FUZZ_H
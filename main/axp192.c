@@ -2,6 +2,7 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
 #include <string.h>
 
 static const char *TAG = "AXP192";
@@ -79,6 +80,17 @@ esp_err_t axp192_read_bytes(uint8_t reg_addr, uint8_t *data, size_t len)
     return ret;
 }
 
+// ADC寄存器解码 (高8位 + 低4/5位), 单值读取与批量快照共用
+static inline uint16_t axp192_adc12(const uint8_t *data)
+{
+    return (uint16_t)((data[0] << 4) | (data[1] & 0x0F));  // 12位ADC值
+}
+
+static inline uint16_t axp192_adc13(const uint8_t *data)
+{
+    return (uint16_t)((data[0] << 5) | (data[1] & 0x1F));  // 13位ADC值
+}
+
 /**
  * @brief 初始化AXP192
  */
@@ -176,7 +188,7 @@ esp_err_t axp192_get_battery_voltage(float *voltage)
         return ret;
     }
     
-    uint16_t vol = ((data[0] << 4) | (data[1] & 0x0F));  // 12位ADC值
+    uint16_t vol = axp192_adc12(data);
     *voltage = vol * 1.1 / 1000.0;  // 转换为电压值 (V)
     
     return ESP_OK;
@@ -196,7 +208,7 @@ esp_err_t axp192_get_battery_current(float *current)
         return ret;
     }
     
-    uint16_t charge_current = ((data[0] << 5) | (data[1] & 0x1F));  // 13位ADC值
+    uint16_t charge_current = axp192_adc13(data);
     float charge_ma = charge_current * 0.5;  // 0.5mA/LSB
     
     // 读取放电电流
@@ -205,7 +217,7 @@ esp_err_t axp192_get_battery_current(float *current)
         return ret;
     }
     
-    uint16_t discharge_current = ((data[0] << 5) | (data[1] & 0x1F));  // 13位ADC值
+    uint16_t discharge_current = axp192_adc13(data);
     float discharge_ma = discharge_current * 0.5;  // 0.5mA/LSB
     
     // 净电流 = 充电电流 - 放电电流
@@ -324,7 +336,7 @@ esp_err_t axp192_get_battery_charge_current(float *charge_current)
         return ret;
     }
     
-    uint16_t raw_current = ((data[0] << 5) | (data[1] & 0x1F));  // 13位ADC值
+    uint16_t raw_current = axp192_adc13(data);
     *charge_current = raw_current * 0.5;  // 0.5mA/LSB (官方精度)
     
     return ESP_OK;
@@ -341,7 +353,7 @@ esp_err_t axp192_get_battery_discharge_current(float *discharge_current)
         return ret;
     }
     
-    uint16_t raw_current = ((data[0] << 5) | (data[1] & 0x1F));  // 13位ADC值
+    uint16_t raw_current = axp192_adc13(data);
     *discharge_current = raw_current * 0.5;  // 0.5mA/LSB (官方精度)
     
     return ESP_OK;
@@ -367,12 +379,12 @@ bool axp192_is_charging(void)
 esp_err_t axp192_get_internal_temperature(float *temperature)
 {
     uint8_t data[2];
-    esp_err_t ret = axp192_read_bytes(0x5E, data, 2);  // 内部温度寄存器
+    esp_err_t ret = axp192_read_bytes(AXP192_INTERNAL_TEMP_H8, data, 2);  // 内部温度寄存器
     if (ret != ESP_OK) {
         return ret;
     }
     
-    uint16_t raw_temp = ((data[0] << 4) | (data[1] & 0x0F));  // 12位ADC值
+    uint16_t raw_temp = axp192_adc12(data);
     *temperature = raw_temp * 0.1 - 144.7;  // 官方温度转换公式
     
     return ESP_OK;
@@ -384,12 +396,12 @@ esp_err_t axp192_get_internal_temperature(float *temperature)
 esp_err_t axp192_get_vbus_voltage(float *voltage)
 {
     uint8_t data[2];
-    esp_err_t ret = axp192_read_bytes(0x5A, data, 2);  // VBUS电压寄存器
+    esp_err_t ret = axp192_read_bytes(AXP192_VBUS_VOL_H8, data, 2);  // VBUS电压寄存器
     if (ret != ESP_OK) {
         return ret;
     }
     
-    uint16_t raw_voltage = ((data[0] << 4) | (data[1] & 0x0F));  // 12位ADC值
+    uint16_t raw_voltage = axp192_adc12(data);
     *voltage = raw_voltage * (1.7 / 1000.0);  // 官方VBUS电压转换
     
     return ESP_OK;
@@ -401,12 +413,12 @@ esp_err_t axp192_get_vbus_voltage(float *voltage)
 esp_err_t axp192_get_vbus_current(float *current)
 {
     uint8_t data[2];
-    esp_err_t ret = axp192_read_bytes(0x5C, data, 2);  // VBUS电流寄存器
+    esp_err_t ret = axp192_read_bytes(AXP192_VBUS_CUR_H8, data, 2);  // VBUS电流寄存器
     if (ret != ESP_OK) {
         return ret;
     }
     
-    uint16_t raw_current = ((data[0] << 4) | (data[1] & 0x0F));  // 12位ADC值
+    uint16_t raw_current = axp192_adc12(data);
     *current = raw_current * 0.375;  // 官方VBUS电流转换 (0.375mA/LSB)
     
     return ESP_OK;
@@ -438,6 +450,113 @@ bool axp192_is_battery_present(void)
     return (status & 0x20) != 0;  // bit5: 电池存在指示
 }
 
+// 解码两个ADC区间 (0x5A-0x5F, 0x78-0x7D), 与单值读取函数相同的转换公式
+static void axp192_decode_adc(axp192_snapshot_t *snapshot, const uint8_t *vbus_adc, const uint8_t *battery_adc)
+{
+    snapshot->vbus_voltage = axp192_adc12(&vbus_adc[0]) * (1.7 / 1000.0);
+    snapshot->vbus_current = axp192_adc12(&vbus_adc[2]) * 0.375;
+    snapshot->internal_temp = axp192_adc12(&vbus_adc[4]) * 0.1 - 144.7;
+    snapshot->battery_voltage = axp192_adc12(&battery_adc[0]) * 1.1 / 1000.0;
+    snapshot->charge_current = axp192_adc13(&battery_adc[2]) * 0.5;
+    snapshot->discharge_current = axp192_adc13(&battery_adc[4]) * 0.5;
+}
+
+/**
+ * @brief 仅批量读取ADC区间 (2次I2C传输), 状态位与电量字段保持不变
+ */
+esp_err_t axp192_read_adc_snapshot(axp192_snapshot_t *snapshot)
+{
+    if (snapshot == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t vbus_adc[6];     // 0x5A-0x5F: VBUS电压, VBUS电流, 内部温度
+    uint8_t battery_adc[6];  // 0x78-0x7D: 电池电压, 充电电流, 放电电流
+    int64_t start_us = esp_timer_get_time();
+
+    esp_err_t ret = axp192_read_bytes(AXP192_VBUS_VOL_H8, vbus_adc, sizeof(vbus_adc));
+    if (ret == ESP_OK) {
+        ret = axp192_read_bytes(AXP192_BAT_AVERVOL_H8, battery_adc, sizeof(battery_adc));
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    axp192_decode_adc(snapshot, vbus_adc, battery_adc);
+    snapshot->read_time_us = (uint32_t)(esp_timer_get_time() - start_us);
+    return ESP_OK;
+}
+
+/**
+ * @brief 设置ADC采样率 (寄存器0x84 bit[7:6]), 不支持的值向上取整到下一档
+ */
+esp_err_t axp192_set_adc_sample_rate(uint16_t rate_hz)
+{
+    uint8_t rate_bits;
+    if (rate_hz <= 25) {
+        rate_bits = 0x00;   // 25Hz (上电默认)
+    } else if (rate_hz <= 50) {
+        rate_bits = 0x40;   // 50Hz
+    } else if (rate_hz <= 100) {
+        rate_bits = 0x80;   // 100Hz
+    } else {
+        rate_bits = 0xC0;   // 200Hz
+    }
+
+    uint8_t data;
+    esp_err_t ret = axp192_read_byte(AXP192_ADC_RATE_TS, &data);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    data = (data & 0x3F) | rate_bits;  // 保留TS管脚设置 [5:0]
+    return axp192_write_byte(AXP192_ADC_RATE_TS, data);
+}
+
+/**
+ * @brief 批量读取所有监测寄存器并解码 (4次I2C传输代替逐项读取)
+ */
+esp_err_t axp192_read_snapshot(axp192_snapshot_t *snapshot)
+{
+    if (snapshot == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 寄存器原始值, 按连续地址区间批量读取
+    struct {
+        uint8_t status[2];      // 0x00-0x01: 电源状态, 充电状态
+        uint8_t vbus_adc[6];    // 0x5A-0x5F: VBUS电压, VBUS电流, 内部温度
+        uint8_t battery_adc[6]; // 0x78-0x7D: 电池电压, 充电电流, 放电电流
+        uint8_t level;          // 0xB9: 电池电量百分比
+    } regs;
+
+    int64_t start_us = esp_timer_get_time();
+
+    esp_err_t ret = axp192_read_bytes(AXP192_POWER_STATUS, regs.status, sizeof(regs.status));
+    if (ret == ESP_OK) {
+        ret = axp192_read_bytes(AXP192_VBUS_VOL_H8, regs.vbus_adc, sizeof(regs.vbus_adc));
+    }
+    if (ret == ESP_OK) {
+        ret = axp192_read_bytes(AXP192_BAT_AVERVOL_H8, regs.battery_adc, sizeof(regs.battery_adc));
+    }
+    if (ret == ESP_OK) {
+        ret = axp192_read_byte(AXP192_BAT_PERCEN_CAL, &regs.level);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // 与单值读取函数相同的转换公式
+    snapshot->vbus_present = (regs.status[0] & 0x20) != 0;     // bit5: VBUS存在指示
+    snapshot->is_charging = (regs.status[1] & 0x40) != 0;      // bit6: 正在充电
+    snapshot->battery_present = (regs.status[1] & 0x20) != 0;  // bit5: 电池存在指示
+    axp192_decode_adc(snapshot, regs.vbus_adc, regs.battery_adc);
+    snapshot->battery_level = (regs.level > 100) ? 100 : regs.level;
+    snapshot->read_time_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    return ESP_OK;
+}
+
 // ========================= M5StickC Plus电源管理API =========================
 // 基于M5Unified官方实现的完整电源控制功能
 
@@ -50,6 +50,7 @@
 // ADC控制
 #define AXP192_ADC_EN1          0x82    // ADC使能设置1
 #define AXP192_ADC_EN2          0x83    // ADC使能设置2
+#define AXP192_ADC_RATE_TS      0x84    // ADC采样率 [7:6] / TS管脚控制
 
 // 电池电压ADC (高8位和低4位)
 #define AXP192_BAT_AVERVOL_H8   0x78    // 电池电压高8位
@@ -61,6 +62,32 @@
 #define AXP192_BAT_AVERDISCHGCUR_H8 0x7C // 电池放电电流高8位
 #define AXP192_BAT_AVERDISCHGCUR_L5 0x7D // 电池放电电流低5位
 
+// VBUS / 内部温度 ADC寄存器 (连续区间 0x5A-0x5F)
+#define AXP192_VBUS_VOL_H8      0x5A    // VBUS电压高8位
+#define AXP192_VBUS_CUR_H8      0x5C    // VBUS电流高8位
+#define AXP192_INTERNAL_TEMP_H8 0x5E    // 内部温度高8位
+
+/**
+ * @brief One burst-read sample of all monitored AXP192 registers
+ *
+ * Filled by axp192_read_snapshot() from four I2C transactions (status 0x00-0x01,
+ * VBUS/temperature ADC 0x5A-0x5F, battery ADC 0x78-0x7D, fuel gauge 0xB9)
+ * instead of one or two transactions per value.
+ */
+typedef struct {
+    float battery_voltage;      // V
+    float charge_current;       // mA
+    float discharge_current;    // mA
+    float vbus_voltage;         // V
+    float vbus_current;         // mA
+    float internal_temp;        // °C
+    uint8_t battery_level;      // 0-100%
+    bool is_charging;           // Charge status bit6
+    bool vbus_present;          // Power status bit5
+    bool battery_present;       // Charge status bit5
+    uint32_t read_time_us;      // I2C time spent on this snapshot
+} axp192_snapshot_t;
+
 // 函数声明
 esp_err_t axp192_init(void);
 esp_err_t axp192_write_byte(uint8_t reg_addr, uint8_t data);
@@ -92,6 +119,9 @@ esp_err_t axp192_get_vbus_voltage(float *voltage);
 esp_err_t axp192_get_vbus_current(float *current);
 bool axp192_is_vbus_present(void);
 bool axp192_is_battery_present(void);
+esp_err_t axp192_read_snapshot(axp192_snapshot_t *snapshot);  // 批量读取所有监测寄存器
+esp_err_t axp192_read_adc_snapshot(axp192_snapshot_t *snapshot);  // 仅读取ADC区间 (高频采样用, 不更新状态/电量字段)
+esp_err_t axp192_set_adc_sample_rate(uint16_t rate_hz);  // ADC采样率: 25/50/100/200Hz
 
 // 电源通道定义
 #define AXP192_DCDC1    0x01
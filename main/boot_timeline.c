@@ -0,0 +1,138 @@
+/*
+ * Boot Timeline for M5StickC Plus 1.1
+ * Timestamps of the boot stages, shared by app_main and the tasks it starts in parallel
+ */
+
+#include "boot_timeline.h"
+#include "esp_bit_defs.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+
+static const char *TAG = "BOOT_TIMELINE";
+
+#define BOOT_STAGE_NONE     BOOT_STAGE_COUNT    // No predecessor: measured from reset
+
+// Name and the stage it waits for; the gap to that stage is the stage's own cost
+typedef struct {
+    const char *name;
+    const char *path;
+    boot_stage_t after;
+} boot_stage_desc_t;
+
+static const boot_stage_desc_t s_stages[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_NVS]          = { "nvs",          "main",  BOOT_STAGE_NONE },
+    [BOOT_STAGE_POWER]        = { "axp192",       "main",  BOOT_STAGE_NVS },
+    [BOOT_STAGE_MONITORS]     = { "monitors",     "main",  BOOT_STAGE_POWER },
+    [BOOT_STAGE_DISPLAY]      = { "display",      "main",  BOOT_STAGE_MONITORS },
+    [BOOT_STAGE_UI]           = { "ui",           "main",  BOOT_STAGE_DISPLAY },
+    [BOOT_STAGE_FIRST_FRAME]  = { "first_frame",  "lvgl",  BOOT_STAGE_UI },
+    [BOOT_STAGE_UX]           = { "ux_service",   "main",  BOOT_STAGE_UI },
+    [BOOT_STAGE_DEMO_EFFECTS] = { "demo_effects", "main",  BOOT_STAGE_FIRST_FRAME },
+    [BOOT_STAGE_RADIO]        = { "radio",        "radio", BOOT_STAGE_NVS },
+    [BOOT_STAGE_FIRST_PACKET] = { "first_packet", "radio", BOOT_STAGE_RADIO },
+};
+
+_Static_assert(BOOT_STAGE_COUNT <= 24, "Boot stages must fit the event group bits");
+
+// 0 until reached; esp_timer is far from 0 by the time app_main runs
+static atomic_uint s_stage_us[BOOT_STAGE_COUNT];
+static EventGroupHandle_t s_events = NULL;
+static StaticEventGroup_t s_events_buffer;
+
+esp_err_t boot_timeline_init(void)
+{
+    if (s_events == NULL) {
+        s_events = xEventGroupCreateStatic(&s_events_buffer);
+    }
+    return (s_events != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void boot_timeline_mark(boot_stage_t stage)
+{
+    if (stage >= BOOT_STAGE_COUNT || atomic_load_explicit(&s_stage_us[stage], memory_order_relaxed) != 0) {
+        return;
+    }
+
+    unsigned int now_us = (unsigned int)esp_timer_get_time();
+    unsigned int expected = 0;
+    if (!atomic_compare_exchange_strong(&s_stage_us[stage], &expected, now_us ? now_us : 1)) {
+        return;     // Another task marked it first
+    }
+    if (s_events != NULL) {
+        xEventGroupSetBits(s_events, BIT(stage));
+    }
+}
+
+bool boot_timeline_reached(boot_stage_t stage)
+{
+    return stage < BOOT_STAGE_COUNT && atomic_load_explicit(&s_stage_us[stage], memory_order_relaxed) != 0;
+}
+
+esp_err_t boot_timeline_wait(boot_stage_t stage, uint32_t timeout_ms)
+{
+    if (stage >= BOOT_STAGE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_events == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(s_events, BIT(stage), pdFALSE, pdTRUE, pdMS_TO_TICKS(timeout_ms));
+    return (bits & BIT(stage)) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t boot_timeline_get(boot_stage_t stage, uint32_t *time_us)
+{
+    if (time_us == NULL || stage >= BOOT_STAGE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *time_us = atomic_load_explicit(&s_stage_us[stage], memory_order_relaxed);
+    return (*time_us != 0) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+void boot_timeline_log(void)
+{
+    uint32_t times[BOOT_STAGE_COUNT];
+    uint8_t order[BOOT_STAGE_COUNT];
+    int reached = 0;
+
+    // Insertion sort of the reached stages by time
+    for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+        times[stage] = atomic_load_explicit(&s_stage_us[stage], memory_order_relaxed);
+        if (times[stage] == 0) {
+            continue;
+        }
+        int pos = reached++;
+        while (pos > 0 && times[order[pos - 1]] > times[stage]) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = (uint8_t)stage;
+    }
+
+    ESP_LOGI(TAG, "=== Boot Timeline (%d/%d stages) ===", reached, BOOT_STAGE_COUNT);
+    for (int i = 0; i < reached; i++) {
+        const boot_stage_desc_t *desc = &s_stages[order[i]];
+        uint32_t at_us = times[order[i]];
+
+        if (desc->after == BOOT_STAGE_NONE || times[desc->after] == 0 || times[desc->after] > at_us) {
+            ESP_LOGI(TAG, "   %6" PRIu32 ".%" PRIu32 " ms  %-5s %-12s", at_us / 1000, (at_us / 100) % 10,
+                     desc->path, desc->name);
+        } else {
+            uint32_t gap_us = at_us - times[desc->after];
+            ESP_LOGI(TAG, "   %6" PRIu32 ".%" PRIu32 " ms  %-5s %-12s +%" PRIu32 ".%" PRIu32 " ms after %s",
+                     at_us / 1000, (at_us / 100) % 10, desc->path, desc->name,
+                     gap_us / 1000, (gap_us / 100) % 10, s_stages[desc->after].name);
+        }
+    }
+    for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+        if (times[stage] == 0) {
+            ESP_LOGI(TAG, "   pending    %-5s %-12s", s_stages[stage].path, s_stages[stage].name);
+        }
+    }
+}
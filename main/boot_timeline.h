@@ -0,0 +1,83 @@
+/*
+ * Boot Timeline for M5StickC Plus 1.1
+ * Timestamps of the boot stages, shared by app_main and the tasks it starts in parallel
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Boot milestones
+ *
+ * app_main runs the display path; the radio path runs in its own task from
+ * BOOT_STAGE_NVS on. Each stage is marked once, when it completes.
+ */
+typedef enum {
+    BOOT_STAGE_NVS = 0,             // NVS ready (Wi-Fi calibration data)
+    BOOT_STAGE_POWER,               // AXP192 rails up
+    BOOT_STAGE_MONITORS,            // System monitor, buttons and power manager running
+    BOOT_STAGE_DISPLAY,             // LCD panel initialized, LVGL task started
+    BOOT_STAGE_UI,                  // Input device and pages created
+    BOOT_STAGE_FIRST_FRAME,         // First refresh flushed to the LCD
+    BOOT_STAGE_UX,                  // LED/buzzer service running (deferred)
+    BOOT_STAGE_DEMO_EFFECTS,        // Startup demo effects queued (deferred)
+    BOOT_STAGE_RADIO,               // Wi-Fi and ESP-NOW started (radio task)
+    BOOT_STAGE_FIRST_PACKET,        // First ESP-NOW frame received
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+/**
+ * @brief Create the stage event group; call first in app_main()
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the event group can't be created
+ */
+esp_err_t boot_timeline_init(void);
+
+/**
+ * @brief Mark a stage as reached now (task context)
+ *
+ * Only the first mark of a stage counts. Marking a stage that is already
+ * reached is a single atomic load, so hot paths may call it unconditionally.
+ */
+void boot_timeline_mark(boot_stage_t stage);
+
+/**
+ * @brief Check whether a stage has been reached
+ */
+bool boot_timeline_reached(boot_stage_t stage);
+
+/**
+ * @brief Block until a stage is reached
+ * @param stage Stage to wait for
+ * @param timeout_ms Maximum wait
+ * @return ESP_OK once reached, ESP_ERR_TIMEOUT otherwise,
+ *         ESP_ERR_INVALID_STATE before boot_timeline_init()
+ */
+esp_err_t boot_timeline_wait(boot_stage_t stage, uint32_t timeout_ms);
+
+/**
+ * @brief Get the time a stage was reached
+ * @param stage Stage
+ * @param time_us Output, esp_timer microseconds since boot
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL or an unknown stage,
+ *         ESP_ERR_NOT_FOUND if the stage has not been reached yet
+ */
+esp_err_t boot_timeline_get(boot_stage_t stage, uint32_t *time_us);
+
+/**
+ * @brief Log the reached stages in time order with the gap to the previous stage of the same path
+ */
+void boot_timeline_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_TIMELINE_H
@@ -4,8 +4,8 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
 #include "esp_timer.h"
+#include "esp_sleep.h"
 #include <string.h>
 
 static const char *TAG = "BUTTON";
@@ -18,15 +18,12 @@ static bool interrupt_mode_enabled = false;
 // Button states
 static button_state_t button_states[BUTTON_COUNT];
 
-// Interrupt queue for button events
-static QueueHandle_t button_interrupt_queue = NULL;
+// Debounce and long-press timers (one-shot, dispatched from the esp_timer task)
+static esp_timer_handle_t debounce_timers[BUTTON_COUNT];
+static esp_timer_handle_t long_press_timers[BUTTON_COUNT];
 
-// Button interrupt event structure
-typedef struct {
-    button_id_t button_id;
-    uint32_t timestamp;
-    bool pressed;
-} button_interrupt_event_t;
+// Deferred statistics; edges is written only by the GPIO ISR, the rest only by the timer callbacks
+static button_stats_t button_stats;
 
 // GPIO pin mapping
 static const gpio_num_t button_pins[BUTTON_COUNT] = {
@@ -50,89 +47,151 @@ static uint32_t get_timestamp_ms(void)
 
 /**
  * @brief GPIO interrupt handler
+ * 
+ * Masks the pin and arms its debounce timer; the level is sampled once the
+ * contacts have settled. No logging or queueing in interrupt context.
  */
 static void IRAM_ATTR button_gpio_isr_handler(void* arg)
 {
     button_id_t button_id = (button_id_t)(uintptr_t)arg;
-    button_interrupt_event_t event = {
-        .button_id = button_id,
-        .timestamp = get_timestamp_ms(),
-        .pressed = (gpio_get_level(button_pins[button_id]) == BUTTON_PRESSED_LEVEL)
-    };
-    
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(button_interrupt_queue, &event, &xHigherPriorityTaskWoken);
     
-    if (xHigherPriorityTaskWoken) {
-        portYIELD_FROM_ISR();
+    button_stats.edges++;
+    gpio_intr_disable(button_pins[button_id]);
+    if (esp_timer_start_once(debounce_timers[button_id], BUTTON_DEBOUNCE_MS * 1000ULL) != ESP_OK) {
+        gpio_intr_enable(button_pins[button_id]);  // Window already running, keep listening
     }
 }
 
 /**
- * @brief Button interrupt processing task
+ * @brief Debounce timer callback - commits a settled level change (esp_timer task)
  */
-static void button_interrupt_task(void *pvParameters)
+static void button_debounce_timer_cb(void *arg)
 {
-    button_interrupt_event_t event;
+    button_id_t button_id = (button_id_t)(uintptr_t)arg;
+    bool pressed = (gpio_get_level(button_pins[button_id]) == BUTTON_PRESSED_LEVEL);
     
-    while (1) {
-        if (xQueueReceive(button_interrupt_queue, &event, portMAX_DELAY)) {
-            if (!interrupt_mode_enabled || !button_initialized) {
-                continue;
-            }
-            
-            button_state_t *state = &button_states[event.button_id];
-            uint32_t current_time = event.timestamp;
+    // Listen for the next edge before acting on this one
+    gpio_intr_enable(button_pins[button_id]);
+    
+    if (!interrupt_mode_enabled || !button_initialized) {
+        return;
+    }
+    
+    button_state_t *state = &button_states[button_id];
+    if (state->current_state == pressed) {
+        button_stats.bounces++;  // Contacts bounced back to the debounced level
+        return;
+    }
+    
+    uint32_t current_time = get_timestamp_ms();
+    state->previous_state = state->current_state;
+    state->current_state = pressed;
+    
+    if (pressed) {
+        // Button pressed; the long-press timer fires while it is still held
+        state->press_start_time = current_time;
+        state->press_count++;
+        state->long_press_triggered = false;
+        esp_timer_start_once(long_press_timers[button_id], BUTTON_LONG_PRESS_MS * 1000ULL);
+        
+        if (interrupt_callback) {
+            interrupt_callback(button_id, BUTTON_EVENT_PRESSED, 0);
+            button_stats.events++;
+        }
+    } else {
+        // Button released
+        esp_timer_stop(long_press_timers[button_id]);
+        state->press_duration = current_time - state->press_start_time;
+        
+        if (interrupt_callback) {
+            interrupt_callback(button_id, BUTTON_EVENT_RELEASED, state->press_duration);
+            button_stats.events++;
             
-            // Debouncing
-            if (state->current_state != event.pressed) {
-                static uint32_t last_change_time[BUTTON_COUNT] = {0};
-                
-                if (current_time - last_change_time[event.button_id] < BUTTON_DEBOUNCE_MS) {
-                    continue; // Ignore bouncing
-                }
-                
-                last_change_time[event.button_id] = current_time;
-                state->previous_state = state->current_state;
-                state->current_state = event.pressed;
-                
-                if (event.pressed) {
-                    // Button pressed
-                    state->press_start_time = current_time;
-                    state->press_count++;
-                    state->long_press_triggered = false;
-                    
-                    ESP_LOGD(TAG, "%s pressed (interrupt)", button_get_name(event.button_id));
-                    
-                    if (interrupt_callback) {
-                        interrupt_callback(event.button_id, BUTTON_EVENT_PRESSED, 0);
-                    }
-                } else {
-                    // Button released
-                    state->press_duration = current_time - state->press_start_time;
-                    
-                    ESP_LOGD(TAG, "%s released after %lums (interrupt)", 
-                             button_get_name(event.button_id), state->press_duration);
-                    
-                    if (interrupt_callback) {
-                        interrupt_callback(event.button_id, BUTTON_EVENT_RELEASED, state->press_duration);
-                        
-                        // Determine if it was a short or long press
-                        if (state->press_duration >= BUTTON_LONG_PRESS_MS) {
-                            if (!state->long_press_triggered) {
-                                interrupt_callback(event.button_id, BUTTON_EVENT_LONG_PRESS, state->press_duration);
-                                state->long_press_triggered = true;
-                            }
-                        } else {
-                            interrupt_callback(event.button_id, BUTTON_EVENT_SHORT_PRESS, state->press_duration);
-                        }
-                    }
-                }
+            // A long press was already reported while the button was held
+            if (!state->long_press_triggered) {
+                interrupt_callback(button_id, BUTTON_EVENT_SHORT_PRESS, state->press_duration);
+                button_stats.events++;
             }
         }
     }
 }
 
+/**
+ * @brief Long-press timer callback - button held for BUTTON_LONG_PRESS_MS (esp_timer task)
+ */
+static void button_long_press_timer_cb(void *arg)
+{
+    button_id_t button_id = (button_id_t)(uintptr_t)arg;
+    button_state_t *state = &button_states[button_id];
+    
+    if (!interrupt_mode_enabled || !button_initialized || !state->current_state || state->long_press_triggered) {
+        return;
+    }
+    
+    state->long_press_triggered = true;
+    state->press_duration = get_timestamp_ms() - state->press_start_time;
+    button_stats.long_presses++;
+    
+    if (interrupt_callback) {
+        interrupt_callback(button_id, BUTTON_EVENT_LONG_PRESS, state->press_duration);
+        button_stats.events++;
+    }
+}
+
+// Delete the debounce and long-press timers that were created
+static void button_delete_timers(void)
+{
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        if (debounce_timers[i]) {
+            esp_timer_stop(debounce_timers[i]);
+            esp_timer_delete(debounce_timers[i]);
+            debounce_timers[i] = NULL;
+        }
+        if (long_press_timers[i]) {
+            esp_timer_stop(long_press_timers[i]);
+            esp_timer_delete(long_press_timers[i]);
+            long_press_timers[i] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Create the per-button debounce and long-press timers
+ */
+static esp_err_t button_create_timers(void)
+{
+    static const char *debounce_names[BUTTON_COUNT] = { "btn_a_debounce", "btn_b_debounce" };
+    static const char *long_press_names[BUTTON_COUNT] = { "btn_a_long", "btn_b_long" };
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        const esp_timer_create_args_t debounce_args = {
+            .callback = button_debounce_timer_cb,
+            .arg = (void*)(uintptr_t)i,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = debounce_names[i],
+        };
+        esp_err_t ret = esp_timer_create(&debounce_args, &debounce_timers[i]);
+        if (ret != ESP_OK) {
+            button_delete_timers();
+            return ret;
+        }
+        
+        const esp_timer_create_args_t long_press_args = {
+            .callback = button_long_press_timer_cb,
+            .arg = (void*)(uintptr_t)i,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = long_press_names[i],
+        };
+        ret = esp_timer_create(&long_press_args, &long_press_timers[i]);
+        if (ret != ESP_OK) {
+            button_delete_timers();
+            return ret;
+        }
+    }
+    
+    return ESP_OK;
+}
+
 esp_err_t button_init(void)
 {
     if (button_initialized) {
@@ -160,18 +219,19 @@ esp_err_t button_init(void)
         return ret;
     }
     
-    // Create interrupt queue
-    button_interrupt_queue = xQueueCreate(10, sizeof(button_interrupt_event_t));
-    if (button_interrupt_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create interrupt queue");
-        return ESP_ERR_NO_MEM;
+    // Create debounce and long-press timers (replace the interrupt queue and task)
+    memset(&button_stats, 0, sizeof(button_stats));
+    ret = button_create_timers();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create button timers: %s", esp_err_to_name(ret));
+        return ret;
     }
     
     // Install GPIO ISR service
     ret = gpio_install_isr_service(ESP_INTR_FLAG_EDGE);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to install ISR service: %s", esp_err_to_name(ret));
-        vQueueDelete(button_interrupt_queue);
+        button_delete_timers();
         return ret;
     }
     
@@ -181,19 +241,15 @@ esp_err_t button_init(void)
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to add ISR handler for %s: %s", 
                      button_get_name(i), esp_err_to_name(ret));
-            button_deinit();
+            for (int j = 0; j < i; j++) {
+                gpio_isr_handler_remove(button_pins[j]);
+            }
+            gpio_uninstall_isr_service();
+            button_delete_timers();
             return ret;
         }
     }
     
-    // Create interrupt processing task with increased stack size for LVGL callbacks and logging
-    BaseType_t task_ret = xTaskCreate(button_interrupt_task, "button_intr", 4096, NULL, 5, NULL);
-    if (task_ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create interrupt task");
-        button_deinit();
-        return ESP_ERR_NO_MEM;
-    }
-    
     // Initialize button states with current GPIO levels
     for (int i = 0; i < BUTTON_COUNT; i++) {
         button_states[i].current_state = (gpio_get_level(button_pins[i]) == BUTTON_PRESSED_LEVEL);
@@ -230,11 +286,8 @@ esp_err_t button_deinit(void)
     // Uninstall GPIO ISR service
     gpio_uninstall_isr_service();
     
-    // Clean up queue
-    if (button_interrupt_queue) {
-        vQueueDelete(button_interrupt_queue);
-        button_interrupt_queue = NULL;
-    }
+    // Stop pending debounce and long-press timers
+    button_delete_timers();
     
     button_initialized = false;
     ESP_LOGI(TAG, "Button driver deinitialized");
@@ -363,6 +416,57 @@ esp_err_t button_reset_press_count(button_id_t button_id)
     return ESP_OK;
 }
 
+esp_err_t button_set_wakeup_mode(bool enable)
+{
+    if (!button_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        esp_err_t ret;
+        if (enable) {
+            // Light sleep wakes only on a GPIO level; a press then also raises the (level) interrupt
+            ret = gpio_wakeup_enable(button_pins[i], GPIO_INTR_LOW_LEVEL);
+        } else {
+            ret = gpio_wakeup_disable(button_pins[i]);
+            if (ret == ESP_OK) {
+                ret = gpio_set_intr_type(button_pins[i], GPIO_INTR_ANYEDGE);
+            }
+            // Resample: a release that happened while only low levels were reported was missed
+            gpio_intr_disable(button_pins[i]);
+            if (esp_timer_start_once(debounce_timers[i], BUTTON_DEBOUNCE_MS * 1000ULL) != ESP_OK) {
+                gpio_intr_enable(button_pins[i]);
+            }
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to %s wakeup for %s: %s", enable ? "enable" : "disable",
+                     button_get_name(i), esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    
+    if (enable) {
+        esp_err_t ret = esp_sleep_enable_gpio_wakeup();
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to enable GPIO wakeup: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    
+    ESP_LOGI(TAG, "Light sleep wakeup %s", enable ? "enabled (low level)" : "disabled (edge interrupts)");
+    return ESP_OK;
+}
+
+esp_err_t button_get_stats(button_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *stats = button_stats;
+    return ESP_OK;
+}
+
 const char* button_get_name(button_id_t button_id)
 {
     if (button_id >= BUTTON_COUNT) {
@@ -12,7 +12,8 @@
  * 
  * Features:
  * - Interrupt-driven button press detection
- * - Debouncing support
+ * - One-shot esp_timer debouncing (no task, no logging in interrupt context)
+ * - Long press reported by timer while the button is still held
  * - Polling mode for battery monitoring task integration
  * - Short press and long press detection
  * - Button state tracking
@@ -42,7 +43,7 @@ extern "C" {
 #define BUTTON_RELEASED_LEVEL   1      // Button released = HIGH
 
 // Button debounce settings
-#define BUTTON_DEBOUNCE_MS      50     // Debounce time in milliseconds
+#define BUTTON_DEBOUNCE_MS      20     // Settle time before a level change is accepted (ms)
 #define BUTTON_LONG_PRESS_MS    1000   // Long press threshold in milliseconds
 
 /**
@@ -77,9 +78,23 @@ typedef struct {
     bool long_press_triggered;  ///< Flag to prevent multiple long press events
 } button_state_t;
 
+/**
+ * @brief Deferred button statistics (interrupt mode)
+ */
+typedef struct {
+    uint32_t edges;             ///< GPIO interrupts taken
+    uint32_t bounces;           ///< Debounce windows that settled on the previous level
+    uint32_t events;            ///< Events delivered to the interrupt callback
+    uint32_t long_presses;      ///< Long presses detected while held
+} button_stats_t;
+
 /**
  * @brief Button interrupt callback function type
  * 
+ * Called from the esp_timer task once an edge has settled (PRESSED, RELEASED,
+ * SHORT_PRESS) or the long-press time elapsed while held (LONG_PRESS). Must not
+ * block; hand the event on to the consuming task.
+ * 
  * @param button_id Which button triggered the interrupt
  * @param event Type of button event
  * @param press_duration Duration of press if applicable (ms)
@@ -168,6 +183,26 @@ uint32_t button_get_press_count(button_id_t button_id);
  */
 esp_err_t button_reset_press_count(button_id_t button_id);
 
+/**
+ * @brief Let the buttons wake the chip from automatic light sleep
+ * 
+ * While enabled the pins interrupt on a low level instead of both edges, so
+ * only presses are seen; disabling restores edge interrupts and resamples
+ * both buttons to pick up a release that happened in between.
+ * 
+ * @param enable true before the system may enter light sleep, false to restore normal operation
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the driver is not initialized
+ */
+esp_err_t button_set_wakeup_mode(bool enable);
+
+/**
+ * @brief Get deferred button statistics
+ * 
+ * @param stats Pointer to store the statistics
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t button_get_stats(button_stats_t *stats);
+
 /**
  * @brief Test all button functions
  * 
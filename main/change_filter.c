@@ -0,0 +1,58 @@
+/*
+ * Change Filter for M5StickC Plus 1.1
+ * Per-metric deadband and hysteresis so sensor noise does not count as a change
+ */
+
+#include "change_filter.h"
+#include <string.h>
+
+void change_filter_reset(change_filter_t *filter)
+{
+    if (filter == NULL) {
+        return;
+    }
+    memset(filter, 0, sizeof(*filter));
+}
+
+void change_filter_reset_all(change_filter_t *filters, size_t count)
+{
+    if (filters == NULL) {
+        return;
+    }
+    memset(filters, 0, count * sizeof(*filters));
+}
+
+bool change_filter_update(change_filter_t *filter, const change_filter_cfg_t *cfg, float value)
+{
+    if (filter == NULL || cfg == NULL) {
+        return false;
+    }
+    
+    if (!filter->valid) {
+        filter->reported = value;
+        filter->direction = 0;
+        filter->valid = true;
+        return true;
+    }
+    
+    float delta = value - filter->reported;
+    int8_t direction = (delta > 0.0f) ? 1 : ((delta < 0.0f) ? -1 : 0);
+    if (direction == 0) {
+        return false;
+    }
+    
+    // Reversing the last reported change has to clear the hysteresis band as well
+    float threshold = cfg->deadband;
+    if (filter->direction != 0 && direction != filter->direction) {
+        threshold += cfg->hysteresis;
+    }
+    
+    float magnitude = (delta > 0.0f) ? delta : -delta;
+    if (magnitude < threshold) {
+        return false;
+    }
+    
+    filter->reported = value;
+    filter->direction = direction;
+    return true;
+}
@@ -0,0 +1,62 @@
+/*
+ * Change Filter for M5StickC Plus 1.1
+ * Per-metric deadband and hysteresis so sensor noise does not count as a change
+ */
+
+#ifndef CHANGE_FILTER_H
+#define CHANGE_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Thresholds for one metric
+ *
+ * A new reading replaces the reported value only if it moved at least
+ * deadband away from it. Moving against the direction of the last reported
+ * change needs deadband + hysteresis, so a reading that sits on a rounding
+ * boundary (e.g. 49/50%) does not toggle the display every second.
+ */
+typedef struct {
+    float deadband;             // Minimum move from the reported value, in the metric's unit
+    float hysteresis;           // Extra move needed to reverse the last direction
+} change_filter_cfg_t;
+
+/**
+ * @brief Filter state for one metric
+ */
+typedef struct {
+    float reported;             // Last value that passed the filter
+    int8_t direction;           // Sign of the last reported change (0 before the second report)
+    bool valid;                 // reported holds a value
+} change_filter_t;
+
+/**
+ * @brief Forget the reported value; the next reading always passes
+ */
+void change_filter_reset(change_filter_t *filter);
+
+/**
+ * @brief Reset an array of filters
+ */
+void change_filter_reset_all(change_filter_t *filters, size_t count);
+
+/**
+ * @brief Feed a new reading
+ * @param filter Filter state
+ * @param cfg Thresholds for this metric
+ * @param value New reading
+ * @return true if the reported value changed (filter->reported is updated)
+ */
+bool change_filter_update(change_filter_t *filter, const change_filter_cfg_t *cfg, float value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHANGE_FILTER_H
@@ -0,0 +1,375 @@
+/*
+ * Device Store for M5StickC Plus 1.1
+ * NVS image of the ESP-NOW device table, written on a coalescing dirty timer
+ */
+
+#include "device_store.h"
+#include "mem_account.h"
+#include "task_placement.h"
+#include "esp_crc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "DEVICE_STORE";
+
+#define DEVICE_STORE_NAMESPACE  "espnow"
+#define DEVICE_STORE_KEY        "devices"
+#define DEVICE_STORE_MAGIC      0x44455654u     // "DEVT"
+
+#if CONFIG_ESPNOW_PERSIST_DEVICES
+#define DEVICE_STORE_VALUES_DELAY_MS    (CONFIG_ESPNOW_PERSIST_INTERVAL_S * 1000u)
+#define DEVICE_STORE_IDENTITY_DELAY_MS  (CONFIG_ESPNOW_PERSIST_IDENTITY_DELAY_S * 1000u)
+#else
+#define DEVICE_STORE_VALUES_DELAY_MS    0
+#define DEVICE_STORE_IDENTITY_DELAY_MS  0
+#endif
+
+// Image = header + records; the records are opaque to the store
+typedef struct {
+    uint32_t magic;
+    uint8_t format;                 // Record format of the snapshot function
+    uint8_t reserved;
+    uint16_t count;                 // Records
+    uint16_t length;                // Record bytes after the header
+    uint16_t crc;                   // CRC16 of the record bytes
+} device_store_header_t;
+
+// Callbacks and limits from device_store_init()
+static device_store_snapshot_fn_t s_snapshot = NULL;
+static size_t s_max_size = 0;
+static uint8_t s_format = 0;
+static void *s_ctx = NULL;
+
+static TimerHandle_t s_flush_timer = NULL;     // One-shot, its callback only wakes s_flush_task
+static TaskHandle_t s_flush_task = NULL;        // Snapshot and NVS writes, off the timer service task
+static atomic_uint s_dirty = ATOMIC_VAR_INIT(DEVICE_STORE_DIRTY_NONE);
+
+// Stored image and statistics (protected by s_write_mutex)
+static SemaphoreHandle_t s_write_mutex = NULL;
+static device_store_stats_t s_stats;
+static uint16_t s_stored_crc = 0;
+static bool s_stored_valid = false;             // s_stored_crc describes the image in NVS
+static int64_t s_last_write_us = 0;
+
+static const char *const s_dirty_names[] = {
+    [DEVICE_STORE_DIRTY_NONE]     = "none",
+    [DEVICE_STORE_DIRTY_VALUES]   = "readings",
+    [DEVICE_STORE_DIRTY_IDENTITY] = "identity",
+};
+
+// Timer service task: hand the write to the flush task so other software timers keep running
+static void device_store_flush_cb(TimerHandle_t timer)
+{
+    (void)timer;
+    xTaskNotifyGive(s_flush_task);
+}
+
+static void device_store_flush_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        device_store_flush();
+    }
+}
+
+esp_err_t device_store_init(device_store_snapshot_fn_t snapshot, size_t max_size, uint8_t format, void *ctx)
+{
+#if CONFIG_ESPNOW_PERSIST_DEVICES
+    if (snapshot == NULL || max_size == 0 || max_size > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_flush_timer != NULL) {
+        return ESP_OK;
+    }
+
+    s_write_mutex = xSemaphoreCreateMutex();
+    if (s_write_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_flush_timer = xTimerCreate("dev_store", pdMS_TO_TICKS(DEVICE_STORE_VALUES_DELAY_MS), pdFALSE, NULL,
+                                 device_store_flush_cb);
+    if (s_flush_timer == NULL) {
+        vSemaphoreDelete(s_write_mutex);
+        s_write_mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_snapshot = snapshot;
+    s_max_size = max_size;
+    s_format = format;
+    s_ctx = ctx;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stored_valid = false;
+    s_last_write_us = 0;
+    atomic_store(&s_dirty, DEVICE_STORE_DIRTY_NONE);
+
+    esp_err_t ret = task_placement_create(TASK_PLACEMENT_DEVICE_STORE, device_store_flush_task, NULL, &s_flush_task);
+    if (ret != ESP_OK) {
+        xTimerDelete(s_flush_timer, portMAX_DELAY);
+        s_flush_timer = NULL;
+        vSemaphoreDelete(s_write_mutex);
+        s_write_mutex = NULL;
+        s_snapshot = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "💾 Device table persisted to NVS: readings every %d s, identities after %d s, image up to %u bytes",
+             CONFIG_ESPNOW_PERSIST_INTERVAL_S, CONFIG_ESPNOW_PERSIST_IDENTITY_DELAY_S,
+             (unsigned)(sizeof(device_store_header_t) + max_size));
+    return ESP_OK;
+#else
+    (void)snapshot;
+    (void)max_size;
+    (void)format;
+    (void)ctx;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void device_store_deinit(void)
+{
+    if (s_write_mutex != NULL) {
+        // Wait for a flush in progress; the flush task holds nothing while it waits
+        xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    }
+    if (s_flush_task != NULL) {
+        vTaskDelete(s_flush_task);
+        s_flush_task = NULL;
+    }
+    if (s_flush_timer != NULL) {
+        xTimerDelete(s_flush_timer, portMAX_DELAY);
+        s_flush_timer = NULL;
+    }
+    if (s_write_mutex != NULL) {
+        vSemaphoreDelete(s_write_mutex);
+        s_write_mutex = NULL;
+    }
+    atomic_store(&s_dirty, DEVICE_STORE_DIRTY_NONE);
+    s_snapshot = NULL;
+}
+
+esp_err_t device_store_restore(device_store_restore_fn_t restore)
+{
+    if (restore == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_write_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(DEVICE_STORE_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+
+    size_t size = 0;
+    ret = nvs_get_blob(handle, DEVICE_STORE_KEY, NULL, &size);
+    if (ret != ESP_OK) {
+        nvs_close(handle);
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+    if (size < sizeof(device_store_header_t) || size > sizeof(device_store_header_t) + s_max_size) {
+        nvs_close(handle);
+        ESP_LOGW(TAG, "Stored image has %u bytes, ignored", (unsigned)size);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    uint8_t *image = mem_account_malloc(MEM_MODULE_DEVICE_STORE, size);
+    if (image == NULL) {
+        nvs_close(handle);
+        return ESP_ERR_NO_MEM;
+    }
+    ret = nvs_get_blob(handle, DEVICE_STORE_KEY, image, &size);
+    nvs_close(handle);
+    if (ret != ESP_OK) {
+        mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+        return ret;
+    }
+
+    device_store_header_t header;
+    memcpy(&header, image, sizeof(header));
+    const uint8_t *records = image + sizeof(header);
+    if (header.magic != DEVICE_STORE_MAGIC || header.format != s_format ||
+        header.length != size - sizeof(header) ||
+        header.crc != esp_crc16_le(UINT16_MAX, records, header.length)) {
+        mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+        ESP_LOGW(TAG, "Stored image is damaged or of another format, ignored");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    int restored = restore(records, header.length, header.count, s_ctx);
+    mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+
+    xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    s_stats.restored = (uint16_t)((restored > 0) ? restored : 0);
+    s_stats.image_size = size;
+    s_stats.image_records = header.count;
+    s_stored_crc = header.crc;
+    s_stored_valid = true;
+    xSemaphoreGive(s_write_mutex);
+
+    ESP_LOGI(TAG, "💾 Restored %d of %u nodes (%u bytes) in %" PRId64 " us", restored, header.count,
+             (unsigned)size, esp_timer_get_time() - start_us);
+    return ESP_OK;
+}
+
+void device_store_mark_dirty(device_store_dirty_t dirty)
+{
+    if (s_flush_timer == NULL || dirty == DEVICE_STORE_DIRTY_NONE) {
+        return;
+    }
+
+    unsigned int prev = atomic_load_explicit(&s_dirty, memory_order_relaxed);
+    while (prev < (unsigned int)dirty) {
+        if (atomic_compare_exchange_weak(&s_dirty, &prev, dirty)) {
+            // (Re)start the timer with the delay of the more urgent change
+            uint32_t delay_ms = (dirty == DEVICE_STORE_DIRTY_IDENTITY) ?
+                                DEVICE_STORE_IDENTITY_DELAY_MS : DEVICE_STORE_VALUES_DELAY_MS;
+            if (xTimerChangePeriod(s_flush_timer, pdMS_TO_TICKS(delay_ms), 0) != pdPASS) {
+                // Timer queue full: the next change tries again
+                unsigned int expected = dirty;
+                atomic_compare_exchange_strong(&s_dirty, &expected, prev);
+            }
+            return;
+        }
+    }
+}
+
+// Snapshot the table and commit it unless identical to the stored image (s_write_mutex held)
+static esp_err_t device_store_write_locked(void)
+{
+    uint8_t *image = mem_account_malloc(MEM_MODULE_DEVICE_STORE, sizeof(device_store_header_t) + s_max_size);
+    if (image == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint16_t count = 0;
+    uint8_t *records = image + sizeof(device_store_header_t);
+    int length = s_snapshot(records, s_max_size, &count, s_ctx);
+    if (length < 0 || (size_t)length > s_max_size) {
+        mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    device_store_header_t header = {
+        .magic = DEVICE_STORE_MAGIC,
+        .format = s_format,
+        .count = count,
+        .length = (uint16_t)length,
+        .crc = esp_crc16_le(UINT16_MAX, records, length),
+    };
+    size_t size = sizeof(header) + length;
+
+    // Quiet nodes leave the image unchanged: no erase cycle for the same bytes
+    if (s_stored_valid && header.crc == s_stored_crc && size == s_stats.image_size && count == s_stats.image_records) {
+        s_stats.unchanged++;
+        mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+        return ESP_OK;
+    }
+    memcpy(image, &header, sizeof(header));
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(DEVICE_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(handle, DEVICE_STORE_KEY, image, size);
+        if (ret == ESP_OK) {
+            ret = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    mem_account_free(MEM_MODULE_DEVICE_STORE, image);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to write device table: %s", esp_err_to_name(ret));
+        s_stored_valid = false;
+        return ret;
+    }
+
+    s_stats.writes++;
+    s_stats.bytes_written += size;
+    s_stats.image_size = size;
+    s_stats.image_records = count;
+    s_stored_crc = header.crc;
+    s_stored_valid = true;
+    s_last_write_us = esp_timer_get_time();
+    ESP_LOGD(TAG, "💾 Wrote %u nodes (%u bytes)", count, (unsigned)size);
+    return ESP_OK;
+}
+
+esp_err_t device_store_flush(void)
+{
+    if (s_write_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    device_store_dirty_t dirty = (device_store_dirty_t)atomic_exchange(&s_dirty, DEVICE_STORE_DIRTY_NONE);
+    if (dirty == DEVICE_STORE_DIRTY_NONE) {
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    esp_err_t ret = device_store_write_locked();
+    if (ret != ESP_OK) {
+        s_stats.failures++;
+    }
+    xSemaphoreGive(s_write_mutex);
+
+    // Keep the change pending; the timer retries after its delay
+    if (ret != ESP_OK) {
+        device_store_mark_dirty(dirty);
+    }
+    return ret;
+}
+
+esp_err_t device_store_get_stats(device_store_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_write_mutex == NULL) {
+        memset(stats, 0, sizeof(*stats));
+        stats->last_write_age_s = UINT32_MAX;
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    *stats = s_stats;
+    stats->last_write_age_s = (s_last_write_us != 0) ?
+                              (uint32_t)((esp_timer_get_time() - s_last_write_us) / 1000000) : UINT32_MAX;
+    xSemaphoreGive(s_write_mutex);
+    stats->pending = (device_store_dirty_t)atomic_load_explicit(&s_dirty, memory_order_relaxed);
+    return ESP_OK;
+}
+
+void device_store_log(void)
+{
+    if (s_write_mutex == NULL) {
+        return;
+    }
+
+    device_store_stats_t stats;
+    device_store_get_stats(&stats);
+
+    ESP_LOGI(TAG, "=== Device Store (%u nodes, %" PRIu32 " bytes, %u restored at boot) ===",
+             stats.image_records, stats.image_size, stats.restored);
+    if (stats.last_write_age_s != UINT32_MAX) {
+        ESP_LOGI(TAG, "   %" PRIu32 " writes, %" PRIu32 " unchanged, %" PRIu32 " failed, %" PRIu32 " KB written, last %" PRIu32 " s ago, pending %s",
+                 stats.writes, stats.unchanged, stats.failures, stats.bytes_written / 1024,
+                 stats.last_write_age_s, s_dirty_names[stats.pending]);
+    } else {
+        ESP_LOGI(TAG, "   no writes since boot (%" PRIu32 " unchanged, %" PRIu32 " failed), pending %s",
+                 stats.unchanged, stats.failures, s_dirty_names[stats.pending]);
+    }
+}
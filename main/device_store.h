@@ -0,0 +1,122 @@
+/*
+ * Device Store for M5StickC Plus 1.1
+ * NVS image of the ESP-NOW device table, written on a coalescing dirty timer
+ */
+
+#ifndef DEVICE_STORE_H
+#define DEVICE_STORE_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief What changed in the device table since the last write
+ *
+ * Readings change with every packet and are written at the long interval.
+ * Node identities (new or evicted nodes, device ID, firmware) change rarely
+ * and are written after a short delay. Both kinds are coalesced: at most one
+ * write per delay, however many packets arrive.
+ */
+typedef enum {
+    DEVICE_STORE_DIRTY_NONE = 0,
+    DEVICE_STORE_DIRTY_VALUES,      // Readings only, CONFIG_ESPNOW_PERSIST_INTERVAL_S
+    DEVICE_STORE_DIRTY_IDENTITY,    // Node set or identity, CONFIG_ESPNOW_PERSIST_IDENTITY_DELAY_S
+} device_store_dirty_t;
+
+/**
+ * @brief Serialize the device table into records (called with no device store lock held)
+ * @param buf Output buffer
+ * @param size Capacity of buf
+ * @param count Output, number of records written
+ * @param ctx User context of device_store_init()
+ * @return Bytes written, or -1 if the table could not be read (the write is retried later)
+ */
+typedef int (*device_store_snapshot_fn_t)(uint8_t *buf, size_t size, uint16_t *count, void *ctx);
+
+/**
+ * @brief Load records written by the snapshot function
+ * @param buf Records, CRC checked
+ * @param len Bytes in buf
+ * @param count Number of records
+ * @param ctx User context of device_store_init()
+ * @return Number of records restored
+ */
+typedef int (*device_store_restore_fn_t)(const uint8_t *buf, size_t len, uint16_t count, void *ctx);
+
+/**
+ * @brief Device store statistics
+ */
+typedef struct {
+    uint32_t writes;                // Images committed to NVS
+    uint32_t unchanged;             // Flushes skipped, image identical to the stored one
+    uint32_t failures;              // Snapshot or NVS errors
+    uint32_t bytes_written;         // Image bytes committed since boot
+    uint32_t image_size;            // Size of the stored image
+    uint16_t image_records;         // Records in the stored image
+    uint16_t restored;              // Records loaded at boot
+    uint32_t last_write_age_s;      // Since the last commit, UINT32_MAX if none since boot
+    device_store_dirty_t pending;   // Change waiting for the flush timer
+} device_store_stats_t;
+
+/**
+ * @brief Create the flush timer and the task that writes the image (after nvs_flash_init())
+ * @param snapshot Serializer of the device table
+ * @param max_size Largest image the snapshot function can produce, header excluded
+ * @param format Record format version; an image with another version is ignored
+ * @param ctx User context for the callbacks
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL,
+ *         ESP_ERR_NOT_SUPPORTED without CONFIG_ESPNOW_PERSIST_DEVICES,
+ *         ESP_ERR_NO_MEM if the timer, task or mutex can't be created
+ */
+esp_err_t device_store_init(device_store_snapshot_fn_t snapshot, size_t max_size, uint8_t format, void *ctx);
+
+/**
+ * @brief Stop the flush timer and task; pending changes are lost unless flushed first
+ */
+void device_store_deinit(void);
+
+/**
+ * @brief Read the stored image in one NVS access and hand it to restore
+ * @param restore Loader of the records
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if nothing is stored,
+ *         ESP_ERR_INVALID_CRC if the image is damaged or of another format,
+ *         ESP_ERR_INVALID_STATE before init
+ */
+esp_err_t device_store_restore(device_store_restore_fn_t restore);
+
+/**
+ * @brief Note a table change and arm the flush timer (task context)
+ *
+ * A change no more urgent than the one already pending is a single atomic
+ * load, so the receive path may call it for every stored frame.
+ */
+void device_store_mark_dirty(device_store_dirty_t dirty);
+
+/**
+ * @brief Write pending changes now (before stopping or powering off)
+ * @return ESP_OK if written or nothing to write, error code otherwise
+ */
+esp_err_t device_store_flush(void);
+
+/**
+ * @brief Get the device store statistics
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t device_store_get_stats(device_store_stats_t *stats);
+
+/**
+ * @brief Log the write and wear statistics
+ */
+void device_store_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEVICE_STORE_H
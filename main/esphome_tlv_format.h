@@ -53,6 +53,12 @@
 #define TLV_TYPE_TEMPERATURE     0x70  // Temperature in Celsius (float32)
 #define TLV_TYPE_HUMIDITY        0x71  // Humidity in % (float32)
 
+// Power Supply (0x90-0xAF)
+#define TLV_TYPE_BATTERY_VOLTAGE 0x90  // Battery voltage in volts (float32)
+#define TLV_TYPE_BATTERY_LEVEL   0x91  // Battery charge in % (uint16_t)
+#define TLV_TYPE_BATTERY_CURRENT 0x92  // Battery current in milliamperes (int32_t), positive while charging
+#define TLV_TYPE_VBUS_VOLTAGE    0x93  // USB/VBUS input voltage in volts (float32)
+
 // Custom/Extension (0xF0-0xFF)
 #define TLV_TYPE_CUSTOM_START    0xF0  // Start of custom types
 
@@ -63,6 +69,8 @@
 #define STATUS_FLAG_LOW_BATTERY      0x0008  // Low battery warning
 #define STATUS_FLAG_WIFI_CONNECTED   0x0010  // WiFi connected
 #define STATUS_FLAG_ESP_NOW_ACTIVE   0x0020  // ESP-NOW active
+#define STATUS_FLAG_CHARGING         0x0040  // Battery charging
+#define STATUS_FLAG_USB_POWERED      0x0080  // External (USB/VBUS) power present
 
 // Error Codes
 #define ERROR_NONE                   0x0000
@@ -110,6 +118,10 @@ typedef struct {
 #define TLV_SIZE_ERROR_CODE      2   // uint16_t, error code
 #define TLV_SIZE_TEMPERATURE     4   // float32, celsius
 #define TLV_SIZE_HUMIDITY        4   // float32, percentage
+#define TLV_SIZE_BATTERY_VOLTAGE 4   // float32, volts
+#define TLV_SIZE_BATTERY_LEVEL   2   // uint16_t, percentage
+#define TLV_SIZE_BATTERY_CURRENT 4   // int32_t, milliamperes (fixed-point)
+#define TLV_SIZE_VBUS_VOLTAGE    4   // float32, volts
 
 // Maximum sizes for variable-length types
 #define TLV_MAX_DEVICE_ID_LEN     16
@@ -297,7 +309,9 @@ typedef struct {
 //     Bit 3 (0x0008): STATUS_FLAG_LOW_BATTERY - Low battery warning
 //     Bit 4 (0x0010): STATUS_FLAG_WIFI_CONNECTED - WiFi connected
 //     Bit 5 (0x0020): STATUS_FLAG_ESP_NOW_ACTIVE - ESP-NOW active
-//     Bits 6-15: Reserved for future use
+//     Bit 6 (0x0040): STATUS_FLAG_CHARGING - Battery charging
+//     Bit 7 (0x0080): STATUS_FLAG_USB_POWERED - External power present
+//     Bits 8-15: Reserved for future use
 //
 // TLV_TYPE_ERROR_CODE (0x51):
 //   Format: uint16_t (2 bytes, big-endian)
@@ -325,6 +339,34 @@ typedef struct {
 //   Range: 0.0 to 100.0%
 //   Usage: Ambient humidity measurement
 
+// POWER SUPPLY (0x90-0xAF)
+//
+// TLV_TYPE_BATTERY_VOLTAGE (0x90):
+//   Format: IEEE 754 float32 (4 bytes, big-endian)
+//   Unit: Volts (V)
+//   Precision: 0.01V
+//   Range: 0.00 to 5.00V (single Li-ion cell)
+//   Usage: Battery-powered devices
+//
+// TLV_TYPE_BATTERY_LEVEL (0x91):
+//   Format: uint16_t (2 bytes, big-endian)
+//   Unit: Percent of full charge (%)
+//   Range: 0 to 100
+//   Usage: Estimated state of charge
+//
+// TLV_TYPE_BATTERY_CURRENT (0x92):
+//   Format: int32_t (4 bytes, big-endian, signed, fixed-point)
+//   Unit: Milliamperes (mA)
+//   Positive: charging, Negative: discharging
+//   Example: -85 = discharging at 0.085A
+//
+// TLV_TYPE_VBUS_VOLTAGE (0x93):
+//   Format: IEEE 754 float32 (4 bytes, big-endian)
+//   Unit: Volts (V)
+//   Precision: 0.01V
+//   Range: 0.00V (unplugged) to about 5.25V (USB)
+//   Usage: External supply monitoring
+
 // IMPLEMENTATION EXAMPLES
 // =======================
 //
@@ -0,0 +1,672 @@
+/*
+ * ESP-NOW benchmark mode for M5StickC Plus 1.1
+ * Timestamped ping-pong and flood tests between two sticks
+ */
+
+#include "espnow_bench.h"
+#include "esp_now.h"  // Must be included BEFORE espnow_example.h for ESP_NOW_ETH_ALEN
+#include "espnow_example.h"
+#include "espnow_manager.h"
+#include "ui_notify.h"
+#include "seqlock.h"
+#include "task_placement.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+#include <inttypes.h>
+
+static const char *TAG = "ESPNOW_BENCH";
+
+// ===== PROTOCOL =====
+
+#define BENCH_MAGIC                 0x48434E42u     // "BNCH" little endian
+#define BENCH_PING_COUNT            CONFIG_ESPNOW_BENCH_PING_COUNT
+#define BENCH_FLOOD_COUNT           CONFIG_ESPNOW_BENCH_FLOOD_COUNT
+#define BENCH_PING_TIMEOUT_MS       100     // Pong must arrive within this time
+#define BENCH_REPLY_TIMEOUT_MS      500     // Setup ack and flood report
+#define BENCH_SETUP_RETRIES         3
+#define BENCH_PROBE_RETRIES         10      // Pings to find a peer before giving up
+#define BENCH_PEER_REVERT_MS        3000    // Responder returns to the default profile when idle
+#define BENCH_SETTLE_MS             50      // Radio settle time after a profile switch
+
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+#define BENCH_POWER_SAVE            true    // Modem sleep is fixed at build time
+#else
+#define BENCH_POWER_SAVE            false
+#endif
+
+typedef enum {
+    BENCH_KIND_PING = 1,            // Initiator -> peer, echoed as PONG
+    BENCH_KIND_PONG,
+    BENCH_KIND_FLOOD,               // Initiator -> peer, counted only
+    BENCH_KIND_FLOOD_END,           // Initiator -> peer, answered with REPORT
+    BENCH_KIND_REPORT,
+    BENCH_KIND_SETUP,               // Initiator -> peer, switch radio profile after SETUP_ACK
+    BENCH_KIND_SETUP_ACK,
+} bench_kind_t;
+
+// Common header of every benchmark frame (broadcast, filtered by target)
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t kind;                   // bench_kind_t
+    uint8_t profile;                // Radio profile index
+    uint16_t seq;
+    uint32_t session;               // Sweep and run the frame belongs to
+    uint8_t target[ESP_NOW_ETH_ALEN];   // Receiver, all zero = any stick
+    int64_t t_tx_us;                // Initiator send time, echoed in the PONG
+} bench_hdr_t;
+
+// Flood result counted by the peer
+typedef struct __attribute__((packed)) {
+    bench_hdr_t hdr;
+    uint16_t received;
+    uint32_t span_us;               // First to last flood frame
+    uint16_t rssi_hist[ESPNOW_BENCH_RSSI_BINS];
+} bench_report_frame_t;
+
+/**
+ * @brief Radio settings measured by one part of the sweep
+ */
+typedef struct {
+    uint8_t channel;
+    bool long_range;
+} bench_profile_t;
+
+// Profile 0 is the normal operating configuration and is restored after the sweep
+static const bench_profile_t k_bench_profiles[ESPNOW_BENCH_PROFILE_COUNT] = {
+    { CONFIG_ESPNOW_CHANNEL, false },
+    { 1, false },
+    { 6, false },
+    { 11, false },
+    { CONFIG_ESPNOW_CHANNEL, true },    // 802.11 LR 250 kbps
+};
+
+static const uint16_t k_bench_sizes[ESPNOW_BENCH_SIZE_COUNT] = {
+    sizeof(bench_report_frame_t), 128, ESP_NOW_MAX_DATA_LEN,
+};
+
+_Static_assert(sizeof(bench_report_frame_t) <= ESP_NOW_MAX_DATA_LEN, "Benchmark report must fit one frame");
+
+static const uint8_t k_broadcast_mac[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static const uint8_t k_any_mac[ESP_NOW_ETH_ALEN] = { 0 };
+
+// ===== STATE =====
+
+// Reply handed from the receive task to the bench task
+typedef struct {
+    uint8_t kind;
+    uint16_t seq;
+    uint32_t rtt_us;                // PONG only
+    int8_t rssi;
+    uint8_t mac[ESP_NOW_ETH_ALEN];
+    bench_report_frame_t report;    // REPORT only
+} bench_reply_t;
+
+static TaskHandle_t s_bench_task = NULL;
+static volatile bool s_running = false;
+static volatile uint32_t s_session = 0;         // Session the bench task is waiting on
+static uint32_t s_sweep_id = 0;
+
+static portMUX_TYPE s_reply_lock = portMUX_INITIALIZER_UNLOCKED;
+static bench_reply_t s_reply;
+static bool s_reply_valid = false;
+
+// Report built by the bench task and published for the UI
+static espnow_bench_report_t s_work;
+static espnow_bench_report_t s_published;
+static seqlock_t s_report_lock = SEQLOCK_INIT;
+
+// Responder side, receive task only (except the revert timer)
+static struct {
+    uint32_t session;
+    uint16_t received;
+    int64_t first_us;
+    int64_t last_us;
+    uint16_t rssi_hist[ESPNOW_BENCH_RSSI_BINS];
+} s_resp;
+
+static uint8_t s_active_profile = 0;
+static esp_timer_handle_t s_revert_timer = NULL;
+static uint8_t s_own_mac[ESP_NOW_ETH_ALEN];
+static bool s_own_mac_valid = false;
+static uint8_t s_resp_buf[ESP_NOW_MAX_DATA_LEN];
+static uint8_t s_tx_buf[ESP_NOW_MAX_DATA_LEN];
+
+// ===== HELPERS =====
+
+static void bench_publish(void)
+{
+    seqlock_write_copy(&s_report_lock, &s_published, &s_work, sizeof(s_work));
+    ui_notify_publish(UI_TOPIC_ESPNOW_BENCH);
+}
+
+static const uint8_t *bench_own_mac(void)
+{
+    if (!s_own_mac_valid && esp_wifi_get_mac(ESPNOW_WIFI_IF, s_own_mac) == ESP_OK) {
+        s_own_mac_valid = true;
+    }
+    return s_own_mac;
+}
+
+static void bench_rssi_count(uint16_t *hist, int8_t rssi)
+{
+    int bin = (rssi - ESPNOW_BENCH_RSSI_FLOOR) / 10;
+    if (bin < 0) {
+        bin = 0;
+    } else if (bin >= ESPNOW_BENCH_RSSI_BINS) {
+        bin = ESPNOW_BENCH_RSSI_BINS - 1;
+    }
+    if (hist[bin] < UINT16_MAX) {
+        hist[bin]++;
+    }
+}
+
+/**
+ * @brief Fill a frame header and pad the payload with a counting pattern
+ */
+static void bench_frame_build(uint8_t *buf, uint16_t len, bench_kind_t kind, uint8_t profile, uint16_t seq,
+                              uint32_t session, const uint8_t *target, int64_t t_tx_us)
+{
+    bench_hdr_t hdr = {
+        .magic = BENCH_MAGIC,
+        .kind = (uint8_t)kind,
+        .profile = profile,
+        .seq = seq,
+        .session = session,
+        .t_tx_us = t_tx_us,
+    };
+    memcpy(hdr.target, target, ESP_NOW_ETH_ALEN);
+    memcpy(buf, &hdr, sizeof(hdr));
+    for (uint16_t i = sizeof(hdr); i < len; i++) {
+        buf[i] = (uint8_t)i;
+    }
+}
+
+/**
+ * @brief Broadcast a frame, retrying while the Wi-Fi TX queue is full
+ */
+static esp_err_t bench_send(const uint8_t *buf, uint16_t len)
+{
+    esp_err_t ret;
+    for (int attempt = 0; attempt < 20; attempt++) {
+        ret = esp_now_send(k_broadcast_mac, buf, len);
+        if (ret != ESP_ERR_ESPNOW_NO_MEM) {
+            return ret;
+        }
+        vTaskDelay(1);
+    }
+    return ret;
+}
+
+/**
+ * @brief Switch channel and PHY rate of the broadcast peer to a profile
+ */
+static esp_err_t bench_apply_profile(uint8_t index)
+{
+    const bench_profile_t *profile = &k_bench_profiles[index];
+
+    uint8_t protocol = WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N;
+#if CONFIG_ESPNOW_ENABLE_LONG_RANGE
+    protocol |= WIFI_PROTOCOL_LR;
+#endif
+    if (profile->long_range) {
+        protocol |= WIFI_PROTOCOL_LR;
+    }
+    esp_err_t ret = esp_wifi_set_protocol(ESPNOW_WIFI_IF, protocol);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_set_channel(profile->channel, WIFI_SECOND_CHAN_NONE);
+    }
+
+    // The broadcast peer is pinned to a channel; move it along
+    esp_now_peer_info_t peer;
+    if (ret == ESP_OK && esp_now_get_peer(k_broadcast_mac, &peer) == ESP_OK) {
+        peer.channel = profile->channel;
+        ret = esp_now_mod_peer(&peer);
+    }
+
+    if (ret == ESP_OK) {
+        esp_now_rate_config_t rate = {
+            .phymode = profile->long_range ? WIFI_PHY_MODE_LR : WIFI_PHY_MODE_11B,
+            .rate = profile->long_range ? WIFI_PHY_RATE_LORA_250K : WIFI_PHY_RATE_1M_L,
+        };
+        ret = esp_now_set_peer_rate_config(k_broadcast_mac, &rate);
+    }
+
+    if (ret == ESP_OK) {
+        s_active_profile = index;
+    } else {
+        ESP_LOGW(TAG, "Failed to apply profile %d (ch%d%s): %s", index, profile->channel,
+                 profile->long_range ? " LR" : "", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+// ===== RESPONDER =====
+
+static void bench_revert_timer_cb(void *arg)
+{
+    // The initiator went away mid-sweep: return to normal operation
+    if (!s_running && s_active_profile != 0) {
+        ESP_LOGI(TAG, "🔙 Benchmark peer idle, restoring default radio profile");
+        bench_apply_profile(0);
+    }
+}
+
+static void bench_revert_touch(void)
+{
+    if (s_revert_timer == NULL) {
+        const esp_timer_create_args_t args = {
+            .callback = bench_revert_timer_cb,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "bench_revert",
+        };
+        if (esp_timer_create(&args, &s_revert_timer) != ESP_OK) {
+            s_revert_timer = NULL;
+            return;
+        }
+    }
+    esp_timer_stop(s_revert_timer);
+    esp_timer_start_once(s_revert_timer, (uint64_t)BENCH_PEER_REVERT_MS * 1000);
+}
+
+static void bench_respond(const uint8_t *mac_addr, const bench_hdr_t *hdr, const uint8_t *data, int len, int8_t rssi)
+{
+    bench_revert_touch();
+
+    switch (hdr->kind) {
+        case BENCH_KIND_PING:
+            // Echo the frame with its timestamp so the initiator measures the full round trip
+            memcpy(s_resp_buf, data, len);
+            bench_frame_build(s_resp_buf, sizeof(bench_hdr_t), BENCH_KIND_PONG, hdr->profile, hdr->seq,
+                              hdr->session, mac_addr, hdr->t_tx_us);
+            bench_send(s_resp_buf, (uint16_t)len);
+            break;
+
+        case BENCH_KIND_FLOOD: {
+            int64_t now_us = esp_timer_get_time();
+            if (hdr->session != s_resp.session) {
+                memset(&s_resp, 0, sizeof(s_resp));
+                s_resp.session = hdr->session;
+                s_resp.first_us = now_us;
+            }
+            s_resp.received++;
+            s_resp.last_us = now_us;
+            bench_rssi_count(s_resp.rssi_hist, rssi);
+            break;
+        }
+
+        case BENCH_KIND_FLOOD_END: {
+            bench_report_frame_t report;
+            bench_frame_build(s_resp_buf, sizeof(report), BENCH_KIND_REPORT, hdr->profile, hdr->seq,
+                              hdr->session, mac_addr, hdr->t_tx_us);
+            memcpy(&report, s_resp_buf, sizeof(report));
+            bool match = (s_resp.session == hdr->session);
+            report.received = match ? s_resp.received : 0;
+            report.span_us = match ? (uint32_t)(s_resp.last_us - s_resp.first_us) : 0;
+            memcpy(report.rssi_hist, s_resp.rssi_hist, sizeof(report.rssi_hist));
+            if (!match) {
+                memset(report.rssi_hist, 0, sizeof(report.rssi_hist));
+            }
+            memcpy(s_resp_buf, &report, sizeof(report));
+            bench_send(s_resp_buf, sizeof(report));
+            break;
+        }
+
+        case BENCH_KIND_SETUP:
+            if (hdr->profile >= ESPNOW_BENCH_PROFILE_COUNT) {
+                break;
+            }
+            bench_frame_build(s_resp_buf, sizeof(bench_hdr_t), BENCH_KIND_SETUP_ACK, hdr->profile, hdr->seq,
+                              hdr->session, mac_addr, hdr->t_tx_us);
+            bench_send(s_resp_buf, sizeof(bench_hdr_t));
+            if (hdr->profile != s_active_profile) {
+                // Let the ack leave on the old channel first
+                vTaskDelay(pdMS_TO_TICKS(20));
+                bench_apply_profile(hdr->profile);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool espnow_bench_handle_frame(const uint8_t *mac_addr, const uint8_t *data, int len, int8_t rssi)
+{
+    bench_hdr_t hdr;
+
+    if (mac_addr == NULL || data == NULL || len < (int)sizeof(hdr)) {
+        return false;
+    }
+    memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.magic != BENCH_MAGIC) {
+        return false;
+    }
+
+    // Benchmark frames are broadcast; drop those addressed to another stick
+    if (memcmp(hdr.target, k_any_mac, ESP_NOW_ETH_ALEN) != 0 &&
+        memcmp(hdr.target, bench_own_mac(), ESP_NOW_ETH_ALEN) != 0) {
+        return true;
+    }
+
+    switch (hdr.kind) {
+        case BENCH_KIND_PONG:
+        case BENCH_KIND_REPORT:
+        case BENCH_KIND_SETUP_ACK: {
+            if (!s_running || hdr.session != s_session || s_bench_task == NULL) {
+                return true;
+            }
+            bench_reply_t reply = {
+                .kind = hdr.kind,
+                .seq = hdr.seq,
+                .rssi = rssi,
+            };
+            memcpy(reply.mac, mac_addr, ESP_NOW_ETH_ALEN);
+            if (hdr.kind == BENCH_KIND_PONG) {
+                reply.rtt_us = (uint32_t)(esp_timer_get_time() - hdr.t_tx_us);
+            } else if (hdr.kind == BENCH_KIND_REPORT && len >= (int)sizeof(bench_report_frame_t)) {
+                memcpy(&reply.report, data, sizeof(bench_report_frame_t));
+            }
+
+            taskENTER_CRITICAL(&s_reply_lock);
+            s_reply = reply;
+            s_reply_valid = true;
+            taskEXIT_CRITICAL(&s_reply_lock);
+            xTaskNotifyGive(s_bench_task);
+            return true;
+        }
+
+        default:
+            // Never answer our own sweep's traffic
+            if (!s_running) {
+                bench_respond(mac_addr, &hdr, data, len, rssi);
+            }
+            return true;
+    }
+}
+
+// ===== INITIATOR =====
+
+/**
+ * @brief Wait for a reply of a kind and sequence number in the current session
+ */
+static bool bench_wait_reply(bench_kind_t kind, uint16_t seq, uint32_t timeout_ms, bench_reply_t *out)
+{
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    for (;;) {
+        taskENTER_CRITICAL(&s_reply_lock);
+        bool valid = s_reply_valid;
+        if (valid) {
+            *out = s_reply;
+            s_reply_valid = false;
+        }
+        taskEXIT_CRITICAL(&s_reply_lock);
+
+        if (valid && out->kind == kind && out->seq == seq) {
+            return true;
+        }
+
+        int64_t left_us = deadline_us - esp_timer_get_time();
+        if (left_us <= 0) {
+            return false;
+        }
+        TickType_t ticks = pdMS_TO_TICKS((uint32_t)(left_us / 1000));
+        ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1);
+    }
+}
+
+/**
+ * @brief Ask the peer to switch profile, then follow it
+ */
+static bool bench_switch_profile(uint8_t index, const uint8_t *peer, uint32_t session)
+{
+    if (index == s_active_profile) {
+        return true;
+    }
+
+    s_session = session;
+    for (int attempt = 0; attempt < BENCH_SETUP_RETRIES; attempt++) {
+        bench_reply_t reply;
+        bench_frame_build(s_tx_buf, sizeof(bench_hdr_t), BENCH_KIND_SETUP, index, (uint16_t)attempt,
+                          session, peer, esp_timer_get_time());
+        bench_send(s_tx_buf, sizeof(bench_hdr_t));
+        if (bench_wait_reply(BENCH_KIND_SETUP_ACK, (uint16_t)attempt, BENCH_REPLY_TIMEOUT_MS, &reply)) {
+            bool ok = (bench_apply_profile(index) == ESP_OK);
+            vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+            return ok;
+        }
+    }
+
+    ESP_LOGW(TAG, "Peer did not acknowledge profile %d", index);
+    return false;
+}
+
+/**
+ * @brief Find a responder with pings to any stick
+ */
+static bool bench_probe_peer(uint8_t *peer)
+{
+    uint32_t session = (s_sweep_id << 8) | 0xFF;
+    s_session = session;
+
+    for (uint16_t seq = 0; seq < BENCH_PROBE_RETRIES; seq++) {
+        bench_reply_t reply;
+        bench_frame_build(s_tx_buf, sizeof(bench_hdr_t), BENCH_KIND_PING, s_active_profile, seq,
+                          session, k_any_mac, esp_timer_get_time());
+        bench_send(s_tx_buf, sizeof(bench_hdr_t));
+        if (bench_wait_reply(BENCH_KIND_PONG, seq, BENCH_PING_TIMEOUT_MS * 2, &reply)) {
+            memcpy(peer, reply.mac, ESP_NOW_ETH_ALEN);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void bench_sort(uint32_t *values, int count)
+{
+    for (int i = 1; i < count; i++) {
+        uint32_t v = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > v) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+}
+
+static uint32_t bench_percentile(const uint32_t *sorted, int count, int pct)
+{
+    return (count > 0) ? sorted[((count - 1) * pct) / 100] : 0;
+}
+
+/**
+ * @brief Ping-pong phase of one run
+ */
+static void bench_run_ping(espnow_bench_result_t *result, const uint8_t *peer, uint32_t session)
+{
+    static uint32_t s_rtt[BENCH_PING_COUNT];
+    int samples = 0;
+
+    s_session = session;
+    for (uint16_t seq = 0; seq < BENCH_PING_COUNT; seq++) {
+        bench_reply_t reply;
+        bench_frame_build(s_tx_buf, result->payload_len, BENCH_KIND_PING, s_active_profile, seq,
+                          session, peer, esp_timer_get_time());
+        if (bench_send(s_tx_buf, result->payload_len) != ESP_OK) {
+            continue;
+        }
+        result->pings_sent++;
+        if (bench_wait_reply(BENCH_KIND_PONG, seq, BENCH_PING_TIMEOUT_MS, &reply)) {
+            s_rtt[samples++] = reply.rtt_us;
+            bench_rssi_count(result->rssi_hist, reply.rssi);
+        }
+    }
+
+    result->pongs_received = (uint16_t)samples;
+    bench_sort(s_rtt, samples);
+    result->rtt_min_us = (samples > 0) ? s_rtt[0] : 0;
+    result->rtt_p50_us = bench_percentile(s_rtt, samples, 50);
+    result->rtt_p90_us = bench_percentile(s_rtt, samples, 90);
+    result->rtt_p99_us = bench_percentile(s_rtt, samples, 99);
+    result->rtt_max_us = (samples > 0) ? s_rtt[samples - 1] : 0;
+}
+
+/**
+ * @brief Flood phase of one run, counted by the peer
+ */
+static void bench_run_flood(espnow_bench_result_t *result, const uint8_t *peer, uint32_t session)
+{
+    s_session = session;
+    for (uint16_t seq = 0; seq < BENCH_FLOOD_COUNT; seq++) {
+        bench_frame_build(s_tx_buf, result->payload_len, BENCH_KIND_FLOOD, s_active_profile, seq,
+                          session, peer, 0);
+        if (bench_send(s_tx_buf, result->payload_len) == ESP_OK) {
+            result->flood_sent++;
+        }
+    }
+
+    // FLOOD_END may be lost like any broadcast; repeat it until the report arrives
+    for (uint16_t attempt = 0; attempt < BENCH_SETUP_RETRIES; attempt++) {
+        bench_reply_t reply;
+        bench_frame_build(s_tx_buf, sizeof(bench_hdr_t), BENCH_KIND_FLOOD_END, s_active_profile, attempt,
+                          session, peer, 0);
+        bench_send(s_tx_buf, sizeof(bench_hdr_t));
+        if (bench_wait_reply(BENCH_KIND_REPORT, attempt, BENCH_REPLY_TIMEOUT_MS, &reply)) {
+            result->flood_received = reply.report.received;
+            if (reply.report.span_us > 0 && reply.report.received > 1) {
+                result->flood_pps = (uint32_t)(((uint64_t)(reply.report.received - 1) * 1000000ULL) /
+                                               reply.report.span_us);
+            }
+            for (int i = 0; i < ESPNOW_BENCH_RSSI_BINS; i++) {
+                uint32_t sum = (uint32_t)result->rssi_hist[i] + reply.report.rssi_hist[i];
+                result->rssi_hist[i] = (sum > UINT16_MAX) ? UINT16_MAX : (uint16_t)sum;
+            }
+            return;
+        }
+    }
+}
+
+static void bench_log_result(const espnow_bench_result_t *r)
+{
+    char hist[ESPNOW_BENCH_RSSI_BINS * 6 + 1];
+    int pos = 0;
+    for (int i = 0; i < ESPNOW_BENCH_RSSI_BINS && pos < (int)sizeof(hist); i++) {
+        pos += snprintf(&hist[pos], sizeof(hist) - pos, "%s%u", i ? "/" : "", r->rssi_hist[i]);
+    }
+
+    ESP_LOGI(TAG, "📊 ch%2d %s%s %3uB | RTT us p50 %" PRIu32 " p90 %" PRIu32 " p99 %" PRIu32
+             " [%" PRIu32 "..%" PRIu32 "] %u/%u | flood %u/%u %" PRIu32 " pps | RSSI %s",
+             r->channel, r->long_range ? "LR" : "--", r->power_save ? " PS" : "", r->payload_len,
+             r->rtt_p50_us, r->rtt_p90_us, r->rtt_p99_us, r->rtt_min_us, r->rtt_max_us,
+             r->pongs_received, r->pings_sent, r->flood_received, r->flood_sent, r->flood_pps, hist);
+}
+
+static void espnow_bench_task(void *pvParameter)
+{
+    uint8_t peer[ESP_NOW_ETH_ALEN];
+
+    ESP_LOGI(TAG, "🏁 Benchmark sweep %" PRIu32 " started", s_sweep_id);
+
+    if (!bench_probe_peer(peer)) {
+        ESP_LOGW(TAG, "❌ No benchmark peer answered");
+        s_work.state = ESPNOW_BENCH_FAILED;
+    } else {
+        memcpy(s_work.peer_mac, peer, sizeof(peer));
+        ESP_LOGI(TAG, "🤝 Benchmark peer " MACSTR, MAC2STR(peer));
+        bench_publish();
+
+        for (int p = 0; p < ESPNOW_BENCH_PROFILE_COUNT; p++) {
+            uint32_t setup_session = (s_sweep_id << 8) | (uint32_t)(p * ESPNOW_BENCH_SIZE_COUNT);
+            bool ready = bench_switch_profile((uint8_t)p, peer, setup_session);
+
+            for (int s = 0; s < ESPNOW_BENCH_SIZE_COUNT; s++) {
+                int run = p * ESPNOW_BENCH_SIZE_COUNT + s;
+                uint32_t session = (s_sweep_id << 8) | (uint32_t)run;
+                espnow_bench_result_t *result = &s_work.results[run];
+
+                memset(result, 0, sizeof(*result));
+                result->channel = k_bench_profiles[p].channel;
+                result->long_range = k_bench_profiles[p].long_range;
+                result->power_save = BENCH_POWER_SAVE;
+                result->payload_len = k_bench_sizes[s];
+                s_work.run_index = (uint8_t)run;
+
+                if (ready) {
+                    bench_run_ping(result, peer, session);
+                    bench_run_flood(result, peer, session);
+                    result->completed = (result->pongs_received > 0);
+                }
+
+                bench_log_result(result);
+                s_work.run_count = (uint8_t)(run + 1);
+                bench_publish();
+            }
+        }
+
+        // Bring both sticks back to the operating configuration
+        bench_switch_profile(0, peer, (s_sweep_id << 8) | 0xFE);
+        if (s_active_profile != 0) {
+            bench_apply_profile(0);
+        }
+        s_work.state = ESPNOW_BENCH_DONE;
+    }
+
+    s_running = false;
+    bench_publish();
+    ESP_LOGI(TAG, "🏁 Benchmark sweep %" PRIu32 " finished", s_sweep_id);
+
+    s_bench_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== PUBLIC API =====
+
+esp_err_t espnow_bench_start(void)
+{
+    if (s_running || !espnow_manager_is_running()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&s_work, 0, sizeof(s_work));
+    s_work.state = ESPNOW_BENCH_RUNNING;
+    s_sweep_id++;
+    s_reply_valid = false;
+    s_running = true;
+    bench_publish();
+
+    esp_err_t ret = task_placement_create(TASK_PLACEMENT_ESPNOW_BENCH, espnow_bench_task, NULL, &s_bench_task);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create benchmark task");
+        s_running = false;
+        s_work.state = ESPNOW_BENCH_IDLE;
+        bench_publish();
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+bool espnow_bench_is_running(void)
+{
+    return s_running;
+}
+
+bool espnow_bench_radio_borrowed(void)
+{
+    return s_running || s_active_profile != 0;
+}
+
+esp_err_t espnow_bench_get_report(espnow_bench_report_t *report)
+{
+    if (report == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    seqlock_read_copy(&s_report_lock, report, &s_published, sizeof(*report));
+    return ESP_OK;
+}
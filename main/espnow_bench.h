@@ -0,0 +1,117 @@
+/*
+ * ESP-NOW benchmark mode for M5StickC Plus 1.1
+ * Timestamped ping-pong and flood tests between two sticks
+ */
+
+#ifndef ESPNOW_BENCH_H
+#define ESPNOW_BENCH_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESPNOW_BENCH_RSSI_BINS      8       // 10 dB bins from -100 dBm up to -20 dBm
+#define ESPNOW_BENCH_RSSI_FLOOR     (-100)  // Lower edge of the first RSSI bin
+#define ESPNOW_BENCH_PROFILE_COUNT  5       // Radio profiles per sweep
+#define ESPNOW_BENCH_SIZE_COUNT     3       // Payload sizes per profile
+#define ESPNOW_BENCH_MAX_RUNS       (ESPNOW_BENCH_PROFILE_COUNT * ESPNOW_BENCH_SIZE_COUNT)
+
+/**
+ * @brief Benchmark state
+ */
+typedef enum {
+    ESPNOW_BENCH_IDLE = 0,          // Never run
+    ESPNOW_BENCH_RUNNING,           // Sweep in progress
+    ESPNOW_BENCH_DONE,              // Sweep finished, results valid
+    ESPNOW_BENCH_FAILED,            // No peer answered
+} espnow_bench_state_t;
+
+/**
+ * @brief Result of one (radio profile, payload size) run
+ */
+typedef struct {
+    uint8_t channel;                // Wi-Fi channel of the run
+    bool long_range;                // 802.11 LR 250 kbps rate
+    bool power_save;                // Built with CONFIG_ESPNOW_ENABLE_POWER_SAVE
+    bool completed;                 // Peer followed the profile and answered
+    uint16_t payload_len;           // Frame length in bytes
+
+    // Ping-pong
+    uint16_t pings_sent;
+    uint16_t pongs_received;
+    uint32_t rtt_min_us;
+    uint32_t rtt_p50_us;
+    uint32_t rtt_p90_us;
+    uint32_t rtt_p99_us;
+    uint32_t rtt_max_us;
+
+    // Flood (counted by the peer)
+    uint16_t flood_sent;
+    uint16_t flood_received;
+    uint32_t flood_pps;             // Frames per second received by the peer
+
+    // RSSI of pongs (local) plus flood frames (peer)
+    uint16_t rssi_hist[ESPNOW_BENCH_RSSI_BINS];
+} espnow_bench_result_t;
+
+/**
+ * @brief Benchmark report
+ */
+typedef struct {
+    espnow_bench_state_t state;
+    uint8_t peer_mac[6];            // Responder of the current sweep
+    uint8_t run_index;              // Run in progress, or run count when done
+    uint8_t run_count;              // Runs with a result
+    espnow_bench_result_t results[ESPNOW_BENCH_MAX_RUNS];
+} espnow_bench_report_t;
+
+/**
+ * @brief Start a benchmark sweep against the first stick that answers
+ *
+ * Runs in its own task. Every stick running this firmware answers benchmark
+ * frames, so the second stick needs no action. Normal ESP-NOW traffic on the
+ * configured channel is interrupted while other channels are measured.
+ *
+ * @return ESP_OK if started, ESP_ERR_INVALID_STATE if ESP-NOW is not running
+ *         or a sweep is already in progress, ESP_ERR_NO_MEM if the task can't be created
+ */
+esp_err_t espnow_bench_start(void);
+
+/**
+ * @brief Check whether a sweep is in progress
+ */
+bool espnow_bench_is_running(void);
+
+/**
+ * @brief Check whether the benchmark has the radio (own sweep, or answering one on another profile)
+ *
+ * Send results in this state reflect the benchmark's channel and rate, not the
+ * link to a node, so per-peer rate adaptation ignores them.
+ */
+bool espnow_bench_radio_borrowed(void);
+
+/**
+ * @brief Get a consistent copy of the benchmark report (never blocks the sweep)
+ * @param report Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t espnow_bench_get_report(espnow_bench_report_t *report);
+
+/**
+ * @brief Handle a received frame if it belongs to the benchmark protocol
+ *
+ * Called by the ESP-NOW receive task for every frame before TLV decoding.
+ *
+ * @return true if the frame was a benchmark frame and has been consumed
+ */
+bool espnow_bench_handle_frame(const uint8_t *mac_addr, const uint8_t *data, int len, int8_t rssi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESPNOW_BENCH_H
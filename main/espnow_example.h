@@ -42,7 +42,7 @@ typedef struct {
     int8_t rate_11bg;      //Set to -1 if not 11b/g
     int8_t rate_11n;       //Set to -1 if not 11n/ac
     int8_t rate_11ac;      //Set to -1 if not 11n/ac
-    uint8_t *data;
+    uint8_t *data;         //Points into a preallocated receive slot, valid until the slot is released
     int data_len;
 } example_espnow_event_recv_cb_t;
 
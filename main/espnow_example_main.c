@@ -18,6 +18,7 @@
 #include "freertos/task.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 // M5StickC Plus project includes
 #include "espnow_manager.h"
@@ -25,19 +26,48 @@
 #include "button.h"
 #include "lvgl_init.h"
 #include "system_monitor.h"
+#include "power_sampler.h"
 #include "lvgl_button_input.h"
 #include "page_manager_lvgl.h"
 #include "ux_service.h"
+#include "task_placement.h"
+#include "task_profiler.h"
+#include "mem_account.h"
+#include "latency_trace.h"
+#include "power_manager.h"
+#include "boot_timeline.h"
+#include "espnow_peers.h"
+#include "device_store.h"
+#include "ui_notify.h"
 
 static const char *TAG = "espnow_example";
 
+#define TASK_MONITOR_LOG_INTERVAL_MS    10000   // Full report period; profiler samples run faster
+#define BOOT_LCD_POWER_SETTLE_MS        500     // LCD rails after AXP192 init, overlapped with the monitors stage
+#define BOOT_FIRST_FRAME_TIMEOUT_MS     2000    // Demo effects start anyway if the screen never refreshes
+#define BOOT_RADIO_TIMEOUT_MS           5000    // app_main logs the timeline once the radio is up or after this
+
 // Task monitoring function to help diagnose watchdog timeouts
+// Samples the task profiler for the Tasks subpage and logs the full report every 10 seconds
 static void task_monitor_debug(void *pvParameters)
 {
     ESP_LOGI(TAG, "Task monitor started for watchdog debugging");
     
+    uint32_t since_log_ms = 0;
+    bool boot_logged = false;
+    
     while (1) {
-        // Simplified task monitoring without requiring runtime stats
+        if (task_profiler_sample() == ESP_OK) {
+            ui_notify_publish(UI_TOPIC_DIAGNOSTICS);
+        }
+        
+        since_log_ms += CONFIG_TASK_PROFILER_INTERVAL_MS;
+        if (since_log_ms < TASK_MONITOR_LOG_INTERVAL_MS) {
+            vTaskDelay(pdMS_TO_TICKS(CONFIG_TASK_PROFILER_INTERVAL_MS));
+            continue;
+        }
+        since_log_ms = 0;
+        
         UBaseType_t task_count = uxTaskGetNumberOfTasks();
         ESP_LOGI(TAG, "=== Task Monitor Report ===");
         ESP_LOGI(TAG, "Total tasks: %lu", task_count);
@@ -58,24 +88,99 @@ static void task_monitor_debug(void *pvParameters)
             ESP_LOGI(TAG, "CPU 1 current task: %s", task_name_cpu1 ? task_name_cpu1 : "Unknown");
         }
         
+        // Display refresh timing (render vs SPI transfer)
+        lvgl_display_perf_t perf;
+        if (lvgl_get_display_perf(&perf) == ESP_OK && perf.frames > 0) {
+            ESP_LOGI(TAG, "LCD: %lu MHz, %u-line buffers, %lu frames",
+                     perf.pixel_clock_hz / 1000000, perf.buffer_lines, perf.frames);
+            ESP_LOGI(TAG, "LCD frame avg %lu us (render %lu us, transfer %lu us), max %lu us",
+                     perf.avg_frame_us, perf.avg_render_us, perf.avg_transfer_us, perf.max_frame_us);
+        }
+        
+        // Button statistics, deferred here from the interrupt path
+        button_stats_t buttons;
+        lvgl_button_input_stats_t keys;
+        if (button_get_stats(&buttons) == ESP_OK && lvgl_button_input_get_stats(&keys) == ESP_OK) {
+            ESP_LOGI(TAG, "Buttons: %lu edges, %lu bounces, %lu long presses, keys OK %lu NEXT %lu, %lu dropped",
+                     buttons.edges, buttons.bounces, buttons.long_presses,
+                     keys.ok_presses, keys.next_presses, keys.dropped);
+        }
         ESP_LOGI(TAG, "==========================");
         
-        // Monitor every 10 seconds
-        vTaskDelay(pdMS_TO_TICKS(10000));
+        // Time and measured battery current per power mode
+        power_manager_log();
+        
+        // PHY rate and delivery of the unicast collection peers
+        espnow_peers_log();
+        
+        // Device table writes to NVS (flash wear)
+        device_store_log();
+        
+        // Per-task CPU share and stack high-water marks
+        task_profiler_log();
+        
+        // Heap per module, fragmentation and stack headroom
+        mem_account_log();
+        
+        // Receive-to-display latency per stage (CONFIG_LATENCY_TRACE_ENABLE)
+        latency_trace_log();
+        
+        // Boot timeline completed by the first received packet
+        if (!boot_logged && boot_timeline_reached(BOOT_STAGE_FIRST_PACKET)) {
+            boot_timeline_log();
+            boot_logged = true;
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_TASK_PROFILER_INTERVAL_MS));
+    }
+}
+
+// Boot path of the radio: Wi-Fi/ESP-NOW bring-up needs NVS only, so it runs while app_main brings up the LCD
+static void boot_radio_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "🌐 Starting ESP-NOW Manager...");
+    esp_err_t ret = espnow_manager_start();
+    if (ret == ESP_OK) {
+        boot_timeline_mark(BOOT_STAGE_RADIO);
+        ESP_LOGI(TAG, "✅ ESP-NOW Manager started successfully");
+    } else {
+        ESP_LOGE(TAG, "❌ Failed to start ESP-NOW Manager: %s", esp_err_to_name(ret));
     }
+    vTaskDelete(NULL);
 }
 
 void app_main(void)
 {
-    // Initialize NVS
+    boot_timeline_init();
+
+    // Stage nvs: Wi-Fi reads its calibration data from NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         ESP_ERROR_CHECK( nvs_flash_erase() );
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK( ret );
+    boot_timeline_mark(BOOT_STAGE_NVS);
+
+    // Draw buffers first: their heap reserve for Wi-Fi only holds while nothing else allocates
+    ret = lvgl_reserve_draw_buffers();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "🎨 LVGL draw buffers not allocated: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    // Stage radio, in parallel from here on. The manager itself is initialized
+    // here so pages can query it before the radio is up.
+    ESP_LOGI(TAG, "🌐 Initializing ESP-NOW Manager...");
+    ret = espnow_manager_init();
+    if (ret == ESP_OK) {
+        ret = task_placement_create(TASK_PLACEMENT_BOOT_RADIO, boot_radio_task, NULL, NULL);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to initialize ESP-NOW Manager: %s", esp_err_to_name(ret));
+    }
 
-    // 初始化AXP192电源管理芯片
+    // Stage axp192: LCD, backlight and 5V GROVE rails
     ESP_LOGI(TAG, "Initializing AXP192...");
     ret = axp192_init();
     if (ret != ESP_OK) {
@@ -84,18 +189,10 @@ void app_main(void)
     } else {
         ESP_LOGI(TAG, "AXP192 initialized successfully");
     }
+    int64_t lcd_power_ready_us = esp_timer_get_time() + BOOT_LCD_POWER_SETTLE_MS * 1000;
+    boot_timeline_mark(BOOT_STAGE_POWER);
 
-    // Initialize UX Service (LED/Buzzer Effects) - PRIORITY STARTUP
-    ESP_LOGI(TAG, "🎨 Initializing UX Service...");
-    ret = ux_service_init();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "UX Service initialization failed: %s", esp_err_to_name(ret));
-        return;
-    }
-    ESP_LOGI(TAG, "🎨 UX Service initialized successfully");
-    ESP_LOGI(TAG, "🎨 UX Service will automatically run demo effects");
-
-    // Initialize system monitor
+    // Stage monitors: runs while the LCD rails settle
     ESP_LOGI(TAG, "🔍 Initializing system monitor");
     ret = system_monitor_init();
     if (ret != ESP_OK) {
@@ -111,6 +208,17 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "System monitor started successfully");
 
+#if CONFIG_POWER_SAMPLER_ENABLE
+    // Start high-rate power telemetry (non-fatal if it fails)
+    ret = power_sampler_init();
+    if (ret == ESP_OK) {
+        ret = power_sampler_start();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Power sampler not started: %s", esp_err_to_name(ret));
+    }
+#endif
+
     // Initialize button driver
     ESP_LOGI(TAG, "🔘 Initializing button driver");
     ret = button_init();
@@ -120,12 +228,22 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "Button driver initialized successfully");
 
-    // Initialize multi-page LVGL system
+    // Power modes follow the screen: DFS/light sleep and sampling rates (needs monitor and buttons)
+    ret = power_manager_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Power manager not started: %s", esp_err_to_name(ret));
+    }
+    boot_timeline_mark(BOOT_STAGE_MONITORS);
+
+    // Stage display: LCD panel and LVGL task
     ESP_LOGI(TAG, "🖥️  Initializing LVGL multi-page system");
     ESP_LOGI(TAG, "🖥️  LCD and backlight power already enabled by AXP192 init");
     
-    // Power stabilization delay (LCD power already enabled)
-    vTaskDelay(pdMS_TO_TICKS(500));       // Wait for power stabilization
+    // Only the part of the power stabilization delay the monitors stage didn't cover
+    int64_t settle_us = lcd_power_ready_us - esp_timer_get_time();
+    if (settle_us > 0) {
+        vTaskDelay(pdMS_TO_TICKS((uint32_t)(settle_us / 1000)) + 1);
+    }
     
     // Initialize LVGL base system without demo UI for multi-page application
     esp_err_t lvgl_ret = lvgl_init_base();
@@ -134,6 +252,7 @@ void app_main(void)
         return;
     }
     ESP_LOGI(TAG, "🖥️  LVGL base system initialized successfully");
+    boot_timeline_mark(BOOT_STAGE_DISPLAY);
     
     // Get default display for page manager
     lv_display_t *disp = lv_display_get_default();
@@ -142,7 +261,7 @@ void app_main(void)
         return;
     }
     
-    // Initialize LVGL button input device (NEW SYSTEM)
+    // Stage ui: input device and pages
     ESP_LOGI(TAG, "🔘 Initializing LVGL button input device...");
     ret = lvgl_button_input_init();
     if (ret != ESP_OK) {
@@ -170,22 +289,31 @@ void app_main(void)
     ESP_LOGI(TAG, "   • Button A (GPIO37): OK/ENTER action");
     ESP_LOGI(TAG, "   • Button B (GPIO39): NEXT page navigation");
     ESP_LOGI(TAG, "");
+    boot_timeline_mark(BOOT_STAGE_UI);
 
     // Create task monitoring to help diagnose watchdog issues
     ESP_LOGI(TAG, "🔍 Starting task monitor for watchdog debugging");
-    xTaskCreate(task_monitor_debug, "task_monitor", 2048, NULL, 1, NULL);
+    task_placement_create(TASK_PLACEMENT_TASK_MONITOR, task_monitor_debug, NULL, NULL);
 
-    // Initialize ESP-NOW Manager for network functionality
-    ESP_LOGI(TAG, "🌐 Initializing ESP-NOW Manager...");
-    esp_err_t espnow_ret = espnow_manager_init();
-    if (espnow_ret == ESP_OK) {
-        espnow_ret = espnow_manager_start();
-        if (espnow_ret == ESP_OK) {
-            ESP_LOGI(TAG, "✅ ESP-NOW Manager started successfully");
-        } else {
-            ESP_LOGE(TAG, "❌ Failed to start ESP-NOW Manager: %s", esp_err_to_name(espnow_ret));
-        }
+    // Deferred stages: LED/buzzer service (buzzer power delay) while the first frame renders
+    ESP_LOGI(TAG, "🎨 Initializing UX Service...");
+    ret = ux_service_init();
+    if (ret == ESP_OK) {
+        boot_timeline_mark(BOOT_STAGE_UX);
+        ESP_LOGI(TAG, "🎨 UX Service initialized successfully");
     } else {
-        ESP_LOGE(TAG, "❌ Failed to initialize ESP-NOW Manager: %s", esp_err_to_name(espnow_ret));
+        ESP_LOGE(TAG, "UX Service initialization failed: %s", esp_err_to_name(ret));
     }
+
+    // Demo effects once the first screen is out
+    if (boot_timeline_wait(BOOT_STAGE_FIRST_FRAME, BOOT_FIRST_FRAME_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGW(TAG, "No frame after %d ms, starting demo effects anyway", BOOT_FIRST_FRAME_TIMEOUT_MS);
+    }
+    if (ux_service_start_demo_effects() == ESP_OK) {
+        boot_timeline_mark(BOOT_STAGE_DEMO_EFFECTS);
+    }
+
+    // The task monitor logs the timeline again when the first packet arrives
+    boot_timeline_wait(BOOT_STAGE_RADIO, BOOT_RADIO_TIMEOUT_MS);
+    boot_timeline_log();
 }
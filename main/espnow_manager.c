@@ -9,16 +9,30 @@
 #include "espnow_manager.h"
 #include "esp_now.h"  // Must be included BEFORE espnow_example.h for ESP_NOW_ETH_ALEN
 #include "espnow_example.h"
-#include "page_manager_espnow.h"
+#include "ui_notify.h"  // UI refresh topics
 #include "esphome_tlv_format.h"  // TLV data format for ESP-NOW communication
+#include "tlv_codec.h"  // Target-independent TLV decoder/encoder
 #include "ux_service.h"  // LED animation support
+#include "seqlock.h"  // Consistent statistics snapshots
+#include "espnow_bench.h"  // Benchmark frames bypass TLV decoding
+#include "node_history.h"  // Per-node trends of the stored readings
+#include "task_placement.h"  // Core, priority and stack of the ESP-NOW tasks
+#include "latency_trace.h"  // Receive-to-display stage timestamps
+#include "boot_timeline.h"  // First received packet of the boot timeline
+#include "espnow_peers.h"  // Unicast collection polls to known nodes
+#include "device_store.h"  // Device table warm start from NVS
+#include "system_monitor.h"  // Own readings for the discovery telemetry
+#include "mem_account.h"  // Heap and static memory of the ESP-NOW module
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_netif.h"
 #include "esp_random.h"
+#include "esp_system.h"
 #include "esp_crc.h"
+#include "esp_timer.h"
 #include "esp_mac.h"
+#include "esp_bit_defs.h"
 #include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -26,98 +40,396 @@
 #include "freertos/semphr.h"
 #include <string.h>
 #include <inttypes.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <math.h>
 
 static const char *TAG = "ESPNOW_MGR";
 
-// ESP-NOW configuration matching official example
-#define ESPNOW_MAXDELAY 512
+// Receive packet ring configuration (allocation-free receive path)
+#define ESPNOW_RX_RING_SIZE 16                      // Number of preallocated receive slots (power of two)
+#define ESPNOW_RX_SLOT_SIZE ESP_NOW_MAX_DATA_LEN    // 250 bytes, maximum ESP-NOW v1 payload
+
+_Static_assert((ESPNOW_RX_RING_SIZE & (ESPNOW_RX_RING_SIZE - 1)) == 0,
+               "ESPNOW_RX_RING_SIZE must be a power of two");
+
+// Frames decoded and committed together by the receive task (one lock, one UI notification)
+#define ESPNOW_RX_BATCH_SIZE CONFIG_ESPNOW_RX_BATCH_SIZE
+
+_Static_assert(ESPNOW_RX_BATCH_SIZE >= 1 && ESPNOW_RX_BATCH_SIZE <= ESPNOW_RX_RING_SIZE,
+               "ESPNOW_RX_BATCH_SIZE must fit in the receive ring");
+
+// Preallocated receive slot: metadata plus payload storage, info.data always points at payload
+typedef struct {
+    example_espnow_event_recv_cb_t info;    // Receive metadata (MAC, RSSI, rates, length)
+    uint8_t payload[ESPNOW_RX_SLOT_SIZE];   // Frame payload copied from the Wi-Fi driver
+    uint32_t trace_id;                      // Latency trace ID, 0 when tracing is disabled
+} espnow_rx_slot_t;
 
 // Global state variables (matching official example)
-static QueueHandle_t s_espnow_queue = NULL;
+static QueueHandle_t s_espnow_queue = NULL;     // Send completion events only
+static _Atomic(TaskHandle_t) s_recv_task_handle = ATOMIC_VAR_INIT(NULL);  // Receive task, woken by task notification
+
+// Receive-path logging: each frame logs in full, or in production mode only
+// one sampled frame per CONFIG_ESPNOW_LOG_SAMPLE_INTERVAL_MS (recv task only)
+#if CONFIG_ESPNOW_LOG_PRODUCTION
+static bool s_hot_log_sampled = false;          // Current frame is the logged sample
+static TickType_t s_hot_log_last_sample = 0;    // Tick of the last sampled frame
+#define ESPNOW_HOT_LOGI(format, ...) do {                   \
+        if (s_hot_log_sampled) {                            \
+            ESP_LOGI(TAG, format, ##__VA_ARGS__);           \
+        } else {                                            \
+            ESPNOW_STAT_INC(log_suppressed);                \
+        }                                                   \
+    } while (0)
+#define ESPNOW_HOT_LOG_HEX(buffer, length) ESPNOW_HOT_LOGI("   %d bytes (hex dump disabled)", (int)(length))
+#else
+#define ESPNOW_HOT_LOGI(format, ...) ESP_LOGI(TAG, format, ##__VA_ARGS__)
+#define ESPNOW_HOT_LOG_HEX(buffer, length) ESP_LOG_BUFFER_HEX(TAG, buffer, length)
+#endif
+
+// Single-producer (Wi-Fi task) / single-consumer (receive task) lock-free packet ring
+static espnow_rx_slot_t s_rx_ring[ESPNOW_RX_RING_SIZE];
+static atomic_uint s_rx_head = ATOMIC_VAR_INIT(0);  // Written only by espnow_recv_cb
+static atomic_uint s_rx_tail = ATOMIC_VAR_INIT(0);  // Written only by espnow_recv_only_task
 static uint8_t s_broadcast_mac[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
 // For compatibility with espnow_example.h macro
 extern uint8_t s_example_broadcast_mac[ESP_NOW_ETH_ALEN];
 uint8_t s_example_broadcast_mac[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
 static uint16_t s_espnow_seq[EXAMPLE_ESPNOW_DATA_MAX] = { 0, 0 };
-static espnow_stats_t s_stats = {0};
-static bool s_espnow_running = false;
+static espnow_stats_t s_stats = {0};            // Session fields (magic, peer); counters live in s_counters
+static atomic_bool s_espnow_running = ATOMIC_VAR_INIT(false);  // Read by the ESP-NOW tasks and callbacks
+
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+// Radio awake time per wake interval, chosen by the power mode (kept across restarts)
+static uint16_t s_wake_window_ms = CONFIG_ESPNOW_WAKE_WINDOW;
+#endif
+
+// Traffic counters: bumped from the Wi-Fi callbacks and the ESP-NOW tasks, every update
+// published through s_counters_lock so espnow_manager_get_stats() copies the block at once
+typedef struct {
+    uint32_t packets_sent;
+    uint32_t packets_received;
+    uint32_t send_success;
+    uint32_t send_failed;
+    uint32_t rx_dropped;
+    uint32_t tx_event_dropped;
+    uint32_t rx_ring_high_water;        // Written only by espnow_recv_cb
+    uint32_t log_suppressed;
+    uint32_t rx_batches;                // Written only by espnow_recv_only_task
+    uint32_t rx_batch_max;              // Written only by espnow_recv_only_task
+    uint32_t discovery_interval_ms;     // Written only by device_discovery_task
+    uint32_t nodes_evicted;
+} espnow_counters_t;
+
+static espnow_counters_t s_counters;
+static seqlock_t s_counters_lock = SEQLOCK_INIT;
+// Serializes the seqlock writers; the critical section also keeps a writer from being
+// preempted mid-update, so a reader only ever retries against the other core
+static portMUX_TYPE s_counters_mux = portMUX_INITIALIZER_UNLOCKED;
+
+#define ESPNOW_STAT_UPDATE(stmt) do {                       \
+        taskENTER_CRITICAL(&s_counters_mux);                \
+        seqlock_write_begin(&s_counters_lock);              \
+        stmt;                                               \
+        seqlock_write_end(&s_counters_lock);                \
+        taskEXIT_CRITICAL(&s_counters_mux);                 \
+    } while (0)
+#define ESPNOW_STAT_INC(field)          ESPNOW_STAT_UPDATE(s_counters.field++)
+#define ESPNOW_STAT_SET(field, value)   ESPNOW_STAT_UPDATE(s_counters.field = (value))
+#define ESPNOW_STAT_MAX(field, value)   ESPNOW_STAT_UPDATE(if ((value) > s_counters.field) { s_counters.field = (value); })
+// One field for logging; aligned 32-bit loads are single accesses
+#define ESPNOW_STAT_GET(field)          (*(volatile const uint32_t *)&s_counters.field)
+
+// Node counts kept incrementally by the aging code and published on every
+// change, so espnow_manager_get_stats() never touches the device table
+typedef struct {
+    uint16_t online_nodes;
+    uint16_t used_nodes;
+} espnow_node_counts_t;
 
-// LED animation rate limiting constant
-static const uint32_t LED_ANIMATION_INTERVAL_MS = 1000;  // 1 second
+static espnow_node_counts_t s_node_counts = {0};
+static seqlock_t s_node_counts_lock = SEQLOCK_INIT;
+
+// Device discovery scheduler: notification bits of device_discovery_task
+#define DISCOVERY_NOTIFY_SEND_DONE      BIT0    // Send callback of the discovery broadcast arrived
+#define DISCOVERY_NOTIFY_TRIGGER        BIT1    // Send one broadcast now (test packet, stop request)
+#define DISCOVERY_NOTIFY_BURST          BIT2    // Restart the burst (ESP-NOW page opened)
+
+#define DISCOVERY_SEND_TIMEOUT_MS       1000    // Give up waiting for the send callback
+#define DISCOVERY_BURST_COUNT           3       // Broadcasts at the minimum interval per burst
+#define DISCOVERY_BASE_INTERVAL_MS      5000    // Interval after new nodes appeared
+#define DISCOVERY_MIN_INTERVAL_MS       CONFIG_ESPNOW_DISCOVERY_MIN_INTERVAL_MS
+#define DISCOVERY_MAX_INTERVAL_MS       CONFIG_ESPNOW_DISCOVERY_MAX_INTERVAL_MS
+#define DISCOVERY_BROADCAST_EVERY       CONFIG_ESPNOW_PEER_BROADCAST_EVERY  // Rounds per broadcast once peers exist
+#define DISCOVERY_TELEMETRY_INTERVAL_MS (CONFIG_ESPNOW_TELEMETRY_INTERVAL_S * 1000U)  // 0: discovery header only
+#define DISCOVERY_TELEMETRY_MAX         64      // TLV bytes after the discovery header (all telemetry fields fit)
+#define DISCOVERY_FRAME_MAX             (sizeof(example_espnow_data_t) + DISCOVERY_TELEMETRY_MAX)
+#define TELEMETRY_LOW_BATTERY_PERCENT   20      // STATUS_FLAG_LOW_BATTERY at or below, on battery
+
+_Static_assert(DISCOVERY_MIN_INTERVAL_MS <= DISCOVERY_MAX_INTERVAL_MS,
+               "Discovery minimum interval must not exceed the maximum");
 
 // Device Discovery Task Variables
 typedef struct {
-    uint8_t *buffer;              // Send buffer
-    int len;                      // Buffer length
+    uint8_t *buffer;              // Send buffer, DISCOVERY_FRAME_MAX bytes
+    int len;                      // Length of the prepared frame (header plus telemetry)
     uint32_t magic;               // Magic number for identification
-    uint32_t last_send_time;      // Timestamp of last successful send (in ticks)
-    bool send_completed;          // Flag indicating last send completed
+    uint32_t last_send_time;      // Timestamp of last broadcast (in ticks)
+    uint32_t interval_ms;         // Current adaptive broadcast interval
+    uint8_t burst_left;           // Broadcasts still to send at the minimum interval
+    uint16_t last_heard_nodes;    // Nodes heard during the previous round
+    uint8_t rounds_since_broadcast; // Unicast rounds since the last broadcast
+    bool telemetry_sent;          // A broadcast has carried telemetry
+    uint32_t telemetry_time;      // Tick of the last broadcast with telemetry
+    char device_id[TLV_MAX_DEVICE_ID_LEN + 1]; // TLV_TYPE_DEVICE_ID of this stick
 } device_discovery_param_t;
 
 static device_discovery_param_t *s_discovery_param = NULL;
-static TaskHandle_t s_discovery_task_handle = NULL;
+static _Atomic(TaskHandle_t) s_discovery_task_handle = ATOMIC_VAR_INIT(NULL);  // Notified from any task
+
+// The task handles are cleared by the tasks themselves right before they exit
+static inline void espnow_wake_recv_task(void)
+{
+    TaskHandle_t task = atomic_load(&s_recv_task_handle);
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static inline bool espnow_notify_discovery(uint32_t bits)
+{
+    TaskHandle_t task = atomic_load(&s_discovery_task_handle);
+    if (task == NULL) {
+        return false;
+    }
+    xTaskNotify(task, bits, eSetBits);
+    return true;
+}
 
 // TLV Device Storage Configuration
-#define MAX_TLV_DEVICES 16          // Maximum number of devices to track
-#define MAX_TLV_ENTRIES_PER_DEVICE 32  // Maximum TLV entries per device
-#define MAX_TLV_ENTRY_VALUE_SIZE 64    // Maximum value size for a single TLV entry
+#define MAX_TLV_DEVICES CONFIG_ESPNOW_MAX_DEVICES  // Maximum number of devices to track (Kconfig)
+#define TLV_BLOB_ARENA_SIZE 96         // Per-device arena bytes for string/byte TLVs
+#define TLV_MAX_EXTRA_BLOBS 4          // Unknown/custom TLV types kept per device
+#define TLV_MAX_EXTRA_BLOB_SIZE 16     // Maximum value size of an unknown/custom TLV
+#define TLV_BLOB_SLOT_COUNT (TLV_BLOB_KNOWN_COUNT + TLV_MAX_EXTRA_BLOBS)  // Known slots followed by extra (unknown type) slots
+
+// Persisted device table: per node MAC, RSSI, TLV length and the stored TLVs re-encoded for the wire
+#define TLV_PERSIST_FORMAT 1           // Bump when the record layout changes
+#define TLV_PERSIST_RECORD_HEADER 8    // MAC(6) + RSSI(1) + TLV length(1)
+#define TLV_PERSIST_TLV_MAX (TLV_NUM_FIELD_COUNT * TLV_TOTAL_SIZE(4) + TLV_BLOB_SLOT_COUNT * 2 + TLV_BLOB_ARENA_SIZE)
+#define TLV_PERSIST_RECORD_MAX (TLV_PERSIST_RECORD_HEADER + TLV_PERSIST_TLV_MAX)
+#if CONFIG_ESPNOW_PERSIST_DEVICES
+#define TLV_PERSIST_MAX_DEVICES ((CONFIG_ESPNOW_PERSIST_MAX_DEVICES < MAX_TLV_DEVICES) ? \
+                                 CONFIG_ESPNOW_PERSIST_MAX_DEVICES : MAX_TLV_DEVICES)
+#else
+#define TLV_PERSIST_MAX_DEVICES 0
+#endif
+
+// Footprint of the previous layout (32 x 76-byte generic entries + 256-byte type map + header)
+#define TLV_LEGACY_BYTES_PER_DEVICE (32 * 76 + 256 + 48)
+
+// Type of the espnow_device_info_t field a TLV is decoded into
+typedef enum {
+    TLV_INFO_NONE = 0,              // Stored only, not exposed in espnow_device_info_t
+    TLV_INFO_U16,
+    TLV_INFO_U32,
+    TLV_INFO_FLOAT,
+    TLV_INFO_STRING,                // NUL-terminated, dropped if it does not fit
+} tlv_info_kind_t;
+
+// espnow_device_info_t field a known TLV is decoded into
+typedef struct {
+    uint8_t kind;                   // tlv_info_kind_t
+    uint8_t size;                   // Size of the target field
+    uint16_t offset;                // offsetof target field in espnow_device_info_t
+} tlv_info_target_t;
+
+#define TLV_TARGET(kind, field) { kind, sizeof(((espnow_device_info_t *)0)->field), offsetof(espnow_device_info_t, field) }
+
+// Targets by tlv_field_desc_t.index; omitted fields are stored only
+static const tlv_info_target_t k_tlv_numeric_targets[TLV_NUM_FIELD_COUNT] = {
+    [TLV_NUM_UPTIME]          = TLV_TARGET(TLV_INFO_U32, uptime_seconds),
+    [TLV_NUM_FREE_MEMORY]     = TLV_TARGET(TLV_INFO_U32, free_memory_kb),
+    [TLV_NUM_AC_VOLTAGE]      = TLV_TARGET(TLV_INFO_FLOAT, ac_voltage),
+    [TLV_NUM_AC_CURRENT]      = TLV_TARGET(TLV_INFO_FLOAT, ac_current),
+    [TLV_NUM_AC_FREQUENCY]    = TLV_TARGET(TLV_INFO_FLOAT, ac_frequency),
+    [TLV_NUM_AC_POWER]        = TLV_TARGET(TLV_INFO_FLOAT, ac_power),
+    [TLV_NUM_AC_POWER_FACTOR] = TLV_TARGET(TLV_INFO_FLOAT, ac_power_factor),
+    [TLV_NUM_STATUS_FLAGS]    = TLV_TARGET(TLV_INFO_U16, status_flags),
+    [TLV_NUM_ERROR_CODE]      = TLV_TARGET(TLV_INFO_U16, error_code),
+    [TLV_NUM_TEMPERATURE]     = TLV_TARGET(TLV_INFO_FLOAT, temperature),
+    [TLV_NUM_BATTERY_VOLTAGE] = TLV_TARGET(TLV_INFO_FLOAT, battery_voltage),
+    [TLV_NUM_BATTERY_LEVEL]   = TLV_TARGET(TLV_INFO_U16, battery_level),
+    [TLV_NUM_BATTERY_CURRENT] = TLV_TARGET(TLV_INFO_FLOAT, battery_current),
+    [TLV_NUM_VBUS_VOLTAGE]    = TLV_TARGET(TLV_INFO_FLOAT, vbus_voltage),
+};
+static const tlv_info_target_t k_tlv_blob_targets[TLV_BLOB_KNOWN_COUNT] = {
+    [TLV_BLOB_DEVICE_ID]      = TLV_TARGET(TLV_INFO_STRING, device_id),
+    [TLV_BLOB_FIRMWARE_VER]   = TLV_TARGET(TLV_INFO_STRING, firmware_version),
+    [TLV_BLOB_COMPILE_TIME]   = TLV_TARGET(TLV_INFO_STRING, compile_time),
+};
+
+#define tlv_info_target(desc)   (TLV_ENC_IS_NUMERIC((desc)->encoding) ? \
+                                 &k_tlv_numeric_targets[(desc)->index] : &k_tlv_blob_targets[(desc)->index])
+
+_Static_assert(TLV_NUM_FIELD_COUNT <= 32, "numeric_present bitmask holds at most 32 fields");
+_Static_assert(TLV_BLOB_SLOT_COUNT <= 8, "blob_present bitmask holds at most 8 slots");
+_Static_assert(TLV_BLOB_ARENA_SIZE <= 255, "Arena offsets are 8-bit");
+_Static_assert(TLV_PERSIST_TLV_MAX <= 255, "Persisted TLV length is 8-bit");
+
+#define TLV_DECODE_MAX_ENTRIES 32   // Decoded entries kept per packet
+
+// One frame of a receive batch; entries point into the ring slot, which stays held until commit
+typedef struct {
+    const example_espnow_event_recv_cb_t *info; // Receive metadata of the slot
+    uint32_t trace_id;                          // Latency trace ID of the slot
+    int entry_count;                            // Decoded entries, <= 0 if parsing failed
+    tlv_decoded_entry_t entries[TLV_DECODE_MAX_ENTRIES];
+} espnow_rx_decoded_t;
 
-// Individual TLV entry storage
+// Pretty-print decoded TLVs only when debug logging is enabled for this module
+#if CONFIG_ESPNOW_LOG_PRODUCTION
+#define TLV_DEBUG_DUMP_ENABLED() (0)
+#else
+#define TLV_DEBUG_DUMP_ENABLED() (LOG_LOCAL_LEVEL >= ESP_LOG_DEBUG && esp_log_level_get(TAG) >= ESP_LOG_DEBUG)
+#endif
+
+// Location of one byte-string TLV inside the device arena
 typedef struct {
-    uint8_t type;                   // TLV type
-    uint8_t length;                 // TLV value length
-    uint8_t value[MAX_TLV_ENTRY_VALUE_SIZE];  // TLV value data
-    uint32_t last_updated;          // Timestamp of last update (in ticks)
-    bool valid;                     // Whether this entry is valid
-} stored_tlv_entry_t;
-
-// Device TLV information storage
+    uint8_t type;                   // TLV type (needed for extra slots)
+    uint8_t offset;                 // Start offset in arena
+    uint8_t length;                 // Current value length
+    uint8_t capacity;               // Reserved bytes at offset (reused in place while length fits)
+} tlv_blob_ref_t;
+
+// Device TLV information storage (numeric values live in g_tlv_numeric[field][slot])
 typedef struct {
     uint8_t mac_address[ESP_NOW_ETH_ALEN];  // Device MAC address
-    stored_tlv_entry_t tlv_entries[MAX_TLV_ENTRIES_PER_DEVICE];  // TLV entries for this device
-    uint16_t entry_count;           // Number of valid TLV entries
-    uint32_t last_seen;             // Last time we received data from this device
     int8_t rssi;                    // Latest RSSI value from ESP-NOW reception
     bool in_use;                    // Whether this device slot is in use
-    char device_name[32];           // Device friendly name (optional)
+    uint8_t blob_present;           // Bit per blob slot holding a value
+    uint8_t arena_used;             // Bytes of arena in use
+    uint16_t entry_count;           // Number of distinct TLV types stored
+    uint32_t numeric_present;       // Bit per tlv_numeric_field_t holding a value
+    uint32_t last_seen;             // Last time we received data from this device
+    int16_t next_slot;              // Next slot in the in-use list (sorted by index) or free list, -1 = end
+    int16_t prev_slot;              // Previous slot in the in-use list, -1 = head
+    int16_t lru_next;               // Next (more recently seen) node, -1 = tail
+    int16_t lru_prev;               // Previous (less recently seen) node, -1 = head
+    int16_t wheel_next;             // Next node in the same aging wheel bucket
+    int16_t wheel_prev;             // Previous node in the bucket, -1 = bucket head
+    bool online;                    // Heard within CONFIG_ESPNOW_NODE_ONLINE_TIMEOUT_S (in the wheel)
+    uint32_t expiry_s;              // Aging clock second at which the node goes offline
+    char device_name[24];           // Device friendly name ("ESP-" + MAC)
+    tlv_blob_ref_t blobs[TLV_BLOB_SLOT_COUNT];  // Known blob slots, then extra (unknown type) slots
+    uint8_t arena[TLV_BLOB_ARENA_SIZE];         // Backing bytes for all blob slots
 } device_tlv_storage_t;
 
+// MAC hash index configuration (open addressing, linear probing, load factor <= 0.5)
+#define TLV_POW2_CEIL(x) ((((x) - 1) | (((x) - 1) >> 1) | (((x) - 1) >> 2) | (((x) - 1) >> 4) | \
+                           (((x) - 1) >> 8) | (((x) - 1) >> 16)) + 1)
+#define TLV_HASH_SIZE (TLV_POW2_CEIL(MAX_TLV_DEVICES) * 2)   // Number of hash buckets (power of two)
+#define TLV_HASH_EMPTY (-1)                                  // Bucket holds no device
+
 // Global TLV device storage array
 static device_tlv_storage_t g_tlv_devices[MAX_TLV_DEVICES];
+static uint32_t g_tlv_numeric[TLV_NUM_FIELD_COUNT][MAX_TLV_DEVICES];  // Host-order numeric values, field-major
 static SemaphoreHandle_t g_tlv_mutex = NULL;  // Mutex for thread-safe access
 
+// Device table index (all protected by g_tlv_mutex)
+static uint64_t g_tlv_hash_keys[TLV_HASH_SIZE];    // 48-bit MAC key per bucket
+static int16_t g_tlv_hash_slots[TLV_HASH_SIZE];    // Device slot per bucket, TLV_HASH_EMPTY if unused
+static int16_t g_tlv_used_head = -1;               // First in-use slot (lowest index)
+static int16_t g_tlv_free_head = -1;               // First free slot
+static uint16_t g_tlv_used_count = 0;              // Number of in-use slots
+static uint32_t g_tlv_generation = 0;              // Bumped on every device slot change
+static uint32_t g_tlv_slot_generation[MAX_TLV_DEVICES]; // Generation of each slot's last change (kept on release)
+
+// Node aging: hashed timer wheel of online nodes by expiry second, plus an LRU list of
+// all in-use nodes for eviction (all protected by g_tlv_mutex)
+#define NODE_WHEEL_SIZE         16      // Buckets, one per second (power of two)
+#define NODE_ONLINE_TIMEOUT_S   CONFIG_ESPNOW_NODE_ONLINE_TIMEOUT_S
+static int16_t g_node_wheel[NODE_WHEEL_SIZE];      // First node per bucket, -1 = empty
+static uint32_t g_node_wheel_s = 0;                // Last aging second processed
+static int16_t g_node_lru_head = -1;               // Least recently seen node
+static int16_t g_node_lru_tail = -1;               // Most recently seen node
+static uint16_t g_node_online_count = 0;
+static esp_timer_handle_t s_node_aging_timer = NULL;
+static espnow_node_event_cb_t s_node_event_cb = NULL;
+static void *s_node_event_ctx = NULL;
+
+#define node_aging_now_s()      ((uint32_t)(esp_timer_get_time() / 1000000))
+
+// DRAM cost of one tracked node: device slot + numeric column share + hash bucket share
+#define TLV_BYTES_PER_DEVICE (sizeof(device_tlv_storage_t) + TLV_NUM_FIELD_COUNT * sizeof(uint32_t) + \
+                              (TLV_HASH_SIZE / MAX_TLV_DEVICES) * (sizeof(uint64_t) + sizeof(int16_t)))
+
 // Forward declarations
 static void espnow_wifi_init(void);
 static void espnow_send_cb(const esp_now_send_info_t *tx_info, esp_now_send_status_t status);
 static void espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
-static int espnow_data_parse(uint8_t *data, uint16_t data_len, uint8_t *state, uint16_t *seq, uint32_t *magic);
+static int espnow_data_parse(const uint8_t *data, uint16_t data_len, tlv_decoded_entry_t *entries, int max_entries);
 static void espnow_trigger_led_animation(void);
 
 // TLV helper functions
-static const char* tlv_type_to_string(uint8_t type);
 
 // TLV Device Storage Functions
 static esp_err_t tlv_storage_init(void);
 static void tlv_storage_deinit(void);
+static void tlv_apply_to_info(const tlv_decoded_entry_t *entry, espnow_device_info_t *info);
+static void tlv_dump_entries(const tlv_decoded_entry_t *entries, int count);
+static bool tlv_device_entry(const device_tlv_storage_t *device, const tlv_field_desc_t *desc, tlv_decoded_entry_t *entry);
+static bool tlv_blob_store(device_tlv_storage_t *device, int blob_index, uint8_t type, const uint8_t *value, uint8_t length);
+static int tlv_extra_blob_slot(device_tlv_storage_t *device, uint8_t type, bool create);
+static uint64_t mac_to_key(const uint8_t *mac_addr);
+static uint32_t tlv_hash_bucket(uint64_t key);
 static device_tlv_storage_t* find_device_by_mac(const uint8_t *mac_addr);
 static device_tlv_storage_t* get_or_create_device(const uint8_t *mac_addr);
-static esp_err_t store_device_tlv_data(const uint8_t *mac_addr, const uint8_t *tlv_data, size_t data_len, int8_t rssi);
-static void process_received_tlv_data(const uint8_t *mac_addr, const uint8_t *data, size_t data_len, int8_t rssi);
+static void node_mark_seen_locked(int slot);
+static void node_lru_append(int slot);
+static void node_evict_locked(int slot);
+static void node_counts_publish_locked(void);
+static void node_aging_timer_cb(void *arg);
+static esp_err_t store_device_tlv_locked(const uint8_t *mac_addr, const tlv_decoded_entry_t *entries, int count,
+                                         int8_t rssi, bool live);
+static int store_device_tlv_batch(const espnow_rx_decoded_t *frames, int frame_count);
+static int tlv_persist_snapshot(uint8_t *buf, size_t size, uint16_t *count, void *ctx);
+static int tlv_persist_restore(const uint8_t *buf, size_t len, uint16_t count, void *ctx);
+static void print_batch_tlv_info(const espnow_rx_decoded_t *frames, int frame_count);
 static void print_device_tlv_info(const device_tlv_storage_t *device);
 
 // Device Discovery Task Functions
-static void device_discovery_data_prepare(device_discovery_param_t *param);
+static bool espnow_discovery_payload(const uint8_t *data, uint16_t data_len,
+                                     const uint8_t **payload, uint16_t *payload_len);
+static size_t device_discovery_telemetry_build(const device_discovery_param_t *param, uint8_t *out, size_t capacity);
+static void device_discovery_data_prepare(device_discovery_param_t *param, bool unicast);
+static bool device_discovery_count_heard(uint32_t since, uint16_t *count);
+static void device_discovery_adapt(device_discovery_param_t *param, bool full_round);
+static bool device_discovery_wait_send_done(uint32_t *pending);
+static void device_discovery_send(device_discovery_param_t *param, uint32_t *pending);
+static void device_discovery_send_unicast(device_discovery_param_t *param, uint32_t *pending);
 static void device_discovery_task(void *pvParameter);
 static void device_discovery_cleanup(void);
+static int espnow_recv_decode_batch(espnow_rx_decoded_t *batch, int max_frames);
 static void espnow_recv_only_task(void *pvParameter);
 
+// Receive ring helpers
+static void espnow_rx_ring_reset(void);
+static espnow_rx_slot_t* espnow_rx_ring_peek(unsigned int index);
+static void espnow_rx_ring_release(unsigned int count);
+static void espnow_hot_log_frame_begin(void);
+static void espnow_counters_reset(void);
+
 esp_err_t espnow_manager_init(void)
 {
     ESP_LOGI(TAG, "Initializing ESP-NOW Manager");
     
     // Reset statistics
     memset(&s_stats, 0, sizeof(s_stats));
-    s_espnow_running = false;
+    espnow_counters_reset();
+    mem_account_set_static(MEM_MODULE_ESPNOW, sizeof(s_rx_ring) + ESPNOW_RX_BATCH_SIZE * sizeof(espnow_rx_decoded_t));
+    atomic_store(&s_espnow_running, false);
     
     // Initialize TLV device storage
     esp_err_t ret = tlv_storage_init();
@@ -126,13 +438,25 @@ esp_err_t espnow_manager_init(void)
         return ret;
     }
     
+    // Warm start: nodes of the previous run are shown at once, offline until heard again
+    ret = device_store_init(tlv_persist_snapshot, TLV_PERSIST_MAX_DEVICES * TLV_PERSIST_RECORD_MAX,
+                            TLV_PERSIST_FORMAT, NULL);
+    if (ret == ESP_OK) {
+        ret = device_store_restore(tlv_persist_restore);
+        if (ret != ESP_OK && ret != ESP_ERR_NOT_FOUND) {
+            ESP_LOGW(TAG, "⚠️ Device table not restored: %s", esp_err_to_name(ret));
+        }
+    } else if (ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "⚠️ Device table persistence unavailable: %s", esp_err_to_name(ret));
+    }
+    
     ESP_LOGI(TAG, "ESP-NOW Manager initialized");
     return ESP_OK;
 }
 
 esp_err_t espnow_manager_start(void)
 {
-    if (s_espnow_running) {
+    if (atomic_load(&s_espnow_running)) {
         ESP_LOGW(TAG, "ESP-NOW already running");
         return ESP_OK;
     }
@@ -142,23 +466,32 @@ esp_err_t espnow_manager_start(void)
     // Initialize WiFi first (required for ESP-NOW)
     espnow_wifi_init();
     
-    // Create event queue for receiving events
+    // Create event queue for send completion events
     s_espnow_queue = xQueueCreate(ESPNOW_QUEUE_SIZE, sizeof(example_espnow_event_t));
     if (s_espnow_queue == NULL) {
         ESP_LOGE(TAG, "Create queue fail");
         return ESP_FAIL;
     }
     
+    // Reset the preallocated receive ring (no per-packet allocation from here on)
+    espnow_rx_ring_reset();
+    
     // Initialize ESP-NOW and register callbacks
     ESP_ERROR_CHECK(esp_now_init());
     ESP_ERROR_CHECK(esp_now_register_send_cb(espnow_send_cb));
     ESP_ERROR_CHECK(esp_now_register_recv_cb(espnow_recv_cb));
     
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+    // Modem sleep between wake windows (official example); the window follows the power mode
+    ESP_ERROR_CHECK(esp_now_set_wake_window(s_wake_window_ms));
+    ESP_ERROR_CHECK(esp_wifi_connectionless_module_set_wake_interval(CONFIG_ESPNOW_WAKE_INTERVAL));
+#endif
+    
     // Set primary master key (from configuration)
     ESP_ERROR_CHECK(esp_now_set_pmk((uint8_t *)CONFIG_ESPNOW_PMK));
     
     // Add broadcast peer
-    esp_now_peer_info_t *peer = malloc(sizeof(esp_now_peer_info_t));
+    esp_now_peer_info_t *peer = mem_account_malloc(MEM_MODULE_ESPNOW, sizeof(esp_now_peer_info_t));
     if (peer == NULL) {
         ESP_LOGE(TAG, "Malloc peer information fail");
         vQueueDelete(s_espnow_queue);
@@ -173,10 +506,15 @@ esp_err_t espnow_manager_start(void)
     peer->encrypt = false;
     memcpy(peer->peer_addr, s_broadcast_mac, ESP_NOW_ETH_ALEN);
     ESP_ERROR_CHECK(esp_now_add_peer(peer));
-    free(peer);
+    mem_account_free(MEM_MODULE_ESPNOW, peer);
+    
+    // Nodes that answer are promoted to unicast peers by the receive task
+    if (espnow_peers_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Unicast peers unavailable, polling by broadcast only");
+    }
     
     // Initialize device discovery parameters
-    s_discovery_param = malloc(sizeof(device_discovery_param_t));
+    s_discovery_param = mem_account_malloc(MEM_MODULE_ESPNOW, sizeof(device_discovery_param_t));
     if (s_discovery_param == NULL) {
         ESP_LOGE(TAG, "Malloc discovery parameter fail");
         vQueueDelete(s_espnow_queue);
@@ -186,15 +524,21 @@ esp_err_t espnow_manager_start(void)
     }
     
     memset(s_discovery_param, 0, sizeof(device_discovery_param_t));
-    s_discovery_param->len = CONFIG_ESPNOW_SEND_LEN;
+    s_discovery_param->len = sizeof(example_espnow_data_t);
     s_discovery_param->magic = esp_random();
-    s_discovery_param->send_completed = true;  // Initially ready to send
     s_discovery_param->last_send_time = 0;
+    s_discovery_param->interval_ms = DISCOVERY_MIN_INTERVAL_MS;
+    s_discovery_param->burst_left = DISCOVERY_BURST_COUNT;  // Find nodes quickly after start
     
-    s_discovery_param->buffer = malloc(CONFIG_ESPNOW_SEND_LEN);
+    uint8_t own_mac[ESP_NOW_ETH_ALEN] = {0};
+    esp_read_mac(own_mac, ESP_MAC_WIFI_STA);
+    snprintf(s_discovery_param->device_id, sizeof(s_discovery_param->device_id), "M5Stick-%02X%02X%02X",
+             own_mac[3], own_mac[4], own_mac[5]);
+    
+    s_discovery_param->buffer = mem_account_calloc(MEM_MODULE_ESPNOW, 1, DISCOVERY_FRAME_MAX);
     if (s_discovery_param->buffer == NULL) {
         ESP_LOGE(TAG, "Malloc discovery buffer fail");
-        free(s_discovery_param);
+        mem_account_free(MEM_MODULE_ESPNOW, s_discovery_param);
         s_discovery_param = NULL;
         vQueueDelete(s_espnow_queue);
         s_espnow_queue = NULL;
@@ -205,37 +549,33 @@ esp_err_t espnow_manager_start(void)
     // Store magic number in stats
     s_stats.magic_number = s_discovery_param->magic;
     
-    s_espnow_running = true;
+    atomic_store(&s_espnow_running, true);
     
     // Create device discovery task (NEW - replaces original espnow_task)
-    BaseType_t task_created = xTaskCreate(
-        device_discovery_task, 
-        "device_discovery", 
-        4096,  // Stack size - sufficient for discovery logic
-        s_discovery_param, 
-        4,     // Priority
-        &s_discovery_task_handle
-    );
-    
-    if (task_created != pdPASS) {
+    TaskHandle_t discovery_task = NULL;
+    esp_err_t task_ret = task_placement_create(TASK_PLACEMENT_ESPNOW_DISCOVERY, device_discovery_task,
+                                               s_discovery_param, &discovery_task);
+    atomic_store(&s_discovery_task_handle, discovery_task);
+    
+    if (task_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create device discovery task");
         device_discovery_cleanup();
         vQueueDelete(s_espnow_queue);
         s_espnow_queue = NULL;
         esp_now_deinit();
-        s_espnow_running = false;
+        atomic_store(&s_espnow_running, false);
         return ESP_FAIL;
     }
     
     // Also create a receive-only task to process incoming data
-    example_espnow_send_param_t *recv_param = malloc(sizeof(example_espnow_send_param_t));
+    example_espnow_send_param_t *recv_param = mem_account_malloc(MEM_MODULE_ESPNOW, sizeof(example_espnow_send_param_t));
     if (recv_param == NULL) {
         ESP_LOGE(TAG, "Malloc recv parameter fail");
         device_discovery_cleanup();
         vQueueDelete(s_espnow_queue);
         s_espnow_queue = NULL;
         esp_now_deinit();
-        s_espnow_running = false;
+        atomic_store(&s_espnow_running, false);
         return ESP_FAIL;
     }
     
@@ -250,10 +590,17 @@ esp_err_t espnow_manager_start(void)
     recv_param->buffer = NULL;  // No send buffer
     
     // Create receive-only task
-    xTaskCreate(espnow_recv_only_task, "espnow_recv_only", 6144, recv_param, 4, NULL);
+    TaskHandle_t recv_task = NULL;
+    task_ret = task_placement_create(TASK_PLACEMENT_ESPNOW_RECV, espnow_recv_only_task, recv_param, &recv_task);
+    atomic_store(&s_recv_task_handle, recv_task);
+    if (task_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create receive task");
+        mem_account_free(MEM_MODULE_ESPNOW, recv_param);
+    }
     
     ESP_LOGI(TAG, "✅ ESP-NOW started with Device Discovery (Magic: 0x%08lX)", s_discovery_param->magic);
-    ESP_LOGI(TAG, "🔍 Device Discovery: Broadcasting every 5 seconds with state=1");
+    ESP_LOGI(TAG, "🔍 Device Discovery: adaptive broadcasts every %d-%d ms with state=1",
+             DISCOVERY_MIN_INTERVAL_MS, DISCOVERY_MAX_INTERVAL_MS);
     ESP_LOGI(TAG, "📥 Receive-only task created for processing incoming data");
     
     return ESP_OK;
@@ -261,7 +608,7 @@ esp_err_t espnow_manager_start(void)
 
 esp_err_t espnow_manager_stop(void)
 {
-    if (!s_espnow_running) {
+    if (!atomic_load(&s_espnow_running)) {
         ESP_LOGW(TAG, "ESP-NOW not running");
         return ESP_OK;
     }
@@ -269,13 +616,21 @@ esp_err_t espnow_manager_stop(void)
     ESP_LOGI(TAG, "Stopping ESP-NOW and Device Discovery");
     
     // Signal all tasks to stop
-    s_espnow_running = false;
+    atomic_store(&s_espnow_running, false);
+    
+    // Wake the receive and discovery tasks so they can observe the stop flag
+    espnow_wake_recv_task();
+    espnow_notify_discovery(DISCOVERY_NOTIFY_TRIGGER);
     
     // Give tasks time to cleanup gracefully
     vTaskDelay(pdMS_TO_TICKS(1000));
     
     // Clean up device discovery resources
     device_discovery_cleanup();
+    espnow_peers_deinit();
+    
+    // Keep the latest readings across a restart
+    device_store_flush();
     
     ESP_LOGI(TAG, "ESP-NOW stopped");
     return ESP_OK;
@@ -285,7 +640,7 @@ esp_err_t espnow_manager_deinit(void)
 {
     ESP_LOGI(TAG, "Deinitializing ESP-NOW Manager");
     
-    if (s_espnow_running) {
+    if (atomic_load(&s_espnow_running)) {
         espnow_manager_stop();
     }
     
@@ -298,6 +653,8 @@ esp_err_t espnow_manager_deinit(void)
     esp_now_deinit();
     
     // Deinitialize TLV storage
+    device_store_flush();
+    device_store_deinit();
     tlv_storage_deinit();
     
     ESP_LOGI(TAG, "ESP-NOW Manager deinitialized");
@@ -310,42 +667,35 @@ esp_err_t espnow_manager_get_stats(espnow_stats_t *stats)
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Copy basic statistics first
+    // Session fields only change in start/stop; counters come from one consistent copy
     memcpy(stats, &s_stats, sizeof(espnow_stats_t));
-    
-    // Calculate node statistics
-    if (g_tlv_mutex != NULL && xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        uint16_t online_count = 0;
-        uint16_t used_count = 0;
-        uint32_t current_time = xTaskGetTickCount();
-        const uint32_t ONLINE_TIMEOUT_TICKS = pdMS_TO_TICKS(10000);  // 10 seconds
-        
-        for (int i = 0; i < MAX_TLV_DEVICES; i++) {
-            if (g_tlv_devices[i].in_use) {
-                used_count++;
-                
-                // Check if node is online (received data in last 10 seconds)
-                uint32_t time_diff = current_time - g_tlv_devices[i].last_seen;
-                if (time_diff <= ONLINE_TIMEOUT_TICKS) {
-                    online_count++;
-                }
-            }
-        }
-        
-        stats->online_nodes = online_count;
-        stats->used_nodes = used_count;
-        stats->total_nodes = MAX_TLV_DEVICES;
-        
-        xSemaphoreGive(g_tlv_mutex);
-        
-        ESP_LOGD(TAG, "📊 Node statistics: online=%d, used=%d, total=%d", 
-                 stats->online_nodes, stats->used_nodes, stats->total_nodes);
-    } else {
-        // If mutex not available, use default values
-        stats->online_nodes = 0;
-        stats->used_nodes = 0;
-        stats->total_nodes = MAX_TLV_DEVICES;
-    }
+    espnow_counters_t counters;
+    seqlock_read_copy(&s_counters_lock, &counters, &s_counters, sizeof(counters));
+    stats->packets_sent = counters.packets_sent;
+    stats->packets_received = counters.packets_received;
+    stats->send_success = counters.send_success;
+    stats->send_failed = counters.send_failed;
+    stats->rx_dropped = counters.rx_dropped;
+    stats->tx_event_dropped = counters.tx_event_dropped;
+    stats->rx_ring_high_water = (uint16_t)counters.rx_ring_high_water;
+    stats->log_suppressed = counters.log_suppressed;
+    stats->rx_batches = counters.rx_batches;
+    stats->rx_batch_max = (uint16_t)counters.rx_batch_max;
+    stats->discovery_interval_ms = counters.discovery_interval_ms;
+    stats->nodes_evicted = counters.nodes_evicted;
+    
+    // O(1): counts are maintained by the aging code
+    espnow_node_counts_t counts;
+    seqlock_read_copy(&s_node_counts_lock, &counts, &s_node_counts, sizeof(counts));
+    stats->online_nodes = counts.online_nodes;
+    stats->used_nodes = counts.used_nodes;
+    stats->total_nodes = MAX_TLV_DEVICES;
+    
+    ESP_LOGD(TAG, "📊 Node statistics: online=%d, used=%d, total=%d", 
+             stats->online_nodes, stats->used_nodes, stats->total_nodes);
+    
+    stats->rx_ring_size = ESPNOW_RX_RING_SIZE;
+    stats->table_bytes_per_node = (uint16_t)TLV_BYTES_PER_DEVICE;
     
     return ESP_OK;
 }
@@ -366,42 +716,33 @@ esp_err_t espnow_manager_get_next_valid_device_index(int current_index, int *nex
     }
     
     esp_err_t result = ESP_ERR_NOT_FOUND;
-    int start_index = (current_index + 1) % MAX_TLV_DEVICES;
-    int search_index = start_index;
-    
-    // Search for next valid device, wrapping around if necessary
-    do {
-        if (g_tlv_devices[search_index].in_use) {
-            *next_index = search_index;
-            result = ESP_OK;
-            ESP_LOGI(TAG, "📱 Found next valid device at index %d (MAC: " MACSTR ")", 
-                     search_index, MAC2STR(g_tlv_devices[search_index].mac_address));
-            break;
-        }
-        search_index = (search_index + 1) % MAX_TLV_DEVICES;
-    } while (search_index != start_index);
-    
-    // If no next device found, try to stay on current device if it's valid
-    if (result != ESP_OK && current_index >= 0 && current_index < MAX_TLV_DEVICES) {
-        if (g_tlv_devices[current_index].in_use) {
-            *next_index = current_index;
-            result = ESP_OK;
-            ESP_LOGI(TAG, "📱 No next device found, staying on current device at index %d", current_index);
-        }
-    }
+    int found_index = -1;
     
-    // If still no valid device, default to first available device
-    if (result != ESP_OK) {
-        for (int i = 0; i < MAX_TLV_DEVICES; i++) {
-            if (g_tlv_devices[i].in_use) {
-                *next_index = i;
-                result = ESP_OK;
-                ESP_LOGI(TAG, "📱 No valid device found in sequence, using first available at index %d", i);
+    if (current_index >= 0 && current_index < MAX_TLV_DEVICES && g_tlv_devices[current_index].in_use) {
+        // Current device is valid: its successor in the sorted in-use list, O(1)
+        found_index = g_tlv_devices[current_index].next_slot;
+    } else {
+        // Current device is gone: first in-use slot after it, O(used)
+        for (int i = g_tlv_used_head; i >= 0; i = g_tlv_devices[i].next_slot) {
+            if (i > current_index) {
+                found_index = i;
                 break;
             }
         }
     }
     
+    // Wrap around to the lowest in-use slot (this also covers staying on a single device)
+    if (found_index < 0) {
+        found_index = g_tlv_used_head;
+    }
+    
+    if (found_index >= 0) {
+        *next_index = found_index;
+        result = ESP_OK;
+        ESP_LOGI(TAG, "📱 Found next valid device at index %d (MAC: " MACSTR ")", 
+                 found_index, MAC2STR(g_tlv_devices[found_index].mac_address));
+    }
+    
     // Release mutex
     xSemaphoreGive(g_tlv_mutex);
     
@@ -413,6 +754,41 @@ esp_err_t espnow_manager_get_next_valid_device_index(int current_index, int *nex
     return result;
 }
 
+/**
+ * @brief Convert one device slot into the public device info (g_tlv_mutex held)
+ */
+static void tlv_fill_device_info_locked(int slot, espnow_device_info_t *device_info)
+{
+    const device_tlv_storage_t *device = &g_tlv_devices[slot];
+    
+    // Initialize device_info structure
+    memset(device_info, 0, sizeof(espnow_device_info_t));
+    device_info->device_index = slot;
+    device_info->generation = g_tlv_slot_generation[slot];
+    if (!device->in_use) {
+        return;
+    }
+    
+    // Copy basic device information
+    memcpy(device_info->mac_address, device->mac_address, ESP_NOW_ETH_ALEN);
+    strncpy(device_info->device_name, device->device_name, sizeof(device_info->device_name) - 1);
+    device_info->is_available = true;
+    device_info->last_seen = device->last_seen;
+    device_info->entry_count = device->entry_count;
+    
+    // Initialize with stored RSSI from actual ESP-NOW reception
+    device_info->rssi = device->rssi;
+    
+    // Fill typed fields from the descriptor table (values decoded at store time)
+    for (size_t i = 0; i < TLV_CODEC_FIELD_COUNT; i++) {
+        tlv_decoded_entry_t entry;
+        if (tlv_info_target(&tlv_codec_fields[i])->kind != TLV_INFO_NONE &&
+            tlv_device_entry(device, &tlv_codec_fields[i], &entry)) {
+            tlv_apply_to_info(&entry, device_info);
+        }
+    }
+}
+
 esp_err_t espnow_manager_get_device_info(int device_index, espnow_device_info_t *device_info)
 {
     if (device_info == NULL) {
@@ -436,168 +812,7 @@ esp_err_t espnow_manager_get_device_info(int device_index, espnow_device_info_t
     
     // Check if device at index is available and in use
     if (g_tlv_devices[device_index].in_use) {
-        const device_tlv_storage_t *device = &g_tlv_devices[device_index];
-        
-        // Initialize device_info structure
-        memset(device_info, 0, sizeof(espnow_device_info_t));
-        
-        // Copy basic device information
-        memcpy(device_info->mac_address, device->mac_address, ESP_NOW_ETH_ALEN);
-        strncpy(device_info->device_name, device->device_name, sizeof(device_info->device_name) - 1);
-        device_info->is_available = true;
-        device_info->last_seen = device->last_seen;
-        device_info->entry_count = device->entry_count;
-        
-        // Initialize with stored RSSI from actual ESP-NOW reception
-        device_info->rssi = device->rssi;
-        device_info->uptime_seconds = 0;
-        device_info->ac_voltage = 0.0f;
-        device_info->ac_current = 0.0f;
-        device_info->ac_power = 0.0f;
-        device_info->ac_power_factor = 0.0f;
-        device_info->ac_frequency = 0.0f;
-        device_info->status_flags = 0;
-        device_info->error_code = 0;
-        device_info->temperature = 0.0f;
-        device_info->free_memory_kb = 0;
-        
-        // Parse TLV entries to extract device information
-        for (int i = 0; i < MAX_TLV_ENTRIES_PER_DEVICE; i++) {
-            const stored_tlv_entry_t *entry = &device->tlv_entries[i];
-            if (!entry->valid || entry->length == 0) {
-                continue;
-            }
-            
-            switch (entry->type) {
-                case TLV_TYPE_UPTIME:
-                    if (entry->length == 4) {
-                        // Convert from big-endian
-                        device_info->uptime_seconds = (entry->value[0] << 24) | 
-                                                    (entry->value[1] << 16) | 
-                                                    (entry->value[2] << 8) | 
-                                                     entry->value[3];
-                    }
-                    break;
-                    
-                case TLV_TYPE_DEVICE_ID:
-                    if (entry->length > 0 && entry->length < sizeof(device_info->device_id)) {
-                        memcpy(device_info->device_id, entry->value, entry->length);
-                        device_info->device_id[entry->length] = '\0';
-                    }
-                    break;
-                    
-                case TLV_TYPE_FIRMWARE_VER:
-                    if (entry->length > 0 && entry->length < sizeof(device_info->firmware_version)) {
-                        memcpy(device_info->firmware_version, entry->value, entry->length);
-                        device_info->firmware_version[entry->length] = '\0';
-                    }
-                    break;
-                    
-                case TLV_TYPE_COMPILE_TIME:
-                    if (entry->length > 0 && entry->length < sizeof(device_info->compile_time)) {
-                        memcpy(device_info->compile_time, entry->value, entry->length);
-                        device_info->compile_time[entry->length] = '\0';
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_VOLTAGE:
-                    if (entry->length == 4) {
-                        // IEEE 754 float32 in big-endian format
-                        uint32_t float_bits = (entry->value[0] << 24) | 
-                                            (entry->value[1] << 16) | 
-                                            (entry->value[2] << 8) | 
-                                             entry->value[3];
-                        memcpy(&device_info->ac_voltage, &float_bits, sizeof(float));
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_CURRENT:
-                    if (entry->length == 4) {
-                        // Convert from milliamperes (int32_t big-endian) to amperes
-                        int32_t milliamps = (int32_t)((entry->value[0] << 24) | 
-                                                     (entry->value[1] << 16) | 
-                                                     (entry->value[2] << 8) | 
-                                                      entry->value[3]);
-                        device_info->ac_current = milliamps / 1000.0f;
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_POWER:
-                    if (entry->length == 4) {
-                        // Convert from milliwatts (int32_t big-endian) to watts
-                        int32_t milliwatts = (int32_t)((entry->value[0] << 24) | 
-                                                      (entry->value[1] << 16) | 
-                                                      (entry->value[2] << 8) | 
-                                                       entry->value[3]);
-                        device_info->ac_power = milliwatts / 1000.0f;
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_POWER_FACTOR:
-                    if (entry->length == 4) {
-                        // IEEE 754 float32 in big-endian format
-                        uint32_t float_bits = (entry->value[0] << 24) | 
-                                            (entry->value[1] << 16) | 
-                                            (entry->value[2] << 8) | 
-                                             entry->value[3];
-                        memcpy(&device_info->ac_power_factor, &float_bits, sizeof(float));
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_FREQUENCY:
-                    if (entry->length == 4) {
-                        // IEEE 754 float32 in big-endian format
-                        uint32_t float_bits = (entry->value[0] << 24) | 
-                                            (entry->value[1] << 16) | 
-                                            (entry->value[2] << 8) | 
-                                             entry->value[3];
-                        memcpy(&device_info->ac_frequency, &float_bits, sizeof(float));
-                    }
-                    break;
-                    
-                case TLV_TYPE_STATUS_FLAGS:
-                    if (entry->length == 2) {
-                        device_info->status_flags = (entry->value[0] << 8) | entry->value[1];
-                    }
-                    break;
-                    
-                case TLV_TYPE_ERROR_CODE:
-                    if (entry->length == 2) {
-                        device_info->error_code = (entry->value[0] << 8) | entry->value[1];
-                    }
-                    break;
-                    
-                case TLV_TYPE_TEMPERATURE:
-                    if (entry->length == 4) {
-                        // IEEE 754 float32 in big-endian format
-                        uint32_t float_bits = (entry->value[0] << 24) | 
-                                            (entry->value[1] << 16) | 
-                                            (entry->value[2] << 8) | 
-                                             entry->value[3];
-                        memcpy(&device_info->temperature, &float_bits, sizeof(float));
-                    }
-                    break;
-                    
-                case TLV_TYPE_FREE_MEMORY:
-                    if (entry->length == 4) {
-                        // Free memory in bytes (uint32_t big-endian), convert to KB
-                        uint32_t free_memory_bytes = (entry->value[0] << 24) | 
-                                                   (entry->value[1] << 16) | 
-                                                   (entry->value[2] << 8) | 
-                                                    entry->value[3];
-                        device_info->free_memory_kb = free_memory_bytes / 1024;
-                        ESP_LOGD(TAG, "🧠 Parsed TLV_TYPE_FREE_MEMORY: %u bytes (%u KB)", 
-                                free_memory_bytes, device_info->free_memory_kb);
-                    }
-                    break;
-                    
-                default:
-                    // Unknown TLV type, skip
-                    break;
-            }
-        }
-        
-        
+        tlv_fill_device_info_locked(device_index, device_info);
         result = ESP_OK;
         
         ESP_LOGD(TAG, "📊 Device info retrieved for index %d: MAC=" MACSTR ", entries=%d", 
@@ -612,21 +827,138 @@ esp_err_t espnow_manager_get_device_info(int device_index, espnow_device_info_t
     return result;
 }
 
+esp_err_t espnow_manager_get_device_generation(int device_index, uint32_t *generation)
+{
+    if (generation == NULL || device_index < 0 || device_index >= MAX_TLV_DEVICES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (g_tlv_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *generation = g_tlv_slot_generation[device_index];
+    xSemaphoreGive(g_tlv_mutex);
+    
+    return ESP_OK;
+}
+
+// Change heap entries carry only device_index and generation until they are filled
+static void tlv_change_heap_swap(espnow_device_info_t *devices, int a, int b)
+{
+    int index = devices[a].device_index;
+    uint32_t generation = devices[a].generation;
+    devices[a].device_index = devices[b].device_index;
+    devices[a].generation = devices[b].generation;
+    devices[b].device_index = index;
+    devices[b].generation = generation;
+}
+
+// Restore the max-heap on generation below position i (heap of n entries)
+static void tlv_change_heap_sift_down(espnow_device_info_t *devices, int n, int i)
+{
+    for (;;) {
+        int largest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < n && devices[left].generation > devices[largest].generation) {
+            largest = left;
+        }
+        if (right < n && devices[right].generation > devices[largest].generation) {
+            largest = right;
+        }
+        if (largest == i) {
+            return;
+        }
+        tlv_change_heap_swap(devices, i, largest);
+        i = largest;
+    }
+}
+
+esp_err_t espnow_manager_get_devices_since(uint32_t since_generation, espnow_device_info_t *devices,
+                                           int max_devices, int *device_count, uint32_t *generation)
+{
+    if (devices == NULL || device_count == NULL || generation == NULL || max_devices <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *device_count = 0;
+    *generation = since_generation;
+    
+    if (g_tlv_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    // One pass over the table keeps the max_devices oldest changes in a max-heap built
+    // in the output array (only device_index and generation are used until the copy)
+    int count = 0;
+    bool exhausted = true;
+    for (int i = 0; i < MAX_TLV_DEVICES; i++) {
+        uint32_t slot_generation = g_tlv_slot_generation[i];
+        if (slot_generation <= since_generation) {
+            continue;
+        }
+        if (count < max_devices) {
+            int pos = count++;
+            devices[pos].device_index = i;
+            devices[pos].generation = slot_generation;
+            while (pos > 0 && devices[(pos - 1) / 2].generation < devices[pos].generation) {
+                tlv_change_heap_swap(devices, pos, (pos - 1) / 2);
+                pos = (pos - 1) / 2;
+            }
+        } else {
+            exhausted = false;
+            if (slot_generation < devices[0].generation) {
+                devices[0].device_index = i;
+                devices[0].generation = slot_generation;
+                tlv_change_heap_sift_down(devices, count, 0);
+            }
+        }
+    }
+    
+    // Resume after the newest change returned; generations are unique per change
+    uint32_t cursor = (count > 0) ? devices[0].generation : since_generation;
+    
+    // Heap sort to oldest change first, then copy each slot over its own heap entry
+    for (int n = count - 1; n > 0; n--) {
+        tlv_change_heap_swap(devices, 0, n);
+        tlv_change_heap_sift_down(devices, n, 0);
+    }
+    for (int i = 0; i < count; i++) {
+        tlv_fill_device_info_locked(devices[i].device_index, &devices[i]);
+    }
+    
+    *generation = exhausted ? g_tlv_generation : cursor;
+    *device_count = count;
+    
+    xSemaphoreGive(g_tlv_mutex);
+    
+    return ESP_OK;
+}
+
 esp_err_t espnow_manager_send_test_packet(void)
 {
-    if (!s_espnow_running) {
+    if (!atomic_load(&s_espnow_running)) {
         ESP_LOGW(TAG, "ESP-NOW not running, cannot send test packet");
         return ESP_ERR_INVALID_STATE;
     }
     
-    if (s_discovery_task_handle == NULL) {
+    TaskHandle_t discovery_task = atomic_load(&s_discovery_task_handle);
+    if (discovery_task == NULL) {
         ESP_LOGW(TAG, "Device discovery task not running, cannot trigger immediate send");
         return ESP_ERR_INVALID_STATE;
     }
     
     // Notify the device discovery task to send immediately
     ESP_LOGI(TAG, "📤 Triggering immediate device discovery broadcast");
-    BaseType_t notify_result = xTaskNotify(s_discovery_task_handle, 0x01, eSetBits);
+    BaseType_t notify_result = xTaskNotify(discovery_task, DISCOVERY_NOTIFY_TRIGGER, eSetBits);
     
     if (notify_result == pdPASS) {
         ESP_LOGI(TAG, "✅ Discovery task notified successfully");
@@ -637,6 +969,59 @@ esp_err_t espnow_manager_send_test_packet(void)
     }
 }
 
+esp_err_t espnow_manager_request_discovery_burst(void)
+{
+    if (!atomic_load(&s_espnow_running) || !espnow_notify_discovery(DISCOVERY_NOTIFY_BURST)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // Coalesces with a pending request: the task only sees the bit once
+    return ESP_OK;
+}
+
+esp_err_t espnow_manager_set_wake_window(uint16_t window_ms)
+{
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+    if (window_ms > CONFIG_ESPNOW_WAKE_INTERVAL) {
+        window_ms = CONFIG_ESPNOW_WAKE_INTERVAL;  // Awake for the whole interval
+    }
+    s_wake_window_ms = window_ms;
+    if (!atomic_load(&s_espnow_running)) {
+        return ESP_OK;  // Applied by espnow_manager_start()
+    }
+    
+    esp_err_t ret = esp_now_set_wake_window(window_ms);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set wake window %u ms: %s", window_ms, esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "📶 Wake window %u/%d ms", window_ms, CONFIG_ESPNOW_WAKE_INTERVAL);
+    return ESP_OK;
+#else
+    (void)window_ms;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t espnow_manager_register_node_event_cb(espnow_node_event_cb_t cb, void *user_ctx)
+{
+    if (g_tlv_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    s_node_event_cb = cb;
+    s_node_event_ctx = user_ctx;
+    xSemaphoreGive(g_tlv_mutex);
+    return ESP_OK;
+}
+
+bool espnow_manager_is_running(void)
+{
+    return atomic_load(&s_espnow_running);
+}
+
 // WiFi initialization (matching official example)
 static void espnow_wifi_init(void)
 {
@@ -671,23 +1056,25 @@ static void espnow_send_cb(const esp_now_send_info_t *tx_info, esp_now_send_stat
     memcpy(send_cb->mac_addr, tx_info->des_addr, ESP_NOW_ETH_ALEN);
     send_cb->status = status;
     
-    if (s_espnow_queue && xQueueSend(s_espnow_queue, &evt, ESPNOW_MAXDELAY) != pdTRUE) {
-        ESP_LOGW(TAG, "Send send queue fail");
+    // Never block the Wi-Fi task: drop the event if the queue is full
+    if (s_espnow_queue && xQueueSend(s_espnow_queue, &evt, 0) != pdTRUE) {
+        ESPNOW_STAT_INC(tx_event_dropped);
+    } else {
+        espnow_wake_recv_task();
     }
     
     // Update statistics
     if (status == ESP_NOW_SEND_SUCCESS) {
-        s_stats.send_success++;
+        ESPNOW_STAT_INC(send_success);
     } else {
-        s_stats.send_failed++;
+        ESPNOW_STAT_INC(send_failed);
     }
 }
 
 // ESP-NOW receive callback (official example)
+// Runs in the Wi-Fi task: copies the frame into a preallocated ring slot, never allocates or blocks
 static void espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len)
 {
-    example_espnow_event_t evt;
-    example_espnow_event_recv_cb_t *recv_cb = &evt.info.recv_cb;
     uint8_t *mac_addr = recv_info->src_addr;
     uint8_t *des_addr = recv_info->des_addr;
     
@@ -695,6 +1082,26 @@ static void espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *
         ESP_LOGE(TAG, "Receive cb arg error");
         return;
     }
+    
+    // Update statistics
+    ESPNOW_STAT_INC(packets_received);
+    boot_timeline_mark(BOOT_STAGE_FIRST_PACKET);   // One atomic load after the first frame
+    
+    // Claim the next free slot (producer side of the SPSC ring)
+    unsigned int head = atomic_load_explicit(&s_rx_head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&s_rx_tail, memory_order_acquire);
+    unsigned int depth = head - tail;
+    
+    if (depth >= ESPNOW_RX_RING_SIZE || len > ESPNOW_RX_SLOT_SIZE) {
+        // Ring full or frame larger than a slot - drop without logging
+        ESPNOW_STAT_INC(rx_dropped);
+        return;
+    }
+    
+    espnow_rx_slot_t *slot = &s_rx_ring[head & (ESPNOW_RX_RING_SIZE - 1)];
+    slot->trace_id = latency_trace_new_id();
+    latency_trace_stamp(LATENCY_STAGE_RECV_CB, slot->trace_id);
+    example_espnow_event_recv_cb_t *recv_cb = &slot->info;
     // this info is from recv_info->rx_ctrl, upload it through 
     //signed rssi: 8;               /**< Received Signal Strength Indicator(RSSI) of packet. unit: dBm */
     //unsigned rate: 5;             /**< PHY rate encoding of the packet. Only valid for non HT(11bg) packet */
@@ -722,7 +1129,10 @@ static void espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *
             recv_cb->rate_11ac = recv_info->rx_ctrl->mcs;
             break;
         default:
-            // Maybe we should assert here?
+            // Unknown signal mode, clear values left over from the previous frame in this slot
+            recv_cb->rate_11bg = -1;
+            recv_cb->rate_11n = -1;
+            recv_cb->rate_11ac = -1;
             break;
     }
     if (IS_BROADCAST_ADDR(des_addr)) {
@@ -731,212 +1141,140 @@ static void espnow_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *
         recv_cb->is_broadcast = false;
     }
     
-    evt.id = EXAMPLE_ESPNOW_RECV_CB;
     memcpy(recv_cb->mac_addr, mac_addr, ESP_NOW_ETH_ALEN);
-    recv_cb->data = malloc(len);
-    if (recv_cb->data == NULL) {
-        ESP_LOGE(TAG, "Malloc receive data fail");
-        return;
-    }
-    memcpy(recv_cb->data, data, len);
+    memcpy(slot->payload, data, len);
+    recv_cb->data = slot->payload;
     recv_cb->data_len = len;
     
-    if (s_espnow_queue && xQueueSend(s_espnow_queue, &evt, ESPNOW_MAXDELAY) != pdTRUE) {
-        ESP_LOGW(TAG, "Send receive queue fail");
-        free(recv_cb->data);
-    }
+    // Publish the slot to the receive task
+    atomic_store_explicit(&s_rx_head, head + 1, memory_order_release);
     
-    // Update statistics
-    s_stats.packets_received++;
+    ESPNOW_STAT_MAX(rx_ring_high_water, depth + 1);
     
-    // Trigger LED animation on packet reception (rate limited)
-    espnow_trigger_led_animation();
+    // Wake the receive task (non-blocking)
+    espnow_wake_recv_task();
+}
+
+/**
+ * @brief Zero the traffic counters and the published node counts
+ */
+static void espnow_counters_reset(void)
+{
+    ESPNOW_STAT_UPDATE(memset(&s_counters, 0, sizeof(s_counters)));
     
-    // Notify ESP-NOW page of receive statistics update
-    espnow_page_notify_data_update();
+    espnow_node_counts_t empty = {0};
+    seqlock_write_copy(&s_node_counts_lock, &s_node_counts, &empty, sizeof(empty));
 }
 
-// Data parsing (official example)
-// TLV helper functions
-static const char* tlv_type_to_string(uint8_t type)
-{
-    switch (type) {
-        // Basic Types (0x00-0x0F)
-        case TLV_TYPE_UPTIME:          return "UPTIME";
-        case TLV_TYPE_TIMESTAMP:       return "TIMESTAMP";
-        case TLV_TYPE_DEVICE_ID:       return "DEVICE_ID";
-        case TLV_TYPE_FIRMWARE_VER:    return "FIRMWARE_VER";
-        case TLV_TYPE_MAC_ADDRESS:     return "MAC_ADDRESS";
-        case TLV_TYPE_COMPILE_TIME:    return "COMPILE_TIME";
-        case TLV_TYPE_FREE_MEMORY:     return "FREE_MEMORY";
-        
-        // Electrical Measurements (0x10-0x2F)
-        case TLV_TYPE_AC_VOLTAGE:      return "AC_VOLTAGE";
-        case TLV_TYPE_AC_CURRENT:      return "AC_CURRENT";
-        case TLV_TYPE_AC_FREQUENCY:    return "AC_FREQUENCY";
-        case TLV_TYPE_AC_POWER:        return "AC_POWER";
-        case TLV_TYPE_AC_POWER_FACTOR: return "AC_POWER_FACTOR";
-        
-        // Energy Measurements (0x30-0x4F)
-        case TLV_TYPE_ENERGY_TOTAL:    return "ENERGY_TOTAL";
-        case TLV_TYPE_ENERGY_TODAY:    return "ENERGY_TODAY";
-        
-        // Status and Flags (0x50-0x6F)
-        case TLV_TYPE_STATUS_FLAGS:    return "STATUS_FLAGS";
-        case TLV_TYPE_ERROR_CODE:      return "ERROR_CODE";
-        
-        // Environmental (0x70-0x8F)
-        case TLV_TYPE_TEMPERATURE:     return "TEMPERATURE";
-        case TLV_TYPE_HUMIDITY:        return "HUMIDITY";
-        
-        default:
-            if (type >= TLV_TYPE_CUSTOM_START) {
-                return "CUSTOM";
-            }
-            return "UNKNOWN";
+// ===== RECEIVE RING IMPLEMENTATION =====
+
+/**
+ * @brief Reset the receive ring to empty
+ * 
+ * Must only be called while ESP-NOW callbacks are not registered.
+ */
+static void espnow_rx_ring_reset(void)
+{
+    atomic_store(&s_rx_head, 0);
+    atomic_store(&s_rx_tail, 0);
+    for (int i = 0; i < ESPNOW_RX_RING_SIZE; i++) {
+        s_rx_ring[i].info.data = s_rx_ring[i].payload;
+        s_rx_ring[i].info.data_len = 0;
     }
 }
 
-static int espnow_data_parse(uint8_t *data, uint16_t data_len, uint8_t *state, uint16_t *seq, uint32_t *magic)
+/**
+ * @brief Get a filled receive slot without removing it
+ * 
+ * Consumer side only. Slots stay owned by the consumer until
+ * espnow_rx_ring_release() is called, so a batch can be processed in place.
+ * 
+ * @param index Position after the oldest filled slot (0 = oldest)
+ * @return Pointer to the slot, or NULL if fewer than index + 1 slots are filled
+ */
+static espnow_rx_slot_t* espnow_rx_ring_peek(unsigned int index)
 {
-    if (data == NULL || data_len == 0) {
-        ESP_LOGE(TAG, "TLV Parse: Invalid data pointer or length");
-        return -1;
-    }
-    
-    ESP_LOGI(TAG, "📊 TLV Data Analysis: Parsing %d bytes", data_len);
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, data_len, ESP_LOG_INFO);
+    unsigned int tail = atomic_load_explicit(&s_rx_tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&s_rx_head, memory_order_acquire);
     
-    // Parse directly as TLV format (no ESP-NOW wrapper)
-    ESP_LOGI(TAG, "� Parsing as pure TLV format...");
-    
-    size_t offset = 0;
-    int tlv_count = 0;
-    bool valid_tlv_found = false;
+    if (head - tail <= index) {
+        return NULL;
+    }
     
-    while (offset < data_len) {
-        // Check if we have at least 2 bytes for type and length
-        if (offset + 2 > data_len) {
-            ESP_LOGW(TAG, "⚠️ Insufficient data for TLV header at offset %zu", offset);
-            break;
-        }
-        
-        uint8_t type = data[offset];
-        uint8_t length = data[offset + 1];
-        
-        // Validate TLV entry bounds
-        size_t total_entry_size = TLV_TOTAL_SIZE(length);
-        if (offset + total_entry_size > data_len) {
-            ESP_LOGE(TAG, "❌ TLV entry exceeds buffer bounds: Entry size: %zu, Remaining buffer: %zu", 
-                     total_entry_size, data_len - offset);
-            break;
-        }
-        
-        // Parse specific known types and create one-line output
-        char value_str[128] = {0};
-        if (length > 0) {
-            switch (type) {
-                case TLV_TYPE_UPTIME:
-                    if (length == 4) {
-                        uint32_t uptime = TLV_UINT32_FROM_BE(&data[offset + 2]);
-                        snprintf(value_str, sizeof(value_str), "Uptime: %" PRIu32 " seconds", uptime);
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_VOLTAGE:
-                    if (length == 4) {
-                        float voltage;
-                        TLV_FLOAT32_FROM_BE(&data[offset + 2], voltage);
-                        snprintf(value_str, sizeof(value_str), "AC Voltage: %.1f V", voltage);
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_CURRENT:
-                    if (length == 4) {
-                        int32_t current_ma = TLV_INT32_FROM_BE(&data[offset + 2]);
-                        float current_a = TLV_CURRENT_MA_TO_A(current_ma);
-                        snprintf(value_str, sizeof(value_str), "AC Current: %.3f A (%" PRId32 " mA)", current_a, current_ma);
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_FREQUENCY:
-                    if (length == 4) {
-                        float frequency;
-                        TLV_FLOAT32_FROM_BE(&data[offset + 2], frequency);
-                        snprintf(value_str, sizeof(value_str), "AC Frequency: %.2f Hz", frequency);
-                    }
-                    break;
-                    
-                case TLV_TYPE_AC_POWER:
-                    if (length == 4) {
-                        int32_t power_mw = TLV_INT32_FROM_BE(&data[offset + 2]);
-                        float power_w = TLV_POWER_MW_TO_W(power_mw);
-                        snprintf(value_str, sizeof(value_str), "AC Power: %.3f W (%" PRId32 " mW)", power_w, power_mw);
-                    }
-                    break;
-                    
-                case TLV_TYPE_DEVICE_ID:
-                case TLV_TYPE_FIRMWARE_VER:
-                case TLV_TYPE_COMPILE_TIME:
-                    // String types - display as text if printable
-                    {
-                        char temp_str[65] = {0}; // Max 64 chars + null terminator
-                        int copy_len = (length < 64) ? length : 64;
-                        memcpy(temp_str, &data[offset + 2], copy_len);
-                        snprintf(value_str, sizeof(value_str), "Text: \"%s\"", temp_str);
-                    }
-                    break;
-                    
-                case TLV_TYPE_MAC_ADDRESS:
-                    if (length == 6) {
-                        snprintf(value_str, sizeof(value_str), "MAC: " MACSTR, MAC2STR(&data[offset + 2]));
-                    }
-                    break;
-                    
-                case TLV_TYPE_STATUS_FLAGS:
-                    if (length == 2) {
-                        uint16_t flags = TLV_UINT16_FROM_BE(&data[offset + 2]);
-                        char flag_details[64] = {0};
-                        if (flags & STATUS_FLAG_POWER_ON) strcat(flag_details, "PWR ");
-                        if (flags & STATUS_FLAG_WIFI_CONNECTED) strcat(flag_details, "WIFI ");
-                        if (flags & STATUS_FLAG_ESP_NOW_ACTIVE) strcat(flag_details, "ESPNOW ");
-                        if (flags & STATUS_FLAG_ERROR) strcat(flag_details, "ERR ");
-                        snprintf(value_str, sizeof(value_str), "Status Flags: 0x%04X (%s)", flags, flag_details);
-                    }
-                    break;
-                    
-                default:
-                    snprintf(value_str, sizeof(value_str), "Raw data (%d bytes)", length);
-                    break;
-            }
-        } else {
-            snprintf(value_str, sizeof(value_str), "(empty)");
-        }
-        
-        // Single line output for each TLV entry
-        ESP_LOGI(TAG, "📋 TLV #%d @%zu: Type=0x%02X (%s), Len=%d, %s", 
-                 tlv_count + 1, offset, type, tlv_type_to_string(type), length, value_str);
-        
-        // Move to next TLV entry
-        offset += total_entry_size;
-        tlv_count++;
-        valid_tlv_found = true;
-        
-        // Safety check to prevent infinite loops
-        if (tlv_count > 100) {
-            ESP_LOGW(TAG, "⚠️ Maximum TLV entry limit reached (100), stopping parse");
+    return &s_rx_ring[(tail + index) & (ESPNOW_RX_RING_SIZE - 1)];
+}
+
+/**
+ * @brief Return the oldest count slots obtained by espnow_rx_ring_peek() to the producer
+ */
+static void espnow_rx_ring_release(unsigned int count)
+{
+    unsigned int tail = atomic_load_explicit(&s_rx_tail, memory_order_relaxed);
+    atomic_store_explicit(&s_rx_tail, tail + count, memory_order_release);
+}
+
+/**
+ * @brief Decide whether the frame about to be processed is logged
+ * 
+ * In production logging mode only one frame per sample interval logs its
+ * info lines; the others only count them in the log_suppressed counter.
+ */
+static void espnow_hot_log_frame_begin(void)
+{
+#if CONFIG_ESPNOW_LOG_PRODUCTION
+    TickType_t now = xTaskGetTickCount();
+    s_hot_log_sampled = (CONFIG_ESPNOW_LOG_SAMPLE_INTERVAL_MS > 0) &&
+                        (now - s_hot_log_last_sample >= pdMS_TO_TICKS(CONFIG_ESPNOW_LOG_SAMPLE_INTERVAL_MS));
+    if (s_hot_log_sampled) {
+        s_hot_log_last_sample = now;
+        ESP_LOGI(TAG, "📉 Sampled frame log (%" PRIu32 " lines suppressed so far, %" PRIu32 " frames received)",
+                 (uint32_t)ESPNOW_STAT_GET(log_suppressed), (uint32_t)ESPNOW_STAT_GET(packets_received));
+    }
+#endif
+}
+
+// Data parsing (official example)
+// TLV helper functions
+/**
+ * @brief Decode a received TLV packet, dumping it when debug logging is enabled
+ * @param data Packet buffer
+ * @param data_len Packet length
+ * @param entries Output array of decoded entries
+ * @param max_entries Capacity of entries
+ * @return Number of decoded TLV entries, -1 if none were found
+ */
+static int espnow_data_parse(const uint8_t *data, uint16_t data_len, tlv_decoded_entry_t *entries, int max_entries)
+{
+    if (data == NULL || data_len == 0) {
+        ESP_LOGE(TAG, "TLV Parse: Invalid data pointer or length");
+        return -1;
+    }
+    
+    tlv_decode_result_t result;
+    int tlv_count = tlv_codec_decode(data, data_len, entries, max_entries, &result);
+    switch (result.stop) {
+        case TLV_DECODE_SHORT_HEADER:
+            ESP_LOGW(TAG, "⚠️ Insufficient data for TLV header at offset %zu", result.offset);
+            break;
+        case TLV_DECODE_OVERRUN:
+            ESP_LOGE(TAG, "❌ TLV entry exceeds buffer bounds: Entry size: %zu, Remaining buffer: %zu",
+                     result.entry_size, (size_t)data_len - result.offset);
+            break;
+        case TLV_DECODE_ENTRY_LIMIT:
+            ESP_LOGW(TAG, "⚠️ Maximum TLV entry limit reached (%d), stopping parse", max_entries);
+            break;
+        default:
             break;
-        }
     }
     
-    if (valid_tlv_found) {
-        ESP_LOGI(TAG, "✅ TLV Format: Successfully parsed %d TLV entries", tlv_count);
-        
-        // For TLV format, we don't have traditional state/seq/magic
-        if (state) *state = 0;
-        if (seq) *seq = 0;
-        if (magic) *magic = 0;
-        
+    if (TLV_DEBUG_DUMP_ENABLED()) {
+        ESP_LOGD(TAG, "📊 TLV Data Analysis: Parsing %d bytes", data_len);
+        ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, data_len, ESP_LOG_DEBUG);
+        tlv_dump_entries(entries, tlv_count);
+    }
+    
+    if (tlv_count > 0) {
+        ESPNOW_HOT_LOGI("✅ TLV Format: Successfully parsed %d TLV entries", tlv_count);
         return tlv_count; // Return number of TLV entries found
     } else {
         ESP_LOGW(TAG, "❌ No valid TLV format detected in data");
@@ -945,111 +1283,352 @@ static int espnow_data_parse(uint8_t *data, uint16_t data_len, uint8_t *state, u
     }
 }
 
-// Data preparation (official example)
 // ===== DEVICE DISCOVERY TASK IMPLEMENTATION =====
 
 /**
- * @brief Prepare discovery broadcast data (simplified version)
+ * @brief Find the TLV payload of a discovery frame sent by another stick
+ * 
+ * Discovery frames start with the example_espnow_data_t header, which is not
+ * TLV. A frame is taken as one when the header fields and its CRC check out;
+ * node frames are TLV from the first byte.
  * 
- * Always sends broadcast with state=1 and incrementing sequence number
+ * @param payload Output, TLVs after the header
+ * @param payload_len Output, length of payload (0 for a frame without telemetry)
+ * @return true if data is a discovery frame
  */
-static void device_discovery_data_prepare(device_discovery_param_t *param)
+static bool espnow_discovery_payload(const uint8_t *data, uint16_t data_len,
+                                     const uint8_t **payload, uint16_t *payload_len)
 {
-    example_espnow_data_t *buf = (example_espnow_data_t *)param->buffer;
+    static const uint8_t zero_crc[sizeof(((example_espnow_data_t *)0)->crc)] = {0};
+    const size_t crc_offset = offsetof(example_espnow_data_t, crc);
+    const size_t after_crc = crc_offset + sizeof(zero_crc);
+    const example_espnow_data_t *buf = (const example_espnow_data_t *)data;
     
-    if (param->len < sizeof(example_espnow_data_t)) {
-        ESP_LOGE(TAG, "Discovery buffer too small");
-        return;
+    if (data_len < sizeof(example_espnow_data_t) || buf->type >= EXAMPLE_ESPNOW_DATA_MAX || buf->state != 1) {
+        return false;
+    }
+    
+    // CRC as computed by the sender, over the frame with the CRC field zeroed
+    uint16_t crc = esp_crc16_le(UINT16_MAX, data, crc_offset);
+    crc = esp_crc16_le(crc, zero_crc, sizeof(zero_crc));
+    crc = esp_crc16_le(crc, &data[after_crc], data_len - after_crc);
+    if (crc != buf->crc) {
+        return false;
+    }
+    
+    *payload = buf->payload;
+    *payload_len = data_len - sizeof(example_espnow_data_t);
+    return true;
+}
+
+/**
+ * @brief Write this stick's own readings as TLVs, most important first
+ * @param out Payload of the discovery frame
+ * @param capacity Room in out
+ * @return TLV bytes written
+ */
+static size_t device_discovery_telemetry_build(const device_discovery_param_t *param, uint8_t *out, size_t capacity)
+{
+    tlv_builder_t builder;
+    system_data_t data;
+    uint16_t flags = STATUS_FLAG_POWER_ON | STATUS_FLAG_ESP_NOW_ACTIVE;
+    
+    tlv_builder_init(&builder, out, capacity);
+    
+    if (system_monitor_get_data(&data) == ESP_OK && data.data_valid) {
+        if (data.is_charging) {
+            flags |= STATUS_FLAG_CHARGING;
+        }
+        if (data.is_usb_connected) {
+            flags |= STATUS_FLAG_USB_POWERED;
+        } else if (data.battery_percentage <= TELEMETRY_LOW_BATTERY_PERCENT) {
+            flags |= STATUS_FLAG_LOW_BATTERY;
+        }
+        tlv_builder_put_u16(&builder, TLV_TYPE_STATUS_FLAGS, flags);
+        tlv_builder_put_f32(&builder, TLV_TYPE_BATTERY_VOLTAGE, data.battery_voltage);
+        tlv_builder_put_u16(&builder, TLV_TYPE_BATTERY_LEVEL, data.battery_percentage);
+        tlv_builder_put_i32(&builder, TLV_TYPE_BATTERY_CURRENT,
+                            (int32_t)lroundf(data.charge_current - data.discharge_current));
+        tlv_builder_put_f32(&builder, TLV_TYPE_VBUS_VOLTAGE, data.vbus_voltage);
+        tlv_builder_put_f32(&builder, TLV_TYPE_TEMPERATURE, data.internal_temp);
+        tlv_builder_put_u32(&builder, TLV_TYPE_UPTIME, data.uptime_seconds);
+        tlv_builder_put_u32(&builder, TLV_TYPE_FREE_MEMORY, data.free_heap);
+    } else {
+        // No power readings yet: report what the system knows directly
+        tlv_builder_put_u16(&builder, TLV_TYPE_STATUS_FLAGS, flags);
+        tlv_builder_put_u32(&builder, TLV_TYPE_UPTIME, (uint32_t)(esp_timer_get_time() / 1000000));
+        tlv_builder_put_u32(&builder, TLV_TYPE_FREE_MEMORY, esp_get_free_heap_size());
+    }
+    tlv_builder_put_string(&builder, TLV_TYPE_DEVICE_ID, param->device_id, TLV_MAX_DEVICE_ID_LEN);
+    
+    if (builder.overflow) {
+        ESP_LOGW(TAG, "⚠️ Telemetry truncated to %u bytes", (unsigned)builder.len);
+    }
+    return builder.len;
+}
+
+/**
+ * @brief Prepare the next discovery frame in the send buffer
+ * 
+ * Broadcasts carry the stick's own telemetry as TLVs after the header once
+ * DISCOVERY_TELEMETRY_INTERVAL_MS has passed, so telemetry never costs a frame
+ * of its own. Unicast polls and the broadcasts in between are header only.
+ */
+static void device_discovery_data_prepare(device_discovery_param_t *param, bool unicast)
+{
+    example_espnow_data_t *buf = (example_espnow_data_t *)param->buffer;
+    size_t tlv_len = 0;
+    
+    if (!unicast && DISCOVERY_TELEMETRY_INTERVAL_MS > 0) {
+        uint32_t now = xTaskGetTickCount();
+        if (!param->telemetry_sent || now - param->telemetry_time >= pdMS_TO_TICKS(DISCOVERY_TELEMETRY_INTERVAL_MS)) {
+            tlv_len = device_discovery_telemetry_build(param, buf->payload, DISCOVERY_TELEMETRY_MAX);
+            param->telemetry_sent = true;
+            param->telemetry_time = now;
+        }
     }
+    param->len = sizeof(example_espnow_data_t) + tlv_len;
     
-    buf->type = EXAMPLE_ESPNOW_DATA_BROADCAST;
+    buf->type = unicast ? EXAMPLE_ESPNOW_DATA_UNICAST : EXAMPLE_ESPNOW_DATA_BROADCAST;
     buf->state = 1;  // Always 1 for device discovery
-    buf->seq_num = s_espnow_seq[EXAMPLE_ESPNOW_DATA_BROADCAST]++;
+    buf->seq_num = s_espnow_seq[buf->type]++;
     buf->crc = 0;
     buf->magic = param->magic;
     
-    // Fill payload with random data
-    esp_fill_random(buf->payload, param->len - sizeof(example_espnow_data_t));
-    
     // Calculate CRC
     buf->crc = esp_crc16_le(UINT16_MAX, (uint8_t const *)buf, param->len);
     
-    ESP_LOGD(TAG, "🔧 Discovery data prepared: state=1, seq=%d, magic=0x%08lX", 
-             buf->seq_num, buf->magic);
+    ESP_LOGD(TAG, "🔧 Discovery data prepared: state=1, seq=%d, magic=0x%08lX, telemetry=%u bytes", 
+             buf->seq_num, buf->magic, (unsigned)tlv_len);
+}
+
+/**
+ * @brief Count the nodes heard since a tick (walks the in-use list)
+ * @param since Tick of the previous discovery broadcast
+ * @param count Output node count, left unchanged if the table stays busy
+ * @return true if the table could be read
+ */
+static bool device_discovery_count_heard(uint32_t since, uint16_t *count)
+{
+    if (g_tlv_mutex == NULL || xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return false;
+    }
+    
+    uint16_t heard = 0;
+    for (int i = g_tlv_used_head; i >= 0; i = g_tlv_devices[i].next_slot) {
+        if ((int32_t)(g_tlv_devices[i].last_seen - since) >= 0) {
+            heard++;
+        }
+    }
+    xSemaphoreGive(g_tlv_mutex);
+    
+    *count = heard;
+    return true;
+}
+
+/**
+ * @brief Pick the next broadcast interval from the nodes heard in the last round
+ * 
+ * - A node went quiet: burst at the minimum interval to find it again
+ * - New nodes appeared: fall back to the base interval
+ * - Stable node set: finish the burst, then double up to the maximum
+ * 
+ * @param full_round false if the round was cut short by a trigger; too short
+ *                   to judge the node set, so only the burst advances
+ */
+static void device_discovery_adapt(device_discovery_param_t *param, bool full_round)
+{
+    bool grew = false;
+    
+    // Nodes answer within one round, so count everything heard since the previous broadcast
+    uint16_t heard = param->last_heard_nodes;
+    if (full_round && device_discovery_count_heard(param->last_send_time, &heard)) {
+        if (heard < param->last_heard_nodes) {
+            ESP_LOGI(TAG, "🔍 Node set shrank (%d -> %d), discovery burst", param->last_heard_nodes, heard);
+            param->burst_left = DISCOVERY_BURST_COUNT;
+        }
+        grew = (heard > param->last_heard_nodes);
+        param->last_heard_nodes = heard;
+    }
+    
+    if (param->burst_left > 0) {
+        param->burst_left--;
+        param->interval_ms = DISCOVERY_MIN_INTERVAL_MS;
+    } else if (grew) {
+        param->interval_ms = DISCOVERY_BASE_INTERVAL_MS;
+    } else if (full_round) {
+        param->interval_ms *= 2;
+    }
+    
+    if (param->interval_ms < DISCOVERY_MIN_INTERVAL_MS) {
+        param->interval_ms = DISCOVERY_MIN_INTERVAL_MS;
+    } else if (param->interval_ms > DISCOVERY_MAX_INTERVAL_MS) {
+        param->interval_ms = DISCOVERY_MAX_INTERVAL_MS;
+    }
+    ESPNOW_STAT_SET(discovery_interval_ms, param->interval_ms);
+}
+
+/**
+ * @brief Sleep until the receive task reports the send callback of the last poll
+ * @param pending Accumulates trigger bits that arrive while waiting
+ * @return false on timeout
+ */
+static bool device_discovery_wait_send_done(uint32_t *pending)
+{
+    // Block on the notification from the receive task instead of polling a flag
+    TickType_t timeout = pdMS_TO_TICKS(DISCOVERY_SEND_TIMEOUT_MS);
+    TickType_t start = xTaskGetTickCount();
+    TickType_t elapsed = 0;
+    
+    while (elapsed < timeout) {
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &bits, timeout - elapsed) == pdTRUE) {
+            *pending |= bits & ~DISCOVERY_NOTIFY_SEND_DONE;
+            if (bits & DISCOVERY_NOTIFY_SEND_DONE) {
+                return true;
+            }
+        }
+        elapsed = xTaskGetTickCount() - start;
+    }
+    return false;
+}
+
+/**
+ * @brief Send one discovery broadcast and sleep until its send callback
+ * @param pending Accumulates trigger bits that arrive while waiting
+ */
+static void device_discovery_send(device_discovery_param_t *param, uint32_t *pending)
+{
+    device_discovery_data_prepare(param, false);
+    param->last_send_time = xTaskGetTickCount();
+    param->rounds_since_broadcast = 0;
+    
+    ESP_LOGI(TAG, "📡 Sending device discovery broadcast (state=1, %d bytes, next in %lu ms)...",
+             param->len, param->interval_ms);
+    
+    esp_err_t ret = esp_now_send(s_broadcast_mac, param->buffer, param->len);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Discovery send failed: %s", esp_err_to_name(ret));
+        ESPNOW_STAT_INC(send_failed);
+        return;
+    }
+    
+    if (device_discovery_wait_send_done(pending)) {
+        ESP_LOGD(TAG, "✅ Discovery broadcast completed");
+    } else {
+        ESP_LOGW(TAG, "⏰ Discovery send timeout (assuming completed)");
+    }
+}
+
+/**
+ * @brief Poll every registered peer by unicast, one at a time
+ * 
+ * Unicast frames are ACKed and retried by the MAC at the peer's own PHY rate,
+ * instead of going out once at the broadcast rate. Each poll waits for its
+ * send callback, which also feeds the peer's rate adaptation.
+ * 
+ * @param pending Accumulates trigger bits that arrive while waiting
+ */
+static void device_discovery_send_unicast(device_discovery_param_t *param, uint32_t *pending)
+{
+    static uint8_t s_peer_macs[ESPNOW_PEERS_MAX > 0 ? ESPNOW_PEERS_MAX : 1][ESPNOW_PEERS_MAC_LEN];
+    int count = espnow_peers_list(s_peer_macs, ESPNOW_PEERS_MAX);
+    
+    param->last_send_time = xTaskGetTickCount();
+    param->rounds_since_broadcast++;
+    
+    ESP_LOGI(TAG, "📡 Polling %d unicast peers (next in %lu ms)...", count, param->interval_ms);
+    
+    for (int i = 0; i < count && atomic_load(&s_espnow_running); i++) {
+        device_discovery_data_prepare(param, true);
+        esp_err_t ret = esp_now_send(s_peer_macs[i], param->buffer, param->len);
+        if (ret != ESP_OK) {
+            // The peer may have been rotated out since the list was taken
+            ESP_LOGW(TAG, "❌ Unicast poll to "MACSTR" failed: %s", MAC2STR(s_peer_macs[i]), esp_err_to_name(ret));
+            ESPNOW_STAT_INC(send_failed);
+            continue;
+        }
+        if (!device_discovery_wait_send_done(pending)) {
+            ESP_LOGW(TAG, "⏰ Unicast poll to "MACSTR" timed out", MAC2STR(s_peer_macs[i]));
+        }
+    }
 }
 
 /**
- * @brief Device discovery task - sends broadcast every 5 seconds
+ * @brief Device discovery task - adaptive broadcast scheduler
+ * 
+ * This task sends ESP-NOW broadcast packets with:
+ * - A burst at the minimum interval after start, when a node goes quiet,
+ *   or when the ESP-NOW page asks for one
+ * - Exponential back-off up to the maximum interval while the node set is stable
+ * - Once nodes are registered as unicast peers, only every
+ *   DISCOVERY_BROADCAST_EVERY-th round is a broadcast; the others poll the
+ *   peers by unicast
+ * - State always set to 1 and incrementing sequence numbers
  * 
- * This task continuously sends ESP-NOW broadcast packets with:
- * - Fixed 5-second interval after last send completion
- * - State always set to 1
- * - Incrementing sequence numbers
+ * Between broadcasts the task sleeps on its task notification; send
+ * completion, triggers and burst requests all arrive as notification bits.
  */
 static void device_discovery_task(void *pvParameter)
 {
     device_discovery_param_t *param = (device_discovery_param_t *)pvParameter;
-    const uint32_t DISCOVERY_INTERVAL_MS = 5000;  // 5 seconds
+    uint32_t pending = 0;
+    bool first_round = true;
+    bool full_round = true;
     
     ESP_LOGI(TAG, "🔍 Device Discovery Task started");
-    ESP_LOGI(TAG, "🔍 Broadcasting every %lu seconds with state=1", DISCOVERY_INTERVAL_MS / 1000);
     
     // Initial delay before first broadcast
     vTaskDelay(pdMS_TO_TICKS(2000));
     
-    while (s_espnow_running) {
-        // Prepare discovery data
-        device_discovery_data_prepare(param);
-        
-        // Send broadcast
-        ESP_LOGI(TAG, "📡 Sending device discovery broadcast (state=1)...");
-        param->send_completed = false;
-        
-        esp_err_t ret = esp_now_send(s_broadcast_mac, param->buffer, param->len);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "❌ Discovery send failed: %s", esp_err_to_name(ret));
-            s_stats.send_failed++;
-        } else {
-            ESP_LOGD(TAG, "📤 Discovery send initiated successfully");
+    while (atomic_load(&s_espnow_running)) {
+        if (pending & DISCOVERY_NOTIFY_BURST) {
+            ESP_LOGI(TAG, "🚀 Discovery burst requested");
+            param->burst_left = DISCOVERY_BURST_COUNT;
+        } else if (pending & DISCOVERY_NOTIFY_TRIGGER) {
+            ESP_LOGI(TAG, "🚀 Immediate discovery trigger received");
         }
+        // Broadcast to find new nodes: bursts, triggers, every few rounds, or no peers yet
+        bool broadcast = first_round || param->burst_left > 0 || (pending & (DISCOVERY_NOTIFY_BURST | DISCOVERY_NOTIFY_TRIGGER)) ||
+                         param->rounds_since_broadcast + 1 >= DISCOVERY_BROADCAST_EVERY;
+        pending = 0;
         
-        // Wait for send completion or timeout
-        TickType_t send_start_time = xTaskGetTickCount();
-        const TickType_t SEND_TIMEOUT_MS = 1000;  // 1 second timeout
-        
-        while (!param->send_completed && 
-               (xTaskGetTickCount() - send_start_time) < pdMS_TO_TICKS(SEND_TIMEOUT_MS)) {
-            vTaskDelay(pdMS_TO_TICKS(10));  // Small delay to check completion
+        if (!first_round) {
+            device_discovery_adapt(param, full_round);
+        } else {
+            param->burst_left--;
+            ESPNOW_STAT_SET(discovery_interval_ms, param->interval_ms);
+            first_round = false;
         }
         
-        if (param->send_completed) {
-            ESP_LOGI(TAG, "✅ Discovery broadcast completed successfully");
-            param->last_send_time = xTaskGetTickCount();
+        uint8_t peer_mac[1][ESPNOW_PEERS_MAC_LEN];
+        if (broadcast || param->burst_left > 0 || espnow_peers_list(peer_mac, 1) == 0) {  // Burst restarted by adapt
+            device_discovery_send(param, &pending);
         } else {
-            ESP_LOGW(TAG, "⏰ Discovery send timeout (assuming completed)");
-            param->last_send_time = xTaskGetTickCount();
+            device_discovery_send_unicast(param, &pending);
+        }
+        if (!atomic_load(&s_espnow_running)) {
+            break;
         }
         
-        // Wait for next discovery interval or immediate trigger
-        ESP_LOGI(TAG, "⏱️ Waiting %lu seconds until next discovery broadcast (or immediate trigger)...", DISCOVERY_INTERVAL_MS / 1000);
-        
-        // Use task notification with timeout for DISCOVERY_INTERVAL_MS
-        uint32_t notification_value;
-        BaseType_t notify_result = xTaskNotifyWait(
-            0x00,      // Don't clear any notification bits on entry
-            0xFFFFFFFF, // Clear all notification bits on exit
-            &notification_value,
-            pdMS_TO_TICKS(DISCOVERY_INTERVAL_MS)  // Wait timeout
-        );
+        // Sleep for the interval unless a trigger arrives (or already arrived during the send)
+        const uint32_t wake_bits = DISCOVERY_NOTIFY_TRIGGER | DISCOVERY_NOTIFY_BURST;
+        TickType_t interval = pdMS_TO_TICKS(param->interval_ms);
+        TickType_t start = xTaskGetTickCount();
+        TickType_t elapsed = 0;
         
-        if (notify_result == pdTRUE) {
-            ESP_LOGI(TAG, "🚀 Immediate discovery trigger received (notification: 0x%08lX)", notification_value);
-        } else {
-            ESP_LOGD(TAG, "⏰ Discovery interval timeout - proceeding with next broadcast");
+        while (!(pending & wake_bits) && elapsed < interval) {
+            uint32_t bits = 0;
+            if (xTaskNotifyWait(0, UINT32_MAX, &bits, interval - elapsed) == pdTRUE) {
+                pending |= bits & ~DISCOVERY_NOTIFY_SEND_DONE;  // Late send callbacks are stale
+            }
+            elapsed = xTaskGetTickCount() - start;
         }
+        full_round = !(pending & wake_bits);
     }
     
     ESP_LOGI(TAG, "🔍 Device Discovery Task ending");
+    atomic_store(&s_discovery_task_handle, NULL);
     vTaskDelete(NULL);
 }
 
@@ -1060,133 +1639,200 @@ static void device_discovery_cleanup(void)
 {
     if (s_discovery_param) {
         if (s_discovery_param->buffer) {
-            free(s_discovery_param->buffer);
+            mem_account_free(MEM_MODULE_ESPNOW, s_discovery_param->buffer);
         }
-        free(s_discovery_param);
+        mem_account_free(MEM_MODULE_ESPNOW, s_discovery_param);
         s_discovery_param = NULL;
     }
-    s_discovery_task_handle = NULL;
+    atomic_store(&s_discovery_task_handle, NULL);
     ESP_LOGI(TAG, "🧹 Device discovery resources cleaned up");
 }
 
+/**
+ * @brief Decode up to max_frames filled ring slots without taking any lock
+ * 
+ * The slots are not released: the decoded entries point into their payloads
+ * until the batch has been committed.
+ * 
+ * @return Number of frames in the batch (0 if the ring is empty)
+ */
+static int espnow_recv_decode_batch(espnow_rx_decoded_t *batch, int max_frames)
+{
+    int count = 0;
+    espnow_rx_slot_t *slot;
+    
+    while (count < max_frames && (slot = espnow_rx_ring_peek(count)) != NULL) {
+        example_espnow_event_recv_cb_t *recv_cb = &slot->info;
+        espnow_rx_decoded_t *frame = &batch[count++];
+        frame->info = recv_cb;
+        frame->trace_id = slot->trace_id;
+        latency_trace_stamp(LATENCY_STAGE_DEQUEUE, frame->trace_id);
+        
+        // Benchmark traffic never reaches the device table
+        if (espnow_bench_handle_frame(recv_cb->mac_addr, recv_cb->data, recv_cb->data_len, recv_cb->rssi)) {
+            frame->entry_count = 0;
+            continue;
+        }
+        
+        espnow_hot_log_frame_begin();
+        
+        // Print raw data for debugging
+        ESPNOW_HOT_LOGI("📦 Raw data from "MACSTR" (len=%d):", MAC2STR(recv_cb->mac_addr), recv_cb->data_len);
+        ESPNOW_HOT_LOGI("   Received via %s", recv_cb->is_broadcast ? "BROADCAST" : "UNICAST");
+        ESPNOW_HOT_LOGI("   rssi: %d dBm, 11bg: %d, 11n: %d, 11ac: %d", recv_cb->rssi, recv_cb->rate_11bg, recv_cb->rate_11n, recv_cb->rate_11ac);
+        ESPNOW_HOT_LOG_HEX(recv_cb->data, recv_cb->data_len);
+        
+        // Another stick's discovery frame: its telemetry follows the header
+        const uint8_t *tlv = recv_cb->data;
+        uint16_t tlv_len = recv_cb->data_len;
+        if (espnow_discovery_payload(recv_cb->data, recv_cb->data_len, &tlv, &tlv_len)) {
+            ESPNOW_HOT_LOGI("   Discovery frame with %d telemetry bytes", tlv_len);
+            if (tlv_len == 0) {
+                frame->entry_count = 0;
+                latency_trace_stamp(LATENCY_STAGE_DECODE, frame->trace_id);
+                continue;
+            }
+        }
+        
+        // Decode once; storage consumes the decoded entries directly
+        frame->entry_count = espnow_data_parse(tlv, tlv_len, frame->entries, TLV_DECODE_MAX_ENTRIES);
+        latency_trace_stamp(LATENCY_STAGE_DECODE, frame->trace_id);
+        
+        if (frame->entry_count > 0) {
+            ESPNOW_HOT_LOGI("✅ TLV data parsed successfully (%d entries), storing for device " MACSTR, 
+                     frame->entry_count, MAC2STR(recv_cb->mac_addr));
+        } else {
+            ESP_LOGW(TAG, "⚠️ TLV parsing failed or no valid TLV data found");
+        }
+    }
+    
+    return count;
+}
+
 /**
  * @brief Receive-only ESP-NOW task (no sending, only processing received data)
  * 
  * This task only processes ESP-NOW receive events without sending any data.
  * All sending is handled by the device_discovery_task.
+ * 
+ * The task sleeps on its task notification. Each pass drains all pending
+ * send completion events from s_espnow_queue and all frames from the receive
+ * ring, up to ESPNOW_RX_BATCH_SIZE frames at a time. A batch is decoded in
+ * place outside the storage lock, committed to the device table under one
+ * g_tlv_mutex hold, and then released with a single UI notification.
  */
 static void espnow_recv_only_task(void *pvParameter)
 {
     example_espnow_event_t evt;
-    uint8_t recv_state = 0;
-    uint16_t recv_seq = 0;
-    uint32_t recv_magic = 0;
+    static espnow_rx_decoded_t s_batch[ESPNOW_RX_BATCH_SIZE];  // Reused for every batch
     
     example_espnow_send_param_t *recv_param = (example_espnow_send_param_t *)pvParameter;
     
     ESP_LOGI(TAG, "📥 ESP-NOW Receive-only task started (Magic: 0x%08lX)", recv_param->magic);
     
-    while (s_espnow_running && xQueueReceive(s_espnow_queue, &evt, portMAX_DELAY) == pdTRUE) {
-        switch (evt.id) {
-            case EXAMPLE_ESPNOW_SEND_CB:
-            {
-                example_espnow_event_send_cb_t *send_cb = &evt.info.send_cb;
-                
-                // Check if this is a broadcast to our broadcast MAC (device discovery)
-                bool is_discovery_broadcast = (memcmp(send_cb->mac_addr, s_broadcast_mac, ESP_NOW_ETH_ALEN) == 0);
-                
-                if (is_discovery_broadcast && s_discovery_param) {
-                    // Notify device discovery task that send completed
-                    s_discovery_param->send_completed = true;
-                    ESP_LOGD(TAG, "🔍 Discovery send callback: %s", 
-                             (send_cb->status == ESP_NOW_SEND_SUCCESS) ? "SUCCESS" : "FAILED");
-                }
-                
-                // Update send statistics
-                if (send_cb->status == ESP_NOW_SEND_SUCCESS) {
-                    s_stats.packets_sent++;
-                    s_stats.send_success++;
-                } else {
-                    s_stats.send_failed++;
+    while (atomic_load(&s_espnow_running)) {
+        // Drain send completion events
+        while (xQueueReceive(s_espnow_queue, &evt, 0) == pdTRUE) {
+            if (evt.id != EXAMPLE_ESPNOW_SEND_CB) {
+                ESP_LOGE(TAG, "Callback type error: %d", evt.id);
+                continue;
+            }
+            
+            example_espnow_event_send_cb_t *send_cb = &evt.info.send_cb;
+            
+            // Check if this is a broadcast to our broadcast MAC (device discovery)
+            bool is_discovery_broadcast = (memcmp(send_cb->mac_addr, s_broadcast_mac, ESP_NOW_ETH_ALEN) == 0);
+            
+            // Unicast polls go to registered peers; their completion also adapts the peer's rate,
+            // except while the benchmark has moved the radio to another channel or rate
+            bool is_peer_poll = false;
+            if (!is_discovery_broadcast) {
+                is_peer_poll = espnow_bench_radio_borrowed() ?
+                               espnow_peers_contains(send_cb->mac_addr) :
+                               espnow_peers_record_send(send_cb->mac_addr, send_cb->status == ESP_NOW_SEND_SUCCESS);
+            }
+            
+            // Wake the device discovery task waiting for this send
+            if ((is_discovery_broadcast || is_peer_poll) && espnow_notify_discovery(DISCOVERY_NOTIFY_SEND_DONE)) {
+                ESP_LOGD(TAG, "🔍 Discovery send callback: %s", 
+                         (send_cb->status == ESP_NOW_SEND_SUCCESS) ? "SUCCESS" : "FAILED");
+            }
+            
+            // Update send statistics
+            if (send_cb->status == ESP_NOW_SEND_SUCCESS) {
+                ESPNOW_STAT_UPDATE(s_counters.packets_sent++; s_counters.send_success++);
+            } else {
+                ESPNOW_STAT_INC(send_failed);
+            }
+            
+            // Notify subscribed pages of send statistics update
+            ui_notify_publish(UI_TOPIC_ESPNOW_STATS);
+            
+            ESP_LOGD(TAG, "📤 Send callback: "MACSTR", status: %d", 
+                     MAC2STR(send_cb->mac_addr), send_cb->status);
+        }
+        
+        // Drain received frames in batches, processing the slots in place
+        int batch_count;
+        while ((batch_count = espnow_recv_decode_batch(s_batch, ESPNOW_RX_BATCH_SIZE)) > 0) {
+            int stored = store_device_tlv_batch(s_batch, batch_count);
+            for (int i = 0; i < batch_count; i++) {
+                if (s_batch[i].entry_count > 0) {
+                    latency_trace_stamp(LATENCY_STAGE_STORE, s_batch[i].trace_id);
+                    espnow_peers_heard(s_batch[i].info->mac_addr, s_batch[i].info->rssi);
                 }
-                
-                // Notify ESP-NOW page of send statistics update
-                espnow_page_notify_data_update();
-                
-                ESP_LOGD(TAG, "📤 Send callback: "MACSTR", status: %d", 
-                         MAC2STR(send_cb->mac_addr), send_cb->status);
-                break;
             }
-            case EXAMPLE_ESPNOW_RECV_CB:
-            {
-                example_espnow_event_recv_cb_t *recv_cb = &evt.info.recv_cb;
-                
-                // Print raw data for debugging
-                ESP_LOGI(TAG, "📦 Raw data from "MACSTR" (len=%d):", MAC2STR(recv_cb->mac_addr), recv_cb->data_len);
-                ESP_LOGI(TAG, "   Received via %s", recv_cb->is_broadcast ? "BROADCAST" : "UNICAST");
-                ESP_LOGI(TAG, "   rssi: %d dBm, 11bg: %d, 11n: %d, 11ac: %d", recv_cb->rssi, recv_cb->rate_11bg, recv_cb->rate_11n, recv_cb->rate_11ac);
-                ESP_LOG_BUFFER_HEX(TAG, recv_cb->data, recv_cb->data_len);
-                
-                int parse_result = espnow_data_parse(recv_cb->data, recv_cb->data_len, &recv_state, &recv_seq, &recv_magic);
-                
-                // If TLV data was successfully parsed, store it indexed by MAC address
-                if (parse_result > 0) {
-                    ESP_LOGI(TAG, "✅ TLV data parsed successfully (%d entries), storing for device " MACSTR, 
-                             parse_result, MAC2STR(recv_cb->mac_addr));
-                    
-                    // Process and store the TLV data using MAC address as index (with RSSI)
-                    process_received_tlv_data(recv_cb->mac_addr, recv_cb->data, recv_cb->data_len, recv_cb->rssi);
-                } else {
-                    ESP_LOGW(TAG, "⚠️ TLV parsing failed or no valid TLV data found");
+            if (stored > 0 && TLV_DEBUG_DUMP_ENABLED()) {
+                print_batch_tlv_info(s_batch, batch_count);
+            }
+            
+            // Hand the slots back to the Wi-Fi callback
+            espnow_rx_ring_release(batch_count);
+            
+            ESPNOW_STAT_INC(rx_batches);
+            ESPNOW_STAT_MAX(rx_batch_max, (uint32_t)batch_count);
+            
+            // Trigger LED animation on packet reception (rate limited by ux_service)
+            espnow_trigger_led_animation();
+            
+            // Notify subscribed pages of counter and device table updates, once per batch
+            ui_notify_publish(UI_TOPIC_ESPNOW_STATS | UI_TOPIC_ESPNOW_DEVICES);
+            for (int i = 0; i < batch_count; i++) {
+                if (s_batch[i].entry_count > 0) {
+                    latency_trace_publish(s_batch[i].trace_id);
                 }
-                
-                free(recv_cb->data);
-                
-                // Notify ESP-NOW page of updates
-                espnow_page_notify_data_update();
-                break;
             }
-            default:
-                ESP_LOGE(TAG, "Callback type error: %d", evt.id);
-                break;
         }
+        
+        // Sleep until a callback publishes more work (drained once first to catch early frames)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
     
     ESP_LOGI(TAG, "📥 ESP-NOW Receive-only task ending");
     if (recv_param) {
-        free(recv_param);
+        mem_account_free(MEM_MODULE_ESPNOW, recv_param);
     }
+    atomic_store(&s_recv_task_handle, NULL);
     vTaskDelete(NULL);
 }
 
 // ===== LED ANIMATION INTEGRATION =====
 
 /**
- * @brief Trigger LED animation with rate limiting
+ * @brief Trigger LED animation on packet reception
  * 
  * Sends a LED animation request to ux_service when ESP-NOW packets are received.
- * Rate limited to once per second to avoid excessive blinking.
+ * The service rate limits identical fast blinks, so bursts don't cause excessive blinking.
  */
 static void espnow_trigger_led_animation(void)
 {
-    static TickType_t s_last_led_animation_time = 0;  // Function-local static variable
-    TickType_t current_time = xTaskGetTickCount();
-    TickType_t time_diff = current_time - s_last_led_animation_time;
+    if (!boot_timeline_reached(BOOT_STAGE_UX)) {
+        return;  // The LED service starts after the first frame; the radio may be up earlier
+    }
     
-    // Check if enough time has passed since last animation (1 second)
-    if (time_diff >= pdMS_TO_TICKS(LED_ANIMATION_INTERVAL_MS)) {
-        // Send LED blink animation to UX service
-        esp_err_t ret = ux_led_blink_fast(500);  // Fast blink for 500ms
-        if (ret == ESP_OK) {
-            s_last_led_animation_time = current_time;
-            ESP_LOGD(TAG, "🔴 LED animation triggered on ESP-NOW packet reception");
-        } else {
-            ESP_LOGW(TAG, "Failed to trigger LED animation: %s", esp_err_to_name(ret));
-        }
-    } else {
-        // Rate limited - too soon since last animation
-        uint32_t remaining_ms = pdTICKS_TO_MS(pdMS_TO_TICKS(LED_ANIMATION_INTERVAL_MS) - time_diff);
-        ESP_LOGD(TAG, "🔴 LED animation rate limited (wait %lu ms)", remaining_ms);
+    esp_err_t ret = ux_led_blink_fast(500);  // Fast blink for 500ms
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to trigger LED animation: %s", esp_err_to_name(ret));
     }
 }
 
@@ -1206,20 +1852,73 @@ static esp_err_t tlv_storage_init(void)
         return ESP_FAIL;
     }
     
-    // Initialize all device storage slots
+    // Initialize all device storage slots and chain them into the free list
     for (int i = 0; i < MAX_TLV_DEVICES; i++) {
         memset(&g_tlv_devices[i], 0, sizeof(device_tlv_storage_t));
         g_tlv_devices[i].in_use = false;
         g_tlv_devices[i].entry_count = 0;
+        g_tlv_devices[i].next_slot = (i + 1 < MAX_TLV_DEVICES) ? (int16_t)(i + 1) : -1;
+        g_tlv_devices[i].prev_slot = -1;
         
-        // Initialize all TLV entries as invalid
-        for (int j = 0; j < MAX_TLV_ENTRIES_PER_DEVICE; j++) {
-            g_tlv_devices[i].tlv_entries[j].valid = false;
+        // Generations survive a restart so readers notice the emptied slots
+        if (g_tlv_slot_generation[i] != 0) {
+            g_tlv_slot_generation[i] = ++g_tlv_generation;
         }
     }
+    memset(g_tlv_numeric, 0, sizeof(g_tlv_numeric));
+    mem_account_set_static(MEM_MODULE_TLV_TABLE, sizeof(g_tlv_devices) + sizeof(g_tlv_numeric) +
+                           sizeof(g_tlv_hash_keys) + sizeof(g_tlv_hash_slots) +
+                           sizeof(g_tlv_slot_generation) + sizeof(g_node_wheel));
+    g_tlv_free_head = 0;
+    g_tlv_used_head = -1;
+    g_tlv_used_count = 0;
+    
+    // Empty aging wheel and LRU list
+    for (int i = 0; i < NODE_WHEEL_SIZE; i++) {
+        g_node_wheel[i] = -1;
+    }
+    g_node_wheel_s = node_aging_now_s();
+    g_node_lru_head = -1;
+    g_node_lru_tail = -1;
+    g_node_online_count = 0;
+    node_counts_publish_locked();
+    
+    // Clear the MAC hash index
+    for (int i = 0; i < TLV_HASH_SIZE; i++) {
+        g_tlv_hash_slots[i] = TLV_HASH_EMPTY;
+        g_tlv_hash_keys[i] = 0;
+    }
+    
+    // Build the TLV type -> descriptor map
+    tlv_codec_init();
+    
+    ESP_LOGI(TAG, "✅ TLV storage initialized (max %d devices, %d hash buckets)", 
+             MAX_TLV_DEVICES, TLV_HASH_SIZE);
+    ESP_LOGI(TAG, "📏 TLV storage footprint: %u bytes/node (was %u), %u bytes total for %d nodes",
+             (unsigned)TLV_BYTES_PER_DEVICE, (unsigned)TLV_LEGACY_BYTES_PER_DEVICE,
+             (unsigned)(TLV_BYTES_PER_DEVICE * MAX_TLV_DEVICES), MAX_TLV_DEVICES);
+    
+    // Trends are optional: the table works without them
+    esp_err_t ret = node_history_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Node history unavailable: %s", esp_err_to_name(ret));
+    }
     
-    ESP_LOGI(TAG, "✅ TLV storage initialized (max %d devices, %d entries each)", 
-             MAX_TLV_DEVICES, MAX_TLV_ENTRIES_PER_DEVICE);
+    // Online/offline aging, 1 Hz
+    const esp_timer_create_args_t aging_args = {
+        .callback = node_aging_timer_cb,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "espnow_aging",
+    };
+    ret = esp_timer_create(&aging_args, &s_node_aging_timer);
+    if (ret == ESP_OK) {
+        ret = esp_timer_start_periodic(s_node_aging_timer, 1000000);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start node aging timer: %s", esp_err_to_name(ret));
+        tlv_storage_deinit();
+        return ret;
+    }
     return ESP_OK;
 }
 
@@ -1230,6 +1929,13 @@ static void tlv_storage_deinit(void)
 {
     ESP_LOGI(TAG, "🗂️ Deinitializing TLV device storage");
     
+    if (s_node_aging_timer != NULL) {
+        esp_timer_stop(s_node_aging_timer);
+        esp_timer_delete(s_node_aging_timer);
+        s_node_aging_timer = NULL;
+    }
+    node_history_deinit();
+    
     if (g_tlv_mutex != NULL) {
         vSemaphoreDelete(g_tlv_mutex);
         g_tlv_mutex = NULL;
@@ -1237,14 +1943,207 @@ static void tlv_storage_deinit(void)
     
     // Clear all storage
     memset(g_tlv_devices, 0, sizeof(g_tlv_devices));
+    memset(g_tlv_numeric, 0, sizeof(g_tlv_numeric));
+    for (int i = 0; i < TLV_HASH_SIZE; i++) {
+        g_tlv_hash_slots[i] = TLV_HASH_EMPTY;
+    }
+    g_tlv_used_head = -1;
+    g_tlv_free_head = -1;
+    g_tlv_used_count = 0;
+    g_node_lru_head = -1;
+    g_node_lru_tail = -1;
+    g_node_online_count = 0;
+    for (int i = 0; i < NODE_WHEEL_SIZE; i++) {
+        g_node_wheel[i] = -1;
+    }
     
     ESP_LOGI(TAG, "✅ TLV storage deinitialized");
 }
 
+/**
+ * @brief Find (or allocate) the extra blob slot holding an unknown TLV type
+ * @return Blob slot index, or -1 if not found / no free slot
+ */
+static int tlv_extra_blob_slot(device_tlv_storage_t *device, uint8_t type, bool create)
+{
+    int free_slot = -1;
+    for (int i = TLV_BLOB_KNOWN_COUNT; i < TLV_BLOB_SLOT_COUNT; i++) {
+        if (device->blob_present & (1U << i)) {
+            if (device->blobs[i].type == type) {
+                return i;
+            }
+        } else if (free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    return create ? free_slot : -1;
+}
+
+/**
+ * @brief Store a byte-string TLV value into the device arena
+ * 
+ * A value that fits the slot's current reservation is rewritten in place,
+ * so periodic updates of the same string do not consume arena space.
+ * Otherwise it is appended; if the arena is exhausted, live values are
+ * compacted to the front first.
+ * 
+ * @return true if stored, false if the arena cannot hold the value
+ */
+static bool tlv_blob_store(device_tlv_storage_t *device, int blob_index, uint8_t type, const uint8_t *value, uint8_t length)
+{
+    tlv_blob_ref_t *ref = &device->blobs[blob_index];
+    uint8_t bit = (uint8_t)(1U << blob_index);
+    
+    if ((device->blob_present & bit) && length <= ref->capacity) {
+        memcpy(&device->arena[ref->offset], value, length);
+        ref->length = length;
+        return true;
+    }
+    
+    if (device->arena_used + length > TLV_BLOB_ARENA_SIZE) {
+        // Check the value fits once the stale copy and any holes are reclaimed
+        size_t live = 0;
+        for (int i = 0; i < TLV_BLOB_SLOT_COUNT; i++) {
+            if (i != blob_index && (device->blob_present & (1U << i))) {
+                live += device->blobs[i].length;
+            }
+        }
+        if (live + length > TLV_BLOB_ARENA_SIZE) {
+            return false;
+        }
+        
+        uint8_t compacted[TLV_BLOB_ARENA_SIZE];
+        uint8_t used = 0;
+        device->blob_present &= (uint8_t)~bit;
+        for (int i = 0; i < TLV_BLOB_SLOT_COUNT; i++) {
+            if (device->blob_present & (1U << i)) {
+                tlv_blob_ref_t *live_ref = &device->blobs[i];
+                memcpy(&compacted[used], &device->arena[live_ref->offset], live_ref->length);
+                live_ref->offset = used;
+                live_ref->capacity = live_ref->length;
+                used += live_ref->length;
+            }
+        }
+        memcpy(device->arena, compacted, used);
+        device->arena_used = used;
+    }
+    
+    ref->type = type;
+    ref->offset = device->arena_used;
+    ref->length = length;
+    ref->capacity = length;
+    memcpy(&device->arena[ref->offset], value, length);
+    device->arena_used += length;
+    device->blob_present |= bit;
+    return true;
+}
+
+/**
+ * @brief Write a decoded entry into its espnow_device_info_t target field
+ */
+static void tlv_apply_to_info(const tlv_decoded_entry_t *entry, espnow_device_info_t *info)
+{
+    const tlv_field_desc_t *desc = entry->desc;
+    const tlv_info_target_t *field = tlv_info_target(desc);
+    uint8_t *target = (uint8_t *)info + field->offset;
+    
+    switch (field->kind) {
+        case TLV_INFO_U16: {
+            uint16_t value = (uint16_t)entry->raw;
+            memcpy(target, &value, sizeof(value));
+            break;
+        }
+        case TLV_INFO_U32: {
+            uint32_t value = (desc->scale == 1.0f) ? entry->raw : (uint32_t)tlv_codec_scaled_value(desc, entry->raw);
+            memcpy(target, &value, sizeof(value));
+            break;
+        }
+        case TLV_INFO_FLOAT: {
+            float value = tlv_codec_scaled_value(desc, entry->raw);
+            memcpy(target, &value, sizeof(value));
+            break;
+        }
+        case TLV_INFO_STRING:
+            if (entry->length > 0 && entry->length < field->size) {
+                memcpy(target, entry->value, entry->length);
+                target[entry->length] = '\0';
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Build a decoded-entry view of a field stored for a device
+ * @return true if the device holds a value for desc
+ */
+static bool tlv_device_entry(const device_tlv_storage_t *device, const tlv_field_desc_t *desc, tlv_decoded_entry_t *entry)
+{
+    memset(entry, 0, sizeof(*entry));
+    entry->desc = desc;
+    entry->type = desc->type;
+    entry->valid = true;
+    
+    if (TLV_ENC_IS_NUMERIC(desc->encoding)) {
+        if (!(device->numeric_present & (1UL << desc->index))) {
+            return false;
+        }
+        entry->raw = g_tlv_numeric[desc->index][device - g_tlv_devices];
+        entry->length = desc->size;
+        return true;
+    }
+    
+    if (!(device->blob_present & (1U << desc->index))) {
+        return false;
+    }
+    const tlv_blob_ref_t *ref = &device->blobs[desc->index];
+    entry->value = &device->arena[ref->offset];
+    entry->length = ref->length;
+    return true;
+}
+
+/**
+ * @brief Log one line per decoded TLV (debug pretty-printer)
+ */
+static void tlv_dump_entries(const tlv_decoded_entry_t *entries, int count)
+{
+    char value_str[128];
+    for (int i = 0; i < count; i++) {
+        tlv_codec_format_entry(&entries[i], value_str, sizeof(value_str));
+        ESP_LOGD(TAG, "📋 TLV #%d @%u: Type=0x%02X (%s), Len=%d, %s", 
+                 i + 1, entries[i].offset, entries[i].type, tlv_codec_type_name(entries[i].type),
+                 entries[i].length, value_str);
+    }
+}
+
+/**
+ * @brief Pack a 6-byte MAC address into a 48-bit integer key
+ */
+static uint64_t mac_to_key(const uint8_t *mac_addr)
+{
+    return ((uint64_t)mac_addr[0] << 40) | ((uint64_t)mac_addr[1] << 32) |
+           ((uint64_t)mac_addr[2] << 24) | ((uint64_t)mac_addr[3] << 16) |
+           ((uint64_t)mac_addr[4] << 8)  |  (uint64_t)mac_addr[5];
+}
+
+/**
+ * @brief Home bucket of a MAC key (Fibonacci hashing)
+ * 
+ * ESP-NOW senders from one vendor share the OUI, so the multiply spreads
+ * the changing low bytes across the whole bucket range.
+ */
+static uint32_t tlv_hash_bucket(uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (TLV_HASH_SIZE - 1);
+}
+
 /**
  * @brief Find device storage by MAC address
  * @param mac_addr MAC address to search for
  * @return Pointer to device storage or NULL if not found
+ * 
+ * Caller must hold g_tlv_mutex. Expected O(1) via the MAC hash index.
  */
 static device_tlv_storage_t* find_device_by_mac(const uint8_t *mac_addr)
 {
@@ -1252,11 +2151,15 @@ static device_tlv_storage_t* find_device_by_mac(const uint8_t *mac_addr)
         return NULL;
     }
     
-    for (int i = 0; i < MAX_TLV_DEVICES; i++) {
-        if (g_tlv_devices[i].in_use && 
-            memcmp(g_tlv_devices[i].mac_address, mac_addr, ESP_NOW_ETH_ALEN) == 0) {
-            return &g_tlv_devices[i];
+    uint64_t key = mac_to_key(mac_addr);
+    uint32_t bucket = tlv_hash_bucket(key);
+    
+    // Linear probe until the key or an empty bucket is found (table is never more than half full)
+    while (g_tlv_hash_slots[bucket] != TLV_HASH_EMPTY) {
+        if (g_tlv_hash_keys[bucket] == key) {
+            return &g_tlv_devices[g_tlv_hash_slots[bucket]];
         }
+        bucket = (bucket + 1) & (TLV_HASH_SIZE - 1);
     }
     
     return NULL;
@@ -1266,6 +2169,10 @@ static device_tlv_storage_t* find_device_by_mac(const uint8_t *mac_addr)
  * @brief Get existing device or create new device storage slot
  * @param mac_addr MAC address of the device
  * @return Pointer to device storage or NULL if no space available
+ * 
+ * Caller must hold g_tlv_mutex. A new device takes the head of the free
+ * list, is linked into the in-use list in slot order and added to the
+ * hash index.
  */
 static device_tlv_storage_t* get_or_create_device(const uint8_t *mac_addr)
 {
@@ -1279,55 +2186,338 @@ static device_tlv_storage_t* get_or_create_device(const uint8_t *mac_addr)
         return device;
     }
     
-    // Look for an empty slot
-    for (int i = 0; i < MAX_TLV_DEVICES; i++) {
-        if (!g_tlv_devices[i].in_use) {
-            // Initialize new device slot
-            memset(&g_tlv_devices[i], 0, sizeof(device_tlv_storage_t));
-            memcpy(g_tlv_devices[i].mac_address, mac_addr, ESP_NOW_ETH_ALEN);
-            g_tlv_devices[i].in_use = true;
-            g_tlv_devices[i].entry_count = 0;
-            g_tlv_devices[i].last_seen = xTaskGetTickCount();
-            g_tlv_devices[i].rssi = -100; // Initialize with weak signal until actual reception
-            
-            // Initialize all TLV entries as invalid
-            for (int j = 0; j < MAX_TLV_ENTRIES_PER_DEVICE; j++) {
-                g_tlv_devices[i].tlv_entries[j].valid = false;
-            }
-            
-            // Generate friendly device name
-            snprintf(g_tlv_devices[i].device_name, sizeof(g_tlv_devices[i].device_name),
-                     "ESP-" MACSTR, MAC2STR(mac_addr));
-            
-            ESP_LOGI(TAG, "📋 Created new device storage: %s", g_tlv_devices[i].device_name);
-            return &g_tlv_devices[i];
+    // Table full: reclaim the least recently seen node if it has gone offline
+    if (g_tlv_free_head < 0 && g_node_lru_head >= 0 && !g_tlv_devices[g_node_lru_head].online) {
+        node_evict_locked(g_node_lru_head);
+    }
+    
+    // Take a slot from the free list
+    if (g_tlv_free_head < 0) {
+        ESP_LOGW(TAG, "⚠️ No space available for new device " MACSTR " (all nodes online)", MAC2STR(mac_addr));
+        return NULL;
+    }
+    
+    int slot = g_tlv_free_head;
+    device = &g_tlv_devices[slot];
+    g_tlv_free_head = device->next_slot;
+    
+    // Initialize new device slot
+    memset(device, 0, sizeof(device_tlv_storage_t));
+    memcpy(device->mac_address, mac_addr, ESP_NOW_ETH_ALEN);
+    device->in_use = true;
+    device->entry_count = 0;
+    device->last_seen = xTaskGetTickCount();
+    device->rssi = -100; // Initialize with weak signal until actual reception
+    device->lru_next = device->lru_prev = -1;
+    device->wheel_next = device->wheel_prev = -1;
+    for (int f = 0; f < TLV_NUM_FIELD_COUNT; f++) {
+        g_tlv_numeric[f][slot] = 0;
+    }
+    
+    // Link into the in-use list, kept sorted by slot index for circular navigation
+    int prev = -1;
+    int next = g_tlv_used_head;
+    while (next >= 0 && next < slot) {
+        prev = next;
+        next = g_tlv_devices[next].next_slot;
+    }
+    device->prev_slot = (int16_t)prev;
+    device->next_slot = (int16_t)next;
+    if (prev >= 0) {
+        g_tlv_devices[prev].next_slot = (int16_t)slot;
+    } else {
+        g_tlv_used_head = (int16_t)slot;
+    }
+    if (next >= 0) {
+        g_tlv_devices[next].prev_slot = (int16_t)slot;
+    }
+    g_tlv_used_count++;
+    node_lru_append(slot);
+    node_counts_publish_locked();
+    
+    // Add to the hash index
+    uint64_t key = mac_to_key(mac_addr);
+    uint32_t bucket = tlv_hash_bucket(key);
+    while (g_tlv_hash_slots[bucket] != TLV_HASH_EMPTY) {
+        bucket = (bucket + 1) & (TLV_HASH_SIZE - 1);
+    }
+    g_tlv_hash_keys[bucket] = key;
+    g_tlv_hash_slots[bucket] = (int16_t)slot;
+    
+    // Generate friendly device name
+    snprintf(device->device_name, sizeof(device->device_name),
+             "ESP-" MACSTR, MAC2STR(mac_addr));
+    
+    ESP_LOGI(TAG, "📋 Created new device storage: %s (slot %d)", device->device_name, slot);
+    return device;
+}
+
+// ===== NODE AGING =====
+
+/**
+ * @brief Publish the node counts for espnow_manager_get_stats() (g_tlv_mutex held)
+ */
+static void node_counts_publish_locked(void)
+{
+    espnow_node_counts_t counts = {
+        .online_nodes = g_node_online_count,
+        .used_nodes = g_tlv_used_count,
+    };
+    // g_tlv_mutex serializes the seqlock writers
+    seqlock_write_copy(&s_node_counts_lock, &s_node_counts, &counts, sizeof(counts));
+}
+
+static void node_event_emit_locked(int slot, espnow_node_event_t event)
+{
+    static const char *const names[] = { "online", "offline", "evicted" };
+    ESP_LOGI(TAG, "📶 Node %s %s (slot %d)", g_tlv_devices[slot].device_name, names[event], slot);
+    if (s_node_event_cb != NULL) {
+        s_node_event_cb(g_tlv_devices[slot].mac_address, slot, event, s_node_event_ctx);
+    }
+}
+
+static void node_wheel_unlink(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
+    if (device->wheel_prev >= 0) {
+        g_tlv_devices[device->wheel_prev].wheel_next = device->wheel_next;
+    } else {
+        g_node_wheel[device->expiry_s % NODE_WHEEL_SIZE] = device->wheel_next;
+    }
+    if (device->wheel_next >= 0) {
+        g_tlv_devices[device->wheel_next].wheel_prev = device->wheel_prev;
+    }
+    device->wheel_next = -1;
+    device->wheel_prev = -1;
+}
+
+static void node_wheel_link(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
+    int16_t *head = &g_node_wheel[device->expiry_s % NODE_WHEEL_SIZE];
+    device->wheel_prev = -1;
+    device->wheel_next = *head;
+    if (*head >= 0) {
+        g_tlv_devices[*head].wheel_prev = (int16_t)slot;
+    }
+    *head = (int16_t)slot;
+}
+
+static void node_lru_unlink(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
+    if (device->lru_prev >= 0) {
+        g_tlv_devices[device->lru_prev].lru_next = device->lru_next;
+    } else {
+        g_node_lru_head = device->lru_next;
+    }
+    if (device->lru_next >= 0) {
+        g_tlv_devices[device->lru_next].lru_prev = device->lru_prev;
+    } else {
+        g_node_lru_tail = device->lru_prev;
+    }
+    device->lru_next = -1;
+    device->lru_prev = -1;
+}
+
+static void node_lru_append(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
+    device->lru_prev = g_node_lru_tail;
+    device->lru_next = -1;
+    if (g_node_lru_tail >= 0) {
+        g_tlv_devices[g_node_lru_tail].lru_next = (int16_t)slot;
+    } else {
+        g_node_lru_head = (int16_t)slot;
+    }
+    g_node_lru_tail = (int16_t)slot;
+}
+
+/**
+ * @brief Record a frame from a node: re-arm its expiry and mark it most recently seen (g_tlv_mutex held)
+ * 
+ * O(1): the node moves to the wheel bucket of its new expiry and to the LRU tail.
+ */
+static void node_mark_seen_locked(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
+    
+    // Every in-use node is in the LRU list, only online nodes are in the wheel
+    if (device->online) {
+        node_wheel_unlink(slot);
+    }
+    node_lru_unlink(slot);
+    device->expiry_s = node_aging_now_s() + NODE_ONLINE_TIMEOUT_S;
+    node_wheel_link(slot);
+    node_lru_append(slot);
+    
+    if (!device->online) {
+        device->online = true;
+        g_node_online_count++;
+        node_counts_publish_locked();
+        node_event_emit_locked(slot, ESPNOW_NODE_ONLINE);
+    }
+}
+
+/**
+ * @brief Remove a MAC key from the hash index (backward-shift deletion, g_tlv_mutex held)
+ */
+static void tlv_hash_remove(uint64_t key)
+{
+    uint32_t hole = tlv_hash_bucket(key);
+    while (g_tlv_hash_slots[hole] != TLV_HASH_EMPTY && g_tlv_hash_keys[hole] != key) {
+        hole = (hole + 1) & (TLV_HASH_SIZE - 1);
+    }
+    if (g_tlv_hash_slots[hole] == TLV_HASH_EMPTY) {
+        return;
+    }
+    g_tlv_hash_slots[hole] = TLV_HASH_EMPTY;
+    
+    // Pull later entries of the probe run back so lookups never stop at the hole early
+    uint32_t next = (hole + 1) & (TLV_HASH_SIZE - 1);
+    while (g_tlv_hash_slots[next] != TLV_HASH_EMPTY) {
+        uint32_t home = tlv_hash_bucket(g_tlv_hash_keys[next]);
+        // Movable unless its home lies cyclically in (hole, next]
+        bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            g_tlv_hash_keys[hole] = g_tlv_hash_keys[next];
+            g_tlv_hash_slots[hole] = g_tlv_hash_slots[next];
+            g_tlv_hash_slots[next] = TLV_HASH_EMPTY;
+            hole = next;
         }
+        next = (next + 1) & (TLV_HASH_SIZE - 1);
     }
+}
+
+/**
+ * @brief Drop an offline node and return its slot to the free list (g_tlv_mutex held)
+ */
+static void node_evict_locked(int slot)
+{
+    device_tlv_storage_t *device = &g_tlv_devices[slot];
     
-    ESP_LOGW(TAG, "⚠️ No space available for new device " MACSTR, MAC2STR(mac_addr));
-    return NULL;
+    node_event_emit_locked(slot, ESPNOW_NODE_EVICTED);
+    ESPNOW_STAT_INC(nodes_evicted);
+    device_store_mark_dirty(DEVICE_STORE_DIRTY_IDENTITY);
+    
+    node_lru_unlink(slot);
+    tlv_hash_remove(mac_to_key(device->mac_address));
+    
+    // Unlink from the sorted in-use list
+    if (device->prev_slot >= 0) {
+        g_tlv_devices[device->prev_slot].next_slot = device->next_slot;
+    } else {
+        g_tlv_used_head = device->next_slot;
+    }
+    if (device->next_slot >= 0) {
+        g_tlv_devices[device->next_slot].prev_slot = device->prev_slot;
+    }
+    g_tlv_used_count--;
+    
+    device->in_use = false;
+    device->next_slot = g_tlv_free_head;
+    device->prev_slot = -1;
+    g_tlv_free_head = (int16_t)slot;
+    
+    g_tlv_slot_generation[slot] = ++g_tlv_generation;
+    node_counts_publish_locked();
+}
+
+/**
+ * @brief Expire the wheel buckets of one second (g_tlv_mutex held)
+ * @return true if a node went offline
+ */
+static bool node_wheel_expire_locked(uint32_t second, uint32_t now_s)
+{
+    bool changed = false;
+    int slot = g_node_wheel[second % NODE_WHEEL_SIZE];
+    
+    while (slot >= 0) {
+        device_tlv_storage_t *device = &g_tlv_devices[slot];
+        int next = device->wheel_next;
+        // Entries more than one wheel turn away share the bucket and stay
+        if ((int32_t)(device->expiry_s - now_s) <= 0) {
+            node_wheel_unlink(slot);
+            device->online = false;
+            g_node_online_count--;
+            g_tlv_slot_generation[slot] = ++g_tlv_generation;
+            node_event_emit_locked(slot, ESPNOW_NODE_OFFLINE);
+            changed = true;
+        }
+        slot = next;
+    }
+    return changed;
+}
+
+/**
+ * @brief Aging timer (esp_timer task, 1 Hz): advance the wheel to now
+ * 
+ * Only the buckets of the elapsed seconds are visited. If the table is busy the
+ * tick is skipped and the next one catches up.
+ */
+static void node_aging_timer_cb(void *arg)
+{
+    if (g_tlv_mutex == NULL || xSemaphoreTake(g_tlv_mutex, 0) != pdTRUE) {
+        return;
+    }
+    
+    uint32_t now_s = node_aging_now_s();
+    uint32_t elapsed = now_s - g_node_wheel_s;
+    if (elapsed > NODE_WHEEL_SIZE) {
+        // Visit every bucket once after a long stall
+        g_node_wheel_s = now_s - NODE_WHEEL_SIZE;
+    }
+    
+    bool changed = false;
+    while (g_node_wheel_s != now_s) {
+        g_node_wheel_s++;
+        changed |= node_wheel_expire_locked(g_node_wheel_s, now_s);
+    }
+    
+    if (changed) {
+        node_counts_publish_locked();
+    }
+    xSemaphoreGive(g_tlv_mutex);
+    
+    if (changed) {
+        ui_notify_publish(UI_TOPIC_ESPNOW_STATS | UI_TOPIC_ESPNOW_DEVICES);
+    }
+}
+
+/**
+ * @brief Map a numeric field to the node history metric it feeds
+ * @return node_history_metric_t, or -1 if the field has no history
+ */
+static int tlv_history_metric(uint8_t numeric_index)
+{
+    switch (numeric_index) {
+        case TLV_NUM_AC_POWER:
+            return NODE_HISTORY_AC_POWER;
+        case TLV_NUM_AC_VOLTAGE:
+            return NODE_HISTORY_AC_VOLTAGE;
+        case TLV_NUM_TEMPERATURE:
+            return NODE_HISTORY_TEMPERATURE;
+        default:
+            return -1;
+    }
 }
 
 /**
- * @brief Store TLV data for a specific device
+ * @brief Store decoded TLV entries for a specific device (g_tlv_mutex held)
  * @param mac_addr MAC address of the device
- * @param tlv_data TLV data buffer
- * @param data_len Length of TLV data
+ * @param entries Entries produced by tlv_codec_decode()
+ * @param count Number of entries
  * @param rssi RSSI value from ESP-NOW reception
+ * @param live false for a node restored from NVS: it stays offline, adds no history and is not persisted again
  * @return ESP_OK on success, ESP_FAIL on error
  */
-static esp_err_t store_device_tlv_data(const uint8_t *mac_addr, const uint8_t *tlv_data, size_t data_len, int8_t rssi)
+static esp_err_t store_device_tlv_locked(const uint8_t *mac_addr, const tlv_decoded_entry_t *entries, int count,
+                                         int8_t rssi, bool live)
 {
-    if (mac_addr == NULL || tlv_data == NULL || data_len == 0 || g_tlv_mutex == NULL) {
+    if (mac_addr == NULL || entries == NULL || count <= 0) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Take mutex for thread safety
-    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-        ESP_LOGE(TAG, "Failed to take TLV storage mutex");
-        return ESP_ERR_TIMEOUT;
-    }
-    
     esp_err_t result = ESP_OK;
     
     do {
@@ -1343,88 +2533,245 @@ static esp_err_t store_device_tlv_data(const uint8_t *mac_addr, const uint8_t *t
         device->last_seen = xTaskGetTickCount();
         device->rssi = rssi;  // Store the actual RSSI from ESP-NOW reception
         
-        // Parse TLV data and store individual entries
-        size_t offset = 0;
+        int slot = (int)(device - g_tlv_devices);
+        if (live) {
+            node_mark_seen_locked(slot);
+        }
+        bool identity_changed = (device->entry_count == 0);  // New node
         int stored_entries = 0;
+        float history_values[NODE_HISTORY_METRIC_COUNT];
+        uint32_t history_mask = 0;
         
-        while (offset < data_len && stored_entries < MAX_TLV_ENTRIES_PER_DEVICE) {
-            // Check if we have at least 2 bytes for type and length
-            if (offset + 2 > data_len) {
-                ESP_LOGW(TAG, "Insufficient data for TLV header at offset %zu", offset);
-                break;
-            }
-            
-            uint8_t type = tlv_data[offset];
-            uint8_t length = tlv_data[offset + 1];
-            
-            // Validate TLV entry bounds
-            size_t total_entry_size = TLV_TOTAL_SIZE(length);
-            if (offset + total_entry_size > data_len) {
-                ESP_LOGE(TAG, "TLV entry exceeds buffer bounds");
-                break;
-            }
+        for (int i = 0; i < count; i++) {
+            const tlv_decoded_entry_t *entry = &entries[i];
+            const tlv_field_desc_t *desc = entry->desc;
             
-            // Check if value fits in our storage
-            if (length > MAX_TLV_ENTRY_VALUE_SIZE) {
-                ESP_LOGW(TAG, "TLV value too large (type=0x%02X, len=%d), skipping", type, length);
-                offset += total_entry_size;
+            if (!entry->valid) {
+                ESP_LOGW(TAG, "TLV type 0x%02X has length %d, expected %d, skipping", 
+                         entry->type, entry->length, desc->size);
                 continue;
             }
             
-            // Find existing entry with same type or get empty slot
-            stored_tlv_entry_t *entry = NULL;
-            
-            // First, look for existing entry with same type (update)
-            for (int i = 0; i < MAX_TLV_ENTRIES_PER_DEVICE; i++) {
-                if (device->tlv_entries[i].valid && device->tlv_entries[i].type == type) {
-                    entry = &device->tlv_entries[i];
-                    break;
+            if (desc != NULL && TLV_ENC_IS_NUMERIC(desc->encoding)) {
+                // Fixed-size numeric: already in host order
+                g_tlv_numeric[desc->index][slot] = entry->raw;
+                uint32_t bit = 1UL << desc->index;
+                if (!(device->numeric_present & bit)) {
+                    device->numeric_present |= bit;
+                    device->entry_count++;
+                }
+                stored_entries++;
+                
+                int metric = tlv_history_metric(desc->index);
+                if (metric >= 0) {
+                    history_values[metric] = tlv_codec_scaled_value(desc, entry->raw);
+                    history_mask |= 1UL << metric;
                 }
+                continue;
             }
             
-            // If not found, look for empty slot (new entry)
-            if (entry == NULL) {
-                for (int i = 0; i < MAX_TLV_ENTRIES_PER_DEVICE; i++) {
-                    if (!device->tlv_entries[i].valid) {
-                        entry = &device->tlv_entries[i];
-                        device->entry_count++;
-                        break;
-                    }
+            // Variable-length string or byte data: copy into the device arena
+            int blob_index;
+            if (desc != NULL) {
+                blob_index = desc->index;
+            } else {
+                if (entry->length > TLV_MAX_EXTRA_BLOB_SIZE) {
+                    ESP_LOGW(TAG, "TLV value too large (type=0x%02X, len=%d), skipping", entry->type, entry->length);
+                    continue;
+                }
+                blob_index = tlv_extra_blob_slot(device, entry->type, true);
+                if (blob_index < 0) {
+                    ESP_LOGW(TAG, "No space for TLV type 0x%02X", entry->type);
+                    continue;
                 }
             }
             
-            if (entry == NULL) {
-                ESP_LOGW(TAG, "No space for TLV type 0x%02X", type);
-                offset += total_entry_size;
+            bool was_present = (device->blob_present & (1U << blob_index)) != 0;
+            if (desc != NULL && !identity_changed) {
+                // Device ID, firmware and the like: persisted soon after a change
+                const tlv_blob_ref_t *ref = &device->blobs[blob_index];
+                identity_changed = !was_present || ref->length != entry->length ||
+                                   memcmp(&device->arena[ref->offset], entry->value, entry->length) != 0;
+            }
+            if (!tlv_blob_store(device, blob_index, entry->type, entry->value, entry->length)) {
+                ESP_LOGW(TAG, "TLV arena full, dropping type 0x%02X (%d bytes)", entry->type, entry->length);
                 continue;
             }
-            
-            // Store TLV entry
-            entry->type = type;
-            entry->length = length;
-            if (length > 0) {
-                memcpy(entry->value, &tlv_data[offset + 2], length);
+            if (!was_present) {
+                device->entry_count++;
             }
-            entry->last_updated = xTaskGetTickCount();
-            entry->valid = true;
-            
             stored_entries++;
-            offset += total_entry_size;
         }
         
-        ESP_LOGI(TAG, "📊 Stored %d TLV entries for device %s (total: %d)", 
+        g_tlv_slot_generation[slot] = ++g_tlv_generation;
+        if (live) {
+            node_history_append(slot, device->mac_address, history_values, history_mask);
+            device_store_mark_dirty(identity_changed ? DEVICE_STORE_DIRTY_IDENTITY : DEVICE_STORE_DIRTY_VALUES);
+        }
+        
+        ESPNOW_HOT_LOGI("📊 Stored %d TLV entries for device %s (total: %d)", 
                  stored_entries, device->device_name, device->entry_count);
         
     } while (0);
     
+    return result;
+}
+
+/**
+ * @brief Commit the decoded frames of a receive batch under one g_tlv_mutex hold
+ * @param frames Frames produced by espnow_recv_decode_batch()
+ * @param frame_count Number of frames
+ * @return Number of frames stored
+ */
+static int store_device_tlv_batch(const espnow_rx_decoded_t *frames, int frame_count)
+{
+    if (frames == NULL || frame_count <= 0 || g_tlv_mutex == NULL) {
+        return 0;
+    }
+    
+    // Take mutex for thread safety
+    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take TLV storage mutex");
+        return 0;
+    }
+    
+    int stored = 0;
+    for (int i = 0; i < frame_count; i++) {
+        const espnow_rx_decoded_t *frame = &frames[i];
+        if (frame->entry_count <= 0) {
+            continue;
+        }
+    
+        esp_err_t ret = store_device_tlv_locked(frame->info->mac_addr, frame->entries,
+                                                frame->entry_count, frame->info->rssi, true);
+        if (ret == ESP_OK) {
+            stored++;
+        } else {
+            ESP_LOGE(TAG, "❌ Failed to store TLV data: %s", esp_err_to_name(ret));
+        }
+    }
+    
     // Release mutex
     xSemaphoreGive(g_tlv_mutex);
     
-    return result;
+    ESPNOW_HOT_LOGI("✅ Stored %d of %d frames in one batch", stored, frame_count);
+    return stored;
+}
+
+// ===== DEVICE TABLE PERSISTENCE =====
+
+/**
+ * @brief Encode one node as a persisted record (g_tlv_mutex held)
+ * @param out Room for TLV_PERSIST_RECORD_MAX bytes
+ * @return Record length
+ */
+static size_t tlv_persist_encode_locked(int slot, uint8_t *out)
+{
+    const device_tlv_storage_t *device = &g_tlv_devices[slot];
+    uint8_t *tlv = &out[TLV_PERSIST_RECORD_HEADER];
+    size_t len = 0;
+    
+    memcpy(out, device->mac_address, ESP_NOW_ETH_ALEN);
+    out[6] = (uint8_t)device->rssi;
+    
+    // Known types, numeric values back in wire order so the restore goes through tlv_codec_decode()
+    for (size_t i = 0; i < TLV_CODEC_FIELD_COUNT; i++) {
+        tlv_decoded_entry_t entry;
+        if (tlv_device_entry(device, &tlv_codec_fields[i], &entry)) {
+            len += tlv_codec_encode_entry(&entry, &tlv[len], TLV_PERSIST_TLV_MAX - len);
+        }
+    }
+    
+    // Unknown types held in the extra blob slots
+    for (int i = TLV_BLOB_KNOWN_COUNT; i < TLV_BLOB_SLOT_COUNT; i++) {
+        if (!(device->blob_present & (1U << i))) {
+            continue;
+        }
+        const tlv_blob_ref_t *ref = &device->blobs[i];
+        tlv[len] = ref->type;
+        tlv[len + 1] = ref->length;
+        memcpy(&tlv[len + 2], &device->arena[ref->offset], ref->length);
+        len += TLV_TOTAL_SIZE(ref->length);
+    }
+    
+    out[7] = (uint8_t)len;
+    return TLV_PERSIST_RECORD_HEADER + len;
+}
+
+/**
+ * @brief Device store snapshot: the most recently seen nodes, least recent first
+ * 
+ * Written in LRU order so that the restore, which appends every node to the
+ * LRU list, rebuilds the same eviction order.
+ */
+static int tlv_persist_snapshot(uint8_t *buf, size_t size, uint16_t *count, void *ctx)
+{
+    (void)ctx;
+    if (g_tlv_mutex == NULL || xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return -1;
+    }
+    
+    // Walk back from the most recently seen node
+    int first = g_node_lru_tail;
+    int nodes = (first >= 0) ? 1 : 0;
+    while (first >= 0 && nodes < TLV_PERSIST_MAX_DEVICES && g_tlv_devices[first].lru_prev >= 0) {
+        first = g_tlv_devices[first].lru_prev;
+        nodes++;
+    }
+    
+    size_t len = 0;
+    uint16_t records = 0;
+    for (int slot = first; slot >= 0 && records < nodes && len + TLV_PERSIST_RECORD_MAX <= size;
+         slot = g_tlv_devices[slot].lru_next) {
+        len += tlv_persist_encode_locked(slot, &buf[len]);
+        records++;
+    }
+    
+    xSemaphoreGive(g_tlv_mutex);
+    
+    *count = records;
+    return (int)len;
+}
+
+/**
+ * @brief Device store restore: load the records in one g_tlv_mutex hold
+ */
+static int tlv_persist_restore(const uint8_t *buf, size_t len, uint16_t count, void *ctx)
+{
+    (void)ctx;
+    tlv_decoded_entry_t *entries = mem_account_malloc(MEM_MODULE_DEVICE_STORE, sizeof(tlv_decoded_entry_t) * TLV_DECODE_MAX_ENTRIES);
+    if (entries == NULL) {
+        return 0;
+    }
+    if (xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        mem_account_free(MEM_MODULE_DEVICE_STORE, entries);
+        return 0;
+    }
+    
+    size_t offset = 0;
+    int restored = 0;
+    for (uint16_t i = 0; i < count && offset + TLV_PERSIST_RECORD_HEADER <= len; i++) {
+        const uint8_t *record = &buf[offset];
+        size_t tlv_len = record[7];
+        if (offset + TLV_PERSIST_RECORD_HEADER + tlv_len > len) {
+            break;
+        }
+        offset += TLV_PERSIST_RECORD_HEADER + tlv_len;
+        
+        int entry_count = tlv_codec_decode(&record[TLV_PERSIST_RECORD_HEADER], tlv_len, entries,
+                                           TLV_DECODE_MAX_ENTRIES, NULL);
+        if (entry_count > 0 && store_device_tlv_locked(record, entries, entry_count, (int8_t)record[6], false) == ESP_OK) {
+            restored++;
+        }
+    }
+    
+    xSemaphoreGive(g_tlv_mutex);
+    mem_account_free(MEM_MODULE_DEVICE_STORE, entries);
+    return restored;
 }
 
 /**
- * @brief Print detailed TLV information for a device
+ * @brief Print detailed TLV information for a device (debug pretty-printer)
  * @param device Pointer to device storage structure
  */
 static void print_device_tlv_info(const device_tlv_storage_t *device)
@@ -1433,140 +2780,62 @@ static void print_device_tlv_info(const device_tlv_storage_t *device)
         return;
     }
     
-    ESP_LOGI(TAG, "🔍 Device TLV Info: %s (" MACSTR ")", 
+    ESP_LOGD(TAG, "🔍 Device TLV Info: %s (" MACSTR ")", 
              device->device_name, MAC2STR(device->mac_address));
-    ESP_LOGI(TAG, "   Last seen: %lu ticks ago", xTaskGetTickCount() - device->last_seen);
-    ESP_LOGI(TAG, "   TLV entries: %d/%d", device->entry_count, MAX_TLV_ENTRIES_PER_DEVICE);
+    ESP_LOGD(TAG, "   Last seen: %lu ticks ago", xTaskGetTickCount() - device->last_seen);
+    ESP_LOGD(TAG, "   TLV entries: %d, arena %d/%d bytes", device->entry_count, device->arena_used, TLV_BLOB_ARENA_SIZE);
     
     int valid_entries = 0;
-    for (int i = 0; i < MAX_TLV_ENTRIES_PER_DEVICE; i++) {
-        if (device->tlv_entries[i].valid) {
-            const stored_tlv_entry_t *entry = &device->tlv_entries[i];
-            
-            // Create one-line value description
-            char value_str[128] = {0};
-            if (entry->length > 0) {
-                switch (entry->type) {
-                    case TLV_TYPE_UPTIME:
-                        if (entry->length == 4) {
-                            uint32_t uptime = TLV_UINT32_FROM_BE(entry->value);
-                            snprintf(value_str, sizeof(value_str), "Uptime: %" PRIu32 " seconds", uptime);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_AC_VOLTAGE:
-                        if (entry->length == 4) {
-                            float voltage;
-                            TLV_FLOAT32_FROM_BE(entry->value, voltage);
-                            snprintf(value_str, sizeof(value_str), "AC Voltage: %.1f V", voltage);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_AC_CURRENT:
-                        if (entry->length == 4) {
-                            int32_t current_ma = TLV_INT32_FROM_BE(entry->value);
-                            float current_a = TLV_CURRENT_MA_TO_A(current_ma);
-                            snprintf(value_str, sizeof(value_str), "AC Current: %.3f A (%" PRId32 " mA)", current_a, current_ma);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_AC_FREQUENCY:
-                        if (entry->length == 4) {
-                            float frequency;
-                            TLV_FLOAT32_FROM_BE(entry->value, frequency);
-                            snprintf(value_str, sizeof(value_str), "AC Frequency: %.2f Hz", frequency);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_AC_POWER:
-                        if (entry->length == 4) {
-                            int32_t power_mw = TLV_INT32_FROM_BE(entry->value);
-                            float power_w = TLV_POWER_MW_TO_W(power_mw);
-                            snprintf(value_str, sizeof(value_str), "AC Power: %.3f W (%" PRId32 " mW)", power_w, power_mw);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_DEVICE_ID:
-                    case TLV_TYPE_FIRMWARE_VER:
-                    case TLV_TYPE_COMPILE_TIME:
-                        // String types
-                        {
-                            char temp_str[65] = {0};
-                            int copy_len = (entry->length < 64) ? entry->length : 64;
-                            memcpy(temp_str, entry->value, copy_len);
-                            snprintf(value_str, sizeof(value_str), "Text: \"%s\"", temp_str);
-                        }
-                        break;
-                        
-                    case TLV_TYPE_MAC_ADDRESS:
-                        if (entry->length == 6) {
-                            snprintf(value_str, sizeof(value_str), "MAC: " MACSTR, MAC2STR(entry->value));
-                        }
-                        break;
-                        
-                    case TLV_TYPE_STATUS_FLAGS:
-                        if (entry->length == 2) {
-                            uint16_t flags = TLV_UINT16_FROM_BE(entry->value);
-                            char flag_details[64] = {0};
-                            if (flags & STATUS_FLAG_POWER_ON) strcat(flag_details, "PWR ");
-                            if (flags & STATUS_FLAG_WIFI_CONNECTED) strcat(flag_details, "WIFI ");
-                            if (flags & STATUS_FLAG_ESP_NOW_ACTIVE) strcat(flag_details, "ESPNOW ");
-                            if (flags & STATUS_FLAG_ERROR) strcat(flag_details, "ERR ");
-                            snprintf(value_str, sizeof(value_str), "Status Flags: 0x%04X (%s)", flags, flag_details);
-                        }
-                        break;
-                        
-                    default:
-                        snprintf(value_str, sizeof(value_str), "Raw data (%d bytes)", entry->length);
-                        break;
-                }
-            } else {
-                snprintf(value_str, sizeof(value_str), "(empty)");
-            }
-            
-            // Single line output for each stored TLV entry
-            ESP_LOGI(TAG, "   [%d] Type=0x%02X (%s), Len=%d, %s", 
-                     valid_entries++,
-                     entry->type, 
-                     tlv_type_to_string(entry->type), 
-                     entry->length,
-                     value_str);
+    char value_str[128];
+    tlv_decoded_entry_t entry;
+    
+    // Known types, in descriptor table order
+    for (size_t i = 0; i < TLV_CODEC_FIELD_COUNT; i++) {
+        if (!tlv_device_entry(device, &tlv_codec_fields[i], &entry)) {
+            continue;
+        }
+        tlv_codec_format_entry(&entry, value_str, sizeof(value_str));
+        ESP_LOGD(TAG, "   [%d] Type=0x%02X (%s), Len=%d, %s", 
+                 valid_entries++, entry.type, tlv_codec_type_name(entry.type), entry.length, value_str);
+    }
+    
+    // Unknown/custom types
+    for (int i = TLV_BLOB_KNOWN_COUNT; i < TLV_BLOB_SLOT_COUNT; i++) {
+        if (!(device->blob_present & (1U << i))) {
+            continue;
         }
+        const tlv_blob_ref_t *ref = &device->blobs[i];
+        memset(&entry, 0, sizeof(entry));
+        entry.type = ref->type;
+        entry.value = &device->arena[ref->offset];
+        entry.length = ref->length;
+        entry.valid = true;
+        tlv_codec_format_entry(&entry, value_str, sizeof(value_str));
+        ESP_LOGD(TAG, "   [%d] Type=0x%02X (%s), Len=%d, %s", 
+                 valid_entries++, entry.type, tlv_codec_type_name(entry.type), entry.length, value_str);
     }
 }
 
 /**
- * @brief Process received TLV data and store it indexed by MAC address
- * @param mac_addr MAC address of sender
- * @param data Raw received data
- * @param data_len Length of received data
+ * @brief Print the device table entries touched by a receive batch (debug)
+ * @param frames Frames produced by espnow_recv_decode_batch()
+ * @param frame_count Number of frames
  */
-static void process_received_tlv_data(const uint8_t *mac_addr, const uint8_t *data, size_t data_len, int8_t rssi)
+static void print_batch_tlv_info(const espnow_rx_decoded_t *frames, int frame_count)
 {
-    if (mac_addr == NULL || data == NULL || data_len == 0) {
+    if (g_tlv_mutex == NULL || xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
         return;
     }
     
-    ESP_LOGI(TAG, "🗂️ Processing TLV data from " MACSTR " (%zu bytes)", 
-             MAC2STR(mac_addr), data_len);
-    
-    // Store the TLV data for this device (including RSSI)
-    esp_err_t ret = store_device_tlv_data(mac_addr, data, data_len, rssi);
-    if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "✅ TLV data stored successfully");
-        
-        // Print device information
-        if (g_tlv_mutex != NULL && 
-            xSemaphoreTake(g_tlv_mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
-            
-            device_tlv_storage_t *device = find_device_by_mac(mac_addr);
-            if (device != NULL) {
-                print_device_tlv_info(device);
-            }
-            
-            xSemaphoreGive(g_tlv_mutex);
+    for (int i = 0; i < frame_count; i++) {
+        if (frames[i].entry_count <= 0) {
+            continue;
+        }
+        device_tlv_storage_t *device = find_device_by_mac(frames[i].info->mac_addr);
+        if (device != NULL) {
+            print_device_tlv_info(device);
         }
-    } else {
-        ESP_LOGE(TAG, "❌ Failed to store TLV data: %s", esp_err_to_name(ret));
     }
+    
+    xSemaphoreGive(g_tlv_mutex);
 }
\ No newline at end of file
@@ -28,8 +28,38 @@ typedef struct {
     uint16_t online_nodes;      // Number of nodes seen in last 10 seconds
     uint16_t used_nodes;        // Number of nodes currently in use (in_use = true)
     uint16_t total_nodes;       // Maximum number of nodes supported (MAX_TLV_DEVICES)
+    uint16_t table_bytes_per_node; // Static DRAM reserved per node slot in the device table
+
+    // Receive path statistics
+    uint32_t rx_dropped;        // Frames dropped in the receive callback (ring full or oversized)
+    uint32_t tx_event_dropped;  // Send completion events dropped (event queue full)
+    uint16_t rx_ring_high_water; // Maximum number of receive slots ever in use at once
+    uint16_t rx_ring_size;      // Number of preallocated receive slots
+    uint32_t log_suppressed;    // Receive-path log lines skipped by production logging
+    uint32_t rx_batches;        // Receive batches committed (one storage lock and UI notification each)
+    uint16_t rx_batch_max;      // Largest number of frames committed in one batch
+    uint32_t discovery_interval_ms; // Current adaptive discovery broadcast interval
+    uint32_t nodes_evicted;     // Offline nodes dropped to make room for new ones
 } espnow_stats_t;
 
+/**
+ * @brief Node presence events of the device table
+ */
+typedef enum {
+    ESPNOW_NODE_ONLINE = 0,         // First frame, or first frame after going offline
+    ESPNOW_NODE_OFFLINE,            // Nothing heard for CONFIG_ESPNOW_NODE_ONLINE_TIMEOUT_S
+    ESPNOW_NODE_EVICTED,            // Offline node dropped to make room for a new one
+} espnow_node_event_t;
+
+/**
+ * @brief Node presence callback
+ * 
+ * Runs in the ESP-NOW receive task or the esp_timer task with the device table
+ * locked: it must not block and must not call espnow_manager functions.
+ */
+typedef void (*espnow_node_event_cb_t)(const uint8_t *mac_addr, int device_index,
+                                       espnow_node_event_t event, void *user_ctx);
+
 /**
  * @brief ESP-NOW device information structure (extracted from TLV data)
  */
@@ -38,6 +68,8 @@ typedef struct {
     uint8_t mac_address[6];         // Device MAC address
     char device_name[32];           // Device friendly name
     bool is_available;              // Whether device data is available
+    int device_index;               // Device table slot
+    uint32_t generation;            // Table generation of the slot's last change
     uint32_t last_seen;             // Last time device was seen (in ticks)
     uint16_t entry_count;           // Number of TLV entries for this device
     
@@ -64,6 +96,12 @@ typedef struct {
     // Environmental data
     float temperature;              // TLV_TYPE_TEMPERATURE (celsius)
     
+    // Power supply (battery-powered nodes such as other sticks)
+    float battery_voltage;          // TLV_TYPE_BATTERY_VOLTAGE (volts)
+    uint16_t battery_level;         // TLV_TYPE_BATTERY_LEVEL (percent)
+    float battery_current;          // TLV_TYPE_BATTERY_CURRENT (amperes, positive while charging)
+    float vbus_voltage;             // TLV_TYPE_VBUS_VOLTAGE (volts)
+    
     // Memory information (derived/calculated)
     uint32_t free_memory_kb;        // Free memory in KB (calculated or estimated)
 } espnow_device_info_t;
@@ -113,6 +151,18 @@ esp_err_t espnow_manager_get_stats(espnow_stats_t *stats);
  */
 esp_err_t espnow_manager_get_device_info(int device_index, espnow_device_info_t *device_info);
 
+/**
+ * @brief Get the generation of one device slot without copying the device
+ * 
+ * The value changes whenever the slot changes (new node, new data, removal), so
+ * a caller holding a copy only needs espnow_manager_get_device_info() when it moves.
+ * 
+ * @param device_index Device slot (0-based)
+ * @param generation Pointer to store the slot generation (0 = never used)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL or bad index, error code otherwise
+ */
+esp_err_t espnow_manager_get_device_generation(int device_index, uint32_t *generation);
+
 /**
  * @brief Get the next valid device index in circular fashion
  * 
@@ -122,6 +172,25 @@ esp_err_t espnow_manager_get_device_info(int device_index, espnow_device_info_t
  */
 esp_err_t espnow_manager_get_next_valid_device_index(int current_index, int *next_index);
 
+/**
+ * @brief Get the devices that changed after a table generation
+ * 
+ * Every change to a device slot (new node, new data, removal) gives the slot a
+ * new table-wide generation. Changed devices are copied oldest change first,
+ * all under one storage lock and one pass over the table. Removed devices are returned with is_available
+ * false and only device_index and generation set.
+ * 
+ * @param since_generation Generation returned by the previous call (0 = everything)
+ * @param devices Output array
+ * @param max_devices Capacity of devices
+ * @param device_count Number of devices written
+ * @param generation Generation to pass to the next call. If device_count equals
+ *                   max_devices, more changes may be pending: call again.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL or bad capacity
+ */
+esp_err_t espnow_manager_get_devices_since(uint32_t since_generation, espnow_device_info_t *devices,
+                                           int max_devices, int *device_count, uint32_t *generation);
+
 /**
  * @brief Send a test packet manually
  * 
@@ -129,6 +198,40 @@ esp_err_t espnow_manager_get_next_valid_device_index(int current_index, int *nex
  */
 esp_err_t espnow_manager_send_test_packet(void);
 
+/**
+ * @brief Ask the discovery scheduler for a burst of broadcasts
+ * 
+ * Drops the broadcast interval to the minimum for a few rounds, e.g. when
+ * the user opens the ESP-NOW page. Never blocks; repeated requests merge.
+ * 
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if ESP-NOW is not running
+ */
+esp_err_t espnow_manager_request_discovery_burst(void);
+
+/**
+ * @brief Set how long the radio stays awake in each ESP-NOW wake interval
+ * 
+ * Frames sent while the radio sleeps are lost, so the power manager keeps the
+ * radio awake for the whole interval while the screen is on. The value is
+ * kept and applied again whenever ESP-NOW is started.
+ * 
+ * @param window_ms Awake time per CONFIG_ESPNOW_WAKE_INTERVAL (clamped to the interval)
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_ESPNOW_ENABLE_POWER_SAVE
+ */
+esp_err_t espnow_manager_set_wake_window(uint16_t window_ms);
+
+/**
+ * @brief Register the node presence callback (NULL to remove)
+ * 
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE before espnow_manager_init()
+ */
+esp_err_t espnow_manager_register_node_event_cb(espnow_node_event_cb_t cb, void *user_ctx);
+
+/**
+ * @brief Check whether ESP-NOW has been started
+ */
+bool espnow_manager_is_running(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,393 @@
+/*
+ * ESP-NOW Unicast Peers for M5StickC Plus 1.1
+ * Registered peers for collection polls with per-peer PHY rate adaptation
+ */
+
+#include "espnow_peers.h"
+#include "esp_now.h"
+#include "espnow_example.h"
+#include "esp_wifi.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "ESPNOW_PEERS";
+
+// The broadcast peer takes one of the ESP-NOW peer slots
+_Static_assert(ESPNOW_PEERS_MAX < ESP_NOW_MAX_TOTAL_PEER_NUM, "CONFIG_ESPNOW_UNICAST_PEERS exceeds the ESP-NOW peer limit");
+
+#define PEER_TABLE_SIZE         (ESPNOW_PEERS_MAX > 0 ? ESPNOW_PEERS_MAX : 1)
+#define PEER_HOLD_MS            (CONFIG_ESPNOW_NODE_ONLINE_TIMEOUT_S * 1000u)  // Heard this recently: not rotated out
+#define PEER_RATE_WINDOW        8       // Sends judged together for a rate step
+#define PEER_RATE_FAIL_DOWN     2       // Failures in a window that step down at once
+#define PEER_LOCK_TIMEOUT_MS    50
+
+#define peer_now_ms()           ((uint32_t)(esp_timer_get_time() / 1000))
+
+// Rate ladder, fastest first; a step up also needs the RSSI the faster rate was chosen for
+typedef struct {
+    wifi_phy_mode_t phymode;
+    wifi_phy_rate_t rate;
+    uint16_t mbps_x10;
+    int8_t min_rssi;
+    const char *name;
+} peer_rate_t;
+
+static const peer_rate_t k_rates[] = {
+    { WIFI_PHY_MODE_HT20, WIFI_PHY_RATE_MCS7_LGI, 650, -62,  "MCS7" },
+    { WIFI_PHY_MODE_HT20, WIFI_PHY_RATE_MCS5_LGI, 520, -68,  "MCS5" },
+    { WIFI_PHY_MODE_HT20, WIFI_PHY_RATE_MCS3_LGI, 260, -74,  "MCS3" },
+    { WIFI_PHY_MODE_HT20, WIFI_PHY_RATE_MCS1_LGI, 130, -80,  "MCS1" },
+    { WIFI_PHY_MODE_HT20, WIFI_PHY_RATE_MCS0_LGI,  65, -86,  "MCS0" },
+    { WIFI_PHY_MODE_11B,  WIFI_PHY_RATE_1M_L,      10, -128, "1M" },
+};
+#define PEER_RATE_COUNT         (sizeof(k_rates) / sizeof(k_rates[0]))
+
+typedef struct {
+    uint8_t mac[ESPNOW_PEERS_MAC_LEN];
+    bool in_use;
+    int8_t rssi;
+    uint8_t rate_index;
+    uint8_t window_sent;
+    uint8_t window_failed;
+    uint16_t rate_changes;
+    uint32_t last_heard_ms;
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t failed;
+    uint16_t fail_streak;
+    uint16_t fail_streak_max;
+} peer_entry_t;
+
+// Peer table (protected by s_peers_mutex)
+static peer_entry_t s_peers[PEER_TABLE_SIZE];
+static uint8_t s_peer_count = 0;
+static uint32_t s_promotions = 0;
+static uint32_t s_evictions = 0;
+static uint32_t s_deferred = 0;
+static SemaphoreHandle_t s_peers_mutex = NULL;
+
+static peer_entry_t *peer_find_locked(const uint8_t *mac)
+{
+    for (int i = 0; i < PEER_TABLE_SIZE; i++) {
+        if (s_peers[i].in_use && memcmp(s_peers[i].mac, mac, ESPNOW_PEERS_MAC_LEN) == 0) {
+            return &s_peers[i];
+        }
+    }
+    return NULL;
+}
+
+// Fastest rate the RSSI supports
+static uint8_t peer_rate_for_rssi(int8_t rssi)
+{
+    for (uint8_t i = 0; i < PEER_RATE_COUNT; i++) {
+        if (rssi >= k_rates[i].min_rssi) {
+            return i;
+        }
+    }
+    return PEER_RATE_COUNT - 1;
+}
+
+static esp_err_t peer_apply_rate(const peer_entry_t *peer)
+{
+    esp_now_rate_config_t rate = {
+        .phymode = k_rates[peer->rate_index].phymode,
+        .rate = k_rates[peer->rate_index].rate,
+        .ersu = false,
+        .dcm = false,
+    };
+    esp_err_t ret = esp_now_set_peer_rate_config(peer->mac, &rate);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set rate %s for " MACSTR ": %s", k_rates[peer->rate_index].name,
+                 MAC2STR(peer->mac), esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+// Least recently heard peer that is quiet long enough to give up its slot
+static peer_entry_t *peer_pick_victim_locked(uint32_t now_ms)
+{
+    peer_entry_t *victim = NULL;
+    for (int i = 0; i < PEER_TABLE_SIZE; i++) {
+        peer_entry_t *peer = &s_peers[i];
+        if (peer->in_use && (victim == NULL || (int32_t)(peer->last_heard_ms - victim->last_heard_ms) < 0)) {
+            victim = peer;
+        }
+    }
+    if (victim != NULL && now_ms - victim->last_heard_ms < PEER_HOLD_MS) {
+        return NULL;
+    }
+    return victim;
+}
+
+static peer_entry_t *peer_free_slot_locked(void)
+{
+    for (int i = 0; i < PEER_TABLE_SIZE; i++) {
+        if (!s_peers[i].in_use) {
+            return &s_peers[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t espnow_peers_init(void)
+{
+    if (s_peers_mutex == NULL) {
+        s_peers_mutex = xSemaphoreCreateMutex();
+        if (s_peers_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xSemaphoreTake(s_peers_mutex, portMAX_DELAY);
+    memset(s_peers, 0, sizeof(s_peers));
+    s_peer_count = 0;
+    s_promotions = 0;
+    s_evictions = 0;
+    s_deferred = 0;
+    xSemaphoreGive(s_peers_mutex);
+
+    ESP_LOGI(TAG, "🤝 Up to %d unicast peers, rates %s-%s", ESPNOW_PEERS_MAX, k_rates[0].name,
+             k_rates[PEER_RATE_COUNT - 1].name);
+    return ESP_OK;
+}
+
+void espnow_peers_deinit(void)
+{
+    if (s_peers_mutex == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(s_peers_mutex, portMAX_DELAY);
+    for (int i = 0; i < PEER_TABLE_SIZE; i++) {
+        if (s_peers[i].in_use) {
+            esp_now_del_peer(s_peers[i].mac);
+            s_peers[i].in_use = false;
+        }
+    }
+    s_peer_count = 0;
+    xSemaphoreGive(s_peers_mutex);
+}
+
+void espnow_peers_heard(const uint8_t *mac, int8_t rssi)
+{
+    if (ESPNOW_PEERS_MAX == 0 || mac == NULL || s_peers_mutex == NULL) {
+        return;
+    }
+    if (xSemaphoreTake(s_peers_mutex, pdMS_TO_TICKS(PEER_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        return;
+    }
+
+    uint32_t now_ms = peer_now_ms();
+    peer_entry_t *peer = peer_find_locked(mac);
+    if (peer != NULL) {
+        peer->rssi = rssi;
+        peer->last_heard_ms = now_ms;
+        xSemaphoreGive(s_peers_mutex);
+        return;
+    }
+
+    // Promote: a free slot, or rotate out the least recently heard peer
+    peer = peer_free_slot_locked();
+    if (peer == NULL) {
+        peer = peer_pick_victim_locked(now_ms);
+        if (peer == NULL) {
+            s_deferred++;
+            xSemaphoreGive(s_peers_mutex);
+            return;
+        }
+        ESP_LOGI(TAG, "🔄 Peer " MACSTR " rotated out (%" PRIu32 " s silent)", MAC2STR(peer->mac),
+                 (now_ms - peer->last_heard_ms) / 1000);
+        esp_now_del_peer(peer->mac);
+        peer->in_use = false;
+        s_peer_count--;
+        s_evictions++;
+    }
+
+    esp_now_peer_info_t info = {
+        .channel = 0,               // Current channel, follows benchmark profile switches
+        .ifidx = ESPNOW_WIFI_IF,
+        .encrypt = false,
+    };
+    memcpy(info.peer_addr, mac, ESPNOW_PEERS_MAC_LEN);
+    esp_err_t ret = esp_now_add_peer(&info);
+    if (ret != ESP_OK && ret != ESP_ERR_ESPNOW_EXIST) {
+        ESP_LOGW(TAG, "Failed to add peer " MACSTR ": %s", MAC2STR(mac), esp_err_to_name(ret));
+        xSemaphoreGive(s_peers_mutex);
+        return;
+    }
+
+    memset(peer, 0, sizeof(*peer));
+    memcpy(peer->mac, mac, ESPNOW_PEERS_MAC_LEN);
+    peer->in_use = true;
+    peer->rssi = rssi;
+    peer->last_heard_ms = now_ms;
+    peer->rate_index = peer_rate_for_rssi(rssi);
+    peer_apply_rate(peer);
+    s_peer_count++;
+    s_promotions++;
+    ESP_LOGI(TAG, "🤝 Peer " MACSTR " registered at %s (RSSI %d, %d/%d peers)", MAC2STR(mac),
+             k_rates[peer->rate_index].name, rssi, s_peer_count, ESPNOW_PEERS_MAX);
+
+    xSemaphoreGive(s_peers_mutex);
+}
+
+bool espnow_peers_record_send(const uint8_t *mac, bool success)
+{
+    if (ESPNOW_PEERS_MAX == 0 || mac == NULL || s_peers_mutex == NULL) {
+        return false;
+    }
+    if (xSemaphoreTake(s_peers_mutex, pdMS_TO_TICKS(PEER_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        return false;
+    }
+
+    peer_entry_t *peer = peer_find_locked(mac);
+    if (peer == NULL) {
+        xSemaphoreGive(s_peers_mutex);
+        return false;
+    }
+
+    peer->sent++;
+    peer->window_sent++;
+    if (success) {
+        peer->acked++;
+        peer->fail_streak = 0;
+    } else {
+        peer->failed++;
+        peer->window_failed++;
+        if (peer->fail_streak < UINT16_MAX) {
+            peer->fail_streak++;
+        }
+        if (peer->fail_streak > peer->fail_streak_max) {
+            peer->fail_streak_max = peer->fail_streak;
+        }
+    }
+
+    // Step down on repeated losses at once, step up after a clean window with enough RSSI
+    uint8_t index = peer->rate_index;
+    if (peer->window_failed >= PEER_RATE_FAIL_DOWN) {
+        if (index + 1 < PEER_RATE_COUNT) {
+            index++;
+        }
+    } else if (peer->window_sent >= PEER_RATE_WINDOW) {
+        if (peer->window_failed == 0 && index > 0 && peer->rssi >= k_rates[index - 1].min_rssi) {
+            index--;
+        }
+    } else {
+        xSemaphoreGive(s_peers_mutex);
+        return true;
+    }
+
+    peer->window_sent = 0;
+    peer->window_failed = 0;
+    if (index != peer->rate_index) {
+        ESP_LOGI(TAG, "📶 Peer " MACSTR " rate %s -> %s (RSSI %d)", MAC2STR(peer->mac),
+                 k_rates[peer->rate_index].name, k_rates[index].name, peer->rssi);
+        peer->rate_index = index;
+        peer->rate_changes++;
+        peer_apply_rate(peer);
+    }
+
+    xSemaphoreGive(s_peers_mutex);
+    return true;
+}
+
+bool espnow_peers_contains(const uint8_t *mac)
+{
+    if (ESPNOW_PEERS_MAX == 0 || mac == NULL || s_peers_mutex == NULL) {
+        return false;
+    }
+    if (xSemaphoreTake(s_peers_mutex, pdMS_TO_TICKS(PEER_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        return false;
+    }
+
+    bool found = (peer_find_locked(mac) != NULL);
+    xSemaphoreGive(s_peers_mutex);
+    return found;
+}
+
+int espnow_peers_list(uint8_t macs[][ESPNOW_PEERS_MAC_LEN], int max)
+{
+    if (macs == NULL || max <= 0 || s_peers_mutex == NULL) {
+        return 0;
+    }
+    if (xSemaphoreTake(s_peers_mutex, pdMS_TO_TICKS(PEER_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        return 0;
+    }
+
+    int count = 0;
+    for (int i = 0; i < PEER_TABLE_SIZE && count < max; i++) {
+        if (s_peers[i].in_use) {
+            memcpy(macs[count++], s_peers[i].mac, ESPNOW_PEERS_MAC_LEN);
+        }
+    }
+
+    xSemaphoreGive(s_peers_mutex);
+    return count;
+}
+
+esp_err_t espnow_peers_get_stats(espnow_peers_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_peers_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(s_peers_mutex, pdMS_TO_TICKS(PEER_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->capacity = ESPNOW_PEERS_MAX;
+    stats->promotions = s_promotions;
+    stats->evictions = s_evictions;
+    stats->deferred = s_deferred;
+
+    uint32_t now_ms = peer_now_ms();
+    for (int i = 0; i < PEER_TABLE_SIZE; i++) {
+        const peer_entry_t *peer = &s_peers[i];
+        if (!peer->in_use) {
+            continue;
+        }
+        espnow_peer_stats_t *out = &stats->peers[stats->count++];
+        memcpy(out->mac, peer->mac, ESPNOW_PEERS_MAC_LEN);
+        out->rssi = peer->rssi;
+        out->rate_index = peer->rate_index;
+        out->rate_name = k_rates[peer->rate_index].name;
+        out->rate_mbps_x10 = k_rates[peer->rate_index].mbps_x10;
+        out->rate_changes = peer->rate_changes;
+        out->sent = peer->sent;
+        out->acked = peer->acked;
+        out->failed = peer->failed;
+        out->fail_streak = peer->fail_streak;
+        out->fail_streak_max = peer->fail_streak_max;
+        out->idle_ms = now_ms - peer->last_heard_ms;
+    }
+
+    xSemaphoreGive(s_peers_mutex);
+    return ESP_OK;
+}
+
+void espnow_peers_log(void)
+{
+    static espnow_peers_stats_t stats;      // Kept off the task monitor stack
+    if (espnow_peers_get_stats(&stats) != ESP_OK) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "=== Unicast Peers (%u/%u, %" PRIu32 " promoted, %" PRIu32 " rotated, %" PRIu32 " deferred) ===",
+             stats.count, stats.capacity, stats.promotions, stats.evictions, stats.deferred);
+    for (int i = 0; i < stats.count; i++) {
+        const espnow_peer_stats_t *peer = &stats.peers[i];
+        ESP_LOGI(TAG, "   " MACSTR "  %-4s %2u.%u Mbps  RSSI %4d  sent %5" PRIu32 "  acked %5" PRIu32
+                 "  failed %4" PRIu32 " (streak %u, max %u)  idle %5" PRIu32 " ms",
+                 MAC2STR(peer->mac), peer->rate_name, peer->rate_mbps_x10 / 10, peer->rate_mbps_x10 % 10,
+                 peer->rssi, peer->sent, peer->acked, peer->failed, peer->fail_streak, peer->fail_streak_max,
+                 peer->idle_ms);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * ESP-NOW Unicast Peers for M5StickC Plus 1.1
+ * Registered peers for collection polls with per-peer PHY rate adaptation
+ */
+
+#ifndef ESPNOW_PEERS_H
+#define ESPNOW_PEERS_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESPNOW_PEERS_MAX        CONFIG_ESPNOW_UNICAST_PEERS    // 0 keeps all traffic on broadcast
+#define ESPNOW_PEERS_MAC_LEN    6
+
+/**
+ * @brief One registered unicast peer
+ */
+typedef struct {
+    uint8_t mac[ESPNOW_PEERS_MAC_LEN];
+    int8_t rssi;                    // Latest RSSI of a frame from the node
+    uint8_t rate_index;             // Rate ladder position, 0 = fastest
+    const char *rate_name;          // "MCS7", ..., "1M"
+    uint16_t rate_mbps_x10;         // PHY rate in 0.1 Mbps
+    uint16_t rate_changes;          // Ladder steps since promotion
+    uint32_t sent;                  // Unicast polls sent
+    uint32_t acked;                 // Acknowledged by the node's MAC
+    uint32_t failed;                // MAC retries exhausted, no ACK
+    uint16_t fail_streak;           // Consecutive failed sends, 0 after an ACK
+    uint16_t fail_streak_max;       // Longest failure streak since promotion
+    uint32_t idle_ms;               // Since the node was last heard
+} espnow_peer_stats_t;
+
+/**
+ * @brief Peer table statistics
+ */
+typedef struct {
+    uint8_t count;                  // Registered peers
+    uint8_t capacity;               // ESPNOW_PEERS_MAX
+    uint32_t promotions;            // Nodes registered as peers
+    uint32_t evictions;             // Peers rotated out for a newer node
+    uint32_t deferred;              // Promotions refused: every peer heard recently
+    espnow_peer_stats_t peers[ESPNOW_PEERS_MAX > 0 ? ESPNOW_PEERS_MAX : 1];
+} espnow_peers_stats_t;
+
+/**
+ * @brief Reset the peer table (after esp_now_init())
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the mutex can't be created
+ */
+esp_err_t espnow_peers_init(void);
+
+/**
+ * @brief Unregister every unicast peer (before esp_now_deinit())
+ */
+void espnow_peers_deinit(void);
+
+/**
+ * @brief A node sent data: refresh its peer entry or promote it (receive task)
+ *
+ * When the table is full, the least recently heard peer is rotated out, but
+ * only once it has been silent for CONFIG_ESPNOW_NODE_ONLINE_TIMEOUT_S; until
+ * then the node keeps being polled by the discovery broadcast.
+ *
+ * @param mac Node MAC address
+ * @param rssi RSSI of the received frame, picks the starting rate
+ */
+void espnow_peers_heard(const uint8_t *mac, int8_t rssi);
+
+/**
+ * @brief Account a send completion and adapt the peer's rate (receive task)
+ *
+ * The send callback only reports whether the MAC got an ACK after its own
+ * retries, not how many it took, so the per-peer retry metric is the failure
+ * streak. Not called for sends completed while the benchmark has the radio.
+ *
+ * @param mac Destination of the completed send
+ * @param success ACK received
+ * @return true if the destination is a registered peer
+ */
+bool espnow_peers_record_send(const uint8_t *mac, bool success);
+
+/**
+ * @brief Check whether a MAC address is a registered peer, without accounting a send
+ * @param mac Node MAC address
+ * @return true if registered
+ */
+bool espnow_peers_contains(const uint8_t *mac);
+
+/**
+ * @brief Copy the MAC addresses of the registered peers
+ * @param macs Output, room for max addresses
+ * @param max Capacity of macs
+ * @return Number of addresses copied
+ */
+int espnow_peers_list(uint8_t macs[][ESPNOW_PEERS_MAC_LEN], int max);
+
+/**
+ * @brief Get the peer table statistics
+ * @param stats Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL, ESP_ERR_INVALID_STATE before init
+ */
+esp_err_t espnow_peers_get_stats(espnow_peers_stats_t *stats);
+
+/**
+ * @brief Log the peer table with rate and delivery per peer
+ */
+void espnow_peers_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESPNOW_PEERS_H
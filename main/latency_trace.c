@@ -0,0 +1,305 @@
+/*
+ * Latency Trace for M5StickC Plus 1.1
+ * Stage timestamps of received frames from the radio callback to the pixels on the LCD
+ */
+
+#include "latency_trace.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <inttypes.h>
+
+#if CONFIG_LATENCY_TRACE_ENABLE
+#include "esp_timer.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+static const char *TAG = "LATENCY_TRACE";
+
+#if CONFIG_LATENCY_TRACE_ENABLE
+
+#define LATENCY_TRACE_RING_SIZE     CONFIG_LATENCY_TRACE_RING_SIZE
+#define LATENCY_TRACE_WINDOW        (LATENCY_TRACE_RING_SIZE * portNUM_PROCESSORS)
+
+_Static_assert((LATENCY_TRACE_RING_SIZE & (LATENCY_TRACE_RING_SIZE - 1)) == 0,
+               "CONFIG_LATENCY_TRACE_RING_SIZE must be a power of two");
+
+// One stamp; seq is the claimed ring index + 1 once the fields are complete, 0 while they are written
+typedef struct {
+    atomic_uint seq;
+    uint32_t id;
+    uint32_t time_us;               // esp_timer, comparable across cores (cycle counters are not)
+    uint8_t stage;
+} latency_event_t;
+
+// Ring of the core a stamp is taken on; tasks and ISRs of that core claim slots with one atomic add
+typedef struct {
+    atomic_uint head;
+    latency_event_t events[LATENCY_TRACE_RING_SIZE];
+} latency_ring_t;
+
+// Copied stamp for the summary
+typedef struct {
+    uint32_t id;
+    uint32_t time_us;
+    uint8_t stage;
+} latency_sample_t;
+
+static const char *const s_stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_RECV_CB]     = "recv_cb",
+    [LATENCY_STAGE_DEQUEUE]     = "dequeue",
+    [LATENCY_STAGE_DECODE]      = "decode",
+    [LATENCY_STAGE_STORE]       = "store",
+    [LATENCY_STAGE_NOTIFY]      = "notify",
+    [LATENCY_STAGE_PAGE_UPDATE] = "page_update",
+    [LATENCY_STAGE_FLUSH_START] = "flush_start",
+    [LATENCY_STAGE_FLUSH_DONE]  = "flush_done",
+};
+
+static latency_ring_t s_rings[portNUM_PROCESSORS];
+static atomic_uint s_next_id = ATOMIC_VAR_INIT(0);
+
+// Frame handed down the UI pipeline: published -> page updated -> flush started
+static atomic_uint s_pending_id = ATOMIC_VAR_INIT(0);   // Last frame published, not yet on a page
+static atomic_uint s_render_id = ATOMIC_VAR_INIT(0);    // Frame of the last page update, not yet flushed
+static atomic_uint s_flush_id = ATOMIC_VAR_INIT(0);     // Frame of the refresh being transferred
+
+// Summary work buffers (one caller at a time)
+static latency_sample_t s_window[LATENCY_TRACE_WINDOW];
+static uint32_t s_deltas[LATENCY_TRACE_WINDOW];
+
+uint32_t latency_trace_new_id(void)
+{
+    uint32_t id = atomic_fetch_add_explicit(&s_next_id, 1, memory_order_relaxed) + 1;
+    if (id == 0) {
+        id = atomic_fetch_add_explicit(&s_next_id, 1, memory_order_relaxed) + 1;  // 0 means untraced
+    }
+    return id;
+}
+
+void latency_trace_stamp(latency_stage_t stage, uint32_t id)
+{
+    if (id == 0 || stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+
+    // Any core's ring stays correct if the task migrates here: slots are claimed atomically
+    latency_ring_t *ring = &s_rings[xPortGetCoreID()];
+    unsigned int index = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+    latency_event_t *event = &ring->events[index & (LATENCY_TRACE_RING_SIZE - 1)];
+
+    atomic_store_explicit(&event->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    event->id = id;
+    event->time_us = now_us;
+    event->stage = (uint8_t)stage;
+    atomic_store_explicit(&event->seq, index + 1, memory_order_release);
+}
+
+void latency_trace_publish(uint32_t id)
+{
+    if (id == 0) {
+        return;
+    }
+    latency_trace_stamp(LATENCY_STAGE_NOTIFY, id);
+    atomic_store_explicit(&s_pending_id, id, memory_order_relaxed);
+}
+
+void latency_trace_page_update(void)
+{
+    uint32_t id = atomic_exchange_explicit(&s_pending_id, 0, memory_order_relaxed);
+    if (id != 0) {
+        latency_trace_stamp(LATENCY_STAGE_PAGE_UPDATE, id);
+        atomic_store_explicit(&s_render_id, id, memory_order_relaxed);
+    }
+}
+
+void latency_trace_flush_start(void)
+{
+    uint32_t id = atomic_exchange_explicit(&s_render_id, 0, memory_order_relaxed);
+    if (id != 0) {
+        latency_trace_stamp(LATENCY_STAGE_FLUSH_START, id);
+        atomic_store_explicit(&s_flush_id, id, memory_order_relaxed);
+    }
+}
+
+void latency_trace_flush_done(void)
+{
+    uint32_t id = atomic_exchange_explicit(&s_flush_id, 0, memory_order_relaxed);
+    if (id != 0) {
+        latency_trace_stamp(LATENCY_STAGE_FLUSH_DONE, id);
+    }
+}
+
+void latency_trace_flush_skipped(void)
+{
+    // The update changed nothing visible; a later unrelated refresh must not be charged to it
+    atomic_store_explicit(&s_render_id, 0, memory_order_relaxed);
+}
+
+static int sample_compare(const void *a, const void *b)
+{
+    const latency_sample_t *x = a;
+    const latency_sample_t *y = b;
+    if (x->id != y->id) {
+        return (x->id < y->id) ? -1 : 1;
+    }
+    if (x->stage != y->stage) {
+        return (x->stage < y->stage) ? -1 : 1;
+    }
+    if (x->time_us != y->time_us) {
+        return ((int32_t)(x->time_us - y->time_us) < 0) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int u32_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+// Copy the complete events of all rings; slots being rewritten are skipped
+static uint32_t window_collect(uint32_t *total_events)
+{
+    uint32_t count = 0;
+    *total_events = 0;
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        latency_ring_t *ring = &s_rings[core];
+        *total_events += atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+        for (int i = 0; i < LATENCY_TRACE_RING_SIZE; i++) {
+            latency_event_t *event = &ring->events[i];
+            unsigned int seq = atomic_load_explicit(&event->seq, memory_order_acquire);
+            if (seq == 0) {
+                continue;
+            }
+            latency_sample_t sample = {
+                .id = event->id,
+                .time_us = event->time_us,
+                .stage = event->stage,
+            };
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&event->seq, memory_order_relaxed) != seq) {
+                continue;
+            }
+            s_window[count++] = sample;
+        }
+    }
+
+    qsort(s_window, count, sizeof(s_window[0]), sample_compare);
+    return count;
+}
+
+// Nearest-rank percentiles of the first n deltas
+static void stats_from_deltas(uint32_t n, latency_trace_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (n == 0) {
+        return;
+    }
+    qsort(s_deltas, n, sizeof(s_deltas[0]), u32_compare);
+    stats->count = n;
+    stats->p50_us = s_deltas[(n * 50 + 99) / 100 - 1];
+    stats->p99_us = s_deltas[(n * 99 + 99) / 100 - 1];
+    stats->max_us = s_deltas[n - 1];
+}
+
+// Time from stage `from` to stage `to` of every frame in the window that has both
+static void window_stage_stats(uint32_t count, latency_stage_t from, latency_stage_t to,
+                               latency_trace_stats_t *stats)
+{
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    while (i < count) {
+        uint32_t id = s_window[i].id;
+        bool have_from = false;
+        bool have_to = false;
+        uint32_t from_us = 0;
+        uint32_t to_us = 0;
+
+        for (; i < count && s_window[i].id == id; i++) {
+            if (s_window[i].stage == from && !have_from) {
+                have_from = true;
+                from_us = s_window[i].time_us;
+            } else if (s_window[i].stage == to && !have_to) {
+                have_to = true;
+                to_us = s_window[i].time_us;
+            }
+        }
+
+        if (have_from && have_to) {
+            s_deltas[n++] = to_us - from_us;
+        }
+    }
+
+    stats_from_deltas(n, stats);
+}
+
+esp_err_t latency_trace_get_summary(latency_trace_summary_t *summary)
+{
+    if (summary == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(summary, 0, sizeof(*summary));
+    uint32_t count = window_collect(&summary->events);
+    summary->window_events = count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == 0 || s_window[i].id != s_window[i - 1].id) {
+            summary->frames++;
+        }
+    }
+
+    for (int stage = LATENCY_STAGE_DEQUEUE; stage < LATENCY_STAGE_COUNT; stage++) {
+        window_stage_stats(count, (latency_stage_t)(stage - 1), (latency_stage_t)stage, &summary->stage[stage]);
+    }
+    window_stage_stats(count, LATENCY_STAGE_RECV_CB, LATENCY_STAGE_FLUSH_DONE, &summary->end_to_end);
+    return ESP_OK;
+}
+
+void latency_trace_log(void)
+{
+    static latency_trace_summary_t summary;
+    latency_trace_get_summary(&summary);
+
+    if (summary.frames == 0) {
+        ESP_LOGI(TAG, "No traced frames yet");
+        return;
+    }
+
+    ESP_LOGI(TAG, "=== Latency (%" PRIu32 " frames, %" PRIu32 "/%" PRIu32 " events in window) ===",
+             summary.frames, summary.window_events, summary.events);
+    for (int stage = LATENCY_STAGE_DEQUEUE; stage < LATENCY_STAGE_COUNT; stage++) {
+        const latency_trace_stats_t *stats = &summary.stage[stage];
+        ESP_LOGI(TAG, "   %-11s n %4" PRIu32 "  p50 %6" PRIu32 " us  p99 %6" PRIu32 " us  max %6" PRIu32 " us",
+                 s_stage_names[stage], stats->count, stats->p50_us, stats->p99_us, stats->max_us);
+    }
+    ESP_LOGI(TAG, "   %-11s n %4" PRIu32 "  p50 %6" PRIu32 " us  p99 %6" PRIu32 " us  max %6" PRIu32 " us",
+             "end_to_end", summary.end_to_end.count, summary.end_to_end.p50_us,
+             summary.end_to_end.p99_us, summary.end_to_end.max_us);
+}
+
+#else
+
+esp_err_t latency_trace_get_summary(latency_trace_summary_t *summary)
+{
+    if (summary == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void latency_trace_log(void)
+{
+    ESP_LOGD(TAG, "Latency tracing disabled (CONFIG_LATENCY_TRACE_ENABLE)");
+}
+
+#endif // CONFIG_LATENCY_TRACE_ENABLE
@@ -0,0 +1,123 @@
+/*
+ * Latency Trace for M5StickC Plus 1.1
+ * Stage timestamps of received frames from the radio callback to the pixels on the LCD
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace points, in pipeline order
+ *
+ * A frame gets its trace ID in the receive callback. The UI coalesces frames, so
+ * only the last frame published before a page update carries on to the display
+ * stages; the others end at LATENCY_STAGE_NOTIFY.
+ */
+typedef enum {
+    LATENCY_STAGE_RECV_CB = 0,      // Frame copied into the receive ring (Wi-Fi task)
+    LATENCY_STAGE_DEQUEUE,          // Receive task picked the slot up
+    LATENCY_STAGE_DECODE,           // TLV entries decoded
+    LATENCY_STAGE_STORE,            // Batch committed to the device table
+    LATENCY_STAGE_NOTIFY,           // UI topics published
+    LATENCY_STAGE_PAGE_UPDATE,      // Page update ran in the LVGL task
+    LATENCY_STAGE_FLUSH_START,      // First stripe of the next refresh handed to esp_lcd
+    LATENCY_STAGE_FLUSH_DONE,       // Last stripe transfer finished
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+/**
+ * @brief Distribution of one stage over the trace window, in microseconds
+ */
+typedef struct {
+    uint32_t count;                 // Frames with both this and the previous stage stamped
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_trace_stats_t;
+
+/**
+ * @brief Latency summary of the events still held in the trace rings
+ */
+typedef struct {
+    uint32_t events;                // Events stamped since boot
+    uint32_t window_events;         // Events summarized (at most the ring size per core)
+    uint32_t frames;                // Distinct trace IDs in the window
+    latency_trace_stats_t stage[LATENCY_STAGE_COUNT];   // Previous stage to this one, stage[0] unused
+    latency_trace_stats_t end_to_end;                   // LATENCY_STAGE_RECV_CB to LATENCY_STAGE_FLUSH_DONE
+} latency_trace_summary_t;
+
+#if CONFIG_LATENCY_TRACE_ENABLE
+
+/**
+ * @brief Allocate the trace ID of a received frame (never 0)
+ */
+uint32_t latency_trace_new_id(void);
+
+/**
+ * @brief Stamp a stage of a frame (any task or ISR, lock-free)
+ */
+void latency_trace_stamp(latency_stage_t stage, uint32_t id);
+
+/**
+ * @brief Stamp LATENCY_STAGE_NOTIFY and hand the frame to the next page update
+ */
+void latency_trace_publish(uint32_t id);
+
+/**
+ * @brief Stamp LATENCY_STAGE_PAGE_UPDATE for the last published frame (LVGL task)
+ */
+void latency_trace_page_update(void);
+
+/**
+ * @brief Stamp LATENCY_STAGE_FLUSH_START for the updated frame (first stripe of a refresh)
+ */
+void latency_trace_flush_start(void);
+
+/**
+ * @brief Stamp LATENCY_STAGE_FLUSH_DONE for the frame being flushed (ISR safe)
+ */
+void latency_trace_flush_done(void);
+
+/**
+ * @brief Drop the updated frame when the refresh had nothing to draw
+ */
+void latency_trace_flush_skipped(void);
+
+#else
+
+static inline uint32_t latency_trace_new_id(void) { return 0; }
+static inline void latency_trace_stamp(latency_stage_t stage, uint32_t id) { (void)stage; (void)id; }
+static inline void latency_trace_publish(uint32_t id) { (void)id; }
+static inline void latency_trace_page_update(void) {}
+static inline void latency_trace_flush_start(void) {}
+static inline void latency_trace_flush_done(void) {}
+static inline void latency_trace_flush_skipped(void) {}
+
+#endif // CONFIG_LATENCY_TRACE_ENABLE
+
+/**
+ * @brief Compute p50/p99 per stage over the trace window (one caller at a time)
+ * @param summary Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL,
+ *         ESP_ERR_NOT_SUPPORTED without CONFIG_LATENCY_TRACE_ENABLE
+ */
+esp_err_t latency_trace_get_summary(latency_trace_summary_t *summary);
+
+/**
+ * @brief Log the latency summary as a table (no-op without CONFIG_LATENCY_TRACE_ENABLE)
+ */
+void latency_trace_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_TRACE_H
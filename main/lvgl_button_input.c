@@ -2,23 +2,22 @@
  * @file lvgl_button_input.c
  * @brief LVGL Input Device Driver Implementation for M5StickC Plus 1.1 GPIO Buttons
  * 
- * This driver b    // Update button state (ISR-safe via message buffer)
-    send_button_event_from_isr(key, state);
-    
-    // 🔥 事件驱动模式：主动触发LVGL立即读取（基于官方SDL示例）
-    if (g_indev && g_input_enabled) {
-        lv_indev_read(g_indev);
-        ESP_LOGD(TAG, "🚀 Event-driven: Triggered immediate LVGL read for key=%d, state=%d", 
-                 (int)key, (int)state);
-    }e GPIO button system with LVGL's input device framework,
+ * This driver bridges the GPIO button system with LVGL's input device framework,
  * providing thread-safe button press detection and key event generation.
+ * 
+ * Debounced events arrive from the button driver's esp_timer callbacks, are
+ * queued in a message buffer and wake the LVGL task through UI_TOPIC_INPUT,
+ * which reads the keypad immediately. Nothing is logged on the event path;
+ * counters are kept for lvgl_button_input_get_stats().
  */
 
 #include "lvgl_button_input.h"
 #include "button.h"
+#include "ui_notify.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/message_buffer.h"
+#include <stdatomic.h>
 #include <string.h>
 
 static const char *TAG = "LVGL_BTN_INPUT";
@@ -34,25 +33,25 @@ typedef struct {
     lv_indev_state_t state;
 } button_event_data_t;
 
-// Message buffer for ISR-safe button events (single producer/consumer)
+// Message buffer for button events (single producer: esp_timer task, single consumer: LVGL task)
 static MessageBufferHandle_t g_button_message_buffer = NULL;
-#define BUTTON_MESSAGE_BUFFER_SIZE (sizeof(button_event_data_t) * 2 + 8)  // Max 2 messages + header overhead
+#define BUTTON_MESSAGE_BUFFER_SIZE ((sizeof(button_event_data_t) + sizeof(size_t)) * 4)  // 4 messages with length headers
 #define BUTTON_EVENT_SIZE sizeof(button_event_data_t)
 
 // Fallback state for when stream buffer is empty
 static volatile lvgl_key_t g_last_key = LVGL_KEY_NONE;
 
-// Statistics tracking
-static uint32_t g_button_a_count = 0;
-static uint32_t g_button_b_count = 0;
+// Statistics tracking (written by the button timer callbacks, read by any task)
+static atomic_uint g_button_a_count = ATOMIC_VAR_INIT(0);
+static atomic_uint g_button_b_count = ATOMIC_VAR_INIT(0);
+static atomic_uint g_events_dropped = ATOMIC_VAR_INIT(0);
 
 /**
- * @brief ISR-safe button event sender using Message Buffer
+ * @brief Queue a key state change for the LVGL task and wake it
  * 
- * Sends button events from ISR to LVGL task using single-producer/single-consumer
- * message buffer. This ensures message integrity and is interrupt-safe.
+ * Runs in the esp_timer task; never blocks and never logs.
  */
-static void send_button_event_from_isr(lvgl_key_t key, lv_indev_state_t state)
+static void send_button_event(lvgl_key_t key, lv_indev_state_t state)
 {
     if (g_button_message_buffer == NULL) {
         return;
@@ -63,53 +62,37 @@ static void send_button_event_from_isr(lvgl_key_t key, lv_indev_state_t state)
         .state = state
     };
     
-    // Send from ISR - non-blocking, ensures message integrity
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    size_t bytes_sent = xMessageBufferSendFromISR(g_button_message_buffer, 
-                                                   &event, 
-                                                   BUTTON_EVENT_SIZE, 
-                                                   &xHigherPriorityTaskWoken);
-    
-    if (bytes_sent == BUTTON_EVENT_SIZE) {
-        g_last_key = key;  // Update fallback state
-        if (state == LV_INDEV_STATE_PRESSED) {
-            // Update statistics
-            if (key == LVGL_KEY_OK) {
-                g_button_a_count++;
-            } else if (key == LVGL_KEY_NEXT) {
-                g_button_b_count++;
-            }
-            
-            ESP_LOGI(TAG, "Button pressed: %s (total A:%lu B:%lu)", 
-                     (key == LVGL_KEY_OK) ? "OK/ENTER" : "RIGHT",
-                     g_button_a_count, g_button_b_count);
-        } else {
-            ESP_LOGI(TAG, "Button released: %s", 
-                     (key == LVGL_KEY_OK) ? "OK/ENTER" : "RIGHT");
-        }
-    } else {
-        ESP_LOGW(TAG, "Message buffer full, button event dropped");
+    size_t bytes_sent = xMessageBufferSend(g_button_message_buffer, &event, BUTTON_EVENT_SIZE, 0);
+    if (bytes_sent != BUTTON_EVENT_SIZE) {
+        atomic_fetch_add_explicit(&g_events_dropped, 1, memory_order_relaxed);
+        return;
     }
     
-    // Wake higher priority task if needed
-    if (xHigherPriorityTaskWoken == pdTRUE) {
-        portYIELD_FROM_ISR();
+    g_last_key = key;  // Update fallback state
+    if (state == LV_INDEV_STATE_PRESSED) {
+        atomic_fetch_add_explicit((key == LVGL_KEY_OK) ? &g_button_a_count : &g_button_b_count,
+                                  1, memory_order_relaxed);
     }
+    
+    // Wake the LVGL task so the keypad is read without waiting for its next poll
+    ui_notify_publish(UI_TOPIC_INPUT);
 }
 
 /**
- * @brief GPIO button callback - converts button events to LVGL keys (ISR CONTEXT)
+ * @brief GPIO button callback - converts button events to LVGL key states
  * 
- * This callback is called from GPIO interrupt context and must be ISR-safe.
- * It converts the hardware button events into LVGL key events and sends them
- * via message buffer to the LVGL task.
+ * Called from the button driver's esp_timer callbacks after debouncing. Only
+ * press and release change the keypad state; LVGL derives long presses from
+ * how long the key stays pressed.
  * 
  * @param button_id Which button triggered the event
- * @param event Type of button event (press/release/long press)
+ * @param event Type of button event
  * @param press_duration Duration of press if applicable
  */
-static void button_to_lvgl_callback_isr(button_id_t button_id, button_event_t event, uint32_t press_duration)
+static void button_to_lvgl_callback(button_id_t button_id, button_event_t event, uint32_t press_duration)
 {
+    (void)press_duration;
+    
     if (!g_input_enabled) {
         return;
     }
@@ -126,7 +109,6 @@ static void button_to_lvgl_callback_isr(button_id_t button_id, button_event_t ev
             key = LVGL_KEY_NEXT;  // Button B = Next
             break;
         default:
-            ESP_LOGW(TAG, "Unknown button ID: %d", button_id);
             return;
     }
     
@@ -136,28 +118,20 @@ static void button_to_lvgl_callback_isr(button_id_t button_id, button_event_t ev
             state = LV_INDEV_STATE_PRESSED;
             break;
         case BUTTON_EVENT_RELEASED:
-        case BUTTON_EVENT_SHORT_PRESS:
-        case BUTTON_EVENT_LONG_PRESS:
             state = LV_INDEV_STATE_RELEASED;
             break;
         default:
-            return;  // Ignore other events
+            return;  // Short/long press classification is not a key state change
     }
     
-    // Update button state (ISR-safe via message buffer)
-    send_button_event_from_isr(key, state);
-    
-    // 🔥 ISR SAFETY: REMOVED direct LVGL call from ISR context
-    // LVGL functions must NEVER be called from interrupt context
-    // LVGL will be read by its timer task in polling mode
+    send_button_event(key, state);
 }
 
 /**
  * @brief LVGL input device read callback for keypad (TIMER MODE)
  * 
- * This function is called by LVGL's timer task periodically (every ~30ms).
- * It safely reads button events from the message buffer populated by ISR.
- * This avoids calling LVGL functions directly from interrupt context.
+ * Called by the LVGL task right after a UI_TOPIC_INPUT wakeup, and by LVGL's
+ * indev timer as a fallback. Reads one queued key state change per call.
  */
 static void lvgl_keypad_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
 {
@@ -184,10 +158,8 @@ static void lvgl_keypad_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
             data->key = 0;
         }
         
-        // Log timer-based behavior
-        if (event.state == LV_INDEV_STATE_PRESSED && data->key != 0) {
-            ESP_LOGI(TAG, "🔑 TIMER read: key=%"PRIu32", state=PRESSED", data->key);
-        }
+        // More queued changes (release after a quick tap): have LVGL read again
+        data->continue_reading = (xMessageBufferIsEmpty(g_button_message_buffer) == pdFALSE);
         
         ESP_LOGD(TAG, "Message buffer: Read complete message key=%d, state=%d", 
                  (int)event.key, (int)event.state);
@@ -212,7 +184,7 @@ esp_err_t lvgl_button_input_init(void)
         return ESP_OK;
     }
     
-    // Create message buffer for ISR-safe button events (prevents message fragmentation)
+    // Create message buffer for button events (prevents message fragmentation)
     g_button_message_buffer = xMessageBufferCreate(BUTTON_MESSAGE_BUFFER_SIZE);
     if (g_button_message_buffer == NULL) {
         ESP_LOGE(TAG, "Failed to create button message buffer");
@@ -229,7 +201,7 @@ esp_err_t lvgl_button_input_init(void)
     }
     
     // Set up button callback for LVGL key events
-    ret = button_set_interrupt_callback(button_to_lvgl_callback_isr);
+    ret = button_set_interrupt_callback(button_to_lvgl_callback);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set button callback: %s", esp_err_to_name(ret));
         button_deinit();
@@ -271,8 +243,9 @@ esp_err_t lvgl_button_input_init(void)
     // Initialize state
     g_last_key = LVGL_KEY_NONE;
     g_input_enabled = true;
-    g_button_a_count = 0;
-    g_button_b_count = 0;
+    atomic_store(&g_button_a_count, 0);
+    atomic_store(&g_button_b_count, 0);
+    atomic_store(&g_events_dropped, 0);
     
     g_input_initialized = true;
     
@@ -318,6 +291,18 @@ lvgl_key_t lvgl_button_input_get_last_key(void)
     return g_last_key;
 }
 
+esp_err_t lvgl_button_input_get_stats(lvgl_button_input_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    stats->ok_presses = atomic_load_explicit(&g_button_a_count, memory_order_relaxed);
+    stats->next_presses = atomic_load_explicit(&g_button_b_count, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&g_events_dropped, memory_order_relaxed);
+    return ESP_OK;
+}
+
 esp_err_t lvgl_button_input_deinit(void)
 {
     ESP_LOGI(TAG, "Deinitializing LVGL button input device...");
@@ -36,6 +36,15 @@ typedef enum {
     LVGL_KEY_NEXT = LV_KEY_RIGHT,   ///< Button B -> Right Arrow (for navigation)
 } lvgl_key_t;
 
+/**
+ * @brief Key event statistics, read instead of logging on the event path
+ */
+typedef struct {
+    uint32_t ok_presses;            ///< Button A presses delivered to LVGL
+    uint32_t next_presses;          ///< Button B presses delivered to LVGL
+    uint32_t dropped;               ///< Key state changes lost to a full message buffer
+} lvgl_button_input_stats_t;
+
 /**
  * @brief Initialize LVGL input device driver for buttons
  * 
@@ -87,6 +96,14 @@ bool lvgl_button_input_is_event_driven(void);
  */
 lvgl_key_t lvgl_button_input_get_last_key(void);
 
+/**
+ * @brief Get key event statistics
+ * 
+ * @param stats Pointer to store the statistics
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t lvgl_button_input_get_stats(lvgl_button_input_stats_t *stats);
+
 /**
  * @brief Deinitialize LVGL input device driver
  * 
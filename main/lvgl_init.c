@@ -4,9 +4,11 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/lock.h>
 #include <assert.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -17,16 +19,25 @@
 #include "esp_lcd_panel_ops.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "soc/spi_pins.h"
 #include "lvgl.h"
 
 #include "axp192.h"
 #include "st7789_lcd.h"
+#include "ui_notify.h"
+#include "task_placement.h"
+#include "latency_trace.h"
+#include "mem_account.h"
+#include "boot_timeline.h"
+#include "lvgl_init.h"
 
 static const char *TAG = "LVGL_INIT";
 
 // M5StickC Plus LCD configuration (matching our working ST7789 code)
 #define LCD_HOST            SPI2_HOST
-#define LCD_PIXEL_CLOCK_HZ  (10 * 1000 * 1000)  // 10MHz for maximum stability
+#define LCD_PIXEL_CLOCK_HZ  (CONFIG_LCD_SPI_CLOCK_MHZ * 1000 * 1000)  // Requested clock, see LCD_SPI_CLOCK in Kconfig
+#define LCD_PIXEL_CLOCK_MIN_HZ (10 * 1000 * 1000)  // Last fallback, known good on this board
 #define PIN_NUM_SCLK        13
 #define PIN_NUM_MOSI        15
 #define PIN_NUM_MISO        -1  // Not used
@@ -34,20 +45,140 @@ static const char *TAG = "LVGL_INIT";
 #define PIN_NUM_LCD_RST     18
 #define PIN_NUM_LCD_CS      5
 
+// SPI signals routed through the GPIO matrix are limited to 40MHz, only IOMUX pins reach 80MHz
+#define LCD_SPI_PINS_ARE_IOMUX  (PIN_NUM_SCLK == SPI2_IOMUX_PIN_NUM_CLK && PIN_NUM_MOSI == SPI2_IOMUX_PIN_NUM_MOSI)
+#define LCD_GPIO_MATRIX_MAX_HZ  (40 * 1000 * 1000)
+
 // LVGL configuration (based on official example)
-#define LVGL_DRAW_BUF_LINES    20    // Number of display lines in each draw buffer
-#define LVGL_TICK_PERIOD_MS    2
+#define LVGL_DRAW_BUF_LINES    CONFIG_LCD_DRAW_BUF_LINES    // Requested display lines in each draw buffer
+#define LVGL_DRAW_BUF_MIN_LINES 10                          // Smallest buffer tried when the heap is short
+#define LVGL_DRAW_BUF_HEAP_RESERVE (CONFIG_LCD_DRAW_BUF_HEAP_RESERVE_KB * 1024)  // Internal heap left for WiFi/ESP-NOW
 #define LVGL_TASK_MAX_DELAY_MS 500
-#define LVGL_TASK_MIN_DELAY_MS 1
-#define LVGL_TASK_STACK_SIZE   (4 * 1024)
-#define LVGL_TASK_PRIORITY     2
+
+// Draw buffers, allocated by lvgl_reserve_draw_buffers() before the radio starts
+static void *s_draw_buf[2] = { NULL, NULL };
+static size_t s_draw_buf_sz = 0;
+static uint16_t s_draw_buf_lines = 0;
+
+// LVGL task handle and display pause request (set from any task, applied in the LVGL task)
+static TaskHandle_t s_lvgl_task = NULL;
+static atomic_bool s_display_pause_requested = ATOMIC_VAR_INIT(false);
 
 // LVGL library is not thread-safe, use a mutex to protect it (simplified for now)
 // static _lock_t lvgl_api_lock;
 
+// ===== DISPLAY PERFORMANCE TRACKING =====
+
+// Trace of the refresh in progress (LVGL task and SPI transfer-done ISR)
+typedef struct {
+    int64_t frame_start_us;     // LV_EVENT_REFR_START
+    int64_t wait_start_us;      // LV_EVENT_FLUSH_WAIT_START
+    int64_t flush_start_us;     // Stripe handed to esp_lcd
+    uint32_t render_end_us;     // LV_EVENT_REFR_READY, relative to frame start
+    uint32_t wait_us;           // Time LVGL blocked on a DMA transfer
+    uint32_t transfer_us;       // Total SPI DMA time of this refresh
+    uint32_t stripes;           // Flushed areas
+    bool active;                // Between REFR_START and the last transfer done
+    bool render_done;           // REFR_READY seen
+    bool flushing;              // A stripe transfer is in flight
+} lvgl_frame_trace_t;
+
+static portMUX_TYPE s_perf_lock = portMUX_INITIALIZER_UNLOCKED;
+static lvgl_frame_trace_t s_frame = {0};
+static lvgl_display_perf_t s_perf = {0};
+
+// Exponential moving average with 1/8 weight for the new sample
+static uint32_t perf_ema(uint32_t avg, uint32_t sample)
+{
+    if (avg == 0) {
+        return sample;
+    }
+    return (uint32_t)((int32_t)avg + ((int32_t)sample - (int32_t)avg) / 8);
+}
+
+/**
+ * @brief Publish the traced frame once rendering and the last transfer finished
+ *
+ * Caller must hold s_perf_lock.
+ */
+static void perf_finish_frame_locked(int64_t now_us)
+{
+    if (!s_frame.active || !s_frame.render_done || s_frame.flushing) {
+        return;
+    }
+    s_frame.active = false;
+    if (s_frame.stripes == 0) {
+        latency_trace_flush_skipped();
+        return;  // Refresh timer ran without invalid areas
+    }
+    latency_trace_flush_done();
+
+    uint32_t frame_us = (uint32_t)(now_us - s_frame.frame_start_us);
+    uint32_t render_us = s_frame.render_end_us > s_frame.wait_us ?
+                         s_frame.render_end_us - s_frame.wait_us : 0;
+
+    s_perf.frames++;
+    s_perf.last_frame_us = frame_us;
+    s_perf.last_render_us = render_us;
+    s_perf.last_transfer_us = s_frame.transfer_us;
+    s_perf.last_flush_wait_us = s_frame.wait_us;
+    s_perf.last_stripes = s_frame.stripes;
+    s_perf.avg_frame_us = perf_ema(s_perf.avg_frame_us, frame_us);
+    s_perf.avg_render_us = perf_ema(s_perf.avg_render_us, render_us);
+    s_perf.avg_transfer_us = perf_ema(s_perf.avg_transfer_us, s_frame.transfer_us);
+    if (frame_us > s_perf.max_frame_us) {
+        s_perf.max_frame_us = frame_us;
+    }
+}
+
+static void lvgl_perf_event_cb(lv_event_t *e)
+{
+    int64_t now_us = esp_timer_get_time();
+    lv_event_code_t code = lv_event_get_code(e);
+
+    portENTER_CRITICAL(&s_perf_lock);
+    switch (code) {
+        case LV_EVENT_REFR_START:
+            // A transfer still in flight from the previous refresh is dropped from the trace
+            memset(&s_frame, 0, sizeof(s_frame));
+            s_frame.active = true;
+            s_frame.frame_start_us = now_us;
+            break;
+        case LV_EVENT_FLUSH_WAIT_START:
+            s_frame.wait_start_us = now_us;
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            if (s_frame.active && s_frame.wait_start_us != 0) {
+                s_frame.wait_us += (uint32_t)(now_us - s_frame.wait_start_us);
+                s_frame.wait_start_us = 0;
+            }
+            break;
+        case LV_EVENT_REFR_READY:
+            if (s_frame.active) {
+                s_frame.render_end_us = (uint32_t)(now_us - s_frame.frame_start_us);
+                s_frame.render_done = true;
+                perf_finish_frame_locked(now_us);
+            }
+            break;
+        default:
+            break;
+    }
+    portEXIT_CRITICAL(&s_perf_lock);
+}
+
 static bool notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
     lv_display_t *disp = (lv_display_t *)user_ctx;
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&s_perf_lock);
+    if (s_frame.flushing) {
+        s_frame.transfer_us += (uint32_t)(now_us - s_frame.flush_start_us);
+        s_frame.flushing = false;
+        perf_finish_frame_locked(now_us);
+    }
+    portEXIT_CRITICAL_ISR(&s_perf_lock);
+
     lv_display_flush_ready(disp);
     return false;
 }
@@ -60,45 +191,230 @@ static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px
     int offsety1 = area->y1;
     int offsety2 = area->y2;
     
-    // Copy a buffer's content to a specific area of the display
+    portENTER_CRITICAL(&s_perf_lock);
+    if (s_frame.active) {
+        s_frame.flush_start_us = esp_timer_get_time();
+        s_frame.flushing = true;
+        if (++s_frame.stripes == 1) {
+            latency_trace_flush_start();
+        }
+    }
+    portEXIT_CRITICAL(&s_perf_lock);
+    
+    // Copy a buffer's content to a specific area of the display; LVGL renders the
+    // next stripe into the other buffer while this one is sent by DMA
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map);
 }
 
-static void increase_lvgl_tick(void *arg)
+esp_err_t lvgl_get_display_perf(lvgl_display_perf_t *perf)
+{
+    if (perf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_perf_lock);
+    *perf = s_perf;
+    portEXIT_CRITICAL(&s_perf_lock);
+    return ESP_OK;
+}
+
+// ===== DISPLAY PROFILE SETUP =====
+
+/**
+ * @brief Create the panel IO at the fastest supported clock not above the request
+ *
+ * Steps down through 80/40/20/10MHz until the SPI driver accepts the device.
+ */
+static esp_err_t lcd_new_panel_io_with_fallback(esp_lcd_panel_io_spi_config_t *io_config,
+                                                esp_lcd_panel_io_handle_t *io_handle)
+{
+    static const uint32_t clock_steps_hz[] = {
+        80 * 1000 * 1000, 40 * 1000 * 1000, 20 * 1000 * 1000, LCD_PIXEL_CLOCK_MIN_HZ,
+    };
+
+    uint32_t max_hz = LCD_PIXEL_CLOCK_HZ;
+    if (!LCD_SPI_PINS_ARE_IOMUX && max_hz > LCD_GPIO_MATRIX_MAX_HZ) {
+        ESP_LOGW(TAG, "⚠️ LCD pins use the GPIO matrix, limiting SPI clock to %d MHz",
+                 LCD_GPIO_MATRIX_MAX_HZ / 1000000);
+        max_hz = LCD_GPIO_MATRIX_MAX_HZ;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+    for (size_t i = 0; i < sizeof(clock_steps_hz) / sizeof(clock_steps_hz[0]); i++) {
+        if (clock_steps_hz[i] > max_hz) {
+            continue;
+        }
+        io_config->pclk_hz = clock_steps_hz[i];
+        ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, io_config, io_handle);
+        if (ret == ESP_OK) {
+            s_perf.pixel_clock_hz = clock_steps_hz[i];
+            ESP_LOGI(TAG, "📺 LCD SPI clock: %lu MHz (requested %d MHz)",
+                     (unsigned long)(clock_steps_hz[i] / 1000000), CONFIG_LCD_SPI_CLOCK_MHZ);
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "⚠️ LCD SPI clock %lu MHz rejected: %s, falling back",
+                 (unsigned long)(clock_steps_hz[i] / 1000000), esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * @brief Allocate both draw buffers, halving the line count until the heap allows it
+ *
+ * A buffer size is only accepted if LVGL_DRAW_BUF_HEAP_RESERVE bytes of internal
+ * heap remain free. This holds for WiFi and ESP-NOW only because app_main calls
+ * lvgl_reserve_draw_buffers() before the radio task is created.
+ */
+static esp_err_t lvgl_alloc_draw_buffers(void **buf1, void **buf2, size_t *buffer_sz, uint16_t *lines)
+{
+    uint32_t try_lines = LVGL_DRAW_BUF_LINES;
+    if (try_lines > ST7789_LCD_V_RES) {
+        try_lines = ST7789_LCD_V_RES;
+    }
+
+    while (try_lines >= LVGL_DRAW_BUF_MIN_LINES) {
+        size_t sz = ST7789_LCD_H_RES * try_lines * sizeof(lv_color16_t);
+        size_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+        if (free_internal >= 2 * sz + LVGL_DRAW_BUF_HEAP_RESERVE) {
+            void *b1 = spi_bus_dma_memory_alloc(LCD_HOST, sz, 0);
+            void *b2 = (b1 != NULL) ? spi_bus_dma_memory_alloc(LCD_HOST, sz, 0) : NULL;
+            if (b1 != NULL && b2 != NULL) {
+                mem_account_track(MEM_MODULE_LCD_DMA, b1);
+                mem_account_track(MEM_MODULE_LCD_DMA, b2);
+                *buf1 = b1;
+                *buf2 = b2;
+                *buffer_sz = sz;
+                *lines = (uint16_t)try_lines;
+                return ESP_OK;
+            }
+            free(b1);
+        }
+
+        ESP_LOGW(TAG, "⚠️ Not enough DMA heap for 2x%lu-line draw buffers (%u bytes free)",
+                 (unsigned long)try_lines, (unsigned)free_internal);
+        try_lines /= 2;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t lvgl_reserve_draw_buffers(void)
 {
-    /* Tell LVGL how many milliseconds has elapsed */
-    lv_tick_inc(LVGL_TICK_PERIOD_MS);
+    if (s_draw_buf[0] != NULL) {
+        return ESP_OK;
+    }
+    esp_err_t ret = lvgl_alloc_draw_buffers(&s_draw_buf[0], &s_draw_buf[1], &s_draw_buf_sz, &s_draw_buf_lines);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to allocate LVGL draw buffers");
+        return ret;
+    }
+    ESP_LOGI(TAG, "📺 LVGL draw buffers: 2 x %u lines (%u bytes each, requested %d lines)",
+             s_draw_buf_lines, (unsigned)s_draw_buf_sz, LVGL_DRAW_BUF_LINES);
+    return ESP_OK;
+}
+
+// LVGL time base read from esp_timer: no periodic tick interrupt keeps the CPU out of light sleep
+static uint32_t lvgl_tick_get_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void lvgl_set_display_paused(bool paused)
+{
+    bool previous = atomic_exchange(&s_display_pause_requested, paused);
+    if (previous != paused && s_lvgl_task != NULL) {
+        xTaskNotifyGive(s_lvgl_task);
+    }
+}
+
+/**
+ * @brief Stop or restart rendering; must run in the LVGL task
+ *
+ * While paused, invalidation is disabled so nothing is rendered or flushed.
+ * On resume the whole screen is invalidated to pick up label changes made
+ * while the screen was dark.
+ */
+static void lvgl_apply_display_paused(lv_display_t *disp, bool paused)
+{
+    if (paused) {
+        lv_display_enable_invalidation(disp, false);
+        ESP_LOGI(TAG, "💤 Display off - LVGL rendering paused");
+    } else {
+        lv_display_enable_invalidation(disp, true);
+        lv_obj_invalidate(lv_display_get_screen_active(disp));
+        ESP_LOGI(TAG, "💡 Display on - LVGL rendering resumed");
+    }
+}
+
+// Read all input devices now instead of waiting for their LVGL poll timer
+static void lvgl_read_input_devices(void)
+{
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev != NULL; indev = lv_indev_get_next(indev)) {
+        lv_indev_read(indev);
+    }
 }
 
 static void lvgl_port_task(void *arg)
 {
-    ESP_LOGI(TAG, "Starting LVGL task");
+    lv_display_t *disp = (lv_display_t *)arg;
+    bool paused = false;
+    bool first_frame = false;
+    
+    ESP_LOGI(TAG, "Starting LVGL task (priority %d, core %d)", CONFIG_LVGL_TASK_PRIORITY, CONFIG_LVGL_TASK_CORE_ID);
+    
+    // Producers wake this task through ui_notify instead of pages polling them
+    ui_notify_bind_current_task();
     
     while (1) {
+        bool pause_requested = atomic_load(&s_display_pause_requested);
+        if (pause_requested != paused) {
+            paused = pause_requested;
+            lvgl_apply_display_paused(disp, paused);
+        }
+        
+        uint32_t pending = ui_notify_get_pending();
+        if (paused && !(pending & UI_TOPIC_INPUT)) {
+            // Screen is dark: data topics stay pending, only input or a resume wakes us
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        
+        if (pending & UI_TOPIC_INPUT) {
+            lvgl_read_input_devices();
+        }
+        
+        // Refresh pages for published topics first so the same pass renders them
+        uint32_t notify_delay_ms = ui_notify_process();
+        
         // _lock_acquire(&lvgl_api_lock);  // Simplified for now
         uint32_t task_delay_ms = lv_timer_handler();
         // _lock_release(&lvgl_api_lock);  // Simplified for now
         
+        // Boot defers non-critical work until the first screen is out
+        if (!first_frame) {
+            portENTER_CRITICAL(&s_perf_lock);
+            first_frame = (s_perf.frames > 0);
+            portEXIT_CRITICAL(&s_perf_lock);
+            if (first_frame) {
+                boot_timeline_mark(BOOT_STAGE_FIRST_FRAME);
+            }
+        }
+        
+        if (notify_delay_ms < task_delay_ms) {
+            task_delay_ms = notify_delay_ms;
+        }
         if (task_delay_ms > LVGL_TASK_MAX_DELAY_MS) {
             task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
-        } else if (task_delay_ms < LVGL_TASK_MIN_DELAY_MS) {
-            task_delay_ms = LVGL_TASK_MIN_DELAY_MS;
         }
         
-        // Ensure IDLE task gets a chance to run and reset watchdog
-        // Force minimum delay to prevent task starvation
-        if (task_delay_ms < 10) {
-            task_delay_ms = 10;  // Minimum 10ms to ensure IDLE task runs
+        // Block for at least one tick so lower priority tasks (and IDLE) always run
+        TickType_t delay_ticks = pdMS_TO_TICKS(task_delay_ms);
+        if (delay_ticks == 0) {
+            delay_ticks = 1;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
-        
-        // Additional safety: yield CPU every 100 iterations to prevent starvation
-        static uint32_t yield_counter = 0;
-        if (++yield_counter >= 100) {
-            yield_counter = 0;
-            taskYIELD();  // Explicitly yield to other tasks
-        }
+        // Sleep until the next LVGL timer is due, a topic is published or input arrives
+        ulTaskNotifyTake(pdTRUE, delay_ticks);
     }
 }
 
@@ -114,7 +430,7 @@ esp_err_t lvgl_init_base(void)
         .miso_io_num = PIN_NUM_MISO,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
-        .max_transfer_sz = ST7789_LCD_H_RES * 80 * sizeof(uint16_t),
+        .max_transfer_sz = ST7789_LCD_H_RES * ST7789_LCD_V_RES * sizeof(uint16_t),  // Up to a full-frame buffer
     };
     ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
 
@@ -123,13 +439,13 @@ esp_err_t lvgl_init_base(void)
     esp_lcd_panel_io_spi_config_t io_config = {
         .dc_gpio_num = PIN_NUM_LCD_DC,
         .cs_gpio_num = PIN_NUM_LCD_CS,
-        .pclk_hz = LCD_PIXEL_CLOCK_HZ,
+        .pclk_hz = LCD_PIXEL_CLOCK_HZ,  // Adjusted by lcd_new_panel_io_with_fallback()
         .lcd_cmd_bits = 8,
         .lcd_param_bits = 8,
         .spi_mode = 0,
         .trans_queue_depth = 10,
     };
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle));
+    ESP_ERROR_CHECK(lcd_new_panel_io_with_fallback(&io_config, &io_handle));
 
     esp_lcd_panel_handle_t panel_handle = NULL;
     esp_lcd_panel_dev_config_t panel_config = {
@@ -157,24 +473,14 @@ esp_err_t lvgl_init_base(void)
     // Create a lvgl display for PORTRAIT mode (135x240)
     lv_display_t *display = lv_display_create(ST7789_LCD_H_RES, ST7789_LCD_V_RES);  // Original W/H for portrait
 
-    // Alloc draw buffers used by LVGL for PORTRAIT mode
-    // Buffer size based on portrait width (135 pixels)
-    size_t draw_buffer_sz = ST7789_LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t);
-
-    void *buf1 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
-    if (buf1 == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate LVGL draw buffer 1");
-        return ESP_FAIL;
-    }
-    void *buf2 = spi_bus_dma_memory_alloc(LCD_HOST, draw_buffer_sz, 0);
-    if (buf2 == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate LVGL draw buffer 2");
-        free(buf1);
+    // Draw buffers for PORTRAIT mode (135 pixels wide), normally reserved by app_main already
+    if (lvgl_reserve_draw_buffers() != ESP_OK) {
         return ESP_FAIL;
     }
+    s_perf.buffer_lines = s_draw_buf_lines;
     
     // Initialize LVGL draw buffers (following official example)
-    lv_display_set_buffers(display, buf1, buf2, draw_buffer_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_buffers(display, s_draw_buf[0], s_draw_buf[1], s_draw_buf_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
     
     // Associate the panel handle to the display
     lv_display_set_user_data(display, panel_handle);
@@ -185,14 +491,14 @@ esp_err_t lvgl_init_base(void)
     // Set the callback which can copy the rendered image to an area of the display
     lv_display_set_flush_cb(display, lvgl_flush_cb);
 
-    ESP_LOGI(TAG, "Install LVGL tick timer");
-    const esp_timer_create_args_t lvgl_tick_timer_args = {
-        .callback = &increase_lvgl_tick,
-        .name = "lvgl_tick"
-    };
-    esp_timer_handle_t lvgl_tick_timer = NULL;
-    ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000));
+    // Track render time versus SPI transfer time per refresh
+    lv_display_add_event_cb(display, lvgl_perf_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display, lvgl_perf_event_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_add_event_cb(display, lvgl_perf_event_cb, LV_EVENT_FLUSH_WAIT_START, NULL);
+    lv_display_add_event_cb(display, lvgl_perf_event_cb, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
+
+    ESP_LOGI(TAG, "Use esp_timer as the LVGL tick source");
+    lv_tick_set_cb(lvgl_tick_get_ms);
 
     ESP_LOGI(TAG, "Register io panel event callback for LVGL flush ready notification");
     const esp_lcd_panel_io_callbacks_t cbs = {
@@ -201,7 +507,11 @@ esp_err_t lvgl_init_base(void)
     esp_lcd_panel_io_register_event_callbacks(io_handle, &cbs, display);
 
     ESP_LOGI(TAG, "Start LVGL task");
-    xTaskCreate(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL);
+    esp_err_t task_ret = task_placement_create(TASK_PLACEMENT_LVGL, lvgl_port_task, display, &s_lvgl_task);
+    if (task_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create LVGL task");
+        return ESP_FAIL;
+    }
 
     ESP_LOGI(TAG, "LVGL base initialization complete (no demo UI created)");
     return ESP_OK;
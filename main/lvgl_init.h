@@ -8,11 +8,48 @@
 
 #include "esp_err.h"
 #include "lvgl.h"
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Display performance profile and per-refresh timing
+ *
+ * A refresh runs from LV_EVENT_REFR_START until the last stripe finished its
+ * SPI DMA transfer. Render time is the CPU time LVGL spent drawing (refresh
+ * time minus time blocked waiting for a transfer); transfer time is the total
+ * DMA time. With double buffering both overlap, so frame time approaches the
+ * larger of the two.
+ */
+typedef struct {
+    uint32_t pixel_clock_hz;        // SPI clock in use after fallback
+    uint16_t buffer_lines;          // Lines per draw buffer after heap fallback
+    uint32_t frames;                // Refreshes that flushed at least one stripe
+    uint32_t last_frame_us;         // Last refresh, start to last transfer done
+    uint32_t last_render_us;        // Last refresh, LVGL drawing time
+    uint32_t last_transfer_us;      // Last refresh, SPI DMA time
+    uint32_t last_flush_wait_us;    // Last refresh, time LVGL waited for DMA
+    uint32_t last_stripes;          // Last refresh, number of flushed areas
+    uint32_t avg_frame_us;          // Moving averages (1/8 weight)
+    uint32_t avg_render_us;
+    uint32_t avg_transfer_us;
+    uint32_t max_frame_us;          // Slowest refresh since boot
+} lvgl_display_perf_t;
+
+/**
+ * @brief Allocate the LVGL draw buffers ahead of the display bring-up
+ *
+ * Call before WiFi and ESP-NOW start allocating, so the internal heap reserve
+ * (CONFIG_LCD_DRAW_BUF_HEAP_RESERVE_KB) is checked against a quiet heap.
+ * lvgl_init_base() uses the buffers, or allocates them itself if this was not called.
+ *
+ * @return ESP_OK on success (also when already allocated), ESP_ERR_NO_MEM if even
+ *         the smallest buffers don't fit
+ */
+esp_err_t lvgl_reserve_draw_buffers(void);
+
 /**
  * @brief Initialize LVGL with M5StickC Plus LCD (without demo UI)
  * 
@@ -34,6 +71,23 @@ esp_err_t lvgl_init_base(void);
  */
 esp_err_t lvgl_init_for_page_manager(lv_display_t **display);
 
+/**
+ * @brief Get the display profile and refresh timing statistics
+ * @param perf Pointer to structure to fill
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if perf is NULL
+ */
+esp_err_t lvgl_get_display_perf(lvgl_display_perf_t *perf);
+
+/**
+ * @brief Pause or resume LVGL rendering (e.g. while the backlight is off)
+ *
+ * Safe to call from any task. While paused the LVGL task blocks until input
+ * arrives; data updates stay pending and are shown on resume.
+ *
+ * @param paused true to stop rendering, false to resume
+ */
+void lvgl_set_display_paused(bool paused);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,204 @@
+/*
+ * Memory Accounting for M5StickC Plus 1.1
+ * Heap use per module, heap fragmentation and task stack headroom
+ */
+
+#include "mem_account.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <string.h>
+
+#if CONFIG_MEM_ACCOUNT_ENABLE
+#include <stdatomic.h>
+#endif
+
+static const char *TAG = "MEM_ACCOUNT";
+
+// Short enough for the Memory subpage column
+static const char *const s_module_names[MEM_MODULE_COUNT] = {
+    [MEM_MODULE_ESPNOW]       = "espnow",
+    [MEM_MODULE_TLV_TABLE]    = "tlv",
+    [MEM_MODULE_HISTORY]      = "hist",
+    [MEM_MODULE_LCD_DMA]      = "lcd",
+    [MEM_MODULE_DEVICE_STORE] = "store",
+};
+
+#if CONFIG_MEM_ACCOUNT_ENABLE
+
+// Counters of one module; updated lock-free from any task
+typedef struct {
+    atomic_uint heap_bytes;
+    atomic_uint heap_peak;
+    atomic_uint static_bytes;
+    atomic_uint allocs;
+    atomic_uint failures;
+} mem_module_counters_t;
+
+static mem_module_counters_t s_modules[MEM_MODULE_COUNT];
+
+static void mem_account_charge(mem_module_t module, void *ptr)
+{
+    if (module >= MEM_MODULE_COUNT) {
+        return;
+    }
+    mem_module_counters_t *counters = &s_modules[module];
+    if (ptr == NULL) {
+        atomic_fetch_add_explicit(&counters->failures, 1, memory_order_relaxed);
+        return;
+    }
+
+    unsigned size = (unsigned)heap_caps_get_allocated_size(ptr);
+    unsigned now = atomic_fetch_add_explicit(&counters->heap_bytes, size, memory_order_relaxed) + size;
+    atomic_fetch_add_explicit(&counters->allocs, 1, memory_order_relaxed);
+
+    unsigned peak = atomic_load_explicit(&counters->heap_peak, memory_order_relaxed);
+    while (now > peak &&
+           !atomic_compare_exchange_weak_explicit(&counters->heap_peak, &peak, now,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void *mem_account_malloc(mem_module_t module, size_t size)
+{
+    void *ptr = malloc(size);
+    mem_account_charge(module, ptr);
+    return ptr;
+}
+
+void *mem_account_calloc(mem_module_t module, size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    mem_account_charge(module, ptr);
+    return ptr;
+}
+
+void *mem_account_caps_malloc(mem_module_t module, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_malloc(size, caps);
+    mem_account_charge(module, ptr);
+    return ptr;
+}
+
+void mem_account_untrack(mem_module_t module, void *ptr)
+{
+    if (ptr == NULL || module >= MEM_MODULE_COUNT) {
+        return;
+    }
+    unsigned size = (unsigned)heap_caps_get_allocated_size(ptr);
+    atomic_fetch_sub_explicit(&s_modules[module].heap_bytes, size, memory_order_relaxed);
+}
+
+void mem_account_free(mem_module_t module, void *ptr)
+{
+    mem_account_untrack(module, ptr);
+    free(ptr);
+}
+
+void mem_account_track(mem_module_t module, void *ptr)
+{
+    if (ptr != NULL) {
+        mem_account_charge(module, ptr);
+    }
+}
+
+void mem_account_set_static(mem_module_t module, size_t bytes)
+{
+    if (module < MEM_MODULE_COUNT) {
+        atomic_store_explicit(&s_modules[module].static_bytes, (unsigned)bytes, memory_order_relaxed);
+    }
+}
+
+#endif // CONFIG_MEM_ACCOUNT_ENABLE
+
+static void mem_account_read_heap(uint32_t caps, mem_account_heap_t *heap)
+{
+    heap->free_bytes = (uint32_t)heap_caps_get_free_size(caps);
+    heap->min_free_bytes = (uint32_t)heap_caps_get_minimum_free_size(caps);
+    heap->largest_free_block = (uint32_t)heap_caps_get_largest_free_block(caps);
+    heap->fragmentation_pct = (heap->free_bytes > 0) ?
+        (uint8_t)(100u - (uint32_t)((uint64_t)heap->largest_free_block * 100u / heap->free_bytes)) : 0;
+}
+
+esp_err_t mem_account_get_snapshot(mem_account_snapshot_t *snapshot)
+{
+    if (snapshot == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    for (int i = 0; i < MEM_MODULE_COUNT; i++) {
+        mem_account_module_t *module = &snapshot->modules[i];
+        module->name = s_module_names[i];
+#if CONFIG_MEM_ACCOUNT_ENABLE
+        module->heap_bytes = atomic_load_explicit(&s_modules[i].heap_bytes, memory_order_relaxed);
+        module->heap_peak = atomic_load_explicit(&s_modules[i].heap_peak, memory_order_relaxed);
+        module->static_bytes = atomic_load_explicit(&s_modules[i].static_bytes, memory_order_relaxed);
+        module->allocs = atomic_load_explicit(&s_modules[i].allocs, memory_order_relaxed);
+        module->failures = atomic_load_explicit(&s_modules[i].failures, memory_order_relaxed);
+#endif
+    }
+#if CONFIG_MEM_ACCOUNT_ENABLE
+    snapshot->tagged = true;
+#endif
+
+    mem_account_read_heap(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, &snapshot->internal);
+    mem_account_read_heap(MALLOC_CAP_DMA, &snapshot->dma);
+
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; i++) {
+        const task_placement_t *placement = task_placement_get((task_placement_id_t)i);
+        mem_account_stack_t *stack = &snapshot->stacks[i];
+        stack->name = placement->name;
+        stack->stack_size = placement->stack_size;
+        stack->stack_free_min = MEM_ACCOUNT_STACK_UNKNOWN;
+
+        if (strnlen(placement->name, configMAX_TASK_NAME_LEN) >= configMAX_TASK_NAME_LEN) {
+            continue;   // xTaskGetHandle() asserts on names FreeRTOS would truncate
+        }
+        TaskHandle_t handle = xTaskGetHandle(placement->name);
+        if (handle == NULL) {
+            continue;   // Not started yet, or a one-shot task that has finished
+        }
+        stack->stack_free_min = (uint32_t)uxTaskGetStackHighWaterMark(handle);     // Bytes on ESP-IDF
+        if (stack->stack_free_min > MEM_ACCOUNT_STACK_MARGIN) {
+            snapshot->stack_reclaimable += stack->stack_free_min - MEM_ACCOUNT_STACK_MARGIN;
+        }
+    }
+    return ESP_OK;
+}
+
+void mem_account_log(void)
+{
+    static mem_account_snapshot_t snapshot;     // Kept off the task monitor stack
+    mem_account_get_snapshot(&snapshot);
+
+    ESP_LOGI(TAG, "=== Memory: internal %" PRIu32 " free (min %" PRIu32 "), largest %" PRIu32 ", frag %u%% ===",
+             snapshot.internal.free_bytes, snapshot.internal.min_free_bytes,
+             snapshot.internal.largest_free_block, snapshot.internal.fragmentation_pct);
+    ESP_LOGI(TAG, "DMA %" PRIu32 " free (min %" PRIu32 "), largest %" PRIu32 ", frag %u%%",
+             snapshot.dma.free_bytes, snapshot.dma.min_free_bytes,
+             snapshot.dma.largest_free_block, snapshot.dma.fragmentation_pct);
+
+    if (snapshot.tagged) {
+        for (int i = 0; i < MEM_MODULE_COUNT; i++) {
+            const mem_account_module_t *module = &snapshot.modules[i];
+            ESP_LOGI(TAG, "%s %-10s heap %6" PRIu32 " peak %6" PRIu32 " static %6" PRIu32 " allocs %" PRIu32,
+                     (module->failures > 0) ? "⚠️" : "  ", module->name, module->heap_bytes,
+                     module->heap_peak, module->static_bytes, module->allocs);
+        }
+    }
+
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; i++) {
+        const mem_account_stack_t *stack = &snapshot.stacks[i];
+        if (stack->stack_free_min == MEM_ACCOUNT_STACK_UNKNOWN) {
+            continue;
+        }
+        bool oversized = stack->stack_free_min * 100u > stack->stack_size * MEM_ACCOUNT_STACK_OVERSIZED_PCT;
+        ESP_LOGI(TAG, "%s %-16s stack %5" PRIu32 " used %5" PRIu32 " free %5" PRIu32,
+                 oversized ? "📉" : "  ", stack->name, stack->stack_size,
+                 stack->stack_size - stack->stack_free_min, stack->stack_free_min);
+    }
+    ESP_LOGI(TAG, "Stack headroom above %d bytes per task: %" PRIu32 " bytes",
+             MEM_ACCOUNT_STACK_MARGIN, snapshot.stack_reclaimable);
+}
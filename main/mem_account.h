@@ -0,0 +1,147 @@
+/*
+ * Memory Accounting for M5StickC Plus 1.1
+ * Heap use per module, heap fragmentation and task stack headroom
+ */
+
+#ifndef MEM_ACCOUNT_H
+#define MEM_ACCOUNT_H
+
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "task_placement.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEM_ACCOUNT_STACK_MARGIN    1024    // Stack bytes kept free when computing reclaimable headroom
+#define MEM_ACCOUNT_STACK_UNKNOWN   UINT32_MAX  // stack_free_min of a task that is not running
+#define MEM_ACCOUNT_STACK_OVERSIZED_PCT 50  // A stack is oversized when more than this share never ran
+
+/**
+ * @brief Modules whose memory is accounted
+ */
+typedef enum {
+    MEM_MODULE_ESPNOW = 0,          // Receive ring, discovery buffers, decode batches
+    MEM_MODULE_TLV_TABLE,           // Device table, hash index and numeric columns
+    MEM_MODULE_HISTORY,             // Per-node reading trends
+    MEM_MODULE_LCD_DMA,             // LVGL draw buffers and st7789 fill stripes
+    MEM_MODULE_DEVICE_STORE,        // NVS image buffers
+    MEM_MODULE_COUNT
+} mem_module_t;
+
+/**
+ * @brief Memory of one module
+ */
+typedef struct {
+    const char *name;
+    uint32_t heap_bytes;            // Heap blocks currently held
+    uint32_t heap_peak;             // High-water mark of heap_bytes since boot
+    uint32_t static_bytes;          // Fixed arrays in .bss/.data, registered once
+    uint32_t allocs;                // Successful allocations
+    uint32_t failures;              // Allocations that returned NULL
+} mem_account_module_t;
+
+/**
+ * @brief Free space and fragmentation of one heap capability
+ */
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t min_free_bytes;        // Low-water mark since boot
+    uint32_t largest_free_block;    // Largest single allocation that would succeed
+    uint8_t fragmentation_pct;      // 100 - largest_free_block / free_bytes, in percent
+} mem_account_heap_t;
+
+/**
+ * @brief Stack headroom of one placed task
+ */
+typedef struct {
+    const char *name;
+    uint32_t stack_size;            // Configured in the task placement table
+    uint32_t stack_free_min;        // Bytes never used, MEM_ACCOUNT_STACK_UNKNOWN if not running
+} mem_account_stack_t;
+
+/**
+ * @brief Memory accounting snapshot
+ */
+typedef struct {
+    mem_account_module_t modules[MEM_MODULE_COUNT];
+    mem_account_heap_t internal;    // MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT
+    mem_account_heap_t dma;         // MALLOC_CAP_DMA
+    mem_account_stack_t stacks[TASK_PLACEMENT_COUNT];
+    uint32_t stack_reclaimable;     // Headroom above MEM_ACCOUNT_STACK_MARGIN over the running tasks
+    bool tagged;                    // Module heap figures valid (CONFIG_MEM_ACCOUNT_ENABLE)
+} mem_account_snapshot_t;
+
+#if CONFIG_MEM_ACCOUNT_ENABLE
+
+/**
+ * @brief Allocate and charge the block to a module (any task)
+ *
+ * The block is charged with its real size from heap_caps_get_allocated_size(),
+ * so nothing is added to the block. Free it with mem_account_free() and the
+ * same module.
+ */
+void *mem_account_malloc(mem_module_t module, size_t size);
+void *mem_account_calloc(mem_module_t module, size_t count, size_t size);
+void *mem_account_caps_malloc(mem_module_t module, size_t size, uint32_t caps);
+
+/**
+ * @brief Release a block allocated by the wrappers (NULL is ignored)
+ */
+void mem_account_free(mem_module_t module, void *ptr);
+
+/**
+ * @brief Charge a block from another allocator (spi_bus_dma_memory_alloc, ...)
+ */
+void mem_account_track(mem_module_t module, void *ptr);
+
+/**
+ * @brief Uncharge a tracked block right before it is freed
+ */
+void mem_account_untrack(mem_module_t module, void *ptr);
+
+/**
+ * @brief Record the fixed arrays of a module (replaces the previous value)
+ */
+void mem_account_set_static(mem_module_t module, size_t bytes);
+
+#else
+
+static inline void *mem_account_malloc(mem_module_t module, size_t size) { (void)module; return malloc(size); }
+static inline void *mem_account_calloc(mem_module_t module, size_t count, size_t size) { (void)module; return calloc(count, size); }
+static inline void *mem_account_caps_malloc(mem_module_t module, size_t size, uint32_t caps) { (void)module; return heap_caps_malloc(size, caps); }
+static inline void mem_account_free(mem_module_t module, void *ptr) { (void)module; free(ptr); }
+static inline void mem_account_track(mem_module_t module, void *ptr) { (void)module; (void)ptr; }
+static inline void mem_account_untrack(mem_module_t module, void *ptr) { (void)module; (void)ptr; }
+static inline void mem_account_set_static(mem_module_t module, size_t bytes) { (void)module; (void)bytes; }
+
+#endif // CONFIG_MEM_ACCOUNT_ENABLE
+
+/**
+ * @brief Collect module totals, heap metrics and stack headroom
+ *
+ * Reads the heap and every placed task live; meant for diagnostics rates, not
+ * hot paths. Without CONFIG_MEM_ACCOUNT_ENABLE only the heaps and stacks are
+ * filled.
+ *
+ * @param snapshot Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t mem_account_get_snapshot(mem_account_snapshot_t *snapshot);
+
+/**
+ * @brief Log modules, heaps and stacks as tables, flagging oversized stacks
+ */
+void mem_account_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_ACCOUNT_H
@@ -0,0 +1,401 @@
+/*
+ * ESP-NOW Node History for M5StickC Plus 1.1
+ * Per-node power/voltage/temperature trends in fixed-RAM rings
+ */
+
+#include "node_history.h"
+#include "mem_account.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "NODE_HISTORY";
+
+// Configuration
+#define NODE_HISTORY_NODES          CONFIG_ESPNOW_HISTORY_NODES
+#define NODE_HISTORY_DEVICE_SLOTS   CONFIG_ESPNOW_MAX_DEVICES
+#define NODE_HISTORY_EMPTY          0xFFFFu     // Bucket without samples
+#define NODE_HISTORY_CODE_MAX       0xFFFEu
+
+_Static_assert(NODE_HISTORY_BUCKETS <= 255, "Ring positions are 8-bit");
+
+// Fixed-point encoding: value = code * scale + offset
+typedef struct {
+    float scale;
+    float offset;
+} node_history_codec_t;
+
+static const node_history_codec_t k_codecs[NODE_HISTORY_METRIC_COUNT] = {
+    [NODE_HISTORY_AC_POWER]    = { 0.1f,  -1000.0f },   // -1000 .. 5553 W
+    [NODE_HISTORY_AC_VOLTAGE]  = { 0.01f, 0.0f },       // 0 .. 655 V
+    [NODE_HISTORY_TEMPERATURE] = { 0.01f, -100.0f },    // -100 .. 555 °C
+};
+
+static const uint32_t k_bucket_s[NODE_HISTORY_RES_COUNT] = {
+    [NODE_HISTORY_RES_5S]   = 5,
+    [NODE_HISTORY_RES_1MIN] = 60,
+};
+
+// ===== RING BUFFERS =====
+
+// Bucket means of one metric at one resolution
+// max_q/min_q are monotonic queues of ring positions, so window min/max is the queue front
+typedef struct {
+    uint16_t value[NODE_HISTORY_BUCKETS];   // Fixed-point bucket means, NODE_HISTORY_EMPTY if none
+    uint8_t max_q[NODE_HISTORY_BUCKETS];    // Values non-increasing from front to back
+    uint8_t min_q[NODE_HISTORY_BUCKETS];    // Values non-decreasing from front to back
+    uint32_t window_sum;                    // Sum of the non-empty committed buckets
+    uint32_t open_sum;                      // Samples of the bucket being filled
+    uint16_t open_count;
+    uint8_t head;                           // Next position to commit
+    uint8_t filled;                         // Committed buckets (up to NODE_HISTORY_BUCKETS)
+    uint8_t valid;                          // Committed buckets with samples
+    uint8_t max_front;
+    uint8_t max_count;
+    uint8_t min_front;
+    uint8_t min_count;
+} node_history_ring_t;
+
+// History of one node
+typedef struct {
+    uint8_t mac_address[6];
+    int16_t device_slot;                    // Device table slot, -1 = entry free
+    uint32_t last_update_s;                 // For least recently updated eviction
+    uint32_t bucket_start_s[NODE_HISTORY_RES_COUNT];    // Start of the open bucket per resolution
+    node_history_ring_t rings[NODE_HISTORY_METRIC_COUNT][NODE_HISTORY_RES_COUNT];
+} node_history_node_t;
+
+static node_history_node_t s_nodes[NODE_HISTORY_NODES];
+static int8_t s_slot_map[NODE_HISTORY_DEVICE_SLOTS];   // Device slot -> s_nodes index, -1 = none
+static SemaphoreHandle_t s_mutex = NULL;
+
+_Static_assert(NODE_HISTORY_NODES <= 127, "Slot map entries are 8-bit");
+
+static uint32_t history_now_s(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+/**
+ * @brief Append a ring position to a monotonic queue, dropping the entries it dominates
+ */
+static void ring_queue_push(uint8_t *queue, uint8_t front, uint8_t *count,
+                            const uint16_t *value, uint8_t pos, bool keep_max)
+{
+    while (*count > 0) {
+        uint8_t back = queue[(front + *count - 1) % NODE_HISTORY_BUCKETS];
+        bool dominated = keep_max ? (value[back] <= value[pos]) : (value[back] >= value[pos]);
+        if (!dominated) {
+            break;
+        }
+        (*count)--;
+    }
+    queue[(front + *count) % NODE_HISTORY_BUCKETS] = pos;
+    (*count)++;
+}
+
+/**
+ * @brief Close the open bucket into the ring, evicting the oldest bucket when full
+ */
+static void ring_close_bucket(node_history_ring_t *ring)
+{
+    uint16_t code = NODE_HISTORY_EMPTY;
+    if (ring->open_count > 0) {
+        code = (uint16_t)(ring->open_sum / ring->open_count);
+    }
+    ring->open_sum = 0;
+    ring->open_count = 0;
+
+    uint8_t pos = ring->head;
+    if (ring->filled == NODE_HISTORY_BUCKETS) {
+        uint16_t old = ring->value[pos];
+        if (old != NODE_HISTORY_EMPTY) {
+            ring->window_sum -= old;
+            ring->valid--;
+        }
+        // The oldest position leaves the window; it can only be at a queue front
+        if (ring->max_count > 0 && ring->max_q[ring->max_front] == pos) {
+            ring->max_front = (ring->max_front + 1) % NODE_HISTORY_BUCKETS;
+            ring->max_count--;
+        }
+        if (ring->min_count > 0 && ring->min_q[ring->min_front] == pos) {
+            ring->min_front = (ring->min_front + 1) % NODE_HISTORY_BUCKETS;
+            ring->min_count--;
+        }
+    } else {
+        ring->filled++;
+    }
+
+    ring->value[pos] = code;
+    if (code != NODE_HISTORY_EMPTY) {
+        ring->window_sum += code;
+        ring->valid++;
+        ring_queue_push(ring->max_q, ring->max_front, &ring->max_count, ring->value, pos, true);
+        ring_queue_push(ring->min_q, ring->min_front, &ring->min_count, ring->value, pos, false);
+    }
+    ring->head = (pos + 1) % NODE_HISTORY_BUCKETS;
+}
+
+/**
+ * @brief Close every bucket that ended before now (bounded by the ring size)
+ */
+static void node_advance(node_history_node_t *node, uint32_t now_s)
+{
+    for (int r = 0; r < NODE_HISTORY_RES_COUNT; r++) {
+        uint32_t period = k_bucket_s[r];
+        uint32_t elapsed = (now_s - node->bucket_start_s[r]) / period;
+        if (elapsed == 0) {
+            continue;
+        }
+
+        // The first close commits the open bucket, the rest mark silent periods;
+        // more than a full ring of silence just empties the window
+        uint32_t closes = (elapsed > NODE_HISTORY_BUCKETS + 1) ? NODE_HISTORY_BUCKETS + 1 : elapsed;
+        for (uint32_t c = 0; c < closes; c++) {
+            for (int m = 0; m < NODE_HISTORY_METRIC_COUNT; m++) {
+                ring_close_bucket(&node->rings[m][r]);
+            }
+        }
+        node->bucket_start_s[r] += elapsed * period;
+    }
+}
+
+static uint16_t history_encode(node_history_metric_t metric, float value)
+{
+    float code = roundf((value - k_codecs[metric].offset) / k_codecs[metric].scale);
+    if (code < 0.0f) {
+        return 0;
+    }
+    if (code > (float)NODE_HISTORY_CODE_MAX) {
+        return NODE_HISTORY_CODE_MAX;
+    }
+    return (uint16_t)code;
+}
+
+static float history_decode(node_history_metric_t metric, uint32_t code)
+{
+    return (float)code * k_codecs[metric].scale + k_codecs[metric].offset;
+}
+
+/**
+ * @brief Find the history of a node (mutex held)
+ */
+static node_history_node_t *node_find(int device_slot, const uint8_t *mac_addr)
+{
+    if (device_slot < 0 || device_slot >= NODE_HISTORY_DEVICE_SLOTS || s_slot_map[device_slot] < 0) {
+        return NULL;
+    }
+    node_history_node_t *node = &s_nodes[s_slot_map[device_slot]];
+    if (memcmp(node->mac_address, mac_addr, sizeof(node->mac_address)) != 0) {
+        return NULL;
+    }
+    return node;
+}
+
+/**
+ * @brief Take a history entry for a node, evicting the least recently updated one (mutex held)
+ */
+static node_history_node_t *node_claim(int device_slot, const uint8_t *mac_addr, uint32_t now_s)
+{
+    // A reused device slot keeps its entry but starts over
+    int index = s_slot_map[device_slot];
+    if (index < 0) {
+        index = 0;
+        for (int i = 0; i < NODE_HISTORY_NODES; i++) {
+            if (s_nodes[i].device_slot < 0) {
+                index = i;
+                break;
+            }
+            if (s_nodes[i].last_update_s < s_nodes[index].last_update_s) {
+                index = i;
+            }
+        }
+        if (s_nodes[index].device_slot >= 0) {
+            ESP_LOGD(TAG, "History of slot %d evicted for slot %d", s_nodes[index].device_slot, device_slot);
+            s_slot_map[s_nodes[index].device_slot] = -1;
+        }
+    }
+
+    node_history_node_t *node = &s_nodes[index];
+    memset(node, 0, sizeof(*node));
+    memcpy(node->mac_address, mac_addr, sizeof(node->mac_address));
+    node->device_slot = (int16_t)device_slot;
+    for (int r = 0; r < NODE_HISTORY_RES_COUNT; r++) {
+        node->bucket_start_s[r] = now_s - (now_s % k_bucket_s[r]);
+    }
+    s_slot_map[device_slot] = (int8_t)index;
+    return node;
+}
+
+// ===== PUBLIC API =====
+
+esp_err_t node_history_init(void)
+{
+    if (s_mutex == NULL) {
+        s_mutex = xSemaphoreCreateMutex();
+        if (s_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create node history mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    memset(s_nodes, 0, sizeof(s_nodes));
+    for (int i = 0; i < NODE_HISTORY_NODES; i++) {
+        s_nodes[i].device_slot = -1;
+    }
+    memset(s_slot_map, -1, sizeof(s_slot_map));
+    mem_account_set_static(MEM_MODULE_HISTORY, sizeof(s_nodes) + sizeof(s_slot_map));
+
+    ESP_LOGI(TAG, "Node history initialized: %d nodes x %d metrics, %d x %lus / %d x %lus buckets (%u bytes)",
+             NODE_HISTORY_NODES, NODE_HISTORY_METRIC_COUNT,
+             NODE_HISTORY_BUCKETS, k_bucket_s[NODE_HISTORY_RES_5S],
+             NODE_HISTORY_BUCKETS, k_bucket_s[NODE_HISTORY_RES_1MIN],
+             (unsigned)(sizeof(s_nodes) + sizeof(s_slot_map)));
+    return ESP_OK;
+}
+
+void node_history_deinit(void)
+{
+    if (s_mutex != NULL) {
+        vSemaphoreDelete(s_mutex);
+        s_mutex = NULL;
+    }
+}
+
+esp_err_t node_history_append(int device_slot, const uint8_t *mac_addr,
+                              const float values[NODE_HISTORY_METRIC_COUNT], uint32_t present_mask)
+{
+    if (mac_addr == NULL || values == NULL || device_slot < 0 || device_slot >= NODE_HISTORY_DEVICE_SLOTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (present_mask == 0) {
+        return ESP_OK;
+    }
+
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint32_t now_s = history_now_s();
+    node_history_node_t *node = node_find(device_slot, mac_addr);
+    if (node == NULL) {
+        node = node_claim(device_slot, mac_addr, now_s);
+    }
+    node_advance(node, now_s);
+    node->last_update_s = now_s;
+
+    for (int m = 0; m < NODE_HISTORY_METRIC_COUNT; m++) {
+        if (!(present_mask & (1UL << m)) || isnan(values[m])) {
+            continue;
+        }
+        uint16_t code = history_encode((node_history_metric_t)m, values[m]);
+        for (int r = 0; r < NODE_HISTORY_RES_COUNT; r++) {
+            node_history_ring_t *ring = &node->rings[m][r];
+            if (ring->open_count < UINT16_MAX) {
+                ring->open_sum += code;
+                ring->open_count++;
+            }
+        }
+    }
+
+    xSemaphoreGive(s_mutex);
+    return ESP_OK;
+}
+
+esp_err_t node_history_query(int device_slot, const uint8_t *mac_addr, node_history_metric_t metric,
+                             node_history_resolution_t resolution, node_history_stats_t *stats)
+{
+    if (mac_addr == NULL || stats == NULL || metric >= NODE_HISTORY_METRIC_COUNT ||
+        resolution >= NODE_HISTORY_RES_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    node_history_node_t *node = node_find(device_slot, mac_addr);
+    if (node != NULL) {
+        node_advance(node, history_now_s());
+        const node_history_ring_t *ring = &node->rings[metric][resolution];
+
+        uint32_t lo = UINT32_MAX;
+        uint32_t hi = 0;
+        uint32_t sum = ring->window_sum;
+        uint16_t buckets = ring->valid;
+        if (ring->valid > 0) {
+            lo = ring->value[ring->min_q[ring->min_front]];
+            hi = ring->value[ring->max_q[ring->max_front]];
+        }
+        if (ring->open_count > 0) {
+            uint32_t open = ring->open_sum / ring->open_count;
+            lo = (open < lo) ? open : lo;
+            hi = (open > hi) ? open : hi;
+            sum += open;
+            buckets++;
+        }
+
+        if (buckets > 0) {
+            stats->min = history_decode(metric, lo);
+            stats->max = history_decode(metric, hi);
+            stats->avg = history_decode(metric, 0) + ((float)sum / buckets) * k_codecs[metric].scale;
+            stats->buckets = buckets;
+            stats->window_s = k_bucket_s[resolution] * NODE_HISTORY_BUCKETS;
+            result = ESP_OK;
+        }
+    }
+
+    xSemaphoreGive(s_mutex);
+    return result;
+}
+
+esp_err_t node_history_get_series(int device_slot, const uint8_t *mac_addr, node_history_metric_t metric,
+                                  node_history_resolution_t resolution, float *values, int max_values, int *count)
+{
+    if (mac_addr == NULL || values == NULL || count == NULL || max_values <= 0 ||
+        metric >= NODE_HISTORY_METRIC_COUNT || resolution >= NODE_HISTORY_RES_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    *count = 0;
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    node_history_node_t *node = node_find(device_slot, mac_addr);
+    if (node != NULL) {
+        node_advance(node, history_now_s());
+        const node_history_ring_t *ring = &node->rings[metric][resolution];
+
+        // Newest committed buckets that fit, then the open bucket
+        int total = ring->filled + 1;
+        int skip = (total > max_values) ? total - max_values : 0;
+        uint8_t oldest = (ring->filled == NODE_HISTORY_BUCKETS) ? ring->head : 0;
+        int n = 0;
+        for (int i = skip; i < ring->filled; i++) {
+            uint16_t code = ring->value[(oldest + i) % NODE_HISTORY_BUCKETS];
+            values[n++] = (code == NODE_HISTORY_EMPTY) ? NAN : history_decode(metric, code);
+        }
+        values[n++] = (ring->open_count > 0) ? history_decode(metric, ring->open_sum / ring->open_count) : NAN;
+
+        *count = n;
+        result = ESP_OK;
+    }
+
+    xSemaphoreGive(s_mutex);
+    return result;
+}
@@ -0,0 +1,99 @@
+/*
+ * ESP-NOW Node History for M5StickC Plus 1.1
+ * Per-node power/voltage/temperature trends in fixed-RAM rings
+ */
+
+#ifndef NODE_HISTORY_H
+#define NODE_HISTORY_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Metrics kept per node
+ */
+typedef enum {
+    NODE_HISTORY_AC_POWER = 0,      // W, 0.1 W steps from -1000 W
+    NODE_HISTORY_AC_VOLTAGE,        // V, 0.01 V steps from 0 V
+    NODE_HISTORY_TEMPERATURE,       // °C, 0.01 °C steps from -100 °C
+    NODE_HISTORY_METRIC_COUNT
+} node_history_metric_t;
+
+/**
+ * @brief History resolutions, each a ring of NODE_HISTORY_BUCKETS bucket means
+ */
+typedef enum {
+    NODE_HISTORY_RES_5S = 0,        // 5 s buckets, 2 minutes
+    NODE_HISTORY_RES_1MIN,          // 1 min buckets, 24 minutes
+    NODE_HISTORY_RES_COUNT
+} node_history_resolution_t;
+
+#define NODE_HISTORY_BUCKETS    24  // Buckets per resolution
+
+/**
+ * @brief Min/max/average over the window of one resolution
+ */
+typedef struct {
+    float min;
+    float max;
+    float avg;
+    uint16_t buckets;               // Buckets with samples, including the open one
+    uint32_t window_s;              // Time covered by the resolution
+} node_history_stats_t;
+
+/**
+ * @brief Initialize the history store (all nodes empty)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the mutex can't be created
+ */
+esp_err_t node_history_init(void);
+
+/**
+ * @brief Release the mutex and forget all nodes
+ */
+void node_history_deinit(void);
+
+/**
+ * @brief Append one reading per present metric for a node, O(1) amortized
+ *
+ * Nodes are keyed by their device table slot; the MAC detects slot reuse.
+ * When every history entry is taken, the least recently updated node is dropped.
+ *
+ * @param device_slot Device table slot of the node
+ * @param mac_addr Node MAC address
+ * @param values Reading per node_history_metric_t
+ * @param present_mask Bit per metric present in values
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad arguments, ESP_ERR_INVALID_STATE before init
+ */
+esp_err_t node_history_append(int device_slot, const uint8_t *mac_addr,
+                              const float values[NODE_HISTORY_METRIC_COUNT], uint32_t present_mask);
+
+/**
+ * @brief Get min/max/average of a metric over one resolution window, O(1)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the node has no samples for the metric
+ */
+esp_err_t node_history_query(int device_slot, const uint8_t *mac_addr, node_history_metric_t metric,
+                             node_history_resolution_t resolution, node_history_stats_t *stats);
+
+/**
+ * @brief Copy the bucket means of one resolution, oldest first
+ *
+ * Buckets without samples are returned as NAN.
+ *
+ * @param values Destination array
+ * @param max_values Capacity of values
+ * @param count Number of values written
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the node is not tracked
+ */
+esp_err_t node_history_get_series(int device_slot, const uint8_t *mac_addr, node_history_metric_t metric,
+                                  node_history_resolution_t resolution, float *values, int max_values, int *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NODE_HISTORY_H
@@ -7,6 +7,9 @@
 #include "page_manager.h"
 #include "page_manager_monitor.h"
 #include "page_manager_espnow.h"
+#include "ui_notify.h"
+#include "ui_screen_cache.h"
+#include "latency_trace.h"
 #include "esp_log.h"
 #include <string.h>
 
@@ -16,17 +19,16 @@ static const char *TAG = "PAGE_MANAGER";
 static lv_obj_t *g_main_screen = NULL;
 static page_id_t g_current_page = PAGE_MONITOR;
 static bool g_navigation_enabled = true;
-static lv_timer_t *g_update_timer = NULL;
 
 // Page controller instances
 static const page_controller_t *g_page_controllers[PAGE_COUNT] = {NULL};
 
 // Forward declarations
 static void load_page(page_id_t page_id);
-static void page_update_timer_cb(lv_timer_t *timer);
+static void page_topics_handler(uint32_t topics);
 
-// Timer callback for page updates - using modular page controller pattern
-static void page_update_timer_cb(lv_timer_t *timer)
+// UI notification handler for page updates - runs in LVGL task with the coalesced topics
+static void page_topics_handler(uint32_t topics)
 {
     // Get the controller for current page
     if (g_current_page >= PAGE_COUNT || g_page_controllers[g_current_page] == NULL) {
@@ -36,17 +38,17 @@ static void page_update_timer_cb(lv_timer_t *timer)
     
     const page_controller_t *controller = g_page_controllers[g_current_page];
     
-    // Check if this page's data has been updated since last check
-    // Note: is_data_updated() atomically clears the flag to avoid race conditions
-    if (controller->is_data_updated && !controller->is_data_updated()) {
-        ESP_LOGD(TAG, "No data update for page %s, skipping UI refresh", controller->name);
+    // Only refresh when one of the page's own topics changed
+    if (!(topics & controller->topics)) {
+        ESP_LOGD(TAG, "Topics 0x%08lX not subscribed by page %s, skipping UI refresh", topics, controller->name);
         return;
     }
     
-    ESP_LOGD(TAG, "Data updated for page %s, refreshing UI", controller->name);
+    ESP_LOGD(TAG, "Topics 0x%08lX updated for page %s, refreshing UI", topics, controller->name);
     
     // Update the page using its controller
     if (controller->update) {
+        latency_trace_page_update();
         esp_err_t ret = controller->update();
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to update page %s: %s", controller->name, esp_err_to_name(ret));
@@ -88,15 +90,9 @@ static void load_page(page_id_t page_id)
         }
     }
     
-    // Get the active screen
-    lv_obj_t *scr = lv_screen_active();
+    ESP_LOGI(TAG, "Showing %s page...", new_controller->name);
     
-    // Clean all content from screen
-    lv_obj_clean(scr);
-    
-    ESP_LOGI(TAG, "Creating %s page...", new_controller->name);
-    
-    // Create page using its controller
+    // Create page using its controller (reactivates the cached screen when there is one)
     esp_err_t ret = ESP_FAIL;
     if (new_controller->create) {
         ret = new_controller->create();
@@ -149,15 +145,18 @@ esp_err_t page_manager_init(lv_display_t *display)
         return ESP_FAIL;
     }
     
+    // Page trees live under the main screen and are kept between visits
+    esp_err_t ret = ui_screen_cache_init(g_main_screen);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize screen cache: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
     // Load initial page using modular controller
     load_page(PAGE_MONITOR);
     
-    // Create update timer with 500ms interval for responsive updates
-    g_update_timer = lv_timer_create(page_update_timer_cb, 500, NULL);
-    if (!g_update_timer) {
-        ESP_LOGE(TAG, "Failed to create update timer");
-        return ESP_FAIL;
-    }
+    // Refresh pages when their topics are published (replaces periodic polling)
+    ui_notify_set_handler(page_topics_handler);
     
     ESP_LOGI(TAG, "Page manager initialized successfully");
     return ESP_OK;
@@ -281,11 +280,8 @@ esp_err_t page_manager_deinit(void)
 {
     ESP_LOGI(TAG, "Deinitializing page manager...");
     
-    // Stop update timer
-    if (g_update_timer) {
-        lv_timer_delete(g_update_timer);
-        g_update_timer = NULL;
-    }
+    // Stop topic driven updates
+    ui_notify_set_handler(NULL);
     
     // Clean up page controllers
     for (int i = 0; i < PAGE_COUNT; i++) {
@@ -295,6 +291,9 @@ esp_err_t page_manager_deinit(void)
         g_page_controllers[i] = NULL;
     }
     
+    // Delete the trees that were only hidden
+    ui_screen_cache_clear();
+    
     g_main_screen = NULL;
     g_current_page = PAGE_MONITOR;
     g_navigation_enabled = true;
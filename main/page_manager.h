@@ -28,12 +28,12 @@ typedef enum {
 typedef struct {
     // Page lifecycle functions
     esp_err_t (*init)(void);            // Initialize page module (called once)
-    esp_err_t (*create)(void);          // Create page UI elements
+    esp_err_t (*create)(void);          // Show page UI (built, or reactivated from the screen cache)
     esp_err_t (*update)(void);          // Update page data display
-    esp_err_t (*destroy)(void);         // Clean up page resources
+    esp_err_t (*destroy)(void);         // Leave page (screen hidden or deleted per cache policy)
     
     // Data state management
-    bool (*is_data_updated)(void);      // Check if page data needs update (atomically clears flag)
+    uint32_t topics;                    // ui_notify topics (ui_topic_t) that trigger update()
     
     // Input event handling (optional)
     bool (*handle_key_event)(uint32_t key);  // Handle page-specific key events, return true if handled
@@ -4,12 +4,17 @@
 #include "misc/lv_color.h"
 #include "page_manager.h"
 #include "espnow_manager.h"
+#include "espnow_bench.h"
+#include "ui_notify.h"
+#include "ui_bound_label.h"
+#include "ui_screen_cache.h"
+#include "change_filter.h"
+#include "node_history.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_mac.h"
 #include "lvgl.h"
 #include "freertos/FreeRTOS.h"
-#include <stdatomic.h>
 #include <inttypes.h>
 
 static const char *TAG = "ESPNOW_PAGE";
@@ -18,9 +23,12 @@ static const char *TAG = "ESPNOW_PAGE";
 typedef enum {
     ESPNOW_SUBPAGE_OVERVIEW = 0,    // Overview/statistics subpage (current default)
     ESPNOW_SUBPAGE_NODE_DETAIL,     // Node detail subpage (future)
+    ESPNOW_SUBPAGE_BENCH,           // Throughput and latency benchmark
     ESPNOW_SUBPAGE_COUNT            // Total number of subpages
 } espnow_subpage_id_t;
 
+_Static_assert(ESPNOW_SUBPAGE_COUNT == UI_SCREEN_COUNT_ESPNOW, "Update UI_SCREEN_COUNT_ESPNOW with the subpages");
+
 // ESP-NOW page UI objects structure for better organization and debugging
 typedef struct {
     lv_obj_t *uptime_label;     // System uptime display
@@ -38,6 +46,17 @@ typedef struct {
     lv_obj_t *total_panel;      // Right panel: Total nodes count
 } espnow_overview_t;
 
+// Overview page value labels, re-rendered only when their text changes
+typedef struct {
+    ui_bound_label_t uptime;
+    ui_bound_label_t memory;
+    ui_bound_label_t sent;
+    ui_bound_label_t recv;
+    ui_bound_label_t online;
+    ui_bound_label_t used;
+    ui_bound_label_t total;
+} espnow_overview_values_t;
+
 // ESP-NOW node detail page UI objects structure (TLV data display)
 typedef struct {
     lv_obj_t *title_label;      // Page title
@@ -66,6 +85,34 @@ typedef struct {
     lv_obj_t *compile_label;
 } espnow_node_detail_t;
 
+// Node detail page value labels, re-rendered only when their text changes
+typedef struct {
+    ui_bound_label_t network;
+    ui_bound_label_t power;
+    ui_bound_label_t voltage;
+    ui_bound_label_t current;
+    ui_bound_label_t system;
+    ui_bound_label_t compile;
+    ui_bound_label_t trend_short;
+    ui_bound_label_t trend_long;
+    ui_bound_label_t uptime;
+    ui_bound_label_t memory;
+} espnow_node_detail_values_t;
+
+// Benchmark page value labels
+typedef struct {
+    ui_bound_label_t profile;
+    ui_bound_label_t p50;
+    ui_bound_label_t tail;
+    ui_bound_label_t loss;
+    ui_bound_label_t flood;
+    ui_bound_label_t pps;
+    ui_bound_label_t rssi;
+    ui_bound_label_t state;
+    ui_bound_label_t uptime;
+    ui_bound_label_t memory;
+} espnow_bench_values_t;
+
 // Node detail data structure (TLV format simulation)
 typedef struct {
     // Network data
@@ -96,13 +143,13 @@ typedef struct {
  * 🏗️  PAGE MANAGEMENT VARIABLES (Core subpage state and control)
  *=============================================================================*/
 static espnow_subpage_id_t g_current_subpage = ESPNOW_SUBPAGE_OVERVIEW;
-static atomic_bool g_espnow_data_updated = ATOMIC_VAR_INIT(false);
 
 /*=============================================================================
  * 📊  OVERVIEW PAGE VARIABLES (ESP-NOW statistics and system monitoring)
  *=============================================================================*/
 // Overview page UI objects
 static espnow_overview_t g_overview_ui = {0};
+static espnow_overview_values_t g_overview_values = {0};
 
 // Overview page data
 static espnow_stats_t g_espnow_stats = {0};
@@ -112,6 +159,7 @@ static espnow_stats_t g_espnow_stats = {0};
  *=============================================================================*/
 // Node detail page UI objects
 static espnow_node_detail_t g_node_detail_ui = {0};
+static espnow_node_detail_values_t g_node_detail_values = {0};
 
 // Node detail page data and state
 static int g_current_device_index = 0;
@@ -133,14 +181,42 @@ static espnow_node_data_t g_current_node_data = {
     .compile_time = "-"
 };
 
+// Node detail change detection: remote readings only replace the shown value
+// once they leave their deadband (filters restart when another node is shown)
+typedef enum {
+    NODE_METRIC_RSSI = 0,
+    NODE_METRIC_AC_VOLTAGE,
+    NODE_METRIC_AC_CURRENT,
+    NODE_METRIC_AC_POWER,
+    NODE_METRIC_POWER_FACTOR,
+    NODE_METRIC_TEMPERATURE,
+    NODE_METRIC_COUNT
+} node_metric_t;
+
+static const change_filter_cfg_t k_node_filters[NODE_METRIC_COUNT] = {
+    [NODE_METRIC_RSSI]         = { .deadband = 3.0f,  .hysteresis = 1.0f },     // dBm
+    [NODE_METRIC_AC_VOLTAGE]   = { .deadband = 0.5f,  .hysteresis = 0.2f },     // V
+    [NODE_METRIC_AC_CURRENT]   = { .deadband = 0.02f, .hysteresis = 0.01f },    // A
+    [NODE_METRIC_AC_POWER]     = { .deadband = 0.5f,  .hysteresis = 0.2f },     // W
+    [NODE_METRIC_POWER_FACTOR] = { .deadband = 0.01f, .hysteresis = 0.005f },   // ratio
+    [NODE_METRIC_TEMPERATURE]  = { .deadband = 0.5f,  .hysteresis = 0.2f },     // °C
+};
+
+static change_filter_t g_node_filter_state[NODE_METRIC_COUNT];
+
+// Shown device as last fetched; refreshed only when its slot generation moves
+static espnow_device_info_t g_node_cached_info;
+static bool g_node_cached_valid = false;
+static int g_node_cached_index = -1;
+static uint32_t g_node_cached_generation = 0;
+static uint8_t g_node_filter_mac[6] = {0};  // Node the filter state belongs to
+
 /*=============================================================================
- * 🔄  SHARED SYSTEM VARIABLES (Change detection and system state)
+ * ⏱️  BENCHMARK PAGE VARIABLES (ESP-NOW throughput and latency sweep)
  *=============================================================================*/
-// Previous state tracking for both pages
-static uint32_t g_prev_uptime_sec = 0;
-static uint32_t g_prev_free_heap_kb = 0;
-static uint32_t g_prev_packets_sent = 0;
-static uint32_t g_prev_packets_received = 0;
+static espnow_bench_values_t g_bench_values = {0};
+static espnow_bench_report_t g_bench_report;    // Too large for the LVGL task stack
+static int g_bench_view_run = 0;                // Result shown once the sweep is done
 
 /*=============================================================================
  * 🔧  HELPER FUNCTIONS (Utility functions shared between pages)
@@ -192,24 +268,32 @@ static void format_free_memory_string(char *buffer, size_t buffer_size)
  *=============================================================================*/
 
 // Overview page functions
-static esp_err_t espnow_overview_create(void);
+static esp_err_t espnow_overview_create(lv_obj_t *scr);
 static esp_err_t espnow_overview_update(void);
-static esp_err_t espnow_overview_destroy(void);
+static void espnow_overview_release(void);
 
 // Node detail page functions  
-static esp_err_t espnow_node_detail_create(void);
+static esp_err_t espnow_node_detail_create(lv_obj_t *scr);
 static esp_err_t espnow_node_detail_update(void);
-static esp_err_t espnow_node_detail_destroy(void);
+static void espnow_node_detail_release(void);
 
 // Internal helper function for updating node detail data and UI
 static esp_err_t espnow_node_detail_refresh_data_and_ui(void);
+static float node_filter_value(node_metric_t metric, float value);
+static bool node_detail_fetch(espnow_device_info_t *device_info);
+static void node_detail_show_trend(ui_bound_label_t *label, const char *window,
+                                   node_history_resolution_t resolution, bool have_real_data);
+
+// Benchmark page functions
+static esp_err_t espnow_bench_page_create(lv_obj_t *scr);
+static esp_err_t espnow_bench_page_update(void);
+static void espnow_bench_page_release(void);
 
 // Main page interface functions
 static esp_err_t espnow_page_init(void);
 static esp_err_t espnow_page_create(void);
 static esp_err_t espnow_page_update(void);
 static esp_err_t espnow_page_destroy(void);
-static bool espnow_page_is_data_updated(void);
 static bool espnow_page_handle_key_event(uint32_t key);
 
 // Subpage management functions
@@ -218,6 +302,29 @@ static esp_err_t espnow_subpage_create_current(void);
 static esp_err_t espnow_subpage_update_current(void);
 static esp_err_t espnow_subpage_destroy_current(void);
 
+// Screen cache policy per subpage: overview and node detail are switched between often
+// and stay cached until the budget needs their memory, the bench page is rarely visited
+static const ui_screen_desc_t k_subpage_screens[ESPNOW_SUBPAGE_COUNT] = {
+    [ESPNOW_SUBPAGE_OVERVIEW] = {
+        .name = "ESP-NOW Overview",
+        .policy = UI_SCREEN_LAZY_ONCE,
+        .build = espnow_overview_create,
+        .forget = espnow_overview_release
+    },
+    [ESPNOW_SUBPAGE_NODE_DETAIL] = {
+        .name = "ESP-NOW Node Detail",
+        .policy = UI_SCREEN_LAZY_ONCE,
+        .build = espnow_node_detail_create,
+        .forget = espnow_node_detail_release
+    },
+    [ESPNOW_SUBPAGE_BENCH] = {
+        .name = "ESP-NOW Bench",
+        .policy = UI_SCREEN_DESTROY_ON_LEAVE,
+        .build = espnow_bench_page_create,
+        .forget = espnow_bench_page_release
+    },
+};
+
 /*=============================================================================
  * 🎮  PAGE CONTROLLER INTERFACE (Public API implementation)
  *=============================================================================*/
@@ -228,7 +335,8 @@ static const page_controller_t espnow_controller = {
     .create = espnow_page_create,
     .update = espnow_page_update,
     .destroy = espnow_page_destroy,
-    .is_data_updated = espnow_page_is_data_updated,
+    .topics = UI_TOPIC_ESPNOW_STATS | UI_TOPIC_ESPNOW_DEVICES | UI_TOPIC_SYSTEM_MONITOR | UI_TOPIC_CLOCK |
+              UI_TOPIC_ESPNOW_BENCH,
     .handle_key_event = espnow_page_handle_key_event,
     .name = "ESP-NOW",
     .page_id = PAGE_ESPNOW
@@ -249,31 +357,15 @@ static esp_err_t espnow_page_init(void)
     
     // Reset UI object pointers in overview structure
     memset(&g_overview_ui, 0, sizeof(espnow_overview_t));
+    memset(&g_overview_values, 0, sizeof(espnow_overview_values_t));
     
     // Reset UI object pointers in node detail structure
     memset(&g_node_detail_ui, 0, sizeof(espnow_node_detail_t));
+    memset(&g_node_detail_values, 0, sizeof(espnow_node_detail_values_t));
     
     // Initialize subpage state
     g_current_subpage = ESPNOW_SUBPAGE_OVERVIEW;
     
-    // Reset data state - atomic variable doesn't need explicit initialization
-    atomic_store(&g_espnow_data_updated, false);
-    
-    // Initialize previous state tracking variables
-    int64_t uptime_us = esp_timer_get_time();
-    g_prev_uptime_sec = (uint32_t)(uptime_us / 1000000);
-    g_prev_free_heap_kb = esp_get_free_heap_size() / 1024;
-    
-    // Initialize previous ESP-NOW statistics
-    espnow_stats_t current_stats = {0};
-    if (espnow_manager_get_stats(&current_stats) == ESP_OK) {
-        g_prev_packets_sent = current_stats.packets_sent;
-        g_prev_packets_received = current_stats.packets_received;
-    } else {
-        g_prev_packets_sent = 0;
-        g_prev_packets_received = 0;
-    }
-    
     ESP_LOGI(TAG, "ESP-NOW page module initialized");
     return ESP_OK;
 }
@@ -282,6 +374,9 @@ static esp_err_t espnow_page_create(void)
 {
     ESP_LOGI(TAG, "Creating ESP-NOW page UI...");
     
+    // Refresh the node list quickly while the user is looking at it
+    espnow_manager_request_discovery_burst();
+    
     esp_err_t ret = espnow_subpage_create_current();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create ESP-NOW page UI: %s", esp_err_to_name(ret));
@@ -322,68 +417,12 @@ static esp_err_t espnow_page_destroy(void)
     return ESP_OK;
 }
 
-static bool espnow_page_is_data_updated(void)
-{
-    bool data_changed = false;
-    
-    // Check if ESP-NOW statistics notification was triggered
-    bool stats_notified = atomic_exchange(&g_espnow_data_updated, false);
-    if (stats_notified) {
-        data_changed = true;
-    }
-    
-    // Get current data for comparison
-    // 1. Current uptime in seconds
-    int64_t uptime_us = esp_timer_get_time();
-    uint32_t current_uptime_sec = (uint32_t)(uptime_us / 1000000);
-    
-    // 2. Current free heap in KB
-    uint32_t current_free_heap_kb = esp_get_free_heap_size() / 1024;
-    
-    // 3. Current ESP-NOW statistics
-    espnow_stats_t current_stats = {0};
-    espnow_manager_get_stats(&current_stats);
-    
-    // Compare with previous values to detect changes
-    
-    // Check uptime change (second-level precision)
-    if (current_uptime_sec != g_prev_uptime_sec) {
-        g_prev_uptime_sec = current_uptime_sec;
-        data_changed = true;
-    }
-    
-    // Check free heap change (KB-level precision)
-    if (current_free_heap_kb != g_prev_free_heap_kb) {
-        g_prev_free_heap_kb = current_free_heap_kb;
-        data_changed = true;
-    }
-    
-    // Check ESP-NOW statistics changes
-    if (current_stats.packets_sent != g_prev_packets_sent) {
-        g_prev_packets_sent = current_stats.packets_sent;
-        data_changed = true;
-    }
-    
-    if (current_stats.packets_received != g_prev_packets_received) {
-        g_prev_packets_received = current_stats.packets_received;
-        data_changed = true;
-    }
-    
-    return data_changed;
-}
-
-void espnow_page_notify_data_update(void)
-{
-    // Atomic store: thread-safe assignment
-    atomic_store(&g_espnow_data_updated, true);
-}
-
 /*=============================================================================
  * 📊  OVERVIEW PAGE IMPLEMENTATION (ESP-NOW statistics and system monitoring)
  *=============================================================================*/
 
 // Internal UI creation function
-static esp_err_t espnow_overview_create(void)
+static esp_err_t espnow_overview_create(lv_obj_t *scr)
 {
     // Get latest statistics from ESP-NOW manager before creating UI
     espnow_stats_t latest_stats = {0};
@@ -392,15 +431,7 @@ static esp_err_t espnow_overview_create(void)
         g_espnow_stats = latest_stats;
     }
     
-    lv_obj_t *scr = lv_scr_act();
-    
-    // Clear screen
-    lv_obj_clean(scr);
-    
-    // Set black background to match Monitor page
-    lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN);
-    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-    
+    // scr is the subpage's cached root (black, not scrollable, like the Monitor page)
     // Title with page indicator - centered for 135px screen
     lv_obj_t *title = lv_label_create(scr);
     lv_label_set_text(title, "ESP-NOW [2/2]");
@@ -496,6 +527,7 @@ static esp_err_t espnow_overview_create(void)
     lv_obj_set_style_text_opa(online_value, LV_OPA_COVER, LV_PART_MAIN);  // Ensure opaque text
     lv_obj_center(online_value);
     lv_obj_set_pos(online_value, 0, 7);
+    ui_bound_label_bind(&g_overview_values.online, online_value);
     
     // Center Panel: Used nodes count
     g_overview_ui.used_panel = lv_obj_create(scr);
@@ -524,6 +556,7 @@ static esp_err_t espnow_overview_create(void)
     lv_obj_set_style_text_opa(used_value, LV_OPA_COVER, LV_PART_MAIN);  // Ensure opaque text
     lv_obj_center(used_value);
     lv_obj_set_pos(used_value, 0, 7);
+    ui_bound_label_bind(&g_overview_values.used, used_value);
     
     // Right Panel: Total nodes count
     g_overview_ui.total_panel = lv_obj_create(scr);
@@ -552,6 +585,7 @@ static esp_err_t espnow_overview_create(void)
     lv_obj_set_style_text_opa(total_value, LV_OPA_COVER, LV_PART_MAIN);  // Ensure opaque text
     lv_obj_center(total_value);
     lv_obj_set_pos(total_value, 0, 7);
+    ui_bound_label_bind(&g_overview_values.total, total_value);
     
     // Uptime at bottom-left (portrait layout: Y:225)
     g_overview_ui.uptime_label = lv_label_create(scr);
@@ -573,6 +607,12 @@ static esp_err_t espnow_overview_create(void)
     lv_obj_set_style_text_opa(g_overview_ui.memory_label, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_pos(g_overview_ui.memory_label, 80, 225);  // Right-aligned for 135px width
     
+    // Bind value labels so updates only re-render what changed
+    ui_bound_label_bind(&g_overview_values.uptime, g_overview_ui.uptime_label);
+    ui_bound_label_bind(&g_overview_values.memory, g_overview_ui.memory_label);
+    ui_bound_label_bind(&g_overview_values.sent, g_overview_ui.sent_label);
+    ui_bound_label_bind(&g_overview_values.recv, g_overview_ui.recv_label);
+    
     return ESP_OK;
 }
 
@@ -586,78 +626,33 @@ static esp_err_t espnow_overview_update(void)
         g_espnow_stats = latest_stats;
     }
     
-    // Update uptime display
-    if (g_overview_ui.uptime_label != NULL) {
-        char uptime_text[16];
-        format_uptime_string(uptime_text, sizeof(uptime_text));
-        lv_label_set_text(g_overview_ui.uptime_label, uptime_text);
-    }
-    
-    // Update memory display
-    if (g_overview_ui.memory_label != NULL) {
-        char memory_text[16];
-        format_free_memory_string(memory_text, sizeof(memory_text));
-        lv_label_set_text(g_overview_ui.memory_label, memory_text);
-    }
+    // Update uptime and memory display
+    char uptime_text[16];
+    format_uptime_string(uptime_text, sizeof(uptime_text));
+    ui_bound_label_set_text(&g_overview_values.uptime, uptime_text);
     
-    // Update packet statistics (48pt numbers with leading zeros - 7 digits)
-    if (g_overview_ui.sent_label != NULL) {
-        char sent_text[16];
-        snprintf(sent_text, sizeof(sent_text), "%09"PRIu32, g_espnow_stats.packets_sent);
-        lv_label_set_text(g_overview_ui.sent_label, sent_text);
-    }
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_overview_values.memory, memory_text);
     
-    if (g_overview_ui.recv_label != NULL) {
-        char recv_text[16];
-        snprintf(recv_text, sizeof(recv_text), "%09"PRIu32, g_espnow_stats.packets_received);
-        lv_label_set_text(g_overview_ui.recv_label, recv_text);
-    }
+    // Update packet statistics (numbers with leading zeros - 9 digits)
+    ui_bound_label_set_u32(&g_overview_values.sent, "%09"PRIu32, g_espnow_stats.packets_sent);
+    ui_bound_label_set_u32(&g_overview_values.recv, "%09"PRIu32, g_espnow_stats.packets_received);
     
     // Update Online Node statistics in triple panels (24pt numbers)
-    if (g_overview_ui.online_panel != NULL) {
-        // Find the value label child of online panel and update it
-        lv_obj_t *online_value = lv_obj_get_child(g_overview_ui.online_panel, 1); // Second child (value label)
-        if (online_value != NULL) {
-            char online_text[8];
-            snprintf(online_text, sizeof(online_text), "%d", g_espnow_stats.online_nodes);
-            lv_label_set_text(online_value, online_text);
-        }
-    }
-    
-    if (g_overview_ui.used_panel != NULL) {
-        // Find the value label child of used panel and update it
-        lv_obj_t *used_value = lv_obj_get_child(g_overview_ui.used_panel, 1); // Second child (value label)
-        if (used_value != NULL) {
-            char used_text[8];
-            snprintf(used_text, sizeof(used_text), "%d", g_espnow_stats.used_nodes);
-            lv_label_set_text(used_value, used_text);
-        }
-    }
-    
-    if (g_overview_ui.total_panel != NULL) {
-        // Find the value label child of total panel and update it
-        lv_obj_t *total_value = lv_obj_get_child(g_overview_ui.total_panel, 1); // Second child (value label)
-        if (total_value != NULL) {
-            char total_text[8];
-            snprintf(total_text, sizeof(total_text), "%d", g_espnow_stats.total_nodes);
-            lv_label_set_text(total_value, total_text);
-        }
-    }
+    ui_bound_label_set_u32(&g_overview_values.online, "%"PRIu32, g_espnow_stats.online_nodes);
+    ui_bound_label_set_u32(&g_overview_values.used, "%"PRIu32, g_espnow_stats.used_nodes);
+    ui_bound_label_set_u32(&g_overview_values.total, "%"PRIu32, g_espnow_stats.total_nodes);
     
     return ESP_OK;
 }
 
-// Internal UI destruction function  
-static esp_err_t espnow_overview_destroy(void)
+// Called by the screen cache right before the overview tree is deleted
+static void espnow_overview_release(void)
 {
-    // Clear screen will automatically clean up all child objects
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    
     // Reset object pointers in overview structure
     memset(&g_overview_ui, 0, sizeof(espnow_overview_t));
-    
-    return ESP_OK;
+    memset(&g_overview_values, 0, sizeof(espnow_overview_values_t));
 }
 
 /*=============================================================================
@@ -665,19 +660,10 @@ static esp_err_t espnow_overview_destroy(void)
  *=============================================================================*/
 
 // Node detail page UI creation function
-static esp_err_t espnow_node_detail_create(void)
+static esp_err_t espnow_node_detail_create(lv_obj_t *scr)
 {
     ESP_LOGI(TAG, "Creating ESP-NOW node detail page...");
     
-    lv_obj_t *scr = lv_scr_act();
-    
-    // Clear screen
-    lv_obj_clean(scr);
-    
-    // Set black background to match other pages
-    lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN);
-    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-    
     // Title with page indicator - centered for 135px screen
     g_node_detail_ui.title_label = lv_label_create(scr);
     lv_label_set_text(g_node_detail_ui.title_label, "Node Detail [2/2]");
@@ -775,6 +761,19 @@ static esp_err_t espnow_node_detail_create(void)
     lv_obj_set_style_text_font(g_node_detail_ui.compile_label, &lv_font_montserrat_12, LV_PART_MAIN);
     lv_obj_set_pos(g_node_detail_ui.compile_label, 5, 150);
     
+    // Rows 6-7: power trend (min/avg/max) over the short and long history windows
+    lv_obj_t *trend_short_label = lv_label_create(scr);
+    lv_label_set_text(trend_short_label, "2m: ---");
+    lv_obj_set_style_text_color(trend_short_label, lv_color_hex(0xFFFF00), LV_PART_MAIN);
+    lv_obj_set_style_text_font(trend_short_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(trend_short_label, 5, 172);
+    
+    lv_obj_t *trend_long_label = lv_label_create(scr);
+    lv_label_set_text(trend_long_label, "24m: ---");
+    lv_obj_set_style_text_color(trend_long_label, lv_color_hex(0xFFFF00), LV_PART_MAIN);
+    lv_obj_set_style_text_font(trend_long_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(trend_long_label, 5, 190);
+    
     // Uptime at bottom-left (LOCAL DEVICE system uptime, same as overview page)
     g_node_detail_ui.uptime_label = lv_label_create(scr);
     char uptime_text[16];
@@ -797,6 +796,18 @@ static esp_err_t espnow_node_detail_create(void)
     lv_obj_set_style_text_opa(g_node_detail_ui.memory_label, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_pos(g_node_detail_ui.memory_label, 80, 225);  // Right-aligned
     
+    // Bind value labels so refreshes only re-render what changed
+    ui_bound_label_bind(&g_node_detail_values.network, g_node_detail_ui.network_row_label);
+    ui_bound_label_bind(&g_node_detail_values.power, g_node_detail_ui.power_label);
+    ui_bound_label_bind(&g_node_detail_values.voltage, voltage_value);
+    ui_bound_label_bind(&g_node_detail_values.current, current_value);
+    ui_bound_label_bind(&g_node_detail_values.system, g_node_detail_ui.system_row_label);
+    ui_bound_label_bind(&g_node_detail_values.compile, g_node_detail_ui.compile_label);
+    ui_bound_label_bind(&g_node_detail_values.trend_short, trend_short_label);
+    ui_bound_label_bind(&g_node_detail_values.trend_long, trend_long_label);
+    ui_bound_label_bind(&g_node_detail_values.uptime, g_node_detail_ui.uptime_label);
+    ui_bound_label_bind(&g_node_detail_values.memory, g_node_detail_ui.memory_label);
+    
     // Populate data using common refresh function (replaces placeholder text if data is available)
     esp_err_t ret = espnow_node_detail_refresh_data_and_ui();
     if (ret != ESP_OK) {
@@ -813,20 +824,15 @@ static esp_err_t espnow_node_detail_update(void)
 {
     ESP_LOGD(TAG, "Updating ESP-NOW node detail page...");
     
-    // Always update LOCAL DEVICE uptime display (same as overview page)
-    if (g_node_detail_ui.uptime_label != NULL) {
-        char uptime_text[16];
-        format_uptime_string(uptime_text, sizeof(uptime_text));
-        lv_label_set_text(g_node_detail_ui.uptime_label, uptime_text);
-    }
-    
-    // Always update LOCAL DEVICE memory display (same as overview page)
+    // Always update LOCAL DEVICE uptime and memory display (same as overview page)
     // NOTE: Remote device memory is handled in refresh_data_and_ui function
-    if (g_node_detail_ui.memory_label != NULL) {
-        char memory_text[16];
-        format_free_memory_string(memory_text, sizeof(memory_text));
-        lv_label_set_text(g_node_detail_ui.memory_label, memory_text);
-    }
+    char uptime_text[16];
+    format_uptime_string(uptime_text, sizeof(uptime_text));
+    ui_bound_label_set_text(&g_node_detail_values.uptime, uptime_text);
+    
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_node_detail_values.memory, memory_text);
     
     // Use common function to refresh device data and UI
     esp_err_t ret = espnow_node_detail_refresh_data_and_ui();
@@ -849,16 +855,22 @@ static esp_err_t espnow_node_detail_refresh_data_and_ui(void)
     espnow_device_info_t device_info = {0};
     bool have_real_data = false;
     
-    if (espnow_manager_get_device_info(g_current_device_index, &device_info) == ESP_OK) {
-        // Update global node data with real device information
+    if (node_detail_fetch(&device_info)) {
+        // A different node (device switch or slot reuse) starts from fresh filters
+        if (memcmp(g_node_filter_mac, device_info.mac_address, sizeof(g_node_filter_mac)) != 0) {
+            change_filter_reset_all(g_node_filter_state, NODE_METRIC_COUNT);
+            memcpy(g_node_filter_mac, device_info.mac_address, sizeof(g_node_filter_mac));
+        }
+        
+        // Update global node data with real device information (noisy readings filtered)
         memcpy(g_current_node_data.mac_address, device_info.mac_address, 6);
-        g_current_node_data.rssi = device_info.rssi;
+        g_current_node_data.rssi = (int)node_filter_value(NODE_METRIC_RSSI, (float)device_info.rssi);
         g_current_node_data.uptime_seconds = device_info.uptime_seconds;
-        g_current_node_data.ac_voltage = device_info.ac_voltage;
-        g_current_node_data.ac_current = device_info.ac_current;
-        g_current_node_data.ac_power = device_info.ac_power;
-        g_current_node_data.power_factor = device_info.ac_power_factor;
-        g_current_node_data.temperature = device_info.temperature;
+        g_current_node_data.ac_voltage = node_filter_value(NODE_METRIC_AC_VOLTAGE, device_info.ac_voltage);
+        g_current_node_data.ac_current = node_filter_value(NODE_METRIC_AC_CURRENT, device_info.ac_current);
+        g_current_node_data.ac_power = node_filter_value(NODE_METRIC_AC_POWER, device_info.ac_power);
+        g_current_node_data.power_factor = node_filter_value(NODE_METRIC_POWER_FACTOR, device_info.ac_power_factor);
+        g_current_node_data.temperature = node_filter_value(NODE_METRIC_TEMPERATURE, device_info.temperature);
         g_current_node_data.free_memory_kb = device_info.free_memory_kb;
         g_current_node_data.error_code = device_info.error_code;
         
@@ -881,120 +893,330 @@ static esp_err_t espnow_node_detail_refresh_data_and_ui(void)
     }
     
     // Update Row 1: Network information (Device ID and RSSI)
-    if (g_node_detail_ui.network_row_label != NULL) {
-        char network_text[80];
-        if (have_real_data) {
-            snprintf(network_text, sizeof(network_text), 
-                     "%d:%s | RSSI:%d",
-                     g_current_device_index,
-                     g_current_node_data.device_id,
-                     g_current_node_data.rssi);
-        } else {
-            snprintf(network_text, sizeof(network_text), "%d:--- | RSSI: ---", g_current_device_index);
-        }
-        lv_label_set_text(g_node_detail_ui.network_row_label, network_text);
-    }
-    
-    // Update Row 2: Power information - Main Display (48pt)
-    if (g_node_detail_ui.power_label != NULL) {
-        char power_text[20];
-        if (have_real_data) {
-            snprintf(power_text, sizeof(power_text), "%06.1f", g_current_node_data.ac_power);
-        } else {
-            snprintf(power_text, sizeof(power_text), "-----.-");
-        }
-        lv_label_set_text(g_node_detail_ui.power_label, power_text);
+    if (have_real_data) {
+        ui_bound_label_set_fmt(&g_node_detail_values.network, "%d:%s | RSSI:%d",
+                               g_current_device_index,
+                               g_current_node_data.device_id,
+                               g_current_node_data.rssi);
+    } else {
+        ui_bound_label_set_fmt(&g_node_detail_values.network, "%d:--- | RSSI: ---", g_current_device_index);
     }
     
-    // Update Row 3: Dual Panel - Voltage (Left Panel)
-    if (g_node_detail_ui.electrical_row_label != NULL) {
-        // Find the voltage value label (second child of voltage panel)
-        lv_obj_t *voltage_value = lv_obj_get_child(g_node_detail_ui.electrical_row_label, 1);
-        if (voltage_value != NULL) {
-            char voltage_text[16];
-            if (have_real_data) {
-                snprintf(voltage_text, sizeof(voltage_text), "%.1f", g_current_node_data.ac_voltage);
-            } else {
-                snprintf(voltage_text, sizeof(voltage_text), "---.-");
-            }
-            lv_label_set_text(voltage_value, voltage_text);
-        }
+    // Update Row 2: Power information - Main Display
+    if (have_real_data) {
+        ui_bound_label_set_fmt(&g_node_detail_values.power, "%06.1f", g_current_node_data.ac_power);
+    } else {
+        ui_bound_label_set_text(&g_node_detail_values.power, "-----.-");
     }
     
-    // Update Row 3: Dual Panel - Current (Right Panel)
-    if (g_node_detail_ui.current_panel != NULL) {
-        // Find the current value label (second child of current panel)
-        lv_obj_t *current_value = lv_obj_get_child(g_node_detail_ui.current_panel, 1);
-        if (current_value != NULL) {
-            char current_text[16];
-            if (have_real_data) {
-                snprintf(current_text, sizeof(current_text), "%.2f", g_current_node_data.ac_current);
-            } else {
-                snprintf(current_text, sizeof(current_text), "--.-");
-            }
-            lv_label_set_text(current_value, current_text);
-        }
+    // Update Row 3: Dual Panel - Voltage (Left Panel) and Current (Right Panel)
+    if (have_real_data) {
+        ui_bound_label_set_fmt(&g_node_detail_values.voltage, "%.1f", g_current_node_data.ac_voltage);
+        ui_bound_label_set_fmt(&g_node_detail_values.current, "%.2f", g_current_node_data.ac_current);
+    } else {
+        ui_bound_label_set_text(&g_node_detail_values.voltage, "---.-");
+        ui_bound_label_set_text(&g_node_detail_values.current, "--.-");
     }
     
     // Update Row 4: System information (Uptime, Memory, Firmware)
-    if (g_node_detail_ui.system_row_label != NULL) {
-        char system_text[80];
-        if (have_real_data) {
-            uint32_t hours = g_current_node_data.uptime_seconds / 3600;
-            uint32_t minutes = (g_current_node_data.uptime_seconds % 3600) / 60;
-            uint32_t seconds = g_current_node_data.uptime_seconds % 60;
-            
-            // Use remote device memory if available, otherwise show placeholder
-            if (g_current_node_data.free_memory_kb > 0) {
-                snprintf(system_text, sizeof(system_text), 
-                         "UP:%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32 " | %" PRIu32 "KB | FW:%s",
-                         hours, minutes, seconds,
-                         g_current_node_data.free_memory_kb,
-                         g_current_node_data.firmware_version);
-            } else {
-                // No valid remote memory data - show N/A
-                snprintf(system_text, sizeof(system_text), 
-                         "UP:%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32 " | N/A | FW:%s",
-                         hours, minutes, seconds,
-                         g_current_node_data.firmware_version);
-            }
+    if (have_real_data) {
+        uint32_t hours = g_current_node_data.uptime_seconds / 3600;
+        uint32_t minutes = (g_current_node_data.uptime_seconds % 3600) / 60;
+        uint32_t seconds = g_current_node_data.uptime_seconds % 60;
+        
+        // Use remote device memory if available, otherwise show N/A
+        if (g_current_node_data.free_memory_kb > 0) {
+            ui_bound_label_set_fmt(&g_node_detail_values.system,
+                                   "UP:%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32 " | %" PRIu32 "KB | FW:%s",
+                                   hours, minutes, seconds,
+                                   g_current_node_data.free_memory_kb,
+                                   g_current_node_data.firmware_version);
         } else {
-            snprintf(system_text, sizeof(system_text), "UP: --:--:-- | --KB | FW: ---");
+            ui_bound_label_set_fmt(&g_node_detail_values.system,
+                                   "UP:%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32 " | N/A | FW:%s",
+                                   hours, minutes, seconds,
+                                   g_current_node_data.firmware_version);
         }
-        lv_label_set_text(g_node_detail_ui.system_row_label, system_text);
+    } else {
+        ui_bound_label_set_text(&g_node_detail_values.system, "UP: --:--:-- | --KB | FW: ---");
     }
     
     // Update Row 5: Compile time information
-    if (g_node_detail_ui.compile_label != NULL) {
-        char compile_text[40];
-        if (have_real_data) {
-            snprintf(compile_text, sizeof(compile_text), "Built: %s", g_current_node_data.compile_time);
-        } else {
-            snprintf(compile_text, sizeof(compile_text), "Built: ---");
-        }
-        lv_label_set_text(g_node_detail_ui.compile_label, compile_text);
+    if (have_real_data) {
+        ui_bound_label_set_fmt(&g_node_detail_values.compile, "Built: %s", g_current_node_data.compile_time);
+    } else {
+        ui_bound_label_set_text(&g_node_detail_values.compile, "Built: ---");
     }
     
+    // Update Rows 6-7: Power trend from the node history (O(1) window queries)
+    node_detail_show_trend(&g_node_detail_values.trend_short, "2m", NODE_HISTORY_RES_5S, have_real_data);
+    node_detail_show_trend(&g_node_detail_values.trend_long, "24m", NODE_HISTORY_RES_1MIN, have_real_data);
+    
     ESP_LOGD(TAG, "ESP-NOW node detail data and UI refreshed successfully");
     return ESP_OK;
 }
 
-// Node detail page UI destruction function
-static esp_err_t espnow_node_detail_destroy(void)
+// Show min/avg/max power of the current node over one history window
+static void node_detail_show_trend(ui_bound_label_t *label, const char *window,
+                                   node_history_resolution_t resolution, bool have_real_data)
 {
-    ESP_LOGI(TAG, "Destroying ESP-NOW node detail page...");
+    node_history_stats_t stats;
+    if (have_real_data &&
+        node_history_query(g_current_device_index, g_current_node_data.mac_address,
+                           NODE_HISTORY_AC_POWER, resolution, &stats) == ESP_OK) {
+        ui_bound_label_set_fmt(label, "%s: %.0f/%.0f/%.0fW", window, stats.min, stats.avg, stats.max);
+    } else {
+        ui_bound_label_set_fmt(label, "%s: ---", window);
+    }
+}
+
+// Run a remote reading through its change filter and return the value to display
+static float node_filter_value(node_metric_t metric, float value)
+{
+    change_filter_update(&g_node_filter_state[metric], &k_node_filters[metric], value);
+    return g_node_filter_state[metric].reported;
+}
+
+// Bring the cached copy of the shown device up to date
+// The slot's generation is checked first; the device is copied only when it changed
+static bool node_detail_fetch(espnow_device_info_t *device_info)
+{
+    bool reload = (g_node_cached_index != g_current_device_index);
+    uint32_t generation = 0;
+    if (espnow_manager_get_device_generation(g_current_device_index, &generation) == ESP_OK) {
+        reload = reload || (generation != g_node_cached_generation);
+    }
+    
+    if (reload) {
+        g_node_cached_index = g_current_device_index;
+        g_node_cached_valid = (espnow_manager_get_device_info(g_current_device_index, &g_node_cached_info) == ESP_OK);
+        g_node_cached_generation = g_node_cached_valid ? g_node_cached_info.generation : generation;
+    }
     
-    // Clear screen will automatically clean up all child objects
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
+    if (g_node_cached_valid) {
+        *device_info = g_node_cached_info;
+    }
+    return g_node_cached_valid;
+}
+
+// Called by the screen cache right before the node detail tree is deleted
+static void espnow_node_detail_release(void)
+{
+    ESP_LOGI(TAG, "Releasing ESP-NOW node detail page...");
     
     // Reset object pointers in node detail structure
     memset(&g_node_detail_ui, 0, sizeof(espnow_node_detail_t));
+    memset(&g_node_detail_values, 0, sizeof(espnow_node_detail_values_t));
     
-    ESP_LOGI(TAG, "ESP-NOW node detail page destroyed successfully");
+    // Refetch in full when the page is rebuilt
+    g_node_cached_index = -1;
+}
+
+/*=============================================================================
+ * ⏱️  BENCHMARK PAGE IMPLEMENTATION (ESP-NOW throughput and latency sweep)
+ *=============================================================================*/
+
+// Render the RSSI histogram as one digit (0-9) per 10 dB bin, scaled to the fullest bin
+static void bench_format_histogram(const espnow_bench_result_t *result, char *buffer, size_t buffer_size)
+{
+    uint16_t peak = 0;
+    for (int i = 0; i < ESPNOW_BENCH_RSSI_BINS; i++) {
+        if (result->rssi_hist[i] > peak) {
+            peak = result->rssi_hist[i];
+        }
+    }
+    
+    size_t pos = 0;
+    for (int i = 0; i < ESPNOW_BENCH_RSSI_BINS && pos + 1 < buffer_size; i++) {
+        uint16_t count = result->rssi_hist[i];
+        buffer[pos++] = (peak == 0) ? '-' : (char)('0' + (count * 9 + peak - 1) / peak);
+    }
+    buffer[pos] = '\0';
+}
+
+// Benchmark page UI creation function
+static esp_err_t espnow_bench_page_create(lv_obj_t *scr)
+{
+    ESP_LOGI(TAG, "Creating ESP-NOW benchmark page...");
+    
+    // Title with page indicator
+    lv_obj_t *title = lv_label_create(scr);
+    lv_label_set_text(title, "Bench [2/2]");
+    lv_obj_set_style_text_color(title, lv_color_hex(0x00FFFF), LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_pos(title, 25, 5);
+    
+    // Row 1: radio profile and payload size of the shown run
+    lv_obj_t *profile_label = lv_label_create(scr);
+    lv_label_set_text(profile_label, "ch-- -- ---B");
+    lv_obj_set_style_text_color(profile_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(profile_label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_pos(profile_label, 5, 25);
+    
+    // Row 2: median round trip - main display (28pt)
+    lv_obj_t *p50_label = lv_label_create(scr);
+    lv_label_set_text(p50_label, "-----");
+    lv_obj_set_style_text_color(p50_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(p50_label, &lv_font_montserrat_28, LV_PART_MAIN);
+    lv_obj_set_pos(p50_label, 10, 50);
+    
+    lv_obj_t *p50_unit_label = lv_label_create(scr);
+    lv_label_set_text(p50_unit_label, "us");
+    lv_obj_set_style_text_color(p50_unit_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(p50_unit_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_set_pos(p50_unit_label, 105, 55);
+    
+    // Row 3: tail latency and ping loss
+    lv_obj_t *tail_label = lv_label_create(scr);
+    lv_label_set_text(tail_label, "p90 --- p99 ---");
+    lv_obj_set_style_text_color(tail_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(tail_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(tail_label, 5, 90);
+    
+    lv_obj_t *loss_label = lv_label_create(scr);
+    lv_label_set_text(loss_label, "Ping --/--");
+    lv_obj_set_style_text_color(loss_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(loss_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(loss_label, 5, 108);
+    
+    // Row 4: flood throughput as counted by the peer
+    lv_obj_t *flood_label = lv_label_create(scr);
+    lv_label_set_text(flood_label, "Flood --/--");
+    lv_obj_set_style_text_color(flood_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(flood_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(flood_label, 5, 130);
+    
+    lv_obj_t *pps_label = lv_label_create(scr);
+    lv_label_set_text(pps_label, "--- pps");
+    lv_obj_set_style_text_color(pps_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(pps_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(pps_label, 5, 148);
+    
+    // Row 5: RSSI histogram, one digit per 10 dB from -100 to -20 dBm
+    lv_obj_t *rssi_label = lv_label_create(scr);
+    lv_label_set_text(rssi_label, "RSSI --------");
+    lv_obj_set_style_text_color(rssi_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(rssi_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(rssi_label, 5, 170);
+    
+    // Row 6: sweep state and what ENTER does next
+    lv_obj_t *state_label = lv_label_create(scr);
+    lv_label_set_text(state_label, "ENTER: start");
+    lv_obj_set_style_text_color(state_label, lv_color_hex(0xFFFF00), LV_PART_MAIN);
+    lv_obj_set_style_text_font(state_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(state_label, 5, 195);
+    
+    // Uptime at bottom-left (same as overview page)
+    lv_obj_t *uptime_label = lv_label_create(scr);
+    char uptime_text[16];
+    format_uptime_string(uptime_text, sizeof(uptime_text));
+    lv_label_set_text(uptime_label, uptime_text);
+    lv_obj_set_style_text_color(uptime_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(uptime_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(uptime_label, 5, 225);
+    
+    // Memory at bottom-right (same as overview page)
+    lv_obj_t *memory_label = lv_label_create(scr);
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    lv_label_set_text(memory_label, memory_text);
+    lv_obj_set_style_text_color(memory_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(memory_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(memory_label, 80, 225);
+    
+    // Bind value labels so refreshes only re-render what changed
+    ui_bound_label_bind(&g_bench_values.profile, profile_label);
+    ui_bound_label_bind(&g_bench_values.p50, p50_label);
+    ui_bound_label_bind(&g_bench_values.tail, tail_label);
+    ui_bound_label_bind(&g_bench_values.loss, loss_label);
+    ui_bound_label_bind(&g_bench_values.flood, flood_label);
+    ui_bound_label_bind(&g_bench_values.pps, pps_label);
+    ui_bound_label_bind(&g_bench_values.rssi, rssi_label);
+    ui_bound_label_bind(&g_bench_values.state, state_label);
+    ui_bound_label_bind(&g_bench_values.uptime, uptime_label);
+    ui_bound_label_bind(&g_bench_values.memory, memory_label);
+    
+    espnow_bench_page_update();
+    
+    ESP_LOGI(TAG, "ESP-NOW benchmark page created successfully");
     return ESP_OK;
 }
 
+// Benchmark page UI update function
+static esp_err_t espnow_bench_page_update(void)
+{
+    char uptime_text[16];
+    format_uptime_string(uptime_text, sizeof(uptime_text));
+    ui_bound_label_set_text(&g_bench_values.uptime, uptime_text);
+    
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_bench_values.memory, memory_text);
+    
+    espnow_bench_report_t *report = &g_bench_report;
+    esp_err_t ret = espnow_bench_get_report(report);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    // While running follow the newest result, afterwards show the selected run
+    if (report->state == ESPNOW_BENCH_RUNNING) {
+        g_bench_view_run = (report->run_count > 0) ? report->run_count - 1 : 0;
+    } else if (g_bench_view_run >= report->run_count) {
+        g_bench_view_run = 0;
+    }
+    
+    switch (report->state) {
+        case ESPNOW_BENCH_RUNNING:
+            ui_bound_label_set_fmt(&g_bench_values.state, "Running %d/%d",
+                                   report->run_index + 1, ESPNOW_BENCH_MAX_RUNS);
+            break;
+        case ESPNOW_BENCH_DONE:
+            ui_bound_label_set_text(&g_bench_values.state,
+                                    (g_bench_view_run + 1 < report->run_count) ? "ENTER: next run" : "ENTER: new sweep");
+            break;
+        case ESPNOW_BENCH_FAILED:
+            ui_bound_label_set_text(&g_bench_values.state, "No peer! ENTER: retry");
+            break;
+        default:
+            ui_bound_label_set_text(&g_bench_values.state, "ENTER: start");
+            break;
+    }
+    
+    if (report->run_count == 0) {
+        return ESP_OK;
+    }
+    
+    const espnow_bench_result_t *result = &report->results[g_bench_view_run];
+    ui_bound_label_set_fmt(&g_bench_values.profile, "ch%d %s %dB %d/%d", result->channel,
+                           result->long_range ? "LR" : "--", result->payload_len,
+                           g_bench_view_run + 1, report->run_count);
+    
+    if (!result->completed) {
+        ui_bound_label_set_text(&g_bench_values.p50, "-----");
+    } else {
+        ui_bound_label_set_u32(&g_bench_values.p50, "%" PRIu32, result->rtt_p50_us);
+    }
+    ui_bound_label_set_fmt(&g_bench_values.tail, "p90 %" PRIu32 " p99 %" PRIu32,
+                           result->rtt_p90_us, result->rtt_p99_us);
+    ui_bound_label_set_fmt(&g_bench_values.loss, "Ping %d/%d%s", result->pongs_received,
+                           result->pings_sent, result->power_save ? " PS" : "");
+    ui_bound_label_set_fmt(&g_bench_values.flood, "Flood %d/%d", result->flood_received, result->flood_sent);
+    ui_bound_label_set_u32(&g_bench_values.pps, "%" PRIu32 " pps", result->flood_pps);
+    
+    char histogram[ESPNOW_BENCH_RSSI_BINS + 1];
+    bench_format_histogram(result, histogram, sizeof(histogram));
+    ui_bound_label_set_fmt(&g_bench_values.rssi, "RSSI %s", histogram);
+    
+    return ESP_OK;
+}
+
+// Called by the screen cache right before the benchmark tree is deleted
+static void espnow_bench_page_release(void)
+{
+    memset(&g_bench_values, 0, sizeof(espnow_bench_values_t));
+}
+
 /*=============================================================================
  * ⌨️   KEY EVENT HANDLING (User input processing)
  *=============================================================================*/
@@ -1021,11 +1243,27 @@ static bool espnow_page_handle_key_event(uint32_t key)
                     ESP_LOGI(TAG, "📱 Switching from device index %d to %d", g_current_device_index, next_device_index);
                     g_current_device_index = next_device_index;
                     // Force data update to refresh UI with new device data
-                    atomic_store(&g_espnow_data_updated, true);
+                    ui_notify_publish(UI_TOPIC_ESPNOW_DEVICES);
                 } else {
                     ESP_LOGW(TAG, "⚠️ No valid devices available for switching: %s", esp_err_to_name(ret));
                     // Still force refresh in case device becomes available
-                    atomic_store(&g_espnow_data_updated, true);
+                    ui_notify_publish(UI_TOPIC_ESPNOW_DEVICES);
+                }
+                return true;  // We handled this key
+            } else if (g_current_subpage == ESPNOW_SUBPAGE_BENCH) {
+                if (espnow_bench_is_running()) {
+                    ESP_LOGI(TAG, "⏱️ Benchmark already running");
+                } else if (g_bench_report.state == ESPNOW_BENCH_DONE &&
+                           g_bench_view_run + 1 < g_bench_report.run_count) {
+                    g_bench_view_run++;
+                    ui_notify_publish(UI_TOPIC_ESPNOW_BENCH);
+                } else {
+                    ESP_LOGI(TAG, "⏱️ ESP-NOW bench ENTER - Start sweep");
+                    g_bench_view_run = 0;
+                    esp_err_t ret = espnow_bench_start();
+                    if (ret != ESP_OK) {
+                        ESP_LOGW(TAG, "⚠️ Failed to start benchmark: %s", esp_err_to_name(ret));
+                    }
                 }
                 return true;  // We handled this key
             }
@@ -1033,7 +1271,7 @@ static bool espnow_page_handle_key_event(uint32_t key)
             return false;
             
         case LV_KEY_RIGHT:
-            // Subpage switching: Overview -> Node Detail
+            // Subpage switching: Overview -> Node Detail -> Bench
             if (g_current_subpage == ESPNOW_SUBPAGE_OVERVIEW) {
                 ESP_LOGI(TAG, "🔄 ESP-NOW RIGHT - Switch to Node Detail subpage");
                 esp_err_t ret = espnow_subpage_switch(ESPNOW_SUBPAGE_NODE_DETAIL);
@@ -1044,7 +1282,14 @@ static bool espnow_page_handle_key_event(uint32_t key)
                 }
                 return true;  // We handled this key
             } else if (g_current_subpage == ESPNOW_SUBPAGE_NODE_DETAIL) {
-                ESP_LOGI(TAG, "📶 ESP-NOW node detail end, should switch to next main page");
+                ESP_LOGI(TAG, "🔄 ESP-NOW RIGHT - Switch to Bench subpage");
+                esp_err_t ret = espnow_subpage_switch(ESPNOW_SUBPAGE_BENCH);
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "❌ Failed to switch to bench subpage: %s", esp_err_to_name(ret));
+                }
+                return true;  // We handled this key
+            } else if (g_current_subpage == ESPNOW_SUBPAGE_BENCH) {
+                ESP_LOGI(TAG, "📶 ESP-NOW bench end, should switch to next main page");
                 return false;
             }
             return false;
@@ -1096,21 +1341,26 @@ static esp_err_t espnow_subpage_switch(espnow_subpage_id_t subpage_id)
     return ESP_OK;
 }
 
+// Show the current subpage, building its screen only if it is not cached
 static esp_err_t espnow_subpage_create_current(void)
 {
-    switch (g_current_subpage) {
-        case ESPNOW_SUBPAGE_OVERVIEW:
-            ESP_LOGD(TAG, "Creating overview subpage");
-            return espnow_overview_create();
-            
-        case ESPNOW_SUBPAGE_NODE_DETAIL:
-            ESP_LOGD(TAG, "Creating node detail subpage");
-            return espnow_node_detail_create();
-            
-        default:
-            ESP_LOGE(TAG, "Unknown subpage ID: %d", g_current_subpage);
-            return ESP_ERR_INVALID_STATE;
+    if (g_current_subpage >= ESPNOW_SUBPAGE_COUNT) {
+        ESP_LOGE(TAG, "Unknown subpage ID: %d", g_current_subpage);
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    bool built = false;
+    esp_err_t ret = ui_screen_cache_show(&k_subpage_screens[g_current_subpage], &built);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    // A reactivated screen still shows the values of the last visit
+    if (!built) {
+        ESP_LOGD(TAG, "Reactivated cached subpage %d", g_current_subpage);
+        espnow_subpage_update_current();
     }
+    return ESP_OK;
 }
 
 static esp_err_t espnow_subpage_update_current(void)
@@ -1122,23 +1372,23 @@ static esp_err_t espnow_subpage_update_current(void)
         case ESPNOW_SUBPAGE_NODE_DETAIL:
             return espnow_node_detail_update();
             
+        case ESPNOW_SUBPAGE_BENCH:
+            return espnow_bench_page_update();
+            
         default:
             ESP_LOGE(TAG, "Unknown subpage ID: %d", g_current_subpage);
             return ESP_ERR_INVALID_STATE;
     }
 }
 
+// Leave the current subpage; its screen is hidden or deleted according to its policy
 static esp_err_t espnow_subpage_destroy_current(void)
 {
-    switch (g_current_subpage) {
-        case ESPNOW_SUBPAGE_OVERVIEW:
-            return espnow_overview_destroy();
-            
-        case ESPNOW_SUBPAGE_NODE_DETAIL:
-            return espnow_node_detail_destroy();
-            
-        default:
-            ESP_LOGE(TAG, "Unknown subpage ID: %d", g_current_subpage);
-            return ESP_ERR_INVALID_STATE;
+    if (g_current_subpage >= ESPNOW_SUBPAGE_COUNT) {
+        ESP_LOGE(TAG, "Unknown subpage ID: %d", g_current_subpage);
+        return ESP_ERR_INVALID_STATE;
     }
+    
+    ui_screen_cache_leave(&k_subpage_screens[g_current_subpage]);
+    return ESP_OK;
 }
@@ -12,7 +12,7 @@ extern "C" {
  * This module manages the ESP-NOW page independently, including:
  * - Page UI creation and destruction
  * - ESP-NOW communication status updates
- * - Independent data update checking
+ * - Topic-driven data updates (see ui_notify.h)
  * - Network statistics management
  */
 
@@ -26,14 +26,6 @@ extern "C" {
  */
 const page_controller_t* get_espnow_page_controller(void);
 
-/**
- * @brief Notify ESP-NOW page of data update
- * 
- * Called by ESP-NOW communication handlers to indicate that
- * page data should be refreshed on next update cycle.
- */
-void espnow_page_notify_data_update(void);
-
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "page_manager_lvgl.h"
 #include "page_manager.h"
 #include "lvgl_button_input.h"
+#include "power_manager.h"
 #include "ux_service.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -57,6 +58,7 @@ static void backlight_timer_callback(TimerHandle_t xTimer)
     } else {
         ESP_LOGI(TAG, "✅ Backlight turned off successfully");
         g_backlight_is_on = false;  // Update state without I2C call
+        power_manager_set_mode(POWER_MODE_DARK);  // Nothing is visible: stop rendering, slow down, sleep
     }
 }
 
@@ -86,6 +88,7 @@ static bool reset_backlight_timer(void)
         } else {
             ESP_LOGI(TAG, "✅ Backlight turned on successfully");
             g_backlight_is_on = true;  // Update state without I2C call
+            power_manager_set_mode(POWER_MODE_ACTIVE);
         }
     }
     
@@ -323,6 +326,7 @@ esp_err_t page_manager_lvgl_deinit(void)
     g_key_events_enabled = false;
     g_backlight_auto_off_enabled = false;
     g_backlight_is_on = true;  // Reset state
+    power_manager_set_mode(POWER_MODE_ACTIVE);  // Never leave LVGL rendering paused
     
     // Clean up backlight timer
     if (g_backlight_timer) {
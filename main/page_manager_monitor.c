@@ -2,6 +2,11 @@
 #include "core/lv_obj_style_gen.h"
 #include "page_manager.h"
 #include "system_monitor.h"
+#include "ui_notify.h"
+#include "ui_bound_label.h"
+#include "ui_screen_cache.h"
+#include "task_profiler.h"
+#include "mem_account.h"
 #include "axp192.h"
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -9,6 +14,7 @@
 #include "freertos/task.h"
 #include "lvgl.h"
 #include <inttypes.h>
+#include <string.h>
 
 static const char *TAG = "MONITOR_PAGE";
 
@@ -29,6 +35,76 @@ static lv_obj_t *g_monitor_power_source_label = NULL;     // "Power Source:" tex
 static lv_obj_t *g_monitor_power_status_panel = NULL;     // Background panel for USB/Battery
 static lv_obj_t *g_monitor_power_status_label = NULL;     // "USB" or "BATTERY" text
 
+// Monitor page value labels, re-rendered only when their text changes
+static struct {
+    ui_bound_label_t uptime;
+    ui_bound_label_t memory;
+    ui_bound_label_t battery_voltage;
+    ui_bound_label_t usb_value;
+    ui_bound_label_t current_title;
+    ui_bound_label_t current_value;
+    ui_bound_label_t temp;
+    ui_bound_label_t power_status;
+} g_monitor_values;
+
+// Monitor subpages, stepped through with RIGHT before moving on to the next page
+typedef enum {
+    MONITOR_SUBPAGE_MAIN = 0,       // Battery and power overview
+    MONITOR_SUBPAGE_TASKS,          // Task profiler diagnostics
+    MONITOR_SUBPAGE_MEMORY,         // Heap per module and fragmentation
+    MONITOR_SUBPAGE_STACKS,         // Stack headroom of the placed tasks
+    MONITOR_SUBPAGE_COUNT
+} monitor_subpage_id_t;
+
+_Static_assert(MONITOR_SUBPAGE_COUNT == UI_SCREEN_COUNT_MONITOR, "Update UI_SCREEN_COUNT_MONITOR with the subpages");
+
+static monitor_subpage_id_t g_monitor_subpage = MONITOR_SUBPAGE_MAIN;
+
+#define TASKS_PAGE_ROWS         10      // Busiest tasks listed on the Tasks subpage
+#define TASKS_PAGE_ROW_CHARS    16      // Longest column entry per row, including the newline
+
+// Tasks subpage value labels; each column is one multi-line label
+static struct {
+    ui_bound_label_t load;
+    ui_bound_label_t names;
+    ui_bound_label_t cores;
+    ui_bound_label_t cpu;
+    ui_bound_label_t stack;
+    ui_bound_label_t count;
+    ui_bound_label_t memory;
+} g_tasks_values;
+
+static task_profiler_snapshot_t g_tasks_snapshot;   // Too large for the LVGL task stack
+
+#define MEMORY_PAGE_ROWS        (MEM_MODULE_COUNT + 1)  // Accounted modules plus the LVGL pool
+#define MEMORY_PAGE_CELL_CHARS  7       // Longest cell ("999.9K" or a module name), including the newline
+#define STACKS_PAGE_NAME_CHARS  15      // Longest task name cell, including the newline
+
+// Memory subpage value labels
+static struct {
+    ui_bound_label_t internal;
+    ui_bound_label_t largest;
+    ui_bound_label_t dma;
+    ui_bound_label_t names;
+    ui_bound_label_t heap;
+    ui_bound_label_t peak;
+    ui_bound_label_t fixed;
+    ui_bound_label_t failures;
+    ui_bound_label_t memory;
+} g_memory_values;
+
+// Stacks subpage value labels
+static struct {
+    ui_bound_label_t reclaim;
+    ui_bound_label_t names;
+    ui_bound_label_t size;
+    ui_bound_label_t free;
+    ui_bound_label_t oversized;
+    ui_bound_label_t memory;
+} g_stacks_values;
+
+static mem_account_snapshot_t g_mem_snapshot;       // Shared by the Memory and Stacks subpages
+
 // Helper function to format uptime as HH:MM:SS string
 static void format_uptime_string(char *buffer, size_t buffer_size)
 {
@@ -42,6 +118,18 @@ static void format_uptime_string(char *buffer, size_t buffer_size)
     snprintf(buffer, buffer_size, "%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32, hours, minutes, seconds);
 }
 
+// Format a byte count compactly: "812", "12.3K", "123K"
+static void format_bytes_short(char *buffer, size_t buffer_size, uint32_t bytes)
+{
+    if (bytes < 1000) {
+        snprintf(buffer, buffer_size, "%" PRIu32, bytes);
+    } else if (bytes < 100 * 1024) {
+        snprintf(buffer, buffer_size, "%" PRIu32 ".%" PRIu32 "K", bytes / 1024, (bytes % 1024) * 10 / 1024);
+    } else {
+        snprintf(buffer, buffer_size, "%" PRIu32 "K", bytes / 1024);
+    }
+}
+
 // Helper function to format free memory as "XXX KB" string  
 static void format_free_memory_string(char *buffer, size_t buffer_size)
 {
@@ -53,14 +141,23 @@ static void format_free_memory_string(char *buffer, size_t buffer_size)
 }
 
 // Internal functions
-static esp_err_t create_monitor_page_ui(void);
+static esp_err_t create_monitor_page_ui(lv_obj_t *scr);
 static esp_err_t update_monitor_page_ui(void);
-static esp_err_t destroy_monitor_page_ui(void);
+static void release_monitor_page_ui(void);
+static esp_err_t create_tasks_page_ui(lv_obj_t *scr);
+static esp_err_t update_tasks_page_ui(void);
+static void release_tasks_page_ui(void);
+static esp_err_t create_memory_page_ui(lv_obj_t *scr);
+static esp_err_t update_memory_page_ui(void);
+static void release_memory_page_ui(void);
+static esp_err_t create_stacks_page_ui(lv_obj_t *scr);
+static esp_err_t update_stacks_page_ui(void);
+static void release_stacks_page_ui(void);
+static esp_err_t monitor_subpage_show(monitor_subpage_id_t subpage);
 static esp_err_t monitor_page_init(void);
 static esp_err_t monitor_page_create(void);
 static esp_err_t monitor_page_update(void);
 static esp_err_t monitor_page_destroy(void);
-static bool monitor_page_is_data_updated(void);
 static bool monitor_page_handle_key_event(uint32_t key);
 
 // Page controller interface implementation
@@ -69,7 +166,7 @@ static const page_controller_t monitor_controller = {
     .create = monitor_page_create,
     .update = monitor_page_update, 
     .destroy = monitor_page_destroy,
-    .is_data_updated = monitor_page_is_data_updated,
+    .topics = UI_TOPIC_SYSTEM_MONITOR | UI_TOPIC_CLOCK | UI_TOPIC_DIAGNOSTICS,
     .handle_key_event = monitor_page_handle_key_event,
     .name = "Monitor",
     .page_id = PAGE_MONITOR
@@ -78,6 +175,43 @@ static const page_controller_t monitor_controller = {
     return &monitor_controller;
 }
 
+// Home page: built once, never evicted from the screen cache
+static const ui_screen_desc_t monitor_screen = {
+    .name = "Monitor",
+    .policy = UI_SCREEN_KEEP_ALIVE,
+    .build = create_monitor_page_ui,
+    .forget = release_monitor_page_ui
+};
+
+// Diagnostics: rarely visited, rebuilt on every visit
+static const ui_screen_desc_t tasks_screen = {
+    .name = "Tasks",
+    .policy = UI_SCREEN_DESTROY_ON_LEAVE,
+    .build = create_tasks_page_ui,
+    .forget = release_tasks_page_ui
+};
+
+static const ui_screen_desc_t memory_screen = {
+    .name = "Memory",
+    .policy = UI_SCREEN_DESTROY_ON_LEAVE,
+    .build = create_memory_page_ui,
+    .forget = release_memory_page_ui
+};
+
+static const ui_screen_desc_t stacks_screen = {
+    .name = "Stacks",
+    .policy = UI_SCREEN_DESTROY_ON_LEAVE,
+    .build = create_stacks_page_ui,
+    .forget = release_stacks_page_ui
+};
+
+static const ui_screen_desc_t *const monitor_subpage_screens[MONITOR_SUBPAGE_COUNT] = {
+    [MONITOR_SUBPAGE_MAIN] = &monitor_screen,
+    [MONITOR_SUBPAGE_TASKS] = &tasks_screen,
+    [MONITOR_SUBPAGE_MEMORY] = &memory_screen,
+    [MONITOR_SUBPAGE_STACKS] = &stacks_screen,
+};
+
 static esp_err_t monitor_page_init(void)
 {
     ESP_LOGI(TAG, "Initializing Monitor page module");
@@ -98,6 +232,11 @@ static esp_err_t monitor_page_init(void)
     g_monitor_power_source_label = NULL;
     g_monitor_power_status_panel = NULL;
     g_monitor_power_status_label = NULL;
+    memset(&g_monitor_values, 0, sizeof(g_monitor_values));
+    memset(&g_tasks_values, 0, sizeof(g_tasks_values));
+    memset(&g_memory_values, 0, sizeof(g_memory_values));
+    memset(&g_stacks_values, 0, sizeof(g_stacks_values));
+    g_monitor_subpage = MONITOR_SUBPAGE_MAIN;
     
     ESP_LOGI(TAG, "Monitor page module initialized");
     return ESP_OK;
@@ -107,13 +246,29 @@ static esp_err_t monitor_page_create(void)
 {
     ESP_LOGI(TAG, "Creating Monitor page UI...");
     
-    esp_err_t ret = create_monitor_page_ui();
+    esp_err_t ret = monitor_subpage_show(g_monitor_subpage);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create Monitor page UI: %s", esp_err_to_name(ret));
         return ret;
     }
     
-    ESP_LOGI(TAG, "Monitor page created successfully");
+    ESP_LOGI(TAG, "Monitor page shown successfully");
+    return ESP_OK;
+}
+
+// Show a subpage screen; a reactivated screen still shows the values of the last visit
+static esp_err_t monitor_subpage_show(monitor_subpage_id_t subpage)
+{
+    bool built = false;
+    esp_err_t ret = ui_screen_cache_show(monitor_subpage_screens[subpage], &built);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    g_monitor_subpage = subpage;
+    if (!built) {
+        monitor_page_update();
+    }
     return ESP_OK;
 }
 
@@ -121,7 +276,21 @@ static esp_err_t monitor_page_update(void)
 {
     ESP_LOGD(TAG, "Updating Monitor page data...");
     
-    esp_err_t ret = update_monitor_page_ui();
+    esp_err_t ret;
+    switch (g_monitor_subpage) {
+        case MONITOR_SUBPAGE_TASKS:
+            ret = update_tasks_page_ui();
+            break;
+        case MONITOR_SUBPAGE_MEMORY:
+            ret = update_memory_page_ui();
+            break;
+        case MONITOR_SUBPAGE_STACKS:
+            ret = update_stacks_page_ui();
+            break;
+        default:
+            ret = update_monitor_page_ui();
+            break;
+    }
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to update Monitor page: %s", esp_err_to_name(ret));
         return ret;
@@ -133,41 +302,21 @@ static esp_err_t monitor_page_update(void)
 
 static esp_err_t monitor_page_destroy(void)
 {
-    ESP_LOGI(TAG, "Destroying Monitor page...");
+    ESP_LOGI(TAG, "Leaving Monitor page...");
     
-    esp_err_t ret = destroy_monitor_page_ui();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to destroy Monitor page: %s", esp_err_to_name(ret));
-        return ret;
-    }
+    // The main screen is keep-alive and only hidden; the page comes back on its main subpage
+    ui_screen_cache_leave(monitor_subpage_screens[g_monitor_subpage]);
+    g_monitor_subpage = MONITOR_SUBPAGE_MAIN;
     
-    ESP_LOGI(TAG, "Monitor page destroyed successfully");
+    ESP_LOGI(TAG, "Monitor page left successfully");
     return ESP_OK;
 }
 
-static bool monitor_page_is_data_updated(void)
-{
-    // Monitor page uses system_monitor data update status
-    // The system_monitor module handles its own thread safety
-    return system_monitor_is_data_updated();
-}
 
 // Internal UI creation function - Fusion Design (Reference Style + Complete Information)
-static esp_err_t create_monitor_page_ui(void)
+// scr is the page's cached root (black, not scrollable)
+static esp_err_t create_monitor_page_ui(lv_obj_t *scr)
 {
-    lv_obj_t *scr = lv_scr_act();
-    if (scr == NULL) {
-        ESP_LOGE(TAG, "Failed to get active screen");
-        return ESP_FAIL;
-    }
-    
-    // Clear screen
-    lv_obj_clean(scr);
-    
-    // Set black background
-    lv_obj_set_style_bg_color(scr, lv_color_black(), LV_PART_MAIN);
-    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-    
     // Title: "BATTERY MONITOR" - descriptive title
     lv_obj_t *title = lv_label_create(scr);
     if (title != NULL) {
@@ -340,6 +489,16 @@ static esp_err_t create_monitor_page_ui(void)
         lv_obj_set_size(g_monitor_memory_label, 50, 15);  // 设置宽度以便右对齐
     }
     
+    // Bind value labels so updates only re-render what changed
+    ui_bound_label_bind(&g_monitor_values.uptime, g_monitor_uptime_label);
+    ui_bound_label_bind(&g_monitor_values.memory, g_monitor_memory_label);
+    ui_bound_label_bind(&g_monitor_values.battery_voltage, g_monitor_battery_voltage_label);
+    ui_bound_label_bind(&g_monitor_values.usb_value, g_monitor_usb_value_label);
+    ui_bound_label_bind(&g_monitor_values.current_title, g_monitor_current_title_label);
+    ui_bound_label_bind(&g_monitor_values.current_value, g_monitor_current_value_label);
+    ui_bound_label_bind(&g_monitor_values.temp, g_monitor_temp_label);
+    ui_bound_label_bind(&g_monitor_values.power_status, g_monitor_power_status_label);
+    
     ESP_LOGI(TAG, "Monitor page UI created successfully (reference style)");
     return ESP_OK;
 }
@@ -348,18 +507,14 @@ static esp_err_t create_monitor_page_ui(void)
 static esp_err_t update_monitor_page_ui(void)
 {
     // Update uptime display
-    if (g_monitor_uptime_label != NULL) {
-        char uptime_text[16];
-        format_uptime_string(uptime_text, sizeof(uptime_text));
-        lv_label_set_text(g_monitor_uptime_label, uptime_text);
-    }
+    char uptime_text[16];
+    format_uptime_string(uptime_text, sizeof(uptime_text));
+    ui_bound_label_set_text(&g_monitor_values.uptime, uptime_text);
     
-    // Update memory display
-    if (g_monitor_memory_label != NULL) {
-        char memory_text[16];
-        format_free_memory_string(memory_text, sizeof(memory_text));
-        lv_label_set_text(g_monitor_memory_label, memory_text);
-    }
+    // Update memory display (small, grey text)
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_monitor_values.memory, memory_text);
     
     // Get system data
     system_data_t sys_data;
@@ -369,78 +524,46 @@ static esp_err_t update_monitor_page_ui(void)
     }
     
     // Update main battery voltage - large display like reference
-    if (g_monitor_battery_voltage_label != NULL) {
-        char battery_voltage[16];
-        snprintf(battery_voltage, sizeof(battery_voltage), "%.2f", sys_data.battery_voltage);
-        lv_label_set_text(g_monitor_battery_voltage_label, battery_voltage);
-    }
+    ui_bound_label_set_fmt(&g_monitor_values.battery_voltage, "%.2f", sys_data.battery_voltage);
     
     // Update left panel - USB voltage value only
-    if (g_monitor_usb_value_label != NULL) {
-        char usb_value[16];
-        float vbus_voltage = sys_data.vbus_voltage;
-        snprintf(usb_value, sizeof(usb_value), "%.2f", vbus_voltage);
-        lv_label_set_text(g_monitor_usb_value_label, usb_value);
-    }
+    ui_bound_label_set_fmt(&g_monitor_values.usb_value, "%.2f", sys_data.vbus_voltage);
     
     // Update right panel - Battery current title and value
-    if (g_monitor_current_title_label != NULL && g_monitor_current_value_label != NULL) {
-        char current_value[16];
-        float ibat = 0.0f;
-        const char* title = "CHR I";  // Default to charge
-        
-        if (sys_data.is_charging) {
-            ibat = sys_data.charge_current;    // mA (positive for charge)
-            title = "CHG I";  // Charging
-        } else {
-            ibat = sys_data.discharge_current; // mA (positive for discharge)
-            title = "DIS I";  // Discharging
-        }
-        
-        // Update title label
-        lv_label_set_text(g_monitor_current_title_label, title);
-        
-        // Update value label (just the number)
-        snprintf(current_value, sizeof(current_value), "%.0f", ibat);
-        lv_label_set_text(g_monitor_current_value_label, current_value);
+    float ibat = 0.0f;
+    const char* title = "CHR I";  // Default to charge
+    
+    if (sys_data.is_charging) {
+        ibat = sys_data.charge_current;    // mA (positive for charge)
+        title = "CHG I";  // Charging
+    } else {
+        ibat = sys_data.discharge_current; // mA (positive for discharge)
+        title = "DIS I";  // Discharging
     }
     
-    // Update temperature display - only show temperature value (24pt)
-    if (g_monitor_temp_label != NULL) {
-        char temp_text[32];
-        snprintf(temp_text, sizeof(temp_text), "%.1f°C", sys_data.internal_temp);
-        lv_label_set_text(g_monitor_temp_label, temp_text);
-    }
-    
-    // Update power status with dynamic background color (全宽度面板)
-    if (g_monitor_power_status_label != NULL && g_monitor_power_status_panel != NULL) {
-        if (sys_data.is_usb_connected) {
-            lv_label_set_text(g_monitor_power_status_label, "USB");
-            lv_obj_set_style_bg_color(g_monitor_power_status_panel, lv_color_hex(0x00AA00), LV_PART_MAIN);  // Green for USB
-        } else {
-            lv_label_set_text(g_monitor_power_status_label, "BATTERY");
-            lv_obj_set_style_bg_color(g_monitor_power_status_panel, lv_color_hex(0xFF6600), LV_PART_MAIN);  // Orange for Battery
-            // 面板保持全宽度，无需调整大小
-        }
-    }
+    ui_bound_label_set_text(&g_monitor_values.current_title, title);
+    ui_bound_label_set_fmt(&g_monitor_values.current_value, "%.0f", ibat);
     
-    // Update memory display (small, grey text)
-    if (g_monitor_memory_label != NULL) {
-        char memory_text[16];
-        format_free_memory_string(memory_text, sizeof(memory_text));
-        lv_label_set_text(g_monitor_memory_label, memory_text);
+    // Update temperature display - only show temperature value (24pt)
+    ui_bound_label_set_fmt(&g_monitor_values.temp, "%.1f°C", sys_data.internal_temp);
+    
+    // Update power status; the panel colour only changes together with the text (全宽度面板)
+    const char *power_status = sys_data.is_usb_connected ? "USB" : "BATTERY";
+    if (ui_bound_label_set_text(&g_monitor_values.power_status, power_status) &&
+        g_monitor_power_status_panel != NULL) {
+        lv_color_t panel_color = sys_data.is_usb_connected ?
+                                 lv_color_hex(0x00AA00) :   // Green for USB
+                                 lv_color_hex(0xFF6600);    // Orange for Battery
+        lv_obj_set_style_bg_color(g_monitor_power_status_panel, panel_color, LV_PART_MAIN);
+        ui_bound_label_match_background(&g_monitor_values.power_status);
     }
     
     return ESP_OK;
 }
 
-// Internal UI destruction function  
-static esp_err_t destroy_monitor_page_ui(void)
+// Called by the screen cache right before the page tree is deleted
+static void release_monitor_page_ui(void)
 {
-    // Clear screen will automatically clean up all child objects
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    
     // Reset object pointers
     g_monitor_uptime_label = NULL;
     g_monitor_memory_label = NULL;
@@ -457,10 +580,377 @@ static esp_err_t destroy_monitor_page_ui(void)
     g_monitor_power_source_label = NULL;
     g_monitor_power_status_panel = NULL;
     g_monitor_power_status_label = NULL;
+    memset(&g_monitor_values, 0, sizeof(g_monitor_values));
+}
+
+// Diagnostics table column: yellow header at y, multi-line value label below it
+static lv_obj_t *create_table_column(lv_obj_t *scr, int32_t x, int32_t y, int32_t width, int rows,
+                                     lv_text_align_t align, const char *header, lv_obj_t **header_label)
+{
+    *header_label = lv_label_create(scr);
+    lv_label_set_text(*header_label, header);
+    lv_obj_set_style_text_color(*header_label, lv_color_hex(0xFFFF00), LV_PART_MAIN);
+    lv_obj_set_style_text_font(*header_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_style_text_align(*header_label, align, LV_PART_MAIN);
+    lv_obj_set_pos(*header_label, x, y);
+    lv_obj_set_width(*header_label, width);
+    
+    lv_obj_t *column = lv_label_create(scr);
+    lv_label_set_text(column, "");
+    lv_label_set_long_mode(column, LV_LABEL_LONG_CLIP);
+    lv_obj_set_style_text_color(column, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(column, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_style_text_align(column, align, LV_PART_MAIN);
+    lv_obj_set_pos(column, x, y + 17);
+    lv_obj_set_size(column, width, 15 * rows);
+    return column;
+}
+
+// Small white label of the diagnostics pages
+static lv_obj_t *create_diag_label(lv_obj_t *scr, int32_t x, int32_t y, const char *text)
+{
+    lv_obj_t *label = lv_label_create(scr);
+    lv_label_set_text(label, text);
+    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(label, x, y);
+    return label;
+}
+
+// Diagnostics page title with page indicator
+static void create_diag_title(lv_obj_t *scr, const char *text)
+{
+    lv_obj_t *title = lv_label_create(scr);
+    lv_label_set_text(title, text);
+    lv_obj_set_style_text_color(title, lv_color_hex(0x00FFFF), LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_pos(title, 25, 5);
+}
+
+static esp_err_t create_tasks_page_ui(lv_obj_t *scr)
+{
+    // Title with page indicator
+    lv_obj_t *title = lv_label_create(scr);
+    lv_label_set_text(title, "Tasks [1/3]");
+    lv_obj_set_style_text_color(title, lv_color_hex(0x00FFFF), LV_PART_MAIN);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_pos(title, 25, 5);
+    
+    // Load of both cores (100% minus their idle tasks)
+    lv_obj_t *load_label = lv_label_create(scr);
+    lv_label_set_text(load_label, "CPU0 --% CPU1 --%");
+    lv_obj_set_style_text_color(load_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(load_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(load_label, 5, 25);
+    
+    // Columns: name, core, CPU %, free stack bytes
+    lv_obj_t *header;
+    lv_obj_t *names = create_table_column(scr, 2, 45, 60, TASKS_PAGE_ROWS, LV_TEXT_ALIGN_LEFT, "Task", &header);
+    lv_obj_t *cores = create_table_column(scr, 62, 45, 10, TASKS_PAGE_ROWS, LV_TEXT_ALIGN_CENTER, "C", &header);
+    lv_obj_t *cpu = create_table_column(scr, 72, 45, 30, TASKS_PAGE_ROWS, LV_TEXT_ALIGN_RIGHT, "CPU", &header);
+    lv_obj_t *stack = create_table_column(scr, 103, 45, 30, TASKS_PAGE_ROWS, LV_TEXT_ALIGN_RIGHT, "Stk", &header);
+    
+    // Task count at bottom-left, memory at bottom-right (same as other pages)
+    lv_obj_t *count_label = lv_label_create(scr);
+    lv_label_set_text(count_label, "-- tasks");
+    lv_obj_set_style_text_color(count_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(count_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(count_label, 5, 225);
+    
+    lv_obj_t *memory_label = lv_label_create(scr);
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    lv_label_set_text(memory_label, memory_text);
+    lv_obj_set_style_text_color(memory_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(memory_label, &lv_font_montserrat_12, LV_PART_MAIN);
+    lv_obj_set_pos(memory_label, 80, 225);
+    
+    ui_bound_label_bind(&g_tasks_values.load, load_label);
+    ui_bound_label_bind(&g_tasks_values.names, names);
+    ui_bound_label_bind(&g_tasks_values.cores, cores);
+    ui_bound_label_bind(&g_tasks_values.cpu, cpu);
+    ui_bound_label_bind(&g_tasks_values.stack, stack);
+    ui_bound_label_bind(&g_tasks_values.count, count_label);
+    ui_bound_label_bind(&g_tasks_values.memory, memory_label);
+    
+    update_tasks_page_ui();
+    
+    ESP_LOGI(TAG, "Tasks page UI created successfully");
+    return ESP_OK;
+}
+
+static esp_err_t update_tasks_page_ui(void)
+{
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_tasks_values.memory, memory_text);
+    
+    task_profiler_get_snapshot(&g_tasks_snapshot);
+    if (g_tasks_snapshot.samples == 0) {
+        ui_bound_label_set_text(&g_tasks_values.load, "Profiler off");
+        return ESP_OK;
+    }
+    
+    if (g_tasks_snapshot.run_time_stats) {
+        ui_bound_label_set_fmt(&g_tasks_values.load, "CPU0 %u%% CPU1 %u%%",
+                               (g_tasks_snapshot.core_load_permille[0] + 5) / 10,
+                               (g_tasks_snapshot.core_load_permille[portNUM_PROCESSORS - 1] + 5) / 10);
+    } else {
+        ui_bound_label_set_text(&g_tasks_values.load, "CPU --");
+    }
+    ui_bound_label_set_fmt(&g_tasks_values.count, "%u tasks", g_tasks_snapshot.total_tasks);
+    
+    char names[TASKS_PAGE_ROWS * TASKS_PAGE_ROW_CHARS + 1];
+    char cores[TASKS_PAGE_ROWS * 2 + 1];
+    char cpu[TASKS_PAGE_ROWS * 6 + 1];
+    char stack[TASKS_PAGE_ROWS * 7 + 1];
+    size_t names_len = 0, cores_len = 0, cpu_len = 0, stack_len = 0;
+    names[0] = cores[0] = cpu[0] = stack[0] = '\0';
+    
+    int rows = (g_tasks_snapshot.task_count < TASKS_PAGE_ROWS) ? g_tasks_snapshot.task_count : TASKS_PAGE_ROWS;
+    for (int i = 0; i < rows; i++) {
+        const task_profiler_task_t *task = &g_tasks_snapshot.tasks[i];
+        const char *sep = (i + 1 < rows) ? "\n" : "";
+        
+        names_len += snprintf(names + names_len, sizeof(names) - names_len, "%.*s%s",
+                              TASKS_PAGE_ROW_CHARS - 2, task->name, sep);
+        cores_len += snprintf(cores + cores_len, sizeof(cores) - cores_len, "%c%s",
+                              (task->core == TASK_PROFILER_NO_AFFINITY) ? '-' : (char)('0' + task->core), sep);
+        if (g_tasks_snapshot.run_time_stats) {
+            cpu_len += snprintf(cpu + cpu_len, sizeof(cpu) - cpu_len, "%u.%u%s",
+                                task->cpu_permille / 10, task->cpu_permille % 10, sep);
+        } else {
+            cpu_len += snprintf(cpu + cpu_len, sizeof(cpu) - cpu_len, "--%s", sep);
+        }
+        stack_len += snprintf(stack + stack_len, sizeof(stack) - stack_len, "%" PRIu32 "%s",
+                              (task->stack_free_min > 99999) ? 99999 : task->stack_free_min, sep);
+    }
+    
+    ui_bound_label_set_text(&g_tasks_values.names, names);
+    ui_bound_label_set_text(&g_tasks_values.cores, cores);
+    ui_bound_label_set_text(&g_tasks_values.cpu, cpu);
+    ui_bound_label_set_text(&g_tasks_values.stack, stack);
+    
+    return ESP_OK;
+}
+
+// Called by the screen cache right before the tasks tree is deleted
+static void release_tasks_page_ui(void)
+{
+    memset(&g_tasks_values, 0, sizeof(g_tasks_values));
+}
+
+// Memory subpage: internal/DMA heap fragmentation and heap per module
+static esp_err_t create_memory_page_ui(lv_obj_t *scr)
+{
+    create_diag_title(scr, "Memory [2/3]");
+    
+    // Internal heap, its largest block and the DMA-capable heap
+    lv_obj_t *internal = create_diag_label(scr, 5, 25, "Int --");
+    lv_obj_t *largest = create_diag_label(scr, 5, 40, "Blk --");
+    lv_obj_t *dma = create_diag_label(scr, 5, 55, "DMA --");
+    
+    // Columns: module, heap now, heap high-water mark, static arrays
+    lv_obj_t *header;
+    lv_obj_t *names = create_table_column(scr, 2, 75, 52, MEMORY_PAGE_ROWS, LV_TEXT_ALIGN_LEFT, "Mod", &header);
+    lv_obj_t *heap = create_table_column(scr, 54, 75, 26, MEMORY_PAGE_ROWS, LV_TEXT_ALIGN_RIGHT, "Now", &header);
+    lv_obj_t *peak = create_table_column(scr, 80, 75, 27, MEMORY_PAGE_ROWS, LV_TEXT_ALIGN_RIGHT, "Peak", &header);
+    lv_obj_t *fixed = create_table_column(scr, 107, 75, 27, MEMORY_PAGE_ROWS, LV_TEXT_ALIGN_RIGHT, "Stat", &header);
+    
+    // Allocation failures at bottom-left, memory at bottom-right (same as other pages)
+    lv_obj_t *failures = create_diag_label(scr, 5, 225, "");
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    lv_obj_t *memory_label = create_diag_label(scr, 80, 225, memory_text);
+    
+    ui_bound_label_bind(&g_memory_values.internal, internal);
+    ui_bound_label_bind(&g_memory_values.largest, largest);
+    ui_bound_label_bind(&g_memory_values.dma, dma);
+    ui_bound_label_bind(&g_memory_values.names, names);
+    ui_bound_label_bind(&g_memory_values.heap, heap);
+    ui_bound_label_bind(&g_memory_values.peak, peak);
+    ui_bound_label_bind(&g_memory_values.fixed, fixed);
+    ui_bound_label_bind(&g_memory_values.failures, failures);
+    ui_bound_label_bind(&g_memory_values.memory, memory_label);
+    
+    update_memory_page_ui();
+    
+    ESP_LOGI(TAG, "Memory page UI created successfully");
+    return ESP_OK;
+}
+
+// Append one cell to a multi-line column
+static size_t append_cell(char *column, size_t size, size_t len, const char *text, bool last)
+{
+    int n = snprintf(column + len, size - len, "%s%s", text, last ? "" : "\n");
+    return (n > 0 && (size_t)n < size - len) ? len + (size_t)n : size - 1;
+}
+
+static esp_err_t update_memory_page_ui(void)
+{
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_memory_values.memory, memory_text);
+    
+    mem_account_get_snapshot(&g_mem_snapshot);
+    
+    char free_text[8], min_text[8], block_text[8];
+    format_bytes_short(free_text, sizeof(free_text), g_mem_snapshot.internal.free_bytes);
+    format_bytes_short(min_text, sizeof(min_text), g_mem_snapshot.internal.min_free_bytes);
+    ui_bound_label_set_fmt(&g_memory_values.internal, "Int %s min %s", free_text, min_text);
+    format_bytes_short(block_text, sizeof(block_text), g_mem_snapshot.internal.largest_free_block);
+    ui_bound_label_set_fmt(&g_memory_values.largest, "Blk %s frag %u%%", block_text,
+                           g_mem_snapshot.internal.fragmentation_pct);
+    format_bytes_short(free_text, sizeof(free_text), g_mem_snapshot.dma.free_bytes);
+    format_bytes_short(block_text, sizeof(block_text), g_mem_snapshot.dma.largest_free_block);
+    ui_bound_label_set_fmt(&g_memory_values.dma, "DMA %s blk %s", free_text, block_text);
+    
+    // LVGL objects live in LVGL's own pool; read it here, in the LVGL task
+    lv_mem_monitor_t lvgl_mem;
+    lv_mem_monitor(&lvgl_mem);
+    
+    char names[MEMORY_PAGE_ROWS * MEMORY_PAGE_CELL_CHARS + 1];
+    char heap[MEMORY_PAGE_ROWS * MEMORY_PAGE_CELL_CHARS + 1];
+    char peak[MEMORY_PAGE_ROWS * MEMORY_PAGE_CELL_CHARS + 1];
+    char fixed[MEMORY_PAGE_ROWS * MEMORY_PAGE_CELL_CHARS + 1];
+    size_t names_len = 0, heap_len = 0, peak_len = 0, fixed_len = 0;
+    char cell[8];
+    uint32_t failures = 0;
+    names[0] = heap[0] = peak[0] = fixed[0] = '\0';
+    
+    for (int i = 0; i < MEM_MODULE_COUNT; i++) {
+        const mem_account_module_t *module = &g_mem_snapshot.modules[i];
+        failures += module->failures;
+        
+        snprintf(cell, sizeof(cell), "%.*s", MEMORY_PAGE_CELL_CHARS - 1, module->name);
+        names_len = append_cell(names, sizeof(names), names_len, cell, false);
+        if (g_mem_snapshot.tagged) {
+            format_bytes_short(cell, sizeof(cell), module->heap_bytes);
+            heap_len = append_cell(heap, sizeof(heap), heap_len, cell, false);
+            format_bytes_short(cell, sizeof(cell), module->heap_peak);
+            peak_len = append_cell(peak, sizeof(peak), peak_len, cell, false);
+            format_bytes_short(cell, sizeof(cell), module->static_bytes);
+            fixed_len = append_cell(fixed, sizeof(fixed), fixed_len, cell, false);
+        } else {
+            heap_len = append_cell(heap, sizeof(heap), heap_len, "--", false);
+            peak_len = append_cell(peak, sizeof(peak), peak_len, "--", false);
+            fixed_len = append_cell(fixed, sizeof(fixed), fixed_len, "--", false);
+        }
+    }
+    
+    // Last row: LVGL pool in use, its high-water mark and its fixed size
+    names_len = append_cell(names, sizeof(names), names_len, "lvgl", true);
+    format_bytes_short(cell, sizeof(cell), lvgl_mem.total_size - lvgl_mem.free_size);
+    heap_len = append_cell(heap, sizeof(heap), heap_len, cell, true);
+    format_bytes_short(cell, sizeof(cell), lvgl_mem.max_used);
+    peak_len = append_cell(peak, sizeof(peak), peak_len, cell, true);
+    format_bytes_short(cell, sizeof(cell), lvgl_mem.total_size);
+    fixed_len = append_cell(fixed, sizeof(fixed), fixed_len, cell, true);
+    
+    ui_bound_label_set_text(&g_memory_values.names, names);
+    ui_bound_label_set_text(&g_memory_values.heap, heap);
+    ui_bound_label_set_text(&g_memory_values.peak, peak);
+    ui_bound_label_set_text(&g_memory_values.fixed, fixed);
+    if (g_mem_snapshot.tagged) {
+        ui_bound_label_set_fmt(&g_memory_values.failures, "%" PRIu32 " fail", failures);
+    } else {
+        ui_bound_label_set_text(&g_memory_values.failures, "Tags off");
+    }
     
     return ESP_OK;
 }
 
+// Called by the screen cache right before the memory tree is deleted
+static void release_memory_page_ui(void)
+{
+    memset(&g_memory_values, 0, sizeof(g_memory_values));
+}
+
+// Stacks subpage: configured stack and never-used bytes of every placed task
+static esp_err_t create_stacks_page_ui(lv_obj_t *scr)
+{
+    create_diag_title(scr, "Stacks [3/3]");
+    
+    // Headroom that could be given back with MEM_ACCOUNT_STACK_MARGIN left per task
+    lv_obj_t *reclaim = create_diag_label(scr, 5, 25, "Reclaim --");
+    
+    // Columns: task, configured stack, minimum free
+    lv_obj_t *header;
+    lv_obj_t *names = create_table_column(scr, 2, 45, 66, TASK_PLACEMENT_COUNT, LV_TEXT_ALIGN_LEFT, "Task", &header);
+    lv_obj_t *size = create_table_column(scr, 68, 45, 32, TASK_PLACEMENT_COUNT, LV_TEXT_ALIGN_RIGHT, "Size", &header);
+    lv_obj_t *free_col = create_table_column(scr, 101, 45, 32, TASK_PLACEMENT_COUNT, LV_TEXT_ALIGN_RIGHT, "Free", &header);
+    
+    // Oversized stacks at bottom-left, memory at bottom-right (same as other pages)
+    lv_obj_t *oversized = create_diag_label(scr, 5, 225, "");
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    lv_obj_t *memory_label = create_diag_label(scr, 80, 225, memory_text);
+    
+    ui_bound_label_bind(&g_stacks_values.reclaim, reclaim);
+    ui_bound_label_bind(&g_stacks_values.names, names);
+    ui_bound_label_bind(&g_stacks_values.size, size);
+    ui_bound_label_bind(&g_stacks_values.free, free_col);
+    ui_bound_label_bind(&g_stacks_values.oversized, oversized);
+    ui_bound_label_bind(&g_stacks_values.memory, memory_label);
+    
+    update_stacks_page_ui();
+    
+    ESP_LOGI(TAG, "Stacks page UI created successfully");
+    return ESP_OK;
+}
+
+static esp_err_t update_stacks_page_ui(void)
+{
+    char memory_text[16];
+    format_free_memory_string(memory_text, sizeof(memory_text));
+    ui_bound_label_set_text(&g_stacks_values.memory, memory_text);
+    
+    mem_account_get_snapshot(&g_mem_snapshot);
+    
+    char cell[16];
+    format_bytes_short(cell, sizeof(cell), g_mem_snapshot.stack_reclaimable);
+    ui_bound_label_set_fmt(&g_stacks_values.reclaim, "Reclaim %s", cell);
+    
+    char names[TASK_PLACEMENT_COUNT * STACKS_PAGE_NAME_CHARS + 1];
+    char size[TASK_PLACEMENT_COUNT * 7 + 1];
+    char free_col[TASK_PLACEMENT_COUNT * 7 + 1];
+    size_t names_len = 0, size_len = 0, free_len = 0;
+    int oversized = 0;
+    names[0] = size[0] = free_col[0] = '\0';
+    
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; i++) {
+        const mem_account_stack_t *stack = &g_mem_snapshot.stacks[i];
+        bool last = (i + 1 == TASK_PLACEMENT_COUNT);
+        
+        snprintf(cell, sizeof(cell), "%.*s", STACKS_PAGE_NAME_CHARS - 1, stack->name);
+        names_len = append_cell(names, sizeof(names), names_len, cell, last);
+        snprintf(cell, sizeof(cell), "%" PRIu32, stack->stack_size);
+        size_len = append_cell(size, sizeof(size), size_len, cell, last);
+        if (stack->stack_free_min == MEM_ACCOUNT_STACK_UNKNOWN) {
+            free_len = append_cell(free_col, sizeof(free_col), free_len, "-", last);
+            continue;
+        }
+        snprintf(cell, sizeof(cell), "%" PRIu32, stack->stack_free_min);
+        free_len = append_cell(free_col, sizeof(free_col), free_len, cell, last);
+        if (stack->stack_free_min * 100u > stack->stack_size * MEM_ACCOUNT_STACK_OVERSIZED_PCT) {
+            oversized++;
+        }
+    }
+    
+    ui_bound_label_set_text(&g_stacks_values.names, names);
+    ui_bound_label_set_text(&g_stacks_values.size, size);
+    ui_bound_label_set_text(&g_stacks_values.free, free_col);
+    ui_bound_label_set_fmt(&g_stacks_values.oversized, "%d over %d%%", oversized, MEM_ACCOUNT_STACK_OVERSIZED_PCT);
+    
+    return ESP_OK;
+}
+
+// Called by the screen cache right before the stacks tree is deleted
+static void release_stacks_page_ui(void)
+{
+    memset(&g_stacks_values, 0, sizeof(g_stacks_values));
+}
+
 // Page-specific key event handler
 static bool monitor_page_handle_key_event(uint32_t key)
 {
@@ -483,6 +973,23 @@ static bool monitor_page_handle_key_event(uint32_t key)
             // Example: Adjust display brightness
             return true;  // We handled this key
             
+        case LV_KEY_RIGHT:
+            // Subpage switching: Main -> Tasks -> Memory -> Stacks, then on to the next page
+            if (g_monitor_subpage + 1 < MONITOR_SUBPAGE_COUNT) {
+                monitor_subpage_id_t next = (monitor_subpage_id_t)(g_monitor_subpage + 1);
+                ESP_LOGI(TAG, "🔄 Monitor RIGHT - Switch to %s subpage", monitor_subpage_screens[next]->name);
+                ui_screen_cache_leave(monitor_subpage_screens[g_monitor_subpage]);
+                esp_err_t ret = monitor_subpage_show(next);
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "❌ Failed to switch to %s subpage: %s", monitor_subpage_screens[next]->name,
+                             esp_err_to_name(ret));
+                    monitor_subpage_show(MONITOR_SUBPAGE_MAIN);
+                }
+                return true;  // We handled this key
+            }
+            ESP_LOGI(TAG, "📊 Monitor subpages end, should switch to next main page");
+            return false;
+            
         default:
             ESP_LOGD(TAG, "🔹 Monitor page - unhandled key: %lu", key);
             return false;  // Let global handler process this key
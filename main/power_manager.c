@@ -0,0 +1,258 @@
+/*
+ * Power Manager for M5StickC Plus 1.1
+ * Screen-driven power modes: DFS, automatic light sleep, sampling rates and ESP-NOW wake windows
+ */
+
+#include "power_manager.h"
+#include "lvgl_init.h"
+#include "system_monitor.h"
+#include "espnow_manager.h"
+#include "button.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
+#include <string.h>
+
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "POWER_MANAGER";
+
+#define POWER_ACTIVE_MONITOR_INTERVAL_MS    1000    // System monitor rate with the screen on
+#define POWER_DARK_MONITOR_INTERVAL_MS      CONFIG_POWER_DARK_MONITOR_INTERVAL_MS
+#define POWER_SAMPLE_GAP_MAX_MS             (2 * POWER_DARK_MONITOR_INTERVAL_MS)   // Longer gaps count this long
+
+#if CONFIG_POWER_MGMT_LIGHT_SLEEP
+#define POWER_LIGHT_SLEEP   true
+#else
+#define POWER_LIGHT_SLEEP   false
+#endif
+
+// Battery drain accumulated in one mode
+typedef struct {
+    uint32_t time_ms;           // Closed spans in the mode (the open span is added on read)
+    uint32_t samples;
+    uint64_t charge_ua_ms;      // Sum of discharge current x time covered by each reading
+    uint64_t weight_ms;         // Time covered by the readings
+} power_account_t;
+
+// Mode and accounting, shared by the mode switchers and the system monitor
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_account_t s_account[POWER_MODE_COUNT];
+static power_mode_t s_mode = POWER_MODE_ACTIVE;
+static int64_t s_mode_since_us = 0;
+static int64_t s_last_sample_us = 0;    // 0 until the first reading of the current mode
+static uint32_t s_transitions = 0;
+
+// Serializes applying a mode (backlight timer task vs. LVGL task)
+static SemaphoreHandle_t s_mode_mutex = NULL;
+static bool s_dfs_enabled = false;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_active_lock = NULL;  // Holds the maximum CPU clock while the screen is on
+#endif
+
+static const char *const s_mode_names[POWER_MODE_COUNT] = {
+    [POWER_MODE_ACTIVE] = "ACTIVE",
+    [POWER_MODE_DARK]   = "DARK",
+};
+
+const char *power_manager_mode_name(power_mode_t mode)
+{
+    return (mode < POWER_MODE_COUNT) ? s_mode_names[mode] : "UNKNOWN";
+}
+
+// Apply everything that differs between the modes; failures are logged, never fatal
+static void power_apply_mode(power_mode_t mode)
+{
+    if (mode == POWER_MODE_DARK) {
+        lvgl_set_display_paused(true);
+        system_monitor_set_interval(POWER_DARK_MONITOR_INTERVAL_MS);
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+        espnow_manager_set_wake_window(CONFIG_ESPNOW_WAKE_WINDOW);
+#endif
+#if CONFIG_POWER_MGMT_LIGHT_SLEEP
+        if (button_set_wakeup_mode(true) != ESP_OK) {
+            ESP_LOGW(TAG, "⚠️ Buttons cannot wake from light sleep");
+        }
+#endif
+#if CONFIG_PM_ENABLE
+        if (s_active_lock) {
+            esp_pm_lock_release(s_active_lock);
+        }
+#endif
+    } else {
+#if CONFIG_PM_ENABLE
+        if (s_active_lock) {
+            esp_pm_lock_acquire(s_active_lock);
+        }
+#endif
+#if CONFIG_POWER_MGMT_LIGHT_SLEEP
+        button_set_wakeup_mode(false);
+#endif
+#if CONFIG_ESPNOW_ENABLE_POWER_SAVE
+        espnow_manager_set_wake_window(CONFIG_ESPNOW_WAKE_INTERVAL);   // Radio always awake
+#endif
+        system_monitor_set_interval(POWER_ACTIVE_MONITOR_INTERVAL_MS);
+        lvgl_set_display_paused(false);
+    }
+}
+
+esp_err_t power_manager_init(void)
+{
+    if (s_mode_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    s_mode_mutex = xSemaphoreCreateMutex();
+    if (s_mode_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_POWER_MGMT_MIN_CPU_FREQ_MHZ,
+        .light_sleep_enable = POWER_LIGHT_SLEEP,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure DFS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "screen_on", &s_active_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create CPU frequency lock: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    s_dfs_enabled = true;
+    ESP_LOGI(TAG, "⚡ DFS %d-%d MHz, light sleep %s", CONFIG_POWER_MGMT_MIN_CPU_FREQ_MHZ,
+             CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, POWER_LIGHT_SLEEP ? "enabled" : "disabled");
+#else
+    ESP_LOGI(TAG, "Power management disabled (CONFIG_PM_ENABLE), only rates and rendering follow the screen");
+#endif
+
+    portENTER_CRITICAL(&s_lock);
+    memset(s_account, 0, sizeof(s_account));
+    s_mode = POWER_MODE_ACTIVE;
+    s_mode_since_us = esp_timer_get_time();
+    s_last_sample_us = 0;
+    s_transitions = 0;
+    portEXIT_CRITICAL(&s_lock);
+
+    power_apply_mode(POWER_MODE_ACTIVE);
+    return ESP_OK;
+}
+
+esp_err_t power_manager_set_mode(power_mode_t mode)
+{
+    if (mode >= POWER_MODE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mode_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_mode_mutex, portMAX_DELAY);
+
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    power_mode_t previous = s_mode;
+    if (previous != mode) {
+        s_account[previous].time_ms += (uint32_t)((now_us - s_mode_since_us) / 1000);
+        s_mode = mode;
+        s_mode_since_us = now_us;
+        s_last_sample_us = 0;   // The next reading starts the new mode's first span
+        s_transitions++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (previous != mode) {
+        power_apply_mode(mode);
+        ESP_LOGI(TAG, "%s Power mode %s -> %s", (mode == POWER_MODE_DARK) ? "💤" : "💡",
+                 s_mode_names[previous], s_mode_names[mode]);
+    }
+
+    xSemaphoreGive(s_mode_mutex);
+    return ESP_OK;
+}
+
+power_mode_t power_manager_get_mode(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    power_mode_t mode = s_mode;
+    portEXIT_CRITICAL(&s_lock);
+    return mode;
+}
+
+void power_manager_record_discharge(float discharge_ma, bool on_battery)
+{
+    int64_t now_us = esp_timer_get_time();
+    uint64_t discharge_ua = (on_battery && discharge_ma > 0.0f) ? (uint64_t)(discharge_ma * 1000.0f) : 0;
+
+    portENTER_CRITICAL(&s_lock);
+    int64_t last_us = s_last_sample_us;
+    s_last_sample_us = now_us;
+    if (on_battery && last_us != 0) {
+        // Each reading stands for the time since the previous one
+        uint64_t span_ms = (uint64_t)(now_us - last_us) / 1000;
+        if (span_ms > POWER_SAMPLE_GAP_MAX_MS) {
+            span_ms = POWER_SAMPLE_GAP_MAX_MS;
+        }
+        power_account_t *account = &s_account[s_mode];
+        account->samples++;
+        account->charge_ua_ms += discharge_ua * span_ms;
+        account->weight_ms += span_ms;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t power_manager_get_stats(power_manager_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    power_account_t account[POWER_MODE_COUNT];
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(account, s_account, sizeof(account));
+    stats->mode = s_mode;
+    stats->transitions = s_transitions;
+    account[s_mode].time_ms += (uint32_t)((now_us - s_mode_since_us) / 1000);
+    portEXIT_CRITICAL(&s_lock);
+
+    stats->dfs_enabled = s_dfs_enabled;
+    stats->light_sleep_enabled = s_dfs_enabled && POWER_LIGHT_SLEEP;
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        power_mode_stats_t *out = &stats->modes[mode];
+        out->time_ms = account[mode].time_ms;
+        out->samples = account[mode].samples;
+        out->avg_discharge_ma = (account[mode].weight_ms > 0) ?
+                                (float)((double)account[mode].charge_ua_ms / account[mode].weight_ms / 1000.0) : 0.0f;
+    }
+    return ESP_OK;
+}
+
+void power_manager_log(void)
+{
+    power_manager_stats_t stats;
+    power_manager_get_stats(&stats);
+
+    ESP_LOGI(TAG, "=== Power (mode %s, %" PRIu32 " transitions, DFS %s, light sleep %s) ===",
+             s_mode_names[stats.mode], stats.transitions, stats.dfs_enabled ? "on" : "off",
+             stats.light_sleep_enabled ? "on" : "off");
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        const power_mode_stats_t *m = &stats.modes[mode];
+        if (m->samples > 0) {
+            ESP_LOGI(TAG, "   %-6s %6" PRIu32 " s  avg discharge %.1f mA (%" PRIu32 " readings)",
+                     s_mode_names[mode], m->time_ms / 1000, m->avg_discharge_ma, m->samples);
+        } else {
+            ESP_LOGI(TAG, "   %-6s %6" PRIu32 " s  no battery readings", s_mode_names[mode], m->time_ms / 1000);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Power Manager for M5StickC Plus 1.1
+ * Screen-driven power modes: DFS, automatic light sleep, sampling rates and ESP-NOW wake windows
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Power modes, switched by the backlight timeout and button wake
+ */
+typedef enum {
+    POWER_MODE_ACTIVE = 0,      // Screen on: full CPU clock, LVGL rendering, 1 s system monitor
+    POWER_MODE_DARK,            // Screen off: DFS and light sleep allowed, rendering paused, slow monitor
+    POWER_MODE_COUNT
+} power_mode_t;
+
+/**
+ * @brief Measured battery drain of one mode
+ */
+typedef struct {
+    uint32_t time_ms;           // Time spent in the mode
+    uint32_t samples;           // AXP192 discharge readings taken on battery
+    float avg_discharge_ma;     // Time-weighted average discharge current (0 without samples)
+} power_mode_stats_t;
+
+/**
+ * @brief Power manager statistics
+ */
+typedef struct {
+    power_mode_t mode;          // Current mode
+    uint32_t transitions;       // Mode changes since init
+    bool dfs_enabled;           // esp_pm configured (CONFIG_PM_ENABLE)
+    bool light_sleep_enabled;   // Automatic light sleep allowed in POWER_MODE_DARK
+    power_mode_stats_t modes[POWER_MODE_COUNT];
+} power_manager_stats_t;
+
+/**
+ * @brief Configure DFS/light sleep and enter POWER_MODE_ACTIVE
+ *
+ * Call after the system monitor has started and before the page manager.
+ *
+ * @return ESP_OK on success, esp_pm error codes on failure
+ */
+esp_err_t power_manager_init(void);
+
+/**
+ * @brief Switch the power mode (task context, any task)
+ *
+ * POWER_MODE_DARK pauses LVGL rendering, lowers the system monitor rate,
+ * shortens the ESP-NOW wake window, lets the buttons wake the chip and
+ * releases the CPU frequency lock. POWER_MODE_ACTIVE restores all of it.
+ *
+ * @param mode New mode
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown mode,
+ *         ESP_ERR_INVALID_STATE before power_manager_init()
+ */
+esp_err_t power_manager_set_mode(power_mode_t mode);
+
+/**
+ * @brief Get the current power mode
+ */
+power_mode_t power_manager_get_mode(void);
+
+/**
+ * @brief Account one AXP192 discharge reading to the current mode (system monitor)
+ * @param discharge_ma Battery discharge current
+ * @param on_battery False while USB powers the device; the reading is then ignored
+ */
+void power_manager_record_discharge(float discharge_ma, bool on_battery);
+
+/**
+ * @brief Get the power manager statistics
+ * @param stats Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t power_manager_get_stats(power_manager_stats_t *stats);
+
+/**
+ * @brief Log time and average current per mode
+ */
+void power_manager_log(void);
+
+/**
+ * @brief Get the name of a power mode
+ */
+const char *power_manager_mode_name(power_mode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MANAGER_H
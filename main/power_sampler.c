@@ -0,0 +1,329 @@
+/*
+ * Power Telemetry Sampler for M5StickC Plus 1.1
+ * High-rate AXP192 battery/VBUS sampling with multi-resolution history
+ */
+
+#include "power_sampler.h"
+#include "axp192.h"
+#include "task_placement.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "POWER_SAMPLER";
+
+// Configuration
+#define POWER_SAMPLER_RATE_HZ           CONFIG_POWER_SAMPLER_RATE_HZ
+#define POWER_SAMPLER_RAW_DEPTH         CONFIG_POWER_SAMPLER_RAW_DEPTH
+#define POWER_SAMPLER_1S_DEPTH          120     // 2 minutes of 1 s entries
+#define POWER_SAMPLER_1MIN_DEPTH        60      // 1 hour of 1 min entries
+#define POWER_RING_COPY_CHUNK           32      // Entries copied per mutex hold
+
+// ===== RING BUFFERS =====
+
+// Fixed-size history ring; `written` counts every push so readers can detect overwrites
+typedef struct {
+    uint8_t *buf;
+    size_t elem_size;
+    uint32_t capacity;
+    uint32_t written;
+} power_ring_t;
+
+static power_sample_t s_raw_buf[POWER_SAMPLER_RAW_DEPTH];
+static power_aggregate_t s_1s_buf[POWER_SAMPLER_1S_DEPTH];
+static power_aggregate_t s_1min_buf[POWER_SAMPLER_1MIN_DEPTH];
+
+static power_ring_t s_rings[POWER_RES_COUNT] = {
+    [POWER_RES_RAW]  = { (uint8_t *)s_raw_buf,  sizeof(power_sample_t),    POWER_SAMPLER_RAW_DEPTH,  0 },
+    [POWER_RES_1S]   = { (uint8_t *)s_1s_buf,   sizeof(power_aggregate_t), POWER_SAMPLER_1S_DEPTH,   0 },
+    [POWER_RES_1MIN] = { (uint8_t *)s_1min_buf, sizeof(power_aggregate_t), POWER_SAMPLER_1MIN_DEPTH, 0 },
+};
+
+// Accumulator for one downsampling interval (sampling task only)
+typedef struct {
+    power_aggregate_t agg;
+    int32_t battery_ma_sum;
+    uint32_t battery_mv_sum;
+    uint32_t vbus_mv_sum;
+} power_accumulator_t;
+
+static SemaphoreHandle_t s_mutex = NULL;
+static TaskHandle_t s_task_handle = NULL;
+static volatile bool s_running = false;
+static power_sampler_stats_t s_stats = {0};
+
+static void ring_push(power_ring_t *ring, const void *elem)
+{
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return;
+    }
+    memcpy(ring->buf + (ring->written % ring->capacity) * ring->elem_size, elem, ring->elem_size);
+    ring->written++;
+    xSemaphoreGive(s_mutex);
+}
+
+/**
+ * @brief Copy the newest entries of a ring, oldest first, in short chunks
+ *
+ * The copied range is fixed when the copy starts. If the writer laps the
+ * reader between chunks, the overwritten entries are skipped.
+ */
+static size_t ring_copy_newest(power_ring_t *ring, void *out, size_t max_entries)
+{
+    if (out == NULL || max_entries == 0 || s_mutex == NULL) {
+        return 0;
+    }
+
+    if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return 0;
+    }
+    uint32_t end = ring->written;
+    uint32_t available = (end < ring->capacity) ? end : ring->capacity;
+    xSemaphoreGive(s_mutex);
+
+    uint32_t count = (available < max_entries) ? available : (uint32_t)max_entries;
+    uint32_t seq = end - count;
+    size_t copied = 0;
+
+    while (seq < end) {
+        if (xSemaphoreTake(s_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+            break;
+        }
+
+        // Skip entries overwritten since the previous chunk
+        uint32_t oldest = (ring->written > ring->capacity) ? ring->written - ring->capacity : 0;
+        if (seq < oldest) {
+            seq = oldest;
+        }
+
+        uint32_t chunk_end = seq + POWER_RING_COPY_CHUNK;
+        if (chunk_end > end) {
+            chunk_end = end;
+        }
+        for (; seq < chunk_end; seq++) {
+            memcpy((uint8_t *)out + copied * ring->elem_size,
+                   ring->buf + (seq % ring->capacity) * ring->elem_size,
+                   ring->elem_size);
+            copied++;
+        }
+        xSemaphoreGive(s_mutex);
+    }
+
+    return copied;
+}
+
+// ===== DOWNSAMPLING =====
+
+static void accumulator_reset(power_accumulator_t *acc, uint32_t interval_start_ms)
+{
+    memset(acc, 0, sizeof(*acc));
+    acc->agg.timestamp_ms = interval_start_ms;
+}
+
+// Merge `samples` readings summarized by min/max/avg into the accumulator
+static void accumulator_add(power_accumulator_t *acc, uint16_t samples,
+                            int16_t ma_min, int16_t ma_max, int16_t ma_avg,
+                            uint16_t batt_mv_avg,
+                            uint16_t vbus_min, uint16_t vbus_max, uint16_t vbus_avg)
+{
+    power_aggregate_t *agg = &acc->agg;
+    if (agg->samples == 0) {
+        agg->battery_ma_min = ma_min;
+        agg->battery_ma_max = ma_max;
+        agg->vbus_mv_min = vbus_min;
+        agg->vbus_mv_max = vbus_max;
+    } else {
+        if (ma_min < agg->battery_ma_min) agg->battery_ma_min = ma_min;
+        if (ma_max > agg->battery_ma_max) agg->battery_ma_max = ma_max;
+        if (vbus_min < agg->vbus_mv_min) agg->vbus_mv_min = vbus_min;
+        if (vbus_max > agg->vbus_mv_max) agg->vbus_mv_max = vbus_max;
+    }
+    agg->samples += samples;
+    acc->battery_ma_sum += (int32_t)ma_avg * samples;
+    acc->battery_mv_sum += (uint32_t)batt_mv_avg * samples;
+    acc->vbus_mv_sum += (uint32_t)vbus_avg * samples;
+}
+
+// Finish the interval averages and push the entry to its ring
+static void accumulator_flush(power_accumulator_t *acc, power_ring_t *ring)
+{
+    power_aggregate_t *agg = &acc->agg;
+    if (agg->samples == 0) {
+        return;
+    }
+    agg->battery_ma_avg = (int16_t)(acc->battery_ma_sum / (int32_t)agg->samples);
+    agg->battery_mv_avg = (uint16_t)(acc->battery_mv_sum / agg->samples);
+    agg->vbus_mv_avg = (uint16_t)(acc->vbus_mv_sum / agg->samples);
+    ring_push(ring, agg);
+}
+
+static int16_t clamp_i16(float value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+// ===== SAMPLING TASK =====
+
+static void power_sampler_task(void *pvParameters)
+{
+    TickType_t period = pdMS_TO_TICKS(1000 / POWER_SAMPLER_RATE_HZ);
+    if (period == 0) {
+        period = 1;  // Tick rate limits the effective sample rate
+    }
+
+    ESP_LOGI(TAG, "Power sampler task started (%d Hz requested, period %lu ticks)",
+             POWER_SAMPLER_RATE_HZ, (unsigned long)period);
+
+    power_accumulator_t acc_1s;
+    power_accumulator_t acc_1min;
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    accumulator_reset(&acc_1s, now_ms - now_ms % 1000);
+    accumulator_reset(&acc_1min, now_ms - now_ms % 60000);
+
+    TickType_t last_wake_time = xTaskGetTickCount();
+    axp192_snapshot_t snapshot = {0};
+
+    while (s_running) {
+        esp_err_t ret = axp192_read_adc_snapshot(&snapshot);
+        now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+        if (ret != ESP_OK) {
+            s_stats.read_errors++;
+        } else {
+            power_sample_t sample = {
+                .timestamp_ms = now_ms,
+                .battery_ma = clamp_i16(snapshot.charge_current - snapshot.discharge_current),
+                .battery_mv = (uint16_t)(snapshot.battery_voltage * 1000.0f),
+                .vbus_mv = (uint16_t)(snapshot.vbus_voltage * 1000.0f),
+            };
+            ring_push(&s_rings[POWER_RES_RAW], &sample);
+            s_stats.samples++;
+            s_stats.last_read_us = snapshot.read_time_us;
+
+            // Close the 1 s interval (and the 1 min interval it feeds) on boundaries
+            if (now_ms - acc_1s.agg.timestamp_ms >= 1000) {
+                accumulator_flush(&acc_1s, &s_rings[POWER_RES_1S]);
+                const power_aggregate_t *sec = &acc_1s.agg;
+                if (sec->samples > 0) {
+                    // The closed second decides which minute it belongs to
+                    if (sec->timestamp_ms - acc_1min.agg.timestamp_ms >= 60000) {
+                        accumulator_flush(&acc_1min, &s_rings[POWER_RES_1MIN]);
+                        accumulator_reset(&acc_1min, sec->timestamp_ms - sec->timestamp_ms % 60000);
+                    }
+                    accumulator_add(&acc_1min, sec->samples,
+                                    sec->battery_ma_min, sec->battery_ma_max, sec->battery_ma_avg,
+                                    sec->battery_mv_avg,
+                                    sec->vbus_mv_min, sec->vbus_mv_max, sec->vbus_mv_avg);
+                }
+                accumulator_reset(&acc_1s, now_ms - now_ms % 1000);
+            }
+            accumulator_add(&acc_1s, 1, sample.battery_ma, sample.battery_ma, sample.battery_ma,
+                            sample.battery_mv, sample.vbus_mv, sample.vbus_mv, sample.vbus_mv);
+        }
+
+        if (xTaskDelayUntil(&last_wake_time, period) == pdFALSE) {
+            s_stats.overruns++;
+        }
+    }
+
+    ESP_LOGI(TAG, "Power sampler task stopped");
+    s_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+// ===== PUBLIC API =====
+
+esp_err_t power_sampler_init(void)
+{
+    ESP_LOGI(TAG, "Initializing power sampler");
+
+    if (s_mutex == NULL) {
+        s_mutex = xSemaphoreCreateMutex();
+        if (s_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create power sampler mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    for (int i = 0; i < POWER_RES_COUNT; i++) {
+        s_rings[i].written = 0;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.rate_hz = POWER_SAMPLER_RATE_HZ;
+
+    // Let the AXP192 ADC produce fresh values at least as fast as we read them
+    esp_err_t ret = axp192_set_adc_sample_rate(POWER_SAMPLER_RATE_HZ);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set AXP192 ADC sample rate: %s", esp_err_to_name(ret));
+    }
+
+    ESP_LOGI(TAG, "Power sampler initialized: %d Hz, history raw=%d, 1s=%d, 1min=%d (%u bytes)",
+             POWER_SAMPLER_RATE_HZ, POWER_SAMPLER_RAW_DEPTH, POWER_SAMPLER_1S_DEPTH, POWER_SAMPLER_1MIN_DEPTH,
+             (unsigned)(sizeof(s_raw_buf) + sizeof(s_1s_buf) + sizeof(s_1min_buf)));
+    return ESP_OK;
+}
+
+esp_err_t power_sampler_start(void)
+{
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_running) {
+        ESP_LOGW(TAG, "Power sampler already running");
+        return ESP_OK;
+    }
+
+    s_running = true;
+    // Priority above system_monitor so bursts are not missed
+    esp_err_t ret = task_placement_create(TASK_PLACEMENT_POWER_SAMPLER, power_sampler_task, NULL, &s_task_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create power sampler task");
+        s_running = false;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t power_sampler_stop(void)
+{
+    if (!s_running) {
+        return ESP_OK;
+    }
+
+    s_running = false;
+    while (s_task_handle != NULL) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return ESP_OK;
+}
+
+size_t power_sampler_read_raw(power_sample_t *out, size_t max_samples)
+{
+    return ring_copy_newest(&s_rings[POWER_RES_RAW], out, max_samples);
+}
+
+size_t power_sampler_read_aggregates(power_resolution_t resolution, power_aggregate_t *out, size_t max_entries)
+{
+    if (resolution != POWER_RES_1S && resolution != POWER_RES_1MIN) {
+        return 0;
+    }
+    return ring_copy_newest(&s_rings[resolution], out, max_entries);
+}
+
+esp_err_t power_sampler_get_stats(power_sampler_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = s_stats;
+    return ESP_OK;
+}
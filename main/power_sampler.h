@@ -0,0 +1,114 @@
+/*
+ * Power Telemetry Sampler for M5StickC Plus 1.1
+ * High-rate AXP192 battery/VBUS sampling with multi-resolution history
+ */
+
+#ifndef POWER_SAMPLER_H
+#define POWER_SAMPLER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief History resolutions kept by the sampler
+ */
+typedef enum {
+    POWER_RES_RAW = 0,      // Every sample (CONFIG_POWER_SAMPLER_RATE_HZ)
+    POWER_RES_1S,           // 1 second min/max/avg
+    POWER_RES_1MIN,         // 1 minute min/max/avg
+    POWER_RES_COUNT
+} power_resolution_t;
+
+/**
+ * @brief One raw power sample
+ */
+typedef struct {
+    uint32_t timestamp_ms;      // Sample time since boot
+    int16_t battery_ma;         // Net battery current, charge positive, discharge negative
+    uint16_t battery_mv;        // Battery voltage
+    uint16_t vbus_mv;           // USB voltage
+} power_sample_t;
+
+/**
+ * @brief Min/max/average over one downsampling interval
+ */
+typedef struct {
+    uint32_t timestamp_ms;      // Start of the interval
+    uint16_t samples;           // Raw samples merged into this entry
+    int16_t battery_ma_min;
+    int16_t battery_ma_max;
+    int16_t battery_ma_avg;
+    uint16_t battery_mv_avg;
+    uint16_t vbus_mv_min;
+    uint16_t vbus_mv_max;
+    uint16_t vbus_mv_avg;
+} power_aggregate_t;
+
+/**
+ * @brief Sampler statistics
+ */
+typedef struct {
+    uint32_t samples;           // Samples taken since start
+    uint32_t read_errors;       // Failed AXP192 reads
+    uint32_t overruns;          // Sample periods missed because a read took too long
+    uint32_t last_read_us;      // I2C time of the last sample
+    uint16_t rate_hz;           // Configured sample rate
+} power_sampler_stats_t;
+
+/**
+ * @brief Initialize the sampler (history buffers, mutex, AXP192 ADC rate)
+ * @return ESP_OK on success
+ */
+esp_err_t power_sampler_init(void);
+
+/**
+ * @brief Start the sampling task
+ * @return ESP_OK on success
+ */
+esp_err_t power_sampler_start(void);
+
+/**
+ * @brief Stop the sampling task (history is kept)
+ * @return ESP_OK on success
+ */
+esp_err_t power_sampler_stop(void);
+
+/**
+ * @brief Copy the newest raw samples, oldest first
+ *
+ * The history is copied in short chunks so the sampling task is never blocked
+ * for the whole copy. Samples overwritten while copying are skipped.
+ *
+ * @param out Destination array
+ * @param max_samples Capacity of out
+ * @return Number of samples copied
+ */
+size_t power_sampler_read_raw(power_sample_t *out, size_t max_samples);
+
+/**
+ * @brief Copy the newest downsampled entries, oldest first
+ * @param resolution POWER_RES_1S or POWER_RES_1MIN
+ * @param out Destination array
+ * @param max_entries Capacity of out
+ * @return Number of entries copied (0 for an invalid resolution)
+ */
+size_t power_sampler_read_aggregates(power_resolution_t resolution, power_aggregate_t *out, size_t max_entries);
+
+/**
+ * @brief Get sampler statistics
+ * @param stats Pointer to statistics structure to fill
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t power_sampler_get_stats(power_sampler_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_SAMPLER_H
@@ -1,17 +1,56 @@
 #include "red_led.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_bit_defs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
 #include <string.h>
 
 static const char *TAG = "RED_LED";
 
+#define RED_LED_DUTY_MAX        ((1u << RED_LED_LEDC_RESOLUTION) - 1)
+#define RED_LED_IDLE_BIT        BIT0
+#define BREATHING_PAUSE_MS      200   // Off time between breathing cycles
+
 // LED state variables
 static bool led_initialized = false;
 static bool led_current_state = false;  // false = OFF, true = ON
 
+/**
+ * @brief One pattern step: reach duty (optionally by hardware fade), then hold
+ */
+typedef struct {
+    uint32_t duty;
+    uint32_t fade_ms;           // 0 = set immediately
+    uint32_t hold_ms;           // Time after the fade before the next step
+} red_led_step_t;
+
+// Step generator of the running pattern, returns false when the pattern is done
+typedef bool (*red_led_next_step_fn_t)(red_led_step_t *step);
+
+// Running pattern (guarded by s_led_mutex, advanced by s_step_timer)
+static struct {
+    red_led_next_step_fn_t next;    // NULL when idle
+    uint32_t on_ms;                 // Blink on time / breathing half cycle / Morse dot
+    uint32_t off_ms;                // Blink off time
+    uint32_t remaining;             // Blink or breathing cycles left
+    bool infinite;                  // Blink until stopped
+    uint8_t phase;
+    int char_index;                 // Morse: current character
+    int element_index;              // Morse: current dot/dash
+    char message[RED_LED_MORSE_MAX_LEN + 1];
+} s_pattern;
+
+static SemaphoreHandle_t s_led_mutex = NULL;
+static EventGroupHandle_t s_led_events = NULL;
+static esp_timer_handle_t s_step_timer = NULL;
+static int64_t s_step_deadline_us = 0;
+
 // Morse code lookup table
 static const char* morse_code[] = {
     ".-",    // A
@@ -52,38 +91,288 @@ static const char* morse_code[] = {
     "----."  // 9
 };
 
+static void red_led_step_timer_cb(void *arg);
+
+// ===== PWM OUTPUT =====
+
+/**
+ * @brief Move the channel to a duty, by hardware fade if fade_ms > 0 (mutex held)
+ */
+static esp_err_t red_led_apply_duty(uint32_t duty, uint32_t fade_ms)
+{
+    // Cancel a fade still in flight so the new target takes effect at once
+    ledc_fade_stop(RED_LED_LEDC_MODE, RED_LED_LEDC_CHANNEL);
+    
+    esp_err_t ret;
+    if (fade_ms > 0) {
+        ret = ledc_set_fade_time_and_start(RED_LED_LEDC_MODE, RED_LED_LEDC_CHANNEL, duty, fade_ms, LEDC_FADE_NO_WAIT);
+    } else {
+        ret = ledc_set_duty_and_update(RED_LED_LEDC_MODE, RED_LED_LEDC_CHANNEL, duty, 0);
+    }
+    
+    if (ret == ESP_OK) {
+        led_current_state = (duty > 0);
+    }
+    return ret;
+}
+
+static uint32_t red_led_brightness_to_duty(uint8_t brightness)
+{
+    return ((uint32_t)brightness * RED_LED_DUTY_MAX) / RED_LED_BRIGHTNESS_MAX;
+}
+
+// ===== PATTERN ENGINE =====
+
+/**
+ * @brief Apply steps until one needs time to elapse (mutex held)
+ */
+static void red_led_run_steps(void)
+{
+    red_led_step_t step;
+    
+    while (s_pattern.next != NULL) {
+        if (!s_pattern.next(&step)) {
+            // Pattern complete: LED off, wake waiters
+            s_pattern.next = NULL;
+            red_led_apply_duty(0, 0);
+            xEventGroupSetBits(s_led_events, RED_LED_IDLE_BIT);
+            return;
+        }
+    
+        red_led_apply_duty(step.duty, step.fade_ms);
+    
+        uint32_t wait_ms = step.fade_ms + step.hold_ms;
+        if (wait_ms > 0) {
+            s_step_deadline_us = esp_timer_get_time() + (int64_t)wait_ms * 1000;
+            esp_timer_start_once(s_step_timer, (uint64_t)wait_ms * 1000);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Stop the running pattern without touching the output (mutex held)
+ */
+static void red_led_cancel_pattern(void)
+{
+    if (s_pattern.next != NULL) {
+        esp_timer_stop(s_step_timer);
+        s_pattern.next = NULL;
+        xEventGroupSetBits(s_led_events, RED_LED_IDLE_BIT);
+    }
+}
+
+/**
+ * @brief Replace the running pattern and apply its first steps
+ * @param next Step generator; s_pattern parameters must be filled by the caller under the mutex
+ */
+static void red_led_start_pattern(red_led_next_step_fn_t next)
+{
+    s_pattern.phase = 0;
+    s_pattern.char_index = 0;
+    s_pattern.element_index = 0;
+    s_pattern.next = next;
+    xEventGroupClearBits(s_led_events, RED_LED_IDLE_BIT);
+    red_led_run_steps();
+}
+
+/**
+ * @brief Step timer: the current step's fade and hold are over (esp_timer task)
+ */
+static void red_led_step_timer_cb(void *arg)
+{
+    if (xSemaphoreTake(s_led_mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    
+    // An expiry of a cancelled pattern may already be dispatched; only the current deadline counts
+    if (s_pattern.next != NULL && esp_timer_get_time() + 1000 >= s_step_deadline_us) {
+        red_led_run_steps();
+    }
+    
+    xSemaphoreGive(s_led_mutex);
+}
+
+static bool red_led_blink_next(red_led_step_t *step)
+{
+    if (s_pattern.phase == 0) {
+        if (!s_pattern.infinite && s_pattern.remaining == 0) {
+            return false;
+        }
+        *step = (red_led_step_t){ .duty = RED_LED_DUTY_MAX, .fade_ms = 0, .hold_ms = s_pattern.on_ms };
+        s_pattern.phase = 1;
+    } else {
+        *step = (red_led_step_t){ .duty = 0, .fade_ms = 0, .hold_ms = s_pattern.off_ms };
+        s_pattern.phase = 0;
+        if (!s_pattern.infinite) {
+            s_pattern.remaining--;
+        }
+    }
+    return true;
+}
+
+static bool red_led_breathing_next(red_led_step_t *step)
+{
+    switch (s_pattern.phase) {
+        case 0:
+            if (s_pattern.remaining == 0) {
+                return false;
+            }
+            *step = (red_led_step_t){ .duty = RED_LED_DUTY_MAX, .fade_ms = s_pattern.on_ms, .hold_ms = 0 };
+            s_pattern.phase = 1;
+            return true;
+        case 1:
+            *step = (red_led_step_t){ .duty = 0, .fade_ms = s_pattern.on_ms, .hold_ms = 0 };
+            s_pattern.phase = 2;
+            return true;
+        default:
+            // Brief pause between cycles
+            *step = (red_led_step_t){ .duty = 0, .fade_ms = 0, .hold_ms = BREATHING_PAUSE_MS };
+            s_pattern.phase = 0;
+            s_pattern.remaining--;
+            return true;
+    }
+}
+
+static const char *red_led_morse_lookup(char c)
+{
+    if (c >= 'a' && c <= 'z') {
+        return morse_code[c - 'a'];
+    } else if (c >= 'A' && c <= 'Z') {
+        return morse_code[c - 'A'];
+    } else if (c >= '0' && c <= '9') {
+        return morse_code[26 + (c - '0')];
+    }
+    return NULL;
+}
+
+static bool red_led_morse_next(red_led_step_t *step)
+{
+    uint32_t dot = s_pattern.on_ms;
+    
+    for (;;) {
+        char c = s_pattern.message[s_pattern.char_index];
+        if (c == '\0') {
+            return false;
+        }
+    
+        if (c == ' ') {
+            // Word gap
+            *step = (red_led_step_t){ .duty = 0, .fade_ms = 0, .hold_ms = dot * 7 };
+            s_pattern.char_index++;
+            return true;
+        }
+    
+        const char *code = red_led_morse_lookup(c);
+        if (code == NULL) {
+            ESP_LOGW(TAG, "Unsupported character: '%c'", c);
+            s_pattern.char_index++;
+            continue;
+        }
+    
+        char element = code[s_pattern.element_index];
+        if (s_pattern.phase == 0) {
+            // Dot or dash
+            uint32_t on_ms = (element == '-') ? dot * 3 : dot;
+            *step = (red_led_step_t){ .duty = RED_LED_DUTY_MAX, .fade_ms = 0, .hold_ms = on_ms };
+            s_pattern.phase = 1;
+            return true;
+        }
+    
+        // LED off, then the inter-element, inter-letter or no gap
+        uint32_t gap_ms = 0;
+        char next_char = s_pattern.message[s_pattern.char_index + 1];
+        if (code[s_pattern.element_index + 1] != '\0') {
+            gap_ms = dot;
+            s_pattern.element_index++;
+        } else {
+            if (next_char != '\0' && next_char != ' ') {
+                gap_ms = dot * 3;
+            }
+            s_pattern.element_index = 0;
+            s_pattern.char_index++;
+        }
+        *step = (red_led_step_t){ .duty = 0, .fade_ms = 0, .hold_ms = gap_ms };
+        s_pattern.phase = 0;
+        return true;
+    }
+}
+
+// ===== PUBLIC API =====
+
 /**
  * @brief Initialize the red LED
  */
 esp_err_t red_led_init(void)
 {
-    ESP_LOGI(TAG, "Initializing red LED on GPIO%d", RED_LED_PIN);
+    if (led_initialized) {
+        return ESP_OK;
+    }
+    
+    ESP_LOGI(TAG, "Initializing red LED on GPIO%d (LEDC channel %d)", RED_LED_PIN, RED_LED_LEDC_CHANNEL);
     
-    // Configure GPIO pin
-    gpio_config_t gpio_conf = {
-        .pin_bit_mask = (1ULL << RED_LED_PIN),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
+    ledc_timer_config_t timer_config = {
+        .speed_mode = RED_LED_LEDC_MODE,
+        .timer_num = RED_LED_LEDC_TIMER,
+        .duty_resolution = RED_LED_LEDC_RESOLUTION,
+        .freq_hz = RED_LED_LEDC_FREQUENCY,
+        .clk_cfg = LEDC_AUTO_CLK
     };
+    esp_err_t ret = ledc_timer_config(&timer_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure LEDC timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
-    esp_err_t ret = gpio_config(&gpio_conf);
+    // Inverted output: duty 0 keeps the active-LOW LED off
+    ledc_channel_config_t channel_config = {
+        .speed_mode = RED_LED_LEDC_MODE,
+        .channel = RED_LED_LEDC_CHANNEL,
+        .timer_sel = RED_LED_LEDC_TIMER,
+        .intr_type = LEDC_INTR_DISABLE,
+        .gpio_num = RED_LED_PIN,
+        .duty = 0,
+        .hpoint = 0,
+        .flags.output_invert = 1,
+    };
+    ret = ledc_channel_config(&channel_config);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure GPIO%d: %s", RED_LED_PIN, esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to configure LEDC channel: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    // The fade service may already be installed by another LEDC user
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to install LEDC fade service: %s", esp_err_to_name(ret));
         return ret;
     }
     
-    // Set initial state (OFF) directly via GPIO
-    ret = gpio_set_level(RED_LED_PIN, RED_LED_OFF_LEVEL);
+    s_led_mutex = xSemaphoreCreateMutex();
+    s_led_events = xEventGroupCreate();
+    if (s_led_mutex == NULL || s_led_events == NULL) {
+        ESP_LOGE(TAG, "Failed to create LED pattern sync objects");
+        red_led_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    xEventGroupSetBits(s_led_events, RED_LED_IDLE_BIT);
+    
+    const esp_timer_create_args_t timer_args = {
+        .callback = red_led_step_timer_cb,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "red_led",
+    };
+    ret = esp_timer_create(&timer_args, &s_step_timer);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set initial LED state: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Failed to create LED step timer: %s", esp_err_to_name(ret));
+        red_led_deinit();
         return ret;
     }
     
+    memset(&s_pattern, 0, sizeof(s_pattern));
     led_initialized = true;
     led_current_state = false;  // LED is OFF
-    ESP_LOGI(TAG, "Red LED initialized successfully (active LOW)");
+    ESP_LOGI(TAG, "Red LED initialized successfully (PWM, active LOW)");
     
     return ESP_OK;
 }
@@ -93,16 +382,29 @@ esp_err_t red_led_init(void)
  */
 esp_err_t red_led_deinit(void)
 {
-    if (!led_initialized) {
-        return ESP_OK;
-    }
-    
     ESP_LOGI(TAG, "Deinitializing red LED");
     
-    // Turn off LED
-    red_led_off();
+    if (led_initialized) {
+        // Turn off LED
+        red_led_off();
+    }
+    
+    if (s_step_timer != NULL) {
+        esp_timer_stop(s_step_timer);
+        esp_timer_delete(s_step_timer);
+        s_step_timer = NULL;
+    }
+    if (s_led_mutex != NULL) {
+        vSemaphoreDelete(s_led_mutex);
+        s_led_mutex = NULL;
+    }
+    if (s_led_events != NULL) {
+        vEventGroupDelete(s_led_events);
+        s_led_events = NULL;
+    }
     
-    // Reset GPIO to input mode to reduce power consumption
+    // Release the channel and reset GPIO to input mode to reduce power consumption
+    ledc_stop(RED_LED_LEDC_MODE, RED_LED_LEDC_CHANNEL, RED_LED_OFF_LEVEL);
     gpio_reset_pin(RED_LED_PIN);
     
     led_initialized = false;
@@ -112,21 +414,34 @@ esp_err_t red_led_deinit(void)
 }
 
 /**
- * @brief Turn on the red LED
+ * @brief Stop any pattern and move to a brightness
  */
-esp_err_t red_led_on(void)
+static esp_err_t red_led_set_level(uint8_t brightness, uint32_t fade_ms)
 {
     if (!led_initialized) {
         ESP_LOGE(TAG, "LED not initialized");
         return ESP_ERR_INVALID_STATE;
     }
     
-    esp_err_t ret = gpio_set_level(RED_LED_PIN, RED_LED_ON_LEVEL);
+    if (xSemaphoreTake(s_led_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    red_led_cancel_pattern();
+    esp_err_t ret = red_led_apply_duty(red_led_brightness_to_duty(brightness), fade_ms);
+    xSemaphoreGive(s_led_mutex);
+    
+    return ret;
+}
+
+/**
+ * @brief Turn on the red LED
+ */
+esp_err_t red_led_on(void)
+{
+    esp_err_t ret = red_led_set_level(RED_LED_BRIGHTNESS_MAX, 0);
     if (ret == ESP_OK) {
-        led_current_state = true;
         ESP_LOGD(TAG, "LED turned ON");
     }
-    
     return ret;
 }
 
@@ -135,17 +450,10 @@ esp_err_t red_led_on(void)
  */
 esp_err_t red_led_off(void)
 {
-    if (!led_initialized) {
-        ESP_LOGE(TAG, "LED not initialized");
-        return ESP_ERR_INVALID_STATE;
-    }
-    
-    esp_err_t ret = gpio_set_level(RED_LED_PIN, RED_LED_OFF_LEVEL);
+    esp_err_t ret = red_led_set_level(0, 0);
     if (ret == ESP_OK) {
-        led_current_state = false;
         ESP_LOGD(TAG, "LED turned OFF");
     }
-    
     return ret;
 }
 
@@ -186,6 +494,47 @@ bool red_led_get_state(void)
     return led_current_state;
 }
 
+/**
+ * @brief Set LED brightness immediately
+ */
+esp_err_t red_led_set_brightness(uint8_t brightness)
+{
+    return red_led_set_level(brightness, 0);
+}
+
+/**
+ * @brief Fade to a brightness with the LEDC fade hardware
+ */
+esp_err_t red_led_fade_to(uint8_t brightness, uint32_t fade_ms)
+{
+    return red_led_set_level(brightness, fade_ms);
+}
+
+/**
+ * @brief Check whether a pattern is playing
+ */
+bool red_led_is_busy(void)
+{
+    if (s_led_events == NULL) {
+        return false;
+    }
+    return (xEventGroupGetBits(s_led_events) & RED_LED_IDLE_BIT) == 0;
+}
+
+/**
+ * @brief Wait until the running pattern has finished
+ */
+esp_err_t red_led_wait_done(uint32_t timeout_ms)
+{
+    if (s_led_events == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    EventBits_t bits = xEventGroupWaitBits(s_led_events, RED_LED_IDLE_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & RED_LED_IDLE_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 /**
  * @brief Blink LED with custom pattern
  */
@@ -198,25 +547,16 @@ esp_err_t red_led_blink_pattern(uint32_t on_time_ms, uint32_t off_time_ms, uint3
     
     ESP_LOGD(TAG, "Blinking: ON %lums, OFF %lums, repeat %lu times", on_time_ms, off_time_ms, repeat_count);
     
-    uint32_t cycles = (repeat_count == 0) ? UINT32_MAX : repeat_count;
-    
-    for (uint32_t i = 0; i < cycles; i++) {
-        // LED ON
-        esp_err_t ret = red_led_on();
-        if (ret != ESP_OK) return ret;
-        vTaskDelay(pdMS_TO_TICKS(on_time_ms));
-        
-        // LED OFF
-        ret = red_led_off();
-        if (ret != ESP_OK) return ret;
-        vTaskDelay(pdMS_TO_TICKS(off_time_ms));
-        
-        // For infinite loop, check if we should break (this is a simple implementation)
-        if (repeat_count == 0 && i > 1000) {
-            ESP_LOGW(TAG, "Breaking infinite blink loop after 1000 cycles");
-            break;
-        }
+    if (xSemaphoreTake(s_led_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
+    red_led_cancel_pattern();
+    s_pattern.on_ms = on_time_ms;
+    s_pattern.off_ms = off_time_ms;
+    s_pattern.remaining = repeat_count;
+    s_pattern.infinite = (repeat_count == 0);  // Runs until red_led_stop()
+    red_led_start_pattern(red_led_blink_next);
+    xSemaphoreGive(s_led_mutex);
     
     return ESP_OK;
 }
@@ -242,22 +582,22 @@ esp_err_t red_led_set_blink_state(led_state_t state)
     switch (state) {
         case LED_STATE_OFF:
             return red_led_off();
-            
+    
         case LED_STATE_ON:
             return red_led_on();
-            
+    
         case LED_STATE_BLINK_FAST:
             return red_led_blink_pattern(BLINK_FAST_MS, BLINK_FAST_MS, 5);
-            
+    
         case LED_STATE_BLINK_NORMAL:
             return red_led_blink_pattern(BLINK_NORMAL_MS, BLINK_NORMAL_MS, 3);
-            
+    
         case LED_STATE_BLINK_SLOW:
             return red_led_blink_pattern(BLINK_SLOW_MS, BLINK_SLOW_MS, 2);
-            
+    
         case LED_STATE_BLINK_VERY_SLOW:
             return red_led_blink_pattern(BLINK_VERY_SLOW_MS, BLINK_VERY_SLOW_MS, 1);
-            
+    
         default:
             ESP_LOGE(TAG, "Invalid LED state: %d", state);
             return ESP_ERR_INVALID_ARG;
@@ -284,50 +624,15 @@ esp_err_t red_led_breathing(uint32_t cycles, uint32_t cycle_duration_ms)
     
     ESP_LOGI(TAG, "Starting breathing effect: %lu cycles, %lums per cycle", cycles, cycle_duration_ms);
     
-    for (uint32_t cycle = 0; cycle < cycles; cycle++) {
-        uint32_t steps = 10;  // Reduced number of steps
-        uint32_t half_cycle = cycle_duration_ms / 2;  // Time for fade in or fade out
-        uint32_t step_duration = half_cycle / steps;
-        
-        ESP_LOGD(TAG, "Cycle %lu: %lu steps, %lums per step", cycle + 1, steps, step_duration);
-        
-        // Fade in (increasing on time)
-        for (uint32_t step = 1; step <= steps; step++) {
-            uint32_t on_time = (step * step_duration) / steps;
-            uint32_t off_time = step_duration - on_time;
-            
-            if (on_time > 0) {
-                red_led_on();
-                vTaskDelay(pdMS_TO_TICKS(on_time));
-            }
-            if (off_time > 0) {
-                red_led_off();
-                vTaskDelay(pdMS_TO_TICKS(off_time));
-            }
-        }
-        
-        // Fade out (decreasing on time)
-        for (uint32_t step = steps; step > 0; step--) {
-            uint32_t on_time = (step * step_duration) / steps;
-            uint32_t off_time = step_duration - on_time;
-            
-            if (on_time > 0) {
-                red_led_on();
-                vTaskDelay(pdMS_TO_TICKS(on_time));
-            }
-            if (off_time > 0) {
-                red_led_off();
-                vTaskDelay(pdMS_TO_TICKS(off_time));
-            }
-        }
-        
-        // Brief pause between cycles
-        red_led_off();
-        vTaskDelay(pdMS_TO_TICKS(200));
-        ESP_LOGD(TAG, "Completed cycle %lu", cycle + 1);
+    if (xSemaphoreTake(s_led_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
-    
-    ESP_LOGI(TAG, "Breathing effect completed");
+    red_led_cancel_pattern();
+    s_pattern.on_ms = cycle_duration_ms / 2;  // Time for fade in or fade out
+    s_pattern.remaining = cycles;
+    s_pattern.infinite = false;
+    red_led_start_pattern(red_led_breathing_next);
+    xSemaphoreGive(s_led_mutex);
     
     return ESP_OK;
 }
@@ -348,68 +653,26 @@ esp_err_t red_led_morse_code(const char* message, uint32_t dot_duration_ms)
     }
     
     ESP_LOGI(TAG, "Transmitting Morse code: \"%s\"", message);
+    if (strlen(message) > RED_LED_MORSE_MAX_LEN) {
+        ESP_LOGW(TAG, "Morse message truncated to %d characters", RED_LED_MORSE_MAX_LEN);
+    }
     
-    uint32_t dash_duration = dot_duration_ms * 3;
-    uint32_t inter_element_gap = dot_duration_ms;
-    uint32_t inter_letter_gap = dot_duration_ms * 3;
-    uint32_t inter_word_gap = dot_duration_ms * 7;
-    
-    for (int i = 0; message[i] != '\0'; i++) {
-        char c = message[i];
-        
-        if (c == ' ') {
-            // Word gap
-            vTaskDelay(pdMS_TO_TICKS(inter_word_gap));
-            continue;
-        }
-        
-        const char* code = NULL;
-        
-        // Convert to uppercase and get morse code
-        if (c >= 'a' && c <= 'z') {
-            code = morse_code[c - 'a'];
-        } else if (c >= 'A' && c <= 'Z') {
-            code = morse_code[c - 'A'];
-        } else if (c >= '0' && c <= '9') {
-            code = morse_code[26 + (c - '0')];
-        }
-        
-        if (code == NULL) {
-            ESP_LOGW(TAG, "Unsupported character: '%c'", c);
-            continue;
-        }
-        
-        ESP_LOGD(TAG, "Character '%c' -> %s", c, code);
-        
-        // Transmit morse code for this character
-        for (int j = 0; code[j] != '\0'; j++) {
-            if (code[j] == '.') {
-                // Dot
-                red_led_on();
-                vTaskDelay(pdMS_TO_TICKS(dot_duration_ms));
-                red_led_off();
-            } else if (code[j] == '-') {
-                // Dash
-                red_led_on();
-                vTaskDelay(pdMS_TO_TICKS(dash_duration));
-                red_led_off();
-            }
-            
-            // Inter-element gap (except after last element)
-            if (code[j + 1] != '\0') {
-                vTaskDelay(pdMS_TO_TICKS(inter_element_gap));
-            }
-        }
-        
-        // Inter-letter gap (except after last letter)
-        if (message[i + 1] != '\0' && message[i + 1] != ' ') {
-            vTaskDelay(pdMS_TO_TICKS(inter_letter_gap));
-        }
+    if (xSemaphoreTake(s_led_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
+    red_led_cancel_pattern();
+    strncpy(s_pattern.message, message, RED_LED_MORSE_MAX_LEN);
+    s_pattern.message[RED_LED_MORSE_MAX_LEN] = '\0';
+    s_pattern.on_ms = dot_duration_ms;
+    red_led_start_pattern(red_led_morse_next);
+    xSemaphoreGive(s_led_mutex);
     
     return ESP_OK;
 }
 
+// Upper bound for one multi-part indication segment to finish
+#define RED_LED_SEGMENT_TIMEOUT_MS  5000
+
 /**
  * @brief Status indication patterns
  */
@@ -418,6 +681,7 @@ esp_err_t red_led_indicate_boot(void)
     ESP_LOGI(TAG, "Boot sequence indication");
     // Fast blinks followed by slow blinks
     red_led_blink(5, 100);
+    red_led_wait_done(RED_LED_SEGMENT_TIMEOUT_MS);
     vTaskDelay(pdMS_TO_TICKS(300));
     red_led_blink(3, 300);
     return ESP_OK;
@@ -445,6 +709,7 @@ esp_err_t red_led_indicate_warning(void)
     // Double blink pattern
     for (int i = 0; i < 3; i++) {
         red_led_blink(2, 100);
+        red_led_wait_done(RED_LED_SEGMENT_TIMEOUT_MS);
         vTaskDelay(pdMS_TO_TICKS(300));
     }
     return ESP_OK;
@@ -480,16 +745,25 @@ esp_err_t red_led_test_patterns(void)
     // Test 2: Fast blink pattern
     ESP_LOGI(TAG, "Test 2: Fast blink");
     red_led_set_blink_state(LED_STATE_BLINK_FAST);
+    red_led_wait_done(RED_LED_SEGMENT_TIMEOUT_MS);
+    
+    // Test 3: Brightness fade
+    ESP_LOGI(TAG, "Test 3: Hardware fade");
+    red_led_fade_to(RED_LED_BRIGHTNESS_MAX, 500);
+    vTaskDelay(pdMS_TO_TICKS(600));
+    red_led_fade_to(0, 500);
     vTaskDelay(pdMS_TO_TICKS(600));
     
-    // Test 3: Essential status indications
-    ESP_LOGI(TAG, "Test 3: Status indications");
+    // Test 4: Essential status indications
+    ESP_LOGI(TAG, "Test 4: Status indications");
     ESP_LOGI(TAG, "  Boot indication");
     red_led_indicate_boot();
+    red_led_wait_done(RED_LED_SEGMENT_TIMEOUT_MS);
     vTaskDelay(pdMS_TO_TICKS(300));
     
     ESP_LOGI(TAG, "  Success indication");
     red_led_indicate_success();
+    red_led_wait_done(RED_LED_SEGMENT_TIMEOUT_MS);
     
     ESP_LOGI(TAG, "Simplified LED test completed");
     
@@ -3,6 +3,7 @@
 
 #include "esp_err.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -11,6 +12,15 @@
 #define RED_LED_ON_LEVEL        0    // LED is active LOW (0 = ON, 1 = OFF)
 #define RED_LED_OFF_LEVEL       1
 
+// LEDC PWM channel (buzzer.c uses timer/channel 0, ux_service buzzer timer/channel 1)
+#define RED_LED_LEDC_MODE       LEDC_LOW_SPEED_MODE
+#define RED_LED_LEDC_TIMER      LEDC_TIMER_2
+#define RED_LED_LEDC_CHANNEL    LEDC_CHANNEL_2
+#define RED_LED_LEDC_RESOLUTION LEDC_TIMER_10_BIT
+#define RED_LED_LEDC_FREQUENCY  5000  // PWM frequency (Hz), well above visible flicker
+#define RED_LED_BRIGHTNESS_MAX  255
+#define RED_LED_MORSE_MAX_LEN   64    // Longest Morse message kept for playback
+
 // Blink patterns for different states
 #define BLINK_FAST_MS           100   // Fast blink interval
 #define BLINK_NORMAL_MS         250   // Normal blink interval  
@@ -41,8 +51,10 @@ typedef struct {
 /**
  * @brief Initialize the red LED (GPIO10)
  * 
- * This function configures GPIO10 as an output pin for controlling
- * the red LED on M5StickC Plus.
+ * Drives GPIO10 from an LEDC PWM channel (output inverted, the LED is active
+ * LOW) and installs the LEDC fade service. Patterns run from hardware fades
+ * and an esp_timer, so the pattern functions below return immediately and a
+ * new pattern replaces the one playing. Safe to call more than once.
  * 
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
@@ -92,7 +104,39 @@ esp_err_t red_led_set_state(bool state);
 bool red_led_get_state(void);
 
 /**
- * @brief Blink the LED with specified pattern
+ * @brief Set LED brightness immediately (stops any running pattern)
+ * 
+ * @param brightness 0 (off) to RED_LED_BRIGHTNESS_MAX
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t red_led_set_brightness(uint8_t brightness);
+
+/**
+ * @brief Fade to a brightness with the LEDC fade hardware (stops any running pattern)
+ * 
+ * @param brightness Target brightness, 0 to RED_LED_BRIGHTNESS_MAX
+ * @param fade_ms Fade duration (0 = set immediately)
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t red_led_fade_to(uint8_t brightness, uint32_t fade_ms);
+
+/**
+ * @brief Check whether a pattern is playing
+ * 
+ * @return bool true while a blink, breathing or Morse pattern is running
+ */
+bool red_led_is_busy(void);
+
+/**
+ * @brief Wait until the running pattern has finished
+ * 
+ * @param timeout_ms Maximum wait
+ * @return esp_err_t ESP_OK when idle, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t red_led_wait_done(uint32_t timeout_ms);
+
+/**
+ * @brief Blink the LED with specified pattern (returns immediately)
  * 
  * @param on_time_ms Time to keep LED on (milliseconds)
  * @param off_time_ms Time to keep LED off (milliseconds)  
@@ -119,17 +163,16 @@ esp_err_t red_led_blink(uint32_t count, uint32_t interval_ms);
 esp_err_t red_led_set_blink_state(led_state_t state);
 
 /**
- * @brief Stop any ongoing LED operations
+ * @brief Stop any ongoing LED pattern and turn the LED off
  * 
  * @return esp_err_t ESP_OK on success
  */
 esp_err_t red_led_stop(void);
 
 /**
- * @brief LED breathing effect (fade in/out)
+ * @brief LED breathing effect (fade in/out, returns immediately)
  * 
- * Creates a breathing effect by rapidly toggling the LED.
- * Note: This is a basic implementation for hardware without PWM dimming.
+ * Each half cycle is one LEDC hardware fade, followed by a 200 ms pause.
  * 
  * @param cycles Number of breathing cycles
  * @param cycle_duration_ms Duration of one complete breathing cycle
@@ -138,7 +181,9 @@ esp_err_t red_led_stop(void);
 esp_err_t red_led_breathing(uint32_t cycles, uint32_t cycle_duration_ms);
 
 /**
- * @brief Morse code transmission using LED
+ * @brief Morse code transmission using LED (returns immediately)
+ * 
+ * The message is copied (up to RED_LED_MORSE_MAX_LEN characters).
  * 
  * @param message Message to transmit in Morse code (A-Z, 0-9, space)
  * @param dot_duration_ms Duration of a dot (base unit)
@@ -149,7 +194,8 @@ esp_err_t red_led_morse_code(const char* message, uint32_t dot_duration_ms);
 /**
  * @brief LED status indication patterns
  * 
- * Predefined patterns for common status indications:
+ * Predefined patterns for common status indications. Multi-part patterns
+ * sleep in red_led_wait_done() between their parts:
  * - Boot sequence
  * - Success indication  
  * - Error indication
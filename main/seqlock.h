@@ -0,0 +1,109 @@
+/*
+ * Sequence lock snapshots for M5StickC Plus 1.1
+ * Lock-free readers for small structures published by one writer at a time
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sequence lock
+ *
+ * The sequence is odd while a write is in progress. Readers copy the data and
+ * retry if the sequence was odd or changed during the copy, so they never take
+ * a lock and never delay the writer. Readers are lock-free, not wait-free: a
+ * reader that keeps overlapping writes sleeps a tick every SEQLOCK_SPIN_RETRIES
+ * retries. Writers must be serialized by the caller (one task, a writer-side
+ * mutex, or a critical section, which also keeps retries to the other core).
+ */
+typedef struct {
+    atomic_uint seq;
+} seqlock_t;
+
+#define SEQLOCK_INIT            { ATOMIC_VAR_INIT(0) }
+
+// Retries before a reader sleeps one tick so a preempted writer on the same core can finish
+#define SEQLOCK_SPIN_RETRIES    8
+
+static inline void seqlock_init(seqlock_t *lock) {
+    atomic_store_explicit(&lock->seq, 0, memory_order_relaxed);
+}
+
+static inline void seqlock_write_begin(seqlock_t *lock) {
+    unsigned int seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void seqlock_write_end(seqlock_t *lock) {
+    unsigned int seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 1, memory_order_release);
+}
+
+static inline unsigned int seqlock_read_begin(const seqlock_t *lock) {
+    return atomic_load_explicit((atomic_uint *)&lock->seq, memory_order_acquire);
+}
+
+static inline bool seqlock_read_retry(const seqlock_t *lock, unsigned int start) {
+    atomic_thread_fence(memory_order_acquire);
+    return (start & 1u) != 0 ||
+           atomic_load_explicit((atomic_uint *)&lock->seq, memory_order_relaxed) != start;
+}
+
+/**
+ * @brief Publish a new copy of the protected data
+ * @param lock Sequence lock guarding dst
+ * @param dst Shared data
+ * @param src New value
+ * @param size Size of the data in bytes
+ */
+static inline void seqlock_write_copy(seqlock_t *lock, void *dst, const void *src, size_t size) {
+    seqlock_write_begin(lock);
+    memcpy(dst, src, size);
+    seqlock_write_end(lock);
+}
+
+/**
+ * @brief Take a consistent copy of the protected data (task context only, may sleep)
+ * @param lock Sequence lock guarding src
+ * @param dst Destination for the copy
+ * @param src Shared data
+ * @param size Size of the data in bytes
+ * @return Number of retries needed (0 when no write overlapped the copy)
+ */
+static inline uint32_t seqlock_read_copy(const seqlock_t *lock, void *dst, const volatile void *src, size_t size) {
+    uint32_t retries = 0;
+    unsigned int start;
+
+    for (;;) {
+        start = seqlock_read_begin(lock);
+        if ((start & 1u) == 0) {
+            memcpy(dst, (const void *)src, size);
+            if (!seqlock_read_retry(lock, start)) {
+                return retries;
+            }
+        }
+        retries++;
+        if ((retries % SEQLOCK_SPIN_RETRIES) == 0) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQLOCK_H
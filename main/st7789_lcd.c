@@ -1,9 +1,14 @@
 #include "st7789_lcd.h"
 #include "axp192.h"
+#include "mem_account.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <string.h>
 
 // ESP-IDF LCD components
 #include "esp_lcd_panel_io.h"
@@ -19,6 +24,99 @@ static const char *TAG = "ST7789_LCD";
 static esp_lcd_panel_handle_t panel_handle = NULL;
 static esp_lcd_panel_io_handle_t io_handle = NULL;
 
+// Fill/blit engine: two DMA stripe buffers, reused for every draw call.
+// A buffer may be rewritten once every transfer queued from it has completed.
+#define ST7789_STRIPE_BUFFERS   2
+#define ST7789_STRIPE_WAIT_MS   1000    // A stripe is well under 10 ms even at 10 MHz
+
+_Static_assert(ST7789_FILL_STRIPE_PIXELS % 2 == 0, "Fills store two pixels per word");
+
+typedef struct {
+    uint16_t *pixels;           // ST7789_FILL_STRIPE_PIXELS, DMA capable (word aligned)
+    uint32_t last_trans;        // s_trans_queued after the last transfer from this buffer
+    uint32_t fill_pixels;       // Leading pixels that hold fill_color (0 after a blit)
+    uint16_t fill_color;
+} st7789_stripe_t;
+
+static st7789_stripe_t s_stripes[ST7789_STRIPE_BUFFERS];
+static int s_next_stripe = 0;
+static uint32_t s_trans_queued = 0;                 // Color transfers queued (drawing task)
+static atomic_uint s_trans_done = ATOMIC_VAR_INIT(0);   // Color transfers finished (SPI ISR)
+static SemaphoreHandle_t s_trans_done_sem = NULL;
+static StaticSemaphore_t s_trans_done_sem_buffer;
+
+static bool st7789_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t high_task_woken = pdFALSE;
+    atomic_fetch_add_explicit(&s_trans_done, 1, memory_order_release);
+    xSemaphoreGiveFromISR(s_trans_done_sem, &high_task_woken);
+    return high_task_woken == pdTRUE;
+}
+
+// Wait until at least `count` color transfers have finished (wrap-safe)
+static esp_err_t st7789_wait_trans(uint32_t count, uint32_t timeout_ms)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+    while ((int32_t)(atomic_load_explicit(&s_trans_done, memory_order_acquire) - count) < 0) {
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(deadline - now) <= 0) {
+            return ESP_ERR_TIMEOUT;
+        }
+        xSemaphoreTake(s_trans_done_sem, deadline - now);
+    }
+    return ESP_OK;
+}
+
+// Next stripe buffer, once its previous transfers are done
+static st7789_stripe_t *st7789_stripe_acquire(void)
+{
+    st7789_stripe_t *stripe = &s_stripes[s_next_stripe];
+    s_next_stripe = (s_next_stripe + 1) % ST7789_STRIPE_BUFFERS;
+    if (st7789_wait_trans(stripe->last_trans, ST7789_STRIPE_WAIT_MS) != ESP_OK) {
+        ESP_LOGE(TAG, "LCD stripe transfer timed out");
+        return NULL;
+    }
+    return stripe;
+}
+
+// Queue one stripe; the buffer stays busy until its transfer finishes
+static esp_err_t st7789_stripe_queue(st7789_stripe_t *stripe, int x, int y, int width, int lines)
+{
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, x, y, x + width, y + lines, stripe->pixels);
+    if (ret == ESP_OK) {
+        stripe->last_trans = ++s_trans_queued;
+    }
+    return ret;
+}
+
+static esp_err_t st7789_stripe_buffers_alloc(void)
+{
+    for (int i = 0; i < ST7789_STRIPE_BUFFERS; i++) {
+        s_stripes[i].pixels = mem_account_caps_malloc(MEM_MODULE_LCD_DMA, ST7789_FILL_STRIPE_PIXELS * sizeof(uint16_t),
+                                                      MALLOC_CAP_DMA);
+        if (s_stripes[i].pixels == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        s_stripes[i].last_trans = 0;
+        s_stripes[i].fill_pixels = 0;
+    }
+    if (s_trans_done_sem == NULL) {
+        s_trans_done_sem = xSemaphoreCreateBinaryStatic(&s_trans_done_sem_buffer);
+    }
+    s_next_stripe = 0;
+    s_trans_queued = 0;
+    atomic_store(&s_trans_done, 0);
+    return ESP_OK;
+}
+
+static void st7789_stripe_buffers_free(void)
+{
+    for (int i = 0; i < ST7789_STRIPE_BUFFERS; i++) {
+        mem_account_free(MEM_MODULE_LCD_DMA, s_stripes[i].pixels);
+        s_stripes[i].pixels = NULL;
+    }
+}
+
 /**
  * @brief Initialize ST7789 TFT display using ESP-IDF LCD components
  */
@@ -47,6 +145,15 @@ esp_err_t st7789_lcd_init(void)
     // Give power some time to stabilize
     vTaskDelay(pdMS_TO_TICKS(100));
 
+    // Preallocate the stripe buffers, draw calls never allocate
+    ret = st7789_stripe_buffers_alloc();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to allocate %d x %u bytes of DMA stripe buffers", ST7789_STRIPE_BUFFERS,
+                 (unsigned)(ST7789_FILL_STRIPE_PIXELS * sizeof(uint16_t)));
+        st7789_stripe_buffers_free();
+        return ret;
+    }
+
     // Initialize SPI bus
     ESP_LOGI(TAG, "Initializing SPI bus");
     spi_bus_config_t buscfg = {
@@ -55,12 +162,13 @@ esp_err_t st7789_lcd_init(void)
         .sclk_io_num = ST7789_PIN_SCLK,
         .quadwp_io_num = GPIO_NUM_NC,
         .quadhd_io_num = GPIO_NUM_NC,
-        .max_transfer_sz = ST7789_LCD_H_RES * ST7789_LCD_V_RES * sizeof(uint16_t),
+        .max_transfer_sz = ST7789_FILL_STRIPE_PIXELS * sizeof(uint16_t),  // Largest transfer is one stripe
     };
     
     ret = spi_bus_initialize(ST7789_SPI_HOST, &buscfg, ST7789_SPI_DMA_CHAN);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize SPI bus: %s", esp_err_to_name(ret));
+        st7789_stripe_buffers_free();
         return ret;
     }
 
@@ -74,12 +182,14 @@ esp_err_t st7789_lcd_init(void)
         .lcd_param_bits = 8,
         .spi_mode = 0,
         .trans_queue_depth = 10,
+        .on_color_trans_done = st7789_color_trans_done,     // Releases the stripe buffers
     };
     
     ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)ST7789_SPI_HOST, &io_config, &io_handle);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create LCD panel IO: %s", esp_err_to_name(ret));
         spi_bus_free(ST7789_SPI_HOST);
+        st7789_stripe_buffers_free();
         return ret;
     }
 
@@ -96,6 +206,7 @@ esp_err_t st7789_lcd_init(void)
         ESP_LOGE(TAG, "Failed to create LCD panel: %s", esp_err_to_name(ret));
         esp_lcd_panel_io_del(io_handle);
         spi_bus_free(ST7789_SPI_HOST);
+        st7789_stripe_buffers_free();
         return ret;
     }
 
@@ -150,6 +261,7 @@ cleanup:
     esp_lcd_panel_del(panel_handle);
     esp_lcd_panel_io_del(io_handle);
     spi_bus_free(ST7789_SPI_HOST);
+    st7789_stripe_buffers_free();
     panel_handle = NULL;
     io_handle = NULL;
     return ret;
@@ -255,27 +367,40 @@ esp_err_t st7789_lcd_draw_rect(int x, int y, int width, int height, uint16_t col
     }
     
     // Validate bounds
-    if (x < 0 || y < 0 || x + width > ST7789_LCD_H_RES || y + height > ST7789_LCD_V_RES) {
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > ST7789_LCD_H_RES || y + height > ST7789_LCD_V_RES) {
         ESP_LOGE(TAG, "Rectangle bounds out of display area");
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Create color buffer for the rectangle
-    uint16_t *color_buffer = malloc(width * height * sizeof(uint16_t));
-    if (color_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate color buffer");
-        return ESP_ERR_NO_MEM;
+    // Narrow rectangles get taller stripes: every stripe is up to a full buffer
+    int stripe_lines = ST7789_FILL_STRIPE_PIXELS / width;
+    if (stripe_lines > height) {
+        stripe_lines = height;
     }
+    uint32_t stripe_pixels = (uint32_t)(stripe_lines * width);
     
-    // Fill buffer with color
-    for (int i = 0; i < width * height; i++) {
-        color_buffer[i] = color;
+    // One buffer holds the color for every stripe of the rectangle
+    st7789_stripe_t *stripe = st7789_stripe_acquire();
+    if (stripe == NULL) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (stripe->fill_color != color || stripe->fill_pixels < stripe_pixels) {
+        // Two pixels per 32-bit store; the buffer is 32-bit aligned and an even number of pixels long
+        uint32_t pattern = ((uint32_t)color << 16) | color;
+        uint32_t *words = (uint32_t *)stripe->pixels;
+        for (uint32_t i = 0; i < (stripe_pixels + 1) / 2; i++) {
+            words[i] = pattern;
+        }
+        stripe->fill_color = color;
+        stripe->fill_pixels = stripe_pixels;
     }
     
-    // Draw the rectangle
-    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, x, y, x + width, y + height, color_buffer);
-    
-    free(color_buffer);
+    esp_err_t ret = ESP_OK;
+    for (int line = 0; line < height && ret == ESP_OK; line += stripe_lines) {
+        int lines = (height - line < stripe_lines) ? height - line : stripe_lines;
+        ret = st7789_stripe_queue(stripe, x, y + line, width, lines);
+    }
     
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to draw rectangle: %s", esp_err_to_name(ret));
@@ -284,6 +409,55 @@ esp_err_t st7789_lcd_draw_rect(int x, int y, int width, int height, uint16_t col
     return ret;
 }
 
+/**
+ * @brief Copy a block of pixels to the display
+ */
+esp_err_t st7789_lcd_blit(int x, int y, int width, int height, const uint16_t *pixels)
+{
+    if (panel_handle == NULL) {
+        ESP_LOGE(TAG, "LCD panel not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (pixels == NULL || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > ST7789_LCD_H_RES || y + height > ST7789_LCD_V_RES) {
+        ESP_LOGE(TAG, "Blit bounds out of display area");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int stripe_lines = ST7789_FILL_STRIPE_PIXELS / width;
+    esp_err_t ret = ESP_OK;
+    
+    // Copying the next stripe overlaps the transfer of the previous one
+    for (int line = 0; line < height && ret == ESP_OK; line += stripe_lines) {
+        int lines = (height - line < stripe_lines) ? height - line : stripe_lines;
+        st7789_stripe_t *stripe = st7789_stripe_acquire();
+        if (stripe == NULL) {
+            return ESP_ERR_TIMEOUT;
+        }
+        memcpy(stripe->pixels, &pixels[line * width], (size_t)lines * width * sizeof(uint16_t));
+        stripe->fill_pixels = 0;
+        ret = st7789_stripe_queue(stripe, x, y + line, width, lines);
+    }
+    
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to blit: %s", esp_err_to_name(ret));
+    }
+    
+    return ret;
+}
+
+/**
+ * @brief Wait for all queued stripes to reach the display
+ */
+esp_err_t st7789_lcd_wait_idle(uint32_t timeout_ms)
+{
+    if (panel_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return st7789_wait_trans(s_trans_queued, timeout_ms);
+}
+
 /**
  * @brief Clear the entire display with specified color
  */
@@ -311,8 +485,11 @@ esp_err_t st7789_lcd_deinit(void)
     
     esp_err_t ret = ESP_OK;
     
-    // Turn off display
+    // Turn off display once the queued stripes are out
     if (panel_handle != NULL) {
+        if (st7789_lcd_wait_idle(ST7789_STRIPE_WAIT_MS) != ESP_OK) {
+            ESP_LOGW(TAG, "LCD transfers still pending at deinit");
+        }
         esp_lcd_panel_disp_on_off(panel_handle, false);
         esp_lcd_panel_del(panel_handle);
         panel_handle = NULL;
@@ -334,6 +511,8 @@ esp_err_t st7789_lcd_deinit(void)
     axp192_power_tft_display(false);
     axp192_power_tft_backlight(false);
     
+    st7789_stripe_buffers_free();
+    
     ESP_LOGI(TAG, "ST7789 LCD cleanup completed");
     return ESP_OK;
 }
\ No newline at end of file
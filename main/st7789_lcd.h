@@ -21,6 +21,10 @@
 #define ST7789_LCD_V_RES        240
 #define ST7789_LCD_PIXEL_CLOCK  (20 * 1000 * 1000)  // 20MHz for better clarity
 
+// Fill/blit engine: every draw streams through two preallocated DMA stripe buffers
+#define ST7789_FILL_STRIPE_LINES    16      // Full-width lines per stripe (narrower rectangles get more)
+#define ST7789_FILL_STRIPE_PIXELS   (ST7789_LCD_H_RES * ST7789_FILL_STRIPE_LINES)
+
 // SPI Host configuration
 #define ST7789_SPI_HOST         SPI2_HOST
 #define ST7789_SPI_DMA_CHAN     SPI_DMA_CH_AUTO
@@ -75,6 +79,11 @@ esp_lcd_panel_handle_t st7789_lcd_get_panel_handle(void);
 /**
  * @brief Draw a filled rectangle on the display
  * 
+ * Streams the rectangle in stripes from a preallocated DMA buffer, filled
+ * two pixels per store; nothing is allocated per call. Returns once the
+ * stripes are queued, use st7789_lcd_wait_idle() to wait for the pixels.
+ * Not thread safe: draw from one task.
+ * 
  * @param x X coordinate (0 to ST7789_LCD_H_RES-1)
  * @param y Y coordinate (0 to ST7789_LCD_V_RES-1) 
  * @param width Width of rectangle
@@ -84,6 +93,32 @@ esp_lcd_panel_handle_t st7789_lcd_get_panel_handle(void);
  */
 esp_err_t st7789_lcd_draw_rect(int x, int y, int width, int height, uint16_t color);
 
+/**
+ * @brief Copy a block of RGB565 pixels to the display
+ * 
+ * The source may be in any memory (flash, PSRAM, stack): each stripe is
+ * copied into a DMA buffer while the previous stripe is transferred, so
+ * the source can be reused as soon as this returns.
+ * 
+ * @param x X coordinate of the top-left pixel
+ * @param y Y coordinate of the top-left pixel
+ * @param width Width of the block, also the source row stride in pixels
+ * @param height Height of the block
+ * @param pixels width * height RGB565 values, row by row
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on NULL or bounds
+ *         outside the display, ESP_ERR_TIMEOUT if a stripe buffer never frees up
+ */
+esp_err_t st7789_lcd_blit(int x, int y, int width, int height, const uint16_t *pixels);
+
+/**
+ * @brief Wait until every queued stripe has been transferred to the display
+ * 
+ * @param timeout_ms Maximum wait
+ * @return esp_err_t ESP_OK when idle, ESP_ERR_TIMEOUT otherwise,
+ *         ESP_ERR_INVALID_STATE if the panel is not initialized
+ */
+esp_err_t st7789_lcd_wait_idle(uint32_t timeout_ms);
+
 /**
  * @brief Clear the entire display with specified color
  * 
@@ -4,6 +4,11 @@
 
 #include "system_monitor.h"
 #include "axp192.h"
+#include "ui_notify.h"
+#include "seqlock.h"
+#include "change_filter.h"
+#include "task_placement.h"
+#include "power_manager.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_heap_caps.h"
@@ -11,45 +16,59 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include <string.h>
-#include <stdlib.h>  // for abs() function
+#include <stdatomic.h>
 
 static const char *TAG = "system_monitor";
 
-// Global system data
+// Global system data: published through a seqlock so readers never take the mutex,
+// the mutex only serializes writers (monitor task and system_monitor_update_now)
 static system_data_t g_system_data = {0};
+static seqlock_t g_data_lock = SEQLOCK_INIT;
 static SemaphoreHandle_t g_data_mutex = NULL;
 static TaskHandle_t g_monitor_task_handle = NULL;
 static bool g_monitor_running = false;
-static bool g_data_updated = false;  // Data update flag
+static atomic_bool g_data_updated = ATOMIC_VAR_INIT(false);  // Data update flag
 
 // Configuration
-#define MONITOR_TASK_STACK_SIZE     4096
-#define MONITOR_TASK_PRIORITY       3
-#define MONITOR_UPDATE_INTERVAL_MS  1000  // Update every 1 second
+#define MONITOR_UPDATE_INTERVAL_MS  1000  // Default update interval (1 second)
 
-// Function to safely read AXP192 data with error handling
-static float safe_read_float(esp_err_t (*read_func)(float*), const char* param_name) {
-    float value = 0.0;
-    esp_err_t ret = read_func(&value);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to read %s: %s", param_name, esp_err_to_name(ret));
-        return 0.0;
-    }
-    return value;
-}
+static atomic_uint g_update_interval_ms = ATOMIC_VAR_INIT(MONITOR_UPDATE_INTERVAL_MS);
 
-static uint8_t safe_read_uint8(esp_err_t (*read_func)(uint8_t*), const char* param_name) {
-    uint8_t value = 0;
-    esp_err_t ret = read_func(&value);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to read %s: %s", param_name, esp_err_to_name(ret));
-        return 0;
-    }
-    return value;
-}
+// Change detection: a metric only counts as changed once it leaves its deadband
+typedef enum {
+    MONITOR_METRIC_BATTERY_VOLTAGE = 0,
+    MONITOR_METRIC_BATTERY_PERCENT,
+    MONITOR_METRIC_VBUS_VOLTAGE,
+    MONITOR_METRIC_CHARGE_CURRENT,
+    MONITOR_METRIC_DISCHARGE_CURRENT,
+    MONITOR_METRIC_INTERNAL_TEMP,
+    MONITOR_METRIC_FREE_HEAP,
+    MONITOR_METRIC_COUNT
+} monitor_metric_t;
 
-static bool safe_read_bool(bool (*read_func)(void), const char* param_name) {
-    return read_func();
+static const change_filter_cfg_t k_monitor_filters[MONITOR_METRIC_COUNT] = {
+    [MONITOR_METRIC_BATTERY_VOLTAGE]   = { .deadband = 0.010f,  .hysteresis = 0.005f },   // V
+    [MONITOR_METRIC_BATTERY_PERCENT]   = { .deadband = 1.0f,    .hysteresis = 1.0f },     // %
+    [MONITOR_METRIC_VBUS_VOLTAGE]      = { .deadband = 0.020f,  .hysteresis = 0.010f },   // V
+    [MONITOR_METRIC_CHARGE_CURRENT]    = { .deadband = 5.0f,    .hysteresis = 2.0f },     // mA
+    [MONITOR_METRIC_DISCHARGE_CURRENT] = { .deadband = 5.0f,    .hysteresis = 2.0f },     // mA
+    [MONITOR_METRIC_INTERNAL_TEMP]     = { .deadband = 0.5f,    .hysteresis = 0.2f },     // °C
+    [MONITOR_METRIC_FREE_HEAP]         = { .deadband = 1024.0f, .hysteresis = 0.0f },     // bytes
+};
+
+// Filter state, owned by the writer (g_data_mutex held)
+static change_filter_t g_monitor_filter_state[MONITOR_METRIC_COUNT];
+
+/**
+ * @brief Run one reading through its filter and replace it with the reported value
+ * @return true if the reported value changed
+ */
+static bool monitor_filter_float(monitor_metric_t metric, float *value)
+{
+    change_filter_t *filter = &g_monitor_filter_state[metric];
+    bool changed = change_filter_update(filter, &k_monitor_filters[metric], *value);
+    *value = filter->reported;
+    return changed;
 }
 
 // Update system data
@@ -59,19 +78,23 @@ static void update_system_data(void) {
     // Get current timestamp
     new_data.last_update = esp_timer_get_time() / 1000; // Convert to ms
     
-    // Battery information
-    new_data.battery_voltage = safe_read_float(axp192_get_battery_voltage, "battery_voltage");
-    new_data.battery_percentage = safe_read_uint8(axp192_get_battery_level, "battery_level");
-    new_data.is_charging = safe_read_bool(axp192_is_charging, "is_charging");
-    new_data.is_usb_connected = safe_read_bool(axp192_is_vbus_present, "is_usb_connected");
-    
-    // Power information
-    new_data.vbus_voltage = safe_read_float(axp192_get_vbus_voltage, "vbus_voltage");
-    new_data.charge_current = safe_read_float(axp192_get_battery_charge_current, "charge_current");
-    new_data.discharge_current = safe_read_float(axp192_get_battery_discharge_current, "discharge_current");
-    
-    // Temperature
-    new_data.internal_temp = safe_read_float(axp192_get_internal_temperature, "internal_temperature");
+    // Battery, power and temperature from one burst-read snapshot
+    axp192_snapshot_t snapshot;
+    esp_err_t ret = axp192_read_snapshot(&snapshot);
+    if (ret == ESP_OK) {
+        new_data.battery_voltage = snapshot.battery_voltage;
+        new_data.battery_percentage = snapshot.battery_level;
+        new_data.is_charging = snapshot.is_charging;
+        new_data.is_usb_connected = snapshot.vbus_present;
+        new_data.vbus_voltage = snapshot.vbus_voltage;
+        new_data.charge_current = snapshot.charge_current;
+        new_data.discharge_current = snapshot.discharge_current;
+        new_data.internal_temp = snapshot.internal_temp;
+        power_manager_record_discharge(snapshot.discharge_current, !snapshot.vbus_present);
+        ESP_LOGV(TAG, "AXP192 snapshot read in %"PRIu32" us", snapshot.read_time_us);
+    } else {
+        ESP_LOGW(TAG, "Failed to read AXP192 snapshot: %s", esp_err_to_name(ret));
+    }
     
     // System information
     new_data.uptime_seconds = new_data.last_update / 1000;
@@ -81,31 +104,32 @@ static void update_system_data(void) {
     // Mark data as valid
     new_data.data_valid = true;
     
-    // Update global data with mutex protection
+    // Publish with the writer mutex held; readers only go through the seqlock
     if (xSemaphoreTake(g_data_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Compare with existing data to detect actual changes
-        bool data_changed = false;
+        // Filter noisy readings; published data holds the reported (filtered) values
+        bool data_changed = !g_system_data.data_valid;  // First valid data always counts
+        data_changed |= monitor_filter_float(MONITOR_METRIC_BATTERY_VOLTAGE, &new_data.battery_voltage);
+        data_changed |= monitor_filter_float(MONITOR_METRIC_VBUS_VOLTAGE, &new_data.vbus_voltage);
+        data_changed |= monitor_filter_float(MONITOR_METRIC_CHARGE_CURRENT, &new_data.charge_current);
+        data_changed |= monitor_filter_float(MONITOR_METRIC_DISCHARGE_CURRENT, &new_data.discharge_current);
+        data_changed |= monitor_filter_float(MONITOR_METRIC_INTERNAL_TEMP, &new_data.internal_temp);
         
-        // Check if this is the first valid data or if key values have changed
-        if (!g_system_data.data_valid) {
-            // First time getting valid data
-            data_changed = true;
-        } else {
-            // Compare key values that matter for UI display
-            if (g_system_data.battery_voltage != new_data.battery_voltage ||
-                g_system_data.battery_percentage != new_data.battery_percentage ||
-                g_system_data.is_charging != new_data.is_charging ||
-                g_system_data.is_usb_connected != new_data.is_usb_connected ||
-                g_system_data.internal_temp != new_data.internal_temp ||
-                abs((int32_t)g_system_data.free_heap - (int32_t)new_data.free_heap) > 1024) {  // Heap change > 1KB
-                data_changed = true;
-            }
-        }
+        float percent = new_data.battery_percentage;
+        data_changed |= monitor_filter_float(MONITOR_METRIC_BATTERY_PERCENT, &percent);
+        new_data.battery_percentage = (uint8_t)percent;
+        
+        float free_heap = (float)new_data.free_heap;
+        data_changed |= monitor_filter_float(MONITOR_METRIC_FREE_HEAP, &free_heap);
+        new_data.free_heap = (uint32_t)free_heap;
+        
+        // State flags are exact
+        data_changed |= g_system_data.is_charging != new_data.is_charging ||
+                        g_system_data.is_usb_connected != new_data.is_usb_connected;
         
         // Update data and set flag only if data actually changed
-        memcpy(&g_system_data, &new_data, sizeof(system_data_t));
+        seqlock_write_copy(&g_data_lock, &g_system_data, &new_data, sizeof(system_data_t));
         if (data_changed) {
-            g_data_updated = true;  // Set flag only when data actually changed
+            atomic_store(&g_data_updated, true);  // Set flag only when data actually changed
             ESP_LOGD(TAG, "System data changed: Bat=%.2fV (%d%%), Temp=%.1f°C, Heap=%"PRIu32"KB", 
                     new_data.battery_voltage, new_data.battery_percentage, 
                     new_data.internal_temp, new_data.free_heap / 1024);
@@ -114,6 +138,11 @@ static void update_system_data(void) {
         }
         
         xSemaphoreGive(g_data_mutex);
+        
+        // Wake subscribed pages outside the lock
+        if (data_changed) {
+            ui_notify_publish(UI_TOPIC_SYSTEM_MONITOR);
+        }
     } else {
         ESP_LOGW(TAG, "Failed to acquire mutex for data update");
     }
@@ -129,8 +158,17 @@ static void system_monitor_task(void *pvParameters) {
         // Update system data
         update_system_data();
         
-        // Wait for next update interval
-        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(MONITOR_UPDATE_INTERVAL_MS));
+        // Tick for uptime labels (1 Hz by default), published even when the data is unchanged
+        ui_notify_publish(UI_TOPIC_CLOCK);
+        
+        // Wait for the next update; an interval change wakes the task and restarts the period
+        TickType_t interval = pdMS_TO_TICKS(atomic_load(&g_update_interval_ms));
+        TickType_t elapsed = xTaskGetTickCount() - last_wake_time;
+        if (elapsed < interval && ulTaskNotifyTake(pdTRUE, interval - elapsed) == 0) {
+            last_wake_time += interval;
+        } else {
+            last_wake_time = xTaskGetTickCount();
+        }
     }
     
     ESP_LOGI(TAG, "System monitor task stopped");
@@ -150,8 +188,10 @@ esp_err_t system_monitor_init(void) {
     }
     
     // Initialize system data
+    seqlock_init(&g_data_lock);
+    change_filter_reset_all(g_monitor_filter_state, MONITOR_METRIC_COUNT);
     memset(&g_system_data, 0, sizeof(system_data_t));
-    g_data_updated = false;  // Initialize data updated flag to false
+    atomic_store(&g_data_updated, false);  // Initialize data updated flag to false
     
     // Perform initial data update
     update_system_data();
@@ -170,16 +210,10 @@ esp_err_t system_monitor_start(void) {
     
     g_monitor_running = true;
     
-    BaseType_t ret = xTaskCreate(
-        system_monitor_task,
-        "sys_monitor",
-        MONITOR_TASK_STACK_SIZE,
-        NULL,
-        MONITOR_TASK_PRIORITY,
-        &g_monitor_task_handle
-    );
+    esp_err_t ret = task_placement_create(TASK_PLACEMENT_SYSTEM_MONITOR, system_monitor_task, NULL,
+                                          &g_monitor_task_handle);
     
-    if (ret != pdPASS) {
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create system monitor task");
         g_monitor_running = false;
         return ESP_FAIL;
@@ -201,6 +235,7 @@ esp_err_t system_monitor_stop(void) {
     
     // Wait for task to finish
     if (g_monitor_task_handle != NULL) {
+        xTaskNotifyGive(g_monitor_task_handle);
         while (g_monitor_task_handle != NULL) {
             vTaskDelay(pdMS_TO_TICKS(10));
         }
@@ -215,18 +250,9 @@ esp_err_t system_monitor_get_data(system_data_t *data) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (xSemaphoreTake(g_data_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        memcpy(data, &g_system_data, sizeof(system_data_t));
-        xSemaphoreGive(g_data_mutex);
-        return ESP_OK;
-    } else {
-        ESP_LOGW(TAG, "Failed to acquire mutex for data read");
-        return ESP_ERR_TIMEOUT;
-    }
-}
-
-const system_data_t* system_monitor_get_global_data(void) {
-    return &g_system_data;
+    // Lock-free: retries only if the monitor task published during the copy
+    seqlock_read_copy(&g_data_lock, data, &g_system_data, sizeof(system_data_t));
+    return ESP_OK;
 }
 
 esp_err_t system_monitor_update_now(void) {
@@ -234,22 +260,27 @@ esp_err_t system_monitor_update_now(void) {
     return ESP_OK;
 }
 
-bool system_monitor_is_data_updated(void) {
-    bool updated = false;
-    if (xSemaphoreTake(g_data_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        updated = g_data_updated;
-        // Atomically clear the flag to avoid race conditions
-        g_data_updated = false;
-        xSemaphoreGive(g_data_mutex);
+esp_err_t system_monitor_set_interval(uint32_t interval_ms) {
+    if (interval_ms < 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint32_t previous = atomic_exchange(&g_update_interval_ms, interval_ms);
+    TaskHandle_t task = g_monitor_task_handle;
+    if (previous != interval_ms && task != NULL) {
+        xTaskNotifyGive(task);  // Sample now and continue at the new rate
     }
-    return updated;
+    ESP_LOGD(TAG, "Update interval %"PRIu32" ms", interval_ms);
+    return ESP_OK;
+}
+
+bool system_monitor_is_data_updated(void) {
+    // Atomically read and clear the flag to avoid race conditions
+    return atomic_exchange(&g_data_updated, false);
 }
 
 void system_monitor_clear_updated_flag(void) {
-    if (xSemaphoreTake(g_data_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        g_data_updated = false;
-        xSemaphoreGive(g_data_mutex);
-    }
+    atomic_store(&g_data_updated, false);
 }
 
 esp_err_t system_monitor_deinit(void) {
@@ -265,8 +296,9 @@ esp_err_t system_monitor_deinit(void) {
     }
     
     // Clear global data
-    memset(&g_system_data, 0, sizeof(system_data_t));
-    g_data_updated = false;  // Reset data updated flag
+    system_data_t empty = {0};
+    seqlock_write_copy(&g_data_lock, &g_system_data, &empty, sizeof(system_data_t));
+    atomic_store(&g_data_updated, false);  // Reset data updated flag
     
     ESP_LOGI(TAG, "System monitor deinitialized");
     return ESP_OK;
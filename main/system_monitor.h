@@ -60,24 +60,28 @@ esp_err_t system_monitor_start(void);
 esp_err_t system_monitor_stop(void);
 
 /**
- * @brief Get current system data (thread-safe)
+ * @brief Get a consistent copy of the current system data (lock-free, task context)
  * @param data Pointer to system_data_t structure to fill
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if data is NULL
  */
 esp_err_t system_monitor_get_data(system_data_t *data);
 
-/**
- * @brief Get pointer to global system data (read-only, use with caution)
- * @return Pointer to global system data
- */
-const system_data_t* system_monitor_get_global_data(void);
-
 /**
  * @brief Force update system data immediately
  * @return ESP_OK on success
  */
 esp_err_t system_monitor_update_now(void);
 
+/**
+ * @brief Change the update interval (power modes lower the rate while the screen is dark)
+ * 
+ * The monitor task samples immediately and then continues at the new interval.
+ * 
+ * @param interval_ms Update interval, at least 100 ms
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the interval is too short
+ */
+esp_err_t system_monitor_set_interval(uint32_t interval_ms);
+
 /**
  * @brief Check if system data has been updated since last check
  * @return true if data has been updated, false otherwise
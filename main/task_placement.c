@@ -0,0 +1,76 @@
+/*
+ * Task Placement for M5StickC Plus 1.1
+ * Central table of core affinity, priority and stack size for every application task
+ */
+
+#include "task_placement.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
+
+static const char *TAG = "TASK_PLACEMENT";
+
+#define TASK_CORE(cfg)  (((cfg) < 0) ? tskNO_AFFINITY : (BaseType_t)(cfg))
+
+// Stack sizes are checked against the high-water marks on the Tasks subpage.
+// Names stay below configMAX_TASK_NAME_LEN so xTaskGetHandle() can find them.
+static const task_placement_t s_placement[TASK_PLACEMENT_COUNT] = {
+    [TASK_PLACEMENT_LVGL] = {
+        "LVGL", 4096, CONFIG_LVGL_TASK_PRIORITY, TASK_CORE(CONFIG_LVGL_TASK_CORE_ID)
+    },
+    [TASK_PLACEMENT_UX_SERVICE] = {
+        "ux_service_task", 3072, CONFIG_TASK_UX_SERVICE_PRIORITY, TASK_CORE(CONFIG_TASK_UX_SERVICE_CORE)
+    },
+    [TASK_PLACEMENT_SYSTEM_MONITOR] = {
+        "sys_monitor", 4096, CONFIG_TASK_SYSTEM_MONITOR_PRIORITY, TASK_CORE(CONFIG_TASK_SYSTEM_MONITOR_CORE)
+    },
+    [TASK_PLACEMENT_POWER_SAMPLER] = {
+        "power_sampler", 3072, CONFIG_TASK_POWER_SAMPLER_PRIORITY, TASK_CORE(CONFIG_TASK_POWER_SAMPLER_CORE)
+    },
+    [TASK_PLACEMENT_ESPNOW_RECV] = {
+        "espnow_recv", 6144, CONFIG_TASK_ESPNOW_RECV_PRIORITY, TASK_CORE(CONFIG_TASK_ESPNOW_RECV_CORE)
+    },
+    [TASK_PLACEMENT_ESPNOW_DISCOVERY] = {
+        "discovery", 4096, CONFIG_TASK_ESPNOW_DISCOVERY_PRIORITY, TASK_CORE(CONFIG_TASK_ESPNOW_DISCOVERY_CORE)
+    },
+    [TASK_PLACEMENT_ESPNOW_BENCH] = {
+        "espnow_bench", 4096, CONFIG_TASK_ESPNOW_BENCH_PRIORITY, TASK_CORE(CONFIG_TASK_ESPNOW_BENCH_CORE)
+    },
+    [TASK_PLACEMENT_TASK_MONITOR] = {
+        "task_monitor", 3072, CONFIG_TASK_MONITOR_PRIORITY, TASK_CORE(CONFIG_TASK_MONITOR_CORE)
+    },
+    [TASK_PLACEMENT_BOOT_RADIO] = {
+        "boot_radio", 4096, CONFIG_TASK_BOOT_RADIO_PRIORITY, TASK_CORE(CONFIG_TASK_BOOT_RADIO_CORE)
+    },
+    [TASK_PLACEMENT_DEVICE_STORE] = {
+        "dev_store", 3072, CONFIG_TASK_DEVICE_STORE_PRIORITY, TASK_CORE(CONFIG_TASK_DEVICE_STORE_CORE)
+    },
+};
+
+const task_placement_t *task_placement_get(task_placement_id_t id)
+{
+    if (id >= TASK_PLACEMENT_COUNT) {
+        return NULL;
+    }
+    return &s_placement[id];
+}
+
+esp_err_t task_placement_create(task_placement_id_t id, TaskFunction_t task_func, void *arg, TaskHandle_t *handle)
+{
+    const task_placement_t *placement = task_placement_get(id);
+    if (placement == NULL || task_func == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    BaseType_t ret = xTaskCreatePinnedToCore(task_func, placement->name, placement->stack_size, arg,
+                                             placement->priority, handle, placement->core);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create task %s (%" PRIu32 " bytes stack)", placement->name, placement->stack_size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Task %s: priority %u, core %d, %" PRIu32 " bytes stack", placement->name,
+             (unsigned)placement->priority, (placement->core == tskNO_AFFINITY) ? -1 : (int)placement->core,
+             placement->stack_size);
+    return ESP_OK;
+}
@@ -0,0 +1,68 @@
+/*
+ * Task Placement for M5StickC Plus 1.1
+ * Central table of core affinity, priority and stack size for every application task
+ */
+
+#ifndef TASK_PLACEMENT_H
+#define TASK_PLACEMENT_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Application tasks
+ *
+ * Wi-Fi runs on core 0. The default plan keeps the ESP-NOW tasks next to it,
+ * where their frames arrive, and moves UI and sampling work to core 1.
+ */
+typedef enum {
+    TASK_PLACEMENT_LVGL = 0,            // LVGL rendering and page logic
+    TASK_PLACEMENT_UX_SERVICE,          // LED/buzzer effect dispatch
+    TASK_PLACEMENT_SYSTEM_MONITOR,      // AXP192 system data polling
+    TASK_PLACEMENT_POWER_SAMPLER,       // High-rate power telemetry
+    TASK_PLACEMENT_ESPNOW_RECV,         // ESP-NOW frame decoding
+    TASK_PLACEMENT_ESPNOW_DISCOVERY,    // ESP-NOW discovery broadcasts
+    TASK_PLACEMENT_ESPNOW_BENCH,        // ESP-NOW benchmark sweep
+    TASK_PLACEMENT_TASK_MONITOR,        // Task profiler and periodic diagnostics log
+    TASK_PLACEMENT_BOOT_RADIO,          // One-shot Wi-Fi/ESP-NOW bring-up during boot
+    TASK_PLACEMENT_DEVICE_STORE,        // NVS writes of the device table
+    TASK_PLACEMENT_COUNT
+} task_placement_id_t;
+
+/**
+ * @brief Placement of one task
+ */
+typedef struct {
+    const char *name;                   // FreeRTOS task name
+    uint32_t stack_size;                // Stack size in bytes
+    UBaseType_t priority;               // FreeRTOS priority
+    BaseType_t core;                    // Core ID, or tskNO_AFFINITY
+} task_placement_t;
+
+/**
+ * @brief Get the placement of a task
+ * @return Table entry, NULL for an invalid ID
+ */
+const task_placement_t *task_placement_get(task_placement_id_t id);
+
+/**
+ * @brief Create a task with its name, stack, priority and core from the placement table
+ * @param id Task to create
+ * @param task_func Task function
+ * @param arg Task argument
+ * @param handle Created task handle (may be NULL)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid ID, ESP_ERR_NO_MEM if the task can't be created
+ */
+esp_err_t task_placement_create(task_placement_id_t id, TaskFunction_t task_func, void *arg, TaskHandle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PLACEMENT_H
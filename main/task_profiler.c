@@ -0,0 +1,175 @@
+/*
+ * Task Profiler for M5StickC Plus 1.1
+ * Per-task CPU load and stack high-water marks from FreeRTOS run time counters
+ */
+
+#include "task_profiler.h"
+#include "seqlock.h"
+#include "esp_log.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "TASK_PROFILER";
+
+#define TASK_PROFILER_STATUS_SLOTS  32      // uxTaskGetSystemState() fails if this is below the task count
+#define TASK_PROFILER_STACK_WARN    512     // Stack bytes left that flag a task in the log
+
+// Published snapshot, read lock-free by the UI
+static task_profiler_snapshot_t s_snapshot;
+static seqlock_t s_snapshot_lock = SEQLOCK_INIT;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+// Sampler state (task monitor only)
+static TaskStatus_t s_status[TASK_PROFILER_STATUS_SLOTS];
+static TaskHandle_t s_prev_handle[TASK_PROFILER_STATUS_SLOTS];
+static uint32_t s_prev_run_time[TASK_PROFILER_STATUS_SLOTS];
+static UBaseType_t s_prev_count = 0;
+static uint32_t s_prev_total = 0;
+static task_profiler_snapshot_t s_work;
+
+// Run time of a task at the previous sample; false for tasks created since
+static bool prev_run_time(TaskHandle_t handle, uint32_t *run_time)
+{
+    for (UBaseType_t i = 0; i < s_prev_count; i++) {
+        if (s_prev_handle[i] == handle) {
+            *run_time = s_prev_run_time[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint16_t share_permille(uint32_t part, uint32_t total)
+{
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t permille = ((uint64_t)part * 1000u + total / 2) / total;
+    return (uint16_t)((permille > 1000u) ? 1000u : permille);
+}
+#endif
+
+esp_err_t task_profiler_sample(void)
+{
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    uint32_t total = 0;
+    UBaseType_t count = uxTaskGetSystemState(s_status, TASK_PROFILER_STATUS_SLOTS, &total);
+    if (count == 0) {
+        ESP_LOGW(TAG, "⚠️ More than %d tasks, raise TASK_PROFILER_STATUS_SLOTS", TASK_PROFILER_STATUS_SLOTS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    bool have_interval = (s_work.samples > 0);
+    uint32_t interval = total - s_prev_total;   // Same clock as the task counters, wraps like them
+
+    memset(s_work.tasks, 0, sizeof(s_work.tasks));
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        s_work.core_load_permille[core] = 0;
+    }
+
+    // Insertion sort by CPU share keeps the busiest TASK_PROFILER_MAX_TASKS
+    uint8_t kept = 0;
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *status = &s_status[i];
+
+        uint16_t cpu = 0;
+        uint32_t before;
+        if (have_interval && prev_run_time(status->xHandle, &before)) {
+            cpu = share_permille(status->ulRunTimeCounter - before, interval);
+        }
+
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (status->xHandle == xTaskGetIdleTaskHandleForCore(core)) {
+                s_work.core_load_permille[core] = have_interval ? (uint16_t)(1000u - cpu) : 0;
+            }
+        }
+
+        int pos = kept;
+        while (pos > 0 && s_work.tasks[pos - 1].cpu_permille < cpu) {
+            pos--;
+        }
+        if (pos >= TASK_PROFILER_MAX_TASKS) {
+            continue;
+        }
+        int last = (kept < TASK_PROFILER_MAX_TASKS) ? kept : TASK_PROFILER_MAX_TASKS - 1;
+        memmove(&s_work.tasks[pos + 1], &s_work.tasks[pos], (size_t)(last - pos) * sizeof(s_work.tasks[0]));
+        if (kept < TASK_PROFILER_MAX_TASKS) {
+            kept++;
+        }
+
+        task_profiler_task_t *task = &s_work.tasks[pos];
+        strncpy(task->name, status->pcTaskName, sizeof(task->name) - 1);
+        task->name[sizeof(task->name) - 1] = '\0';
+        BaseType_t core = xTaskGetCoreID(status->xHandle);
+        task->core = (core == tskNO_AFFINITY) ? TASK_PROFILER_NO_AFFINITY : (uint8_t)core;
+        task->priority = (uint8_t)status->uxCurrentPriority;
+        task->cpu_permille = cpu;
+        task->stack_free_min = status->usStackHighWaterMark;    // Bytes on ESP-IDF
+    }
+
+    // Remember the counters for the next interval
+    for (UBaseType_t i = 0; i < count; i++) {
+        s_prev_handle[i] = s_status[i].xHandle;
+        s_prev_run_time[i] = s_status[i].ulRunTimeCounter;
+    }
+    s_prev_count = count;
+    s_prev_total = total;
+
+    s_work.samples++;
+    s_work.interval_us = have_interval ? interval : 0;
+    s_work.task_count = kept;
+    s_work.total_tasks = (uint8_t)count;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    s_work.run_time_stats = have_interval;
+#else
+    s_work.run_time_stats = false;
+#endif
+
+    seqlock_write_copy(&s_snapshot_lock, &s_snapshot, &s_work, sizeof(s_snapshot));
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t task_profiler_get_snapshot(task_profiler_snapshot_t *snapshot)
+{
+    if (snapshot == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    seqlock_read_copy(&s_snapshot_lock, snapshot, &s_snapshot, sizeof(*snapshot));
+    return ESP_OK;
+}
+
+void task_profiler_log(void)
+{
+    static task_profiler_snapshot_t snapshot;   // Too large for the task monitor stack
+    task_profiler_get_snapshot(&snapshot);
+
+    if (snapshot.samples == 0) {
+        ESP_LOGI(TAG, "No task profile yet (needs CONFIG_FREERTOS_USE_TRACE_FACILITY)");
+        return;
+    }
+
+    if (snapshot.run_time_stats) {
+        ESP_LOGI(TAG, "=== Task Profile (%" PRIu32 " ms, %u tasks) CPU0 %u.%u%% CPU1 %u.%u%% ===",
+                 snapshot.interval_us / 1000, snapshot.total_tasks,
+                 snapshot.core_load_permille[0] / 10, snapshot.core_load_permille[0] % 10,
+                 snapshot.core_load_permille[portNUM_PROCESSORS - 1] / 10,
+                 snapshot.core_load_permille[portNUM_PROCESSORS - 1] % 10);
+    } else {
+        ESP_LOGI(TAG, "=== Task Profile (%u tasks, no run time stats) ===", snapshot.total_tasks);
+    }
+
+    for (int i = 0; i < snapshot.task_count; i++) {
+        const task_profiler_task_t *task = &snapshot.tasks[i];
+        char core = (task->core == TASK_PROFILER_NO_AFFINITY) ? '-' : (char)('0' + task->core);
+        ESP_LOGI(TAG, "%s %-16s core %c prio %2u cpu %3u.%u%% stack free %5" PRIu32,
+                 (task->stack_free_min < TASK_PROFILER_STACK_WARN) ? "⚠️" : "  ",
+                 task->name, core, task->priority, task->cpu_permille / 10, task->cpu_permille % 10,
+                 task->stack_free_min);
+    }
+}
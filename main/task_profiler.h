@@ -0,0 +1,72 @@
+/*
+ * Task Profiler for M5StickC Plus 1.1
+ * Per-task CPU load and stack high-water marks from FreeRTOS run time counters
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_PROFILER_MAX_TASKS     24      // Tasks tracked per sample, busiest first
+#define TASK_PROFILER_NAME_LEN      16      // Stored task name length including terminator
+#define TASK_PROFILER_NO_AFFINITY   0xFF    // Core value of unpinned tasks
+
+/**
+ * @brief Profile of one task over the last sample interval
+ */
+typedef struct {
+    char name[TASK_PROFILER_NAME_LEN];
+    uint8_t core;                   // Pinned core, or TASK_PROFILER_NO_AFFINITY
+    uint8_t priority;               // Current priority
+    uint16_t cpu_permille;          // Share of one core, 0.1% steps
+    uint32_t stack_free_min;        // Stack bytes never used since the task started
+} task_profiler_task_t;
+
+/**
+ * @brief Task profiler snapshot
+ */
+typedef struct {
+    uint32_t samples;               // Samples taken since boot
+    uint32_t interval_us;           // Length of the last sample interval (run time clock, esp_timer by default)
+    uint16_t core_load_permille[portNUM_PROCESSORS];   // 1000 minus the core's idle task share
+    uint8_t task_count;             // Tasks in tasks[] (all tasks if not truncated)
+    uint8_t total_tasks;            // Tasks alive at the last sample
+    bool run_time_stats;            // CPU figures valid (run time counters enabled)
+    task_profiler_task_t tasks[TASK_PROFILER_MAX_TASKS];    // Sorted by cpu_permille, busiest first
+} task_profiler_snapshot_t;
+
+/**
+ * @brief Take a sample and publish a new snapshot (one sampling task only)
+ *
+ * CPU shares are computed against the previous sample, so the first sample
+ * only reports stacks.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_FREERTOS_USE_TRACE_FACILITY
+ */
+esp_err_t task_profiler_sample(void);
+
+/**
+ * @brief Get a consistent copy of the last snapshot (never blocks the sampler)
+ * @param snapshot Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on NULL
+ */
+esp_err_t task_profiler_get_snapshot(task_profiler_snapshot_t *snapshot);
+
+/**
+ * @brief Log the last snapshot as a table
+ */
+void task_profiler_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PROFILER_H
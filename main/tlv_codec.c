@@ -0,0 +1,348 @@
+/*
+ * TLV Codec for M5StickC Plus 1.1
+ * Target-independent decoder/encoder of the ESPHome TLV payload (no ESP-IDF dependencies)
+ */
+
+#include "tlv_codec.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+const tlv_field_desc_t tlv_codec_fields[TLV_CODEC_FIELD_COUNT] = {
+    { TLV_TYPE_UPTIME,          TLV_ENC_U32,    TLV_SIZE_UPTIME,          TLV_NUM_UPTIME,          1.0f,           0, "s"   },
+    { TLV_TYPE_TIMESTAMP,       TLV_ENC_U32,    TLV_SIZE_TIMESTAMP,       TLV_NUM_TIMESTAMP,       1.0f,           0, ""    },
+    { TLV_TYPE_FREE_MEMORY,     TLV_ENC_U32,    TLV_SIZE_UINT32,          TLV_NUM_FREE_MEMORY,     1.0f / 1024.0f, 1, "KB"  },
+    { TLV_TYPE_AC_VOLTAGE,      TLV_ENC_F32,    TLV_SIZE_AC_VOLTAGE,      TLV_NUM_AC_VOLTAGE,      1.0f,           1, "V"   },
+    { TLV_TYPE_AC_CURRENT,      TLV_ENC_I32,    TLV_SIZE_AC_CURRENT,      TLV_NUM_AC_CURRENT,      0.001f,         3, "A"   },
+    { TLV_TYPE_AC_FREQUENCY,    TLV_ENC_F32,    TLV_SIZE_AC_FREQUENCY,    TLV_NUM_AC_FREQUENCY,    1.0f,           2, "Hz"  },
+    { TLV_TYPE_AC_POWER,        TLV_ENC_I32,    TLV_SIZE_AC_POWER,        TLV_NUM_AC_POWER,        0.001f,         3, "W"   },
+    { TLV_TYPE_AC_POWER_FACTOR, TLV_ENC_F32,    TLV_SIZE_AC_POWER_FACTOR, TLV_NUM_AC_POWER_FACTOR, 1.0f,           3, ""    },
+    { TLV_TYPE_ENERGY_TOTAL,    TLV_ENC_F32,    TLV_SIZE_ENERGY_TOTAL,    TLV_NUM_ENERGY_TOTAL,    1.0f,           3, "kWh" },
+    { TLV_TYPE_ENERGY_TODAY,    TLV_ENC_F32,    TLV_SIZE_ENERGY_TODAY,    TLV_NUM_ENERGY_TODAY,    1.0f,           3, "kWh" },
+    { TLV_TYPE_STATUS_FLAGS,    TLV_ENC_U16,    TLV_SIZE_STATUS_FLAGS,    TLV_NUM_STATUS_FLAGS,    1.0f,           0, ""    },
+    { TLV_TYPE_ERROR_CODE,      TLV_ENC_U16,    TLV_SIZE_ERROR_CODE,      TLV_NUM_ERROR_CODE,      1.0f,           0, ""    },
+    { TLV_TYPE_TEMPERATURE,     TLV_ENC_F32,    TLV_SIZE_TEMPERATURE,     TLV_NUM_TEMPERATURE,     1.0f,           1, "C"   },
+    { TLV_TYPE_HUMIDITY,        TLV_ENC_F32,    TLV_SIZE_HUMIDITY,        TLV_NUM_HUMIDITY,        1.0f,           1, "%"   },
+    { TLV_TYPE_BATTERY_VOLTAGE, TLV_ENC_F32,    TLV_SIZE_BATTERY_VOLTAGE, TLV_NUM_BATTERY_VOLTAGE, 1.0f,           2, "V"   },
+    { TLV_TYPE_BATTERY_LEVEL,   TLV_ENC_U16,    TLV_SIZE_BATTERY_LEVEL,   TLV_NUM_BATTERY_LEVEL,   1.0f,           0, "%"   },
+    { TLV_TYPE_BATTERY_CURRENT, TLV_ENC_I32,    TLV_SIZE_BATTERY_CURRENT, TLV_NUM_BATTERY_CURRENT, 0.001f,         3, "A"   },
+    { TLV_TYPE_VBUS_VOLTAGE,    TLV_ENC_F32,    TLV_SIZE_VBUS_VOLTAGE,    TLV_NUM_VBUS_VOLTAGE,    1.0f,           2, "V"   },
+    { TLV_TYPE_DEVICE_ID,       TLV_ENC_STRING, 31,                       TLV_BLOB_DEVICE_ID,      1.0f,           0, ""    },
+    { TLV_TYPE_FIRMWARE_VER,    TLV_ENC_STRING, TLV_MAX_FIRMWARE_VER_LEN, TLV_BLOB_FIRMWARE_VER,   1.0f,           0, ""    },
+    { TLV_TYPE_COMPILE_TIME,    TLV_ENC_STRING, TLV_MAX_COMPILE_TIME_LEN, TLV_BLOB_COMPILE_TIME,   1.0f,           0, ""    },
+    { TLV_TYPE_MAC_ADDRESS,     TLV_ENC_BYTES,  TLV_SIZE_MAC_ADDRESS,     TLV_BLOB_MAC_ADDRESS,    1.0f,           0, ""    },
+};
+
+_Static_assert(sizeof(tlv_codec_fields) / sizeof(tlv_codec_fields[0]) == TLV_NUM_FIELD_COUNT + TLV_BLOB_KNOWN_COUNT,
+               "Every numeric field and known blob needs a descriptor");
+
+// TLV type -> index into tlv_codec_fields plus one; 0 (also the zeroed state) means unknown
+static uint8_t s_type_map[256];
+static bool s_type_map_ready = false;
+
+void tlv_codec_init(void)
+{
+    if (s_type_map_ready) {
+        return;
+    }
+    for (size_t i = 0; i < TLV_CODEC_FIELD_COUNT; i++) {
+        s_type_map[tlv_codec_fields[i].type] = (uint8_t)(i + 1);
+    }
+    s_type_map_ready = true;
+}
+
+const tlv_field_desc_t *tlv_codec_find_field(uint8_t type)
+{
+    if (!s_type_map_ready) {
+        tlv_codec_init();
+    }
+    uint8_t slot = s_type_map[type];
+    return (slot == 0) ? NULL : &tlv_codec_fields[slot - 1];
+}
+
+int tlv_codec_decode(const uint8_t *data, size_t data_len, tlv_decoded_entry_t *entries, int max_entries,
+                     tlv_decode_result_t *result)
+{
+    tlv_decode_result_t local;
+    tlv_decode_result_t *res = (result != NULL) ? result : &local;
+    size_t offset = 0;
+    int count = 0;
+
+    res->stop = TLV_DECODE_COMPLETE;
+    res->entry_size = 0;
+
+    while (offset < data_len) {
+        // Check if we have at least 2 bytes for type and length
+        if (offset + 2 > data_len) {
+            res->stop = TLV_DECODE_SHORT_HEADER;
+            break;
+        }
+
+        uint8_t type = data[offset];
+        uint8_t length = data[offset + 1];
+
+        // Validate TLV entry bounds
+        size_t total_entry_size = TLV_TOTAL_SIZE(length);
+        if (offset + total_entry_size > data_len) {
+            res->stop = TLV_DECODE_OVERRUN;
+            res->entry_size = total_entry_size;
+            break;
+        }
+
+        if (count >= max_entries) {
+            res->stop = TLV_DECODE_ENTRY_LIMIT;
+            break;
+        }
+
+        tlv_decoded_entry_t *entry = &entries[count++];
+        entry->desc = tlv_codec_find_field(type);
+        entry->value = &data[offset + 2];
+        entry->offset = (uint16_t)offset;
+        entry->type = type;
+        entry->length = length;
+        entry->raw = 0;
+        entry->valid = true;
+
+        if (entry->desc != NULL) {
+            if (TLV_ENC_IS_NUMERIC(entry->desc->encoding)) {
+                entry->valid = (length == entry->desc->size);
+                if (entry->valid) {
+                    entry->raw = (entry->desc->encoding == TLV_ENC_U16) ?
+                        (uint32_t)TLV_UINT16_FROM_BE(entry->value) : TLV_UINT32_FROM_BE(entry->value);
+                }
+            } else {
+                entry->valid = (length <= entry->desc->size);
+            }
+        }
+
+        offset += total_entry_size;
+    }
+
+    res->offset = offset;
+    return count;
+}
+
+void tlv_builder_init(tlv_builder_t *builder, uint8_t *buf, size_t capacity)
+{
+    builder->buf = buf;
+    builder->capacity = capacity;
+    builder->len = 0;
+    builder->overflow = false;
+}
+
+/**
+ * @brief Write the header of the next entry and return where its value goes
+ * @return Value pointer, NULL if the entry does not fit
+ */
+static uint8_t *tlv_builder_reserve(tlv_builder_t *builder, uint8_t type, size_t length)
+{
+    if (builder->overflow || length > UINT8_MAX ||
+        TLV_TOTAL_SIZE(length) > builder->capacity - builder->len) {
+        builder->overflow = true;
+        return NULL;
+    }
+
+    uint8_t *out = &builder->buf[builder->len];
+    out[0] = type;
+    out[1] = (uint8_t)length;
+    builder->len += TLV_TOTAL_SIZE(length);
+    return &out[2];
+}
+
+bool tlv_builder_put_u16(tlv_builder_t *builder, uint8_t type, uint16_t value)
+{
+    uint8_t *out = tlv_builder_reserve(builder, type, TLV_SIZE_UINT16);
+    if (out == NULL) {
+        return false;
+    }
+    TLV_UINT16_TO_BE(value, out);
+    return true;
+}
+
+bool tlv_builder_put_u32(tlv_builder_t *builder, uint8_t type, uint32_t value)
+{
+    uint8_t *out = tlv_builder_reserve(builder, type, TLV_SIZE_UINT32);
+    if (out == NULL) {
+        return false;
+    }
+    TLV_UINT32_TO_BE(value, out);
+    return true;
+}
+
+bool tlv_builder_put_i32(tlv_builder_t *builder, uint8_t type, int32_t value)
+{
+    return tlv_builder_put_u32(builder, type, (uint32_t)value);
+}
+
+bool tlv_builder_put_f32(tlv_builder_t *builder, uint8_t type, float value)
+{
+    uint8_t *out = tlv_builder_reserve(builder, type, TLV_SIZE_FLOAT32);
+    if (out == NULL) {
+        return false;
+    }
+    TLV_FLOAT32_TO_BE(value, out);
+    return true;
+}
+
+bool tlv_builder_put_bytes(tlv_builder_t *builder, uint8_t type, const void *value, size_t length)
+{
+    uint8_t *out = tlv_builder_reserve(builder, type, length);
+    if (out == NULL) {
+        return false;
+    }
+    if (length > 0) {
+        memcpy(out, value, length);
+    }
+    return true;
+}
+
+bool tlv_builder_put_string(tlv_builder_t *builder, uint8_t type, const char *value, size_t max_length)
+{
+    size_t length = strnlen(value, max_length);
+    return tlv_builder_put_bytes(builder, type, value, length);
+}
+
+size_t tlv_codec_encode_entry(const tlv_decoded_entry_t *entry, uint8_t *out, size_t out_size)
+{
+    size_t total = TLV_TOTAL_SIZE(entry->length);
+    if (total > out_size) {
+        return 0;
+    }
+
+    out[0] = entry->type;
+    out[1] = entry->length;
+    const tlv_field_desc_t *desc = entry->desc;
+    if (desc != NULL && TLV_ENC_IS_NUMERIC(desc->encoding) && entry->length == desc->size) {
+        if (desc->encoding == TLV_ENC_U16) {
+            TLV_UINT16_TO_BE(entry->raw, &out[2]);
+        } else {
+            TLV_UINT32_TO_BE(entry->raw, &out[2]);
+        }
+    } else if (entry->length > 0) {
+        memcpy(&out[2], entry->value, entry->length);
+    }
+    return total;
+}
+
+float tlv_codec_scaled_value(const tlv_field_desc_t *desc, uint32_t raw)
+{
+    float value;
+    switch (desc->encoding) {
+        case TLV_ENC_F32:
+            memcpy(&value, &raw, sizeof(value));
+            break;
+        case TLV_ENC_I32:
+            value = (float)(int32_t)raw;
+            break;
+        default:
+            value = (float)raw;
+            break;
+    }
+    return value * desc->scale;
+}
+
+const char *tlv_codec_type_name(uint8_t type)
+{
+    switch (type) {
+        // Basic Types (0x00-0x0F)
+        case TLV_TYPE_UPTIME:          return "UPTIME";
+        case TLV_TYPE_TIMESTAMP:       return "TIMESTAMP";
+        case TLV_TYPE_DEVICE_ID:       return "DEVICE_ID";
+        case TLV_TYPE_FIRMWARE_VER:    return "FIRMWARE_VER";
+        case TLV_TYPE_MAC_ADDRESS:     return "MAC_ADDRESS";
+        case TLV_TYPE_COMPILE_TIME:    return "COMPILE_TIME";
+        case TLV_TYPE_FREE_MEMORY:     return "FREE_MEMORY";
+
+        // Electrical Measurements (0x10-0x2F)
+        case TLV_TYPE_AC_VOLTAGE:      return "AC_VOLTAGE";
+        case TLV_TYPE_AC_CURRENT:      return "AC_CURRENT";
+        case TLV_TYPE_AC_FREQUENCY:    return "AC_FREQUENCY";
+        case TLV_TYPE_AC_POWER:        return "AC_POWER";
+        case TLV_TYPE_AC_POWER_FACTOR: return "AC_POWER_FACTOR";
+
+        // Energy Measurements (0x30-0x4F)
+        case TLV_TYPE_ENERGY_TOTAL:    return "ENERGY_TOTAL";
+        case TLV_TYPE_ENERGY_TODAY:    return "ENERGY_TODAY";
+
+        // Status and Flags (0x50-0x6F)
+        case TLV_TYPE_STATUS_FLAGS:    return "STATUS_FLAGS";
+        case TLV_TYPE_ERROR_CODE:      return "ERROR_CODE";
+
+        // Environmental (0x70-0x8F)
+        case TLV_TYPE_TEMPERATURE:     return "TEMPERATURE";
+        case TLV_TYPE_HUMIDITY:        return "HUMIDITY";
+
+        // Power Supply (0x90-0xAF)
+        case TLV_TYPE_BATTERY_VOLTAGE: return "BATTERY_VOLTAGE";
+        case TLV_TYPE_BATTERY_LEVEL:   return "BATTERY_LEVEL";
+        case TLV_TYPE_BATTERY_CURRENT: return "BATTERY_CURRENT";
+        case TLV_TYPE_VBUS_VOLTAGE:    return "VBUS_VOLTAGE";
+
+        default:
+            if (type >= TLV_TYPE_CUSTOM_START) {
+                return "CUSTOM";
+            }
+            return "UNKNOWN";
+    }
+}
+
+void tlv_codec_format_entry(const tlv_decoded_entry_t *entry, char *out, size_t out_size)
+{
+    const tlv_field_desc_t *desc = entry->desc;
+
+    out[0] = '\0';
+    if (entry->length == 0) {
+        snprintf(out, out_size, "(empty)");
+        return;
+    }
+    if (desc == NULL) {
+        snprintf(out, out_size, "Raw data (%d bytes)", entry->length);
+        return;
+    }
+    if (!entry->valid) {
+        snprintf(out, out_size, "Invalid length (expected %d)", desc->size);
+        return;
+    }
+
+    switch (desc->encoding) {
+        case TLV_ENC_U16:
+        case TLV_ENC_U32:
+        case TLV_ENC_I32:
+            if (desc->scale != 1.0f) {
+                snprintf(out, out_size, "%.*f %s (raw %" PRId32 ")", desc->decimals,
+                         tlv_codec_scaled_value(desc, entry->raw), desc->unit, (int32_t)entry->raw);
+            } else if (desc->type == TLV_TYPE_STATUS_FLAGS) {
+                uint16_t flags = (uint16_t)entry->raw;
+                char flag_details[64] = {0};
+                if (flags & STATUS_FLAG_POWER_ON) strcat(flag_details, "PWR ");
+                if (flags & STATUS_FLAG_WIFI_CONNECTED) strcat(flag_details, "WIFI ");
+                if (flags & STATUS_FLAG_ESP_NOW_ACTIVE) strcat(flag_details, "ESPNOW ");
+                if (flags & STATUS_FLAG_ERROR) strcat(flag_details, "ERR ");
+                if (flags & STATUS_FLAG_LOW_BATTERY) strcat(flag_details, "LOWBAT ");
+                if (flags & STATUS_FLAG_CHARGING) strcat(flag_details, "CHG ");
+                if (flags & STATUS_FLAG_USB_POWERED) strcat(flag_details, "USB ");
+                snprintf(out, out_size, "0x%04X (%s)", flags, flag_details);
+            } else {
+                snprintf(out, out_size, "%" PRIu32 " %s", entry->raw, desc->unit);
+            }
+            break;
+
+        case TLV_ENC_F32:
+            snprintf(out, out_size, "%.*f %s", desc->decimals, tlv_codec_scaled_value(desc, entry->raw), desc->unit);
+            break;
+
+        case TLV_ENC_STRING:
+            snprintf(out, out_size, "Text: \"%.*s\"", entry->length, (const char *)entry->value);
+            break;
+
+        default:
+            if (desc->type == TLV_TYPE_MAC_ADDRESS && entry->length == TLV_SIZE_MAC_ADDRESS) {
+                const uint8_t *mac = entry->value;
+                snprintf(out, out_size, "MAC: %02x:%02x:%02x:%02x:%02x:%02x",
+                         mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            } else {
+                snprintf(out, out_size, "Raw data (%d bytes)", entry->length);
+            }
+            break;
+    }
+}
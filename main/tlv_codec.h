@@ -0,0 +1,210 @@
+/*
+ * TLV Codec for M5StickC Plus 1.1
+ * Target-independent decoder/encoder of the ESPHome TLV payload (no ESP-IDF dependencies)
+ */
+
+#ifndef TLV_CODEC_H
+#define TLV_CODEC_H
+
+#include "esphome_tlv_format.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-size numeric TLVs (storage column of tlv_field_desc_t.index)
+typedef enum {
+    TLV_NUM_UPTIME = 0,
+    TLV_NUM_TIMESTAMP,
+    TLV_NUM_FREE_MEMORY,
+    TLV_NUM_AC_VOLTAGE,
+    TLV_NUM_AC_CURRENT,
+    TLV_NUM_AC_FREQUENCY,
+    TLV_NUM_AC_POWER,
+    TLV_NUM_AC_POWER_FACTOR,
+    TLV_NUM_ENERGY_TOTAL,
+    TLV_NUM_ENERGY_TODAY,
+    TLV_NUM_STATUS_FLAGS,
+    TLV_NUM_ERROR_CODE,
+    TLV_NUM_TEMPERATURE,
+    TLV_NUM_HUMIDITY,
+    TLV_NUM_BATTERY_VOLTAGE,
+    TLV_NUM_BATTERY_LEVEL,
+    TLV_NUM_BATTERY_CURRENT,
+    TLV_NUM_VBUS_VOLTAGE,
+    TLV_NUM_FIELD_COUNT
+} tlv_numeric_field_t;
+
+// Known byte-string TLVs (storage slot of tlv_field_desc_t.index)
+typedef enum {
+    TLV_BLOB_DEVICE_ID = 0,
+    TLV_BLOB_FIRMWARE_VER,
+    TLV_BLOB_COMPILE_TIME,
+    TLV_BLOB_MAC_ADDRESS,
+    TLV_BLOB_KNOWN_COUNT
+} tlv_blob_field_t;
+
+// Wire encoding of a TLV value (multi-byte values are big-endian)
+typedef enum {
+    TLV_ENC_U16 = 0,
+    TLV_ENC_U32,
+    TLV_ENC_I32,
+    TLV_ENC_F32,
+    TLV_ENC_STRING,                 // Byte strings from here on
+    TLV_ENC_BYTES,
+} tlv_encoding_t;
+
+#define TLV_ENC_IS_NUMERIC(enc) ((enc) < TLV_ENC_STRING)
+
+/**
+ * @brief Descriptor of a known TLV type
+ */
+typedef struct {
+    uint8_t type;                   // TLV_TYPE_*
+    uint8_t encoding;               // tlv_encoding_t
+    uint8_t size;                   // Exact wire length (numeric) or maximum length (string/bytes)
+    uint8_t index;                  // tlv_numeric_field_t or tlv_blob_field_t
+    float scale;                    // Applied to numeric values on decode (mA -> A, mW -> W, B -> KB)
+    uint8_t decimals;               // Precision for the pretty-printer
+    const char *unit;               // Unit for the pretty-printer
+} tlv_field_desc_t;
+
+#define TLV_CODEC_FIELD_COUNT   22  // Entries of tlv_codec_fields
+
+extern const tlv_field_desc_t tlv_codec_fields[TLV_CODEC_FIELD_COUNT];
+
+/**
+ * @brief One TLV as produced by tlv_codec_decode(); value points into the source buffer
+ */
+typedef struct {
+    const tlv_field_desc_t *desc;   // Descriptor, NULL for unknown/custom types
+    const uint8_t *value;           // Raw value bytes
+    uint16_t offset;                // Offset of the TLV header in the packet
+    uint8_t type;                   // TLV type
+    uint8_t length;                 // TLV value length
+    bool valid;                     // False if a known type arrived with the wrong length
+    uint32_t raw;                   // Host-order value of numeric types (IEEE754 bits for F32)
+} tlv_decoded_entry_t;
+
+/**
+ * @brief Why tlv_codec_decode() stopped
+ */
+typedef enum {
+    TLV_DECODE_COMPLETE = 0,        // Consumed the whole buffer
+    TLV_DECODE_SHORT_HEADER,        // Fewer than 2 bytes left for a header
+    TLV_DECODE_OVERRUN,             // Value length runs past the buffer
+    TLV_DECODE_ENTRY_LIMIT,         // max_entries decoded, data left
+} tlv_decode_stop_t;
+
+/**
+ * @brief Decode result details
+ */
+typedef struct {
+    tlv_decode_stop_t stop;
+    size_t offset;                  // Offset of the entry decoding stopped at
+    size_t entry_size;              // TLV_DECODE_OVERRUN: header plus declared value length
+} tlv_decode_result_t;
+
+/**
+ * @brief Build the type lookup (idempotent); the first lookup builds it if this was not called
+ */
+void tlv_codec_init(void);
+
+/**
+ * @brief Look up the descriptor of a known TLV type
+ * @return Descriptor, or NULL for unknown/custom types
+ */
+const tlv_field_desc_t *tlv_codec_find_field(uint8_t type);
+
+/**
+ * @brief Decode a TLV buffer into typed entries in a single pass
+ *
+ * Bounds are validated once per entry and numeric values of known types are
+ * converted from big-endian to host order. Nothing is allocated; entries
+ * point into data.
+ *
+ * @param data TLV bytes
+ * @param data_len Length of data
+ * @param entries Output array
+ * @param max_entries Capacity of entries
+ * @param result Optional output, why decoding stopped
+ * @return Number of entries written to entries
+ */
+int tlv_codec_decode(const uint8_t *data, size_t data_len, tlv_decoded_entry_t *entries, int max_entries,
+                     tlv_decode_result_t *result);
+
+/**
+ * @brief Encode one entry in wire format (numeric values from raw, others from value)
+ * @param out Output buffer
+ * @param out_size Capacity of out
+ * @return Bytes written, 0 if out is too small
+ */
+size_t tlv_codec_encode_entry(const tlv_decoded_entry_t *entry, uint8_t *out, size_t out_size);
+
+/**
+ * @brief In-place TLV writer over a caller-owned buffer
+ *
+ * Values are written straight into the buffer in wire format; nothing is
+ * allocated or copied afterwards. An entry that does not fit is left out and
+ * sets overflow, after which every further put is refused, so the buffer
+ * always holds a complete prefix of the entries in call order.
+ */
+typedef struct {
+    uint8_t *buf;                   // Output buffer
+    size_t capacity;                // Size of buf
+    size_t len;                     // Bytes written so far
+    bool overflow;                  // An entry did not fit
+} tlv_builder_t;
+
+/**
+ * @brief Start writing at the beginning of buf
+ */
+void tlv_builder_init(tlv_builder_t *builder, uint8_t *buf, size_t capacity);
+
+/**
+ * @brief Append a numeric TLV (big-endian, IEEE754 for float)
+ * @return true if the entry was written
+ */
+bool tlv_builder_put_u16(tlv_builder_t *builder, uint8_t type, uint16_t value);
+bool tlv_builder_put_u32(tlv_builder_t *builder, uint8_t type, uint32_t value);
+bool tlv_builder_put_i32(tlv_builder_t *builder, uint8_t type, int32_t value);
+bool tlv_builder_put_f32(tlv_builder_t *builder, uint8_t type, float value);
+
+/**
+ * @brief Append a byte-string TLV
+ * @param value Value bytes, may be NULL if length is 0
+ * @param length Value length, at most 255
+ * @return true if the entry was written
+ */
+bool tlv_builder_put_bytes(tlv_builder_t *builder, uint8_t type, const void *value, size_t length);
+
+/**
+ * @brief Append a string TLV without its terminator
+ * @param max_length Longer strings are truncated to this many bytes
+ * @return true if the entry was written
+ */
+bool tlv_builder_put_string(tlv_builder_t *builder, uint8_t type, const char *value, size_t max_length);
+
+/**
+ * @brief Convert a host-order numeric value to its scaled physical value
+ */
+float tlv_codec_scaled_value(const tlv_field_desc_t *desc, uint32_t raw);
+
+/**
+ * @brief Name of a TLV type ("AC_POWER", "CUSTOM", "UNKNOWN", ...)
+ */
+const char *tlv_codec_type_name(uint8_t type);
+
+/**
+ * @brief Format a decoded TLV value as a one-line description
+ */
+void tlv_codec_format_entry(const tlv_decoded_entry_t *entry, char *out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLV_CODEC_H
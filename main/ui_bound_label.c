@@ -0,0 +1,164 @@
+/*
+ * Bound Label Layer for M5StickC Plus 1.1
+ * Caches the last rendered value of a label so unchanged refreshes skip LVGL
+ */
+
+#include "ui_bound_label.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Longest text formatted by ui_bound_label_set_fmt()/set_int()
+#define UI_BOUND_LABEL_TEXT_MAX 80
+
+// Statistics (LVGL task only, like the labels themselves)
+static uint32_t s_rendered = 0;
+static uint32_t s_skipped = 0;
+static uint32_t s_opaque = 0;
+
+static bool areas_overlap(const lv_area_t *a, const lv_area_t *b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+// Nearest ancestor that paints a solid background under the label
+static lv_obj_t *opaque_ancestor(lv_obj_t *label)
+{
+    for (lv_obj_t *obj = lv_obj_get_parent(label); obj != NULL; obj = lv_obj_get_parent(obj)) {
+        if (lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) >= LV_OPA_COVER) {
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+// A sibling drawn before the label shows through it, so the label can't cover its area
+static bool earlier_sibling_overlaps(lv_obj_t *label)
+{
+    lv_obj_t *parent = lv_obj_get_parent(label);
+    if (parent == NULL) {
+        return false;
+    }
+
+    lv_area_t label_area;
+    lv_obj_get_coords(label, &label_area);
+
+    int32_t index = lv_obj_get_index(label);
+    for (int32_t i = 0; i < index; i++) {
+        lv_obj_t *sibling = lv_obj_get_child(parent, i);
+        if (sibling == NULL || lv_obj_has_flag(sibling, LV_OBJ_FLAG_HIDDEN)) {
+            continue;
+        }
+        lv_area_t sibling_area;
+        lv_obj_get_coords(sibling, &sibling_area);
+        if (areas_overlap(&label_area, &sibling_area)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ui_bound_label_bind(ui_bound_label_t *bound, lv_obj_t *label)
+{
+    if (bound == NULL) {
+        return;
+    }
+    bound->label = label;
+    bound->last_value = 0;
+    bound->value_valid = false;
+    bound->opaque = false;
+
+    if (label != NULL) {
+        // Positions are needed for the overlap check
+        lv_obj_update_layout(label);
+        if (!earlier_sibling_overlaps(label) && opaque_ancestor(label) != NULL) {
+            bound->opaque = true;
+            ui_bound_label_match_background(bound);
+            s_opaque++;
+        }
+    }
+}
+
+void ui_bound_label_match_background(ui_bound_label_t *bound)
+{
+    if (bound == NULL || bound->label == NULL || !bound->opaque) {
+        return;
+    }
+
+    lv_obj_t *ancestor = opaque_ancestor(bound->label);
+    if (ancestor == NULL) {
+        return;
+    }
+    lv_obj_set_style_bg_color(bound->label, lv_obj_get_style_bg_color(ancestor, LV_PART_MAIN), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(bound->label, LV_OPA_COVER, LV_PART_MAIN);
+}
+
+void ui_bound_label_unbind(ui_bound_label_t *bound)
+{
+    ui_bound_label_bind(bound, NULL);
+}
+
+bool ui_bound_label_set_text(ui_bound_label_t *bound, const char *text)
+{
+    if (bound == NULL || bound->label == NULL || text == NULL) {
+        return false;
+    }
+
+    // The label keeps its own copy of the text, which is the cached value
+    const char *current = lv_label_get_text(bound->label);
+    if (current != NULL && strcmp(current, text) == 0) {
+        s_skipped++;
+        return false;
+    }
+
+    lv_label_set_text(bound->label, text);
+    bound->value_valid = false;
+    s_rendered++;
+    return true;
+}
+
+bool ui_bound_label_set_fmt(ui_bound_label_t *bound, const char *fmt, ...)
+{
+    if (bound == NULL || bound->label == NULL || fmt == NULL) {
+        return false;
+    }
+
+    char text[UI_BOUND_LABEL_TEXT_MAX];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+
+    return ui_bound_label_set_text(bound, text);
+}
+
+bool ui_bound_label_set_u32(ui_bound_label_t *bound, const char *fmt, uint32_t value)
+{
+    if (bound == NULL || bound->label == NULL || fmt == NULL) {
+        return false;
+    }
+
+    if (bound->value_valid && bound->last_value == value) {
+        s_skipped++;
+        return false;
+    }
+
+    char text[UI_BOUND_LABEL_TEXT_MAX];
+    snprintf(text, sizeof(text), fmt, value);
+    bool rendered = ui_bound_label_set_text(bound, text);
+
+    bound->last_value = value;
+    bound->value_valid = true;
+    return rendered;
+}
+
+esp_err_t ui_bound_label_get_stats(ui_bound_label_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    stats->rendered = s_rendered;
+    stats->skipped = s_skipped;
+    stats->opaque = s_opaque;
+    return ESP_OK;
+}
@@ -0,0 +1,102 @@
+/*
+ * Bound Label Layer for M5StickC Plus 1.1
+ * Caches the last rendered value of a label so unchanged refreshes skip LVGL
+ */
+
+#ifndef UI_BOUND_LABEL_H
+#define UI_BOUND_LABEL_H
+
+#include "lvgl.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Label bound to a cached value
+ *
+ * lv_label_set_text() always invalidates the label area, even if the text did
+ * not change, which costs a render pass and an SPI flush of those lines.
+ * Setting text through a bound label compares it with what the label already
+ * shows and only calls into LVGL when the formatted output differs.
+ *
+ * Bound labels are the dynamic part of a page; everything else is static
+ * chrome. Binding paints the label with the solid colour it sits on, so LVGL's
+ * cover check starts a refresh at the label and never repaints the panels,
+ * titles and backgrounds underneath.
+ */
+typedef struct {
+    lv_obj_t *label;            // Bound LVGL label (NULL when unbound)
+    uint32_t last_value;        // Last value rendered through ui_bound_label_set_u32()
+    bool value_valid;           // last_value matches the label text
+    bool opaque;                // Label paints its own background (see ui_bound_label_bind())
+} ui_bound_label_t;
+
+/**
+ * @brief Bound label statistics (all bound labels)
+ */
+typedef struct {
+    uint32_t rendered;          // Updates passed to lv_label_set_text()
+    uint32_t skipped;           // Updates dropped because the output was unchanged
+    uint32_t opaque;            // Binds that made the label opaque over the static layer
+} ui_bound_label_stats_t;
+
+/**
+ * @brief Bind a label; the cache starts from the label's current text
+ *
+ * The label gets an opaque background matching its nearest opaque ancestor,
+ * unless an earlier sibling overlaps it (the label then stays transparent).
+ *
+ * @param bound Bound label to initialize
+ * @param label LVGL label object (may be NULL, updates are then ignored)
+ */
+void ui_bound_label_bind(ui_bound_label_t *bound, lv_obj_t *label);
+
+/**
+ * @brief Repaint the label background after the colour under it changed
+ *
+ * Call after changing the background colour of a panel holding a bound label.
+ * Does nothing for labels left transparent by ui_bound_label_bind().
+ */
+void ui_bound_label_match_background(ui_bound_label_t *bound);
+
+/**
+ * @brief Drop the label reference (call before the label is deleted)
+ */
+void ui_bound_label_unbind(ui_bound_label_t *bound);
+
+/**
+ * @brief Set label text if it differs from the displayed text
+ * @return true if the label was re-rendered
+ */
+bool ui_bound_label_set_text(ui_bound_label_t *bound, const char *text);
+
+/**
+ * @brief Format and set label text if the output differs from the displayed text
+ * @return true if the label was re-rendered
+ */
+bool ui_bound_label_set_fmt(ui_bound_label_t *bound, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Set a counter label; formatting is skipped when the value is unchanged
+ * @param fmt printf format with a single uint32_t conversion (e.g. "%" PRIu32)
+ * @return true if the label was re-rendered
+ */
+bool ui_bound_label_set_u32(ui_bound_label_t *bound, const char *fmt, uint32_t value);
+
+/**
+ * @brief Get bound label statistics
+ * @param stats Pointer to statistics structure to fill
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t ui_bound_label_get_stats(ui_bound_label_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_BOUND_LABEL_H
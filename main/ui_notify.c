@@ -0,0 +1,131 @@
+/*
+ * UI Notification Layer for M5StickC Plus 1.1
+ * Publish/subscribe dirty bits from producer tasks to the LVGL task
+ */
+
+#include "ui_notify.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+
+static const char *TAG = "UI_NOTIFY";
+
+// Coalescing window: topics published within this time are handled in one refresh
+#define UI_NOTIFY_COALESCE_MS   CONFIG_UI_REFRESH_COALESCE_MS
+
+// Topics that are dispatched without waiting for the coalescing window
+#define UI_NOTIFY_URGENT_TOPICS (UI_TOPIC_INPUT)
+
+static atomic_uint s_pending_topics = ATOMIC_VAR_INIT(0);   // Dirty bits, written by any task
+static TaskHandle_t s_ui_task = NULL;                       // Task woken on publish
+static ui_notify_handler_t s_handler = NULL;                // Called in the UI task
+
+// Coalescing window state (UI task only)
+static bool s_window_open = false;
+static TickType_t s_window_start = 0;
+
+// Statistics
+static atomic_uint s_published = ATOMIC_VAR_INIT(0);
+static atomic_uint s_wakeups = ATOMIC_VAR_INIT(0);
+static uint32_t s_dispatches = 0;
+
+void ui_notify_bind_current_task(void)
+{
+    s_ui_task = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "UI notifications bound to task %s (coalescing %d ms)",
+             pcTaskGetName(s_ui_task), UI_NOTIFY_COALESCE_MS);
+}
+
+void ui_notify_set_handler(ui_notify_handler_t handler)
+{
+    s_handler = handler;
+}
+
+/**
+ * @brief Record topics and report whether the UI task needs a wakeup
+ *
+ * Only the first publish after a dispatch (or an urgent topic) wakes the
+ * UI task; later publishes inside the window just merge their bits.
+ */
+static bool ui_notify_mark(uint32_t topics)
+{
+    unsigned int previous = atomic_fetch_or(&s_pending_topics, topics);
+    atomic_fetch_add(&s_published, 1);
+
+    bool wake = (previous == 0) || (topics & UI_NOTIFY_URGENT_TOPICS);
+    if (wake && s_ui_task != NULL) {
+        atomic_fetch_add(&s_wakeups, 1);
+        return true;
+    }
+    return false;
+}
+
+void ui_notify_publish(uint32_t topics)
+{
+    if (topics == 0) {
+        return;
+    }
+    if (ui_notify_mark(topics)) {
+        xTaskNotifyGive(s_ui_task);
+    }
+}
+
+void ui_notify_publish_from_isr(uint32_t topics, BaseType_t *higher_priority_task_woken)
+{
+    if (topics == 0) {
+        return;
+    }
+    if (ui_notify_mark(topics)) {
+        vTaskNotifyGiveFromISR(s_ui_task, higher_priority_task_woken);
+    }
+}
+
+uint32_t ui_notify_process(void)
+{
+    unsigned int pending = atomic_load(&s_pending_topics);
+    if (pending == 0) {
+        s_window_open = false;
+        return UI_NOTIFY_NO_DEADLINE;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    if (!s_window_open) {
+        s_window_open = true;
+        s_window_start = now;
+    }
+
+    // Hold non-urgent topics until the window closes so bursts merge into one refresh
+    TickType_t window = pdMS_TO_TICKS(UI_NOTIFY_COALESCE_MS);
+    TickType_t elapsed = now - s_window_start;
+    if (!(pending & UI_NOTIFY_URGENT_TOPICS) && elapsed < window) {
+        return (uint32_t)((window - elapsed) * portTICK_PERIOD_MS);
+    }
+
+    pending = atomic_exchange(&s_pending_topics, 0);
+    s_window_open = false;
+
+    ui_notify_handler_t handler = s_handler;
+    if (handler != NULL && pending != 0) {
+        s_dispatches++;
+        handler(pending);
+    }
+    return UI_NOTIFY_NO_DEADLINE;
+}
+
+uint32_t ui_notify_get_pending(void)
+{
+    return atomic_load(&s_pending_topics);
+}
+
+esp_err_t ui_notify_get_stats(ui_notify_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->published = atomic_load(&s_published);
+    stats->wakeups = atomic_load(&s_wakeups);
+    stats->dispatches = s_dispatches;
+    return ESP_OK;
+}
@@ -0,0 +1,94 @@
+#ifndef UI_NOTIFY_H
+#define UI_NOTIFY_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief UI refresh topics (dirty bits)
+ *
+ * Producers publish topics when their data changes; the LVGL task collects
+ * them and hands them to the registered handler once per coalescing window.
+ */
+typedef enum {
+    UI_TOPIC_ESPNOW_STATS   = (1u << 0),    // ESP-NOW send/receive counters changed
+    UI_TOPIC_ESPNOW_DEVICES = (1u << 1),    // ESP-NOW device table changed
+    UI_TOPIC_SYSTEM_MONITOR = (1u << 2),    // system_monitor published changed data
+    UI_TOPIC_CLOCK          = (1u << 3),    // 1 Hz tick for uptime style labels
+    UI_TOPIC_INPUT          = (1u << 4),    // Button event queued for LVGL (not coalesced)
+    UI_TOPIC_ESPNOW_BENCH   = (1u << 5),    // ESP-NOW benchmark progress or results changed
+    UI_TOPIC_DIAGNOSTICS    = (1u << 6),    // Task profiler took a new sample
+} ui_topic_t;
+
+#define UI_TOPIC_ALL            (0xFFFFFFFFu)
+#define UI_NOTIFY_NO_DEADLINE   (UINT32_MAX)
+
+/**
+ * @brief Topic handler, called in the LVGL task with the collected topics
+ */
+typedef void (*ui_notify_handler_t)(uint32_t topics);
+
+/**
+ * @brief UI notification statistics
+ */
+typedef struct {
+    uint32_t published;         // ui_notify_publish*() calls
+    uint32_t wakeups;           // Publishes that had to wake the LVGL task
+    uint32_t dispatches;        // Handler invocations
+} ui_notify_stats_t;
+
+/**
+ * @brief Bind the calling task as the UI (LVGL) task that gets woken on publish
+ */
+void ui_notify_bind_current_task(void);
+
+/**
+ * @brief Set the handler that receives collected topics (NULL to clear)
+ */
+void ui_notify_set_handler(ui_notify_handler_t handler);
+
+/**
+ * @brief Mark topics dirty (task context, never blocks)
+ * @param topics Bitwise OR of ui_topic_t
+ */
+void ui_notify_publish(uint32_t topics);
+
+/**
+ * @brief Mark topics dirty from an ISR
+ * @param topics Bitwise OR of ui_topic_t
+ * @param higher_priority_task_woken Set to pdTRUE if a context switch is needed
+ */
+void ui_notify_publish_from_isr(uint32_t topics, BaseType_t *higher_priority_task_woken);
+
+/**
+ * @brief Dispatch pending topics if the coalescing window has elapsed
+ *
+ * Must be called from the bound UI task only.
+ *
+ * @return Milliseconds until the next dispatch is due, UI_NOTIFY_NO_DEADLINE if nothing is pending
+ */
+uint32_t ui_notify_process(void);
+
+/**
+ * @brief Get the topics that are currently pending (not yet dispatched)
+ */
+uint32_t ui_notify_get_pending(void);
+
+/**
+ * @brief Get UI notification statistics
+ * @param stats Pointer to statistics structure to fill
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t ui_notify_get_stats(ui_notify_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_NOTIFY_H
@@ -0,0 +1,247 @@
+/*
+ * Screen Cache for M5StickC Plus 1.1
+ * Keeps page object trees alive between visits instead of rebuilding them
+ */
+
+#include "ui_screen_cache.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "UI_SCREEN_CACHE";
+
+#define UI_SCREEN_CACHE_BUDGET      ((uint32_t)CONFIG_UI_SCREEN_CACHE_BUDGET_KB * 1024)
+
+// One built (or previously built) page tree
+typedef struct {
+    const ui_screen_desc_t *desc;   // Owner, NULL when the slot is free
+    lv_obj_t *root;                 // Tree root, NULL when not built
+    uint32_t bytes;                 // LVGL heap taken by the last build
+    uint32_t last_shown;            // Show counter value of the last visit (LRU order)
+} ui_screen_slot_t;
+
+// Cache state (LVGL task only, like the trees themselves)
+static lv_obj_t *s_screen = NULL;
+static ui_screen_slot_t s_slots[UI_SCREEN_CACHE_SLOTS];
+static ui_screen_slot_t *s_visible = NULL;
+static uint32_t s_show_counter = 0;
+static ui_screen_cache_stats_t s_stats = {0};
+
+// LVGL heap in use; only meaningful with the built-in LVGL allocator, 0 otherwise
+static uint32_t lvgl_heap_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return (uint32_t)(mon.total_size - mon.free_size);
+}
+
+static ui_screen_slot_t *slot_find(const ui_screen_desc_t *desc)
+{
+    for (int i = 0; i < UI_SCREEN_CACHE_SLOTS; i++) {
+        if (s_slots[i].desc == desc) {
+            return &s_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static ui_screen_slot_t *slot_claim(const ui_screen_desc_t *desc)
+{
+    ui_screen_slot_t *slot = slot_find(desc);
+    if (slot != NULL) {
+        return slot;
+    }
+    slot = slot_find(NULL);
+    if (slot != NULL) {
+        memset(slot, 0, sizeof(*slot));
+        slot->desc = desc;
+    }
+    return slot;
+}
+
+// Delete a slot's tree and give the slot back; the page forgets its pointers first
+static void slot_delete_tree(ui_screen_slot_t *slot)
+{
+    if (slot->root == NULL) {
+        slot->desc = NULL;
+        return;
+    }
+    if (slot->desc->forget) {
+        slot->desc->forget();
+    }
+    lv_obj_delete(slot->root);
+    slot->root = NULL;
+    s_stats.cached_bytes -= slot->bytes;
+    s_stats.cached_count--;
+    if (s_visible == slot) {
+        s_visible = NULL;
+    }
+    slot->desc = NULL;
+}
+
+// Evict hidden lazy trees, least recently shown first, until the cache fits the budget
+static void cache_enforce_budget(void)
+{
+    while (s_stats.cached_bytes > UI_SCREEN_CACHE_BUDGET) {
+        ui_screen_slot_t *victim = NULL;
+        for (int i = 0; i < UI_SCREEN_CACHE_SLOTS; i++) {
+            ui_screen_slot_t *slot = &s_slots[i];
+            if (slot->root == NULL || slot == s_visible || slot->desc->policy != UI_SCREEN_LAZY_ONCE) {
+                continue;
+            }
+            if (victim == NULL || slot->last_shown < victim->last_shown) {
+                victim = slot;
+            }
+        }
+        if (victim == NULL) {
+            break;  // Only the visible and keep-alive trees are left
+        }
+        ESP_LOGI(TAG, "🗑️ Evicting %s (%" PRIu32 " bytes) to stay within %" PRIu32 " bytes",
+                 victim->desc->name, victim->bytes, UI_SCREEN_CACHE_BUDGET);
+        slot_delete_tree(victim);
+        s_stats.evictions++;
+    }
+}
+
+// Build a slot's tree under a fresh root (the root counts towards the tree's cost)
+static esp_err_t slot_build_tree(ui_screen_slot_t *slot)
+{
+    uint32_t used_before = lvgl_heap_used();
+
+    lv_obj_t *root = lv_obj_create(s_screen);
+    if (root == NULL) {
+        ESP_LOGE(TAG, "Failed to create root for %s", slot->desc->name);
+        return ESP_ERR_NO_MEM;
+    }
+    lv_obj_remove_style_all(root);
+    lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(root, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(root, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_clear_flag(root, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+
+    esp_err_t ret = slot->desc->build(root);
+    if (ret != ESP_OK) {
+        if (slot->desc->forget) {
+            slot->desc->forget();
+        }
+        lv_obj_delete(root);
+        return ret;
+    }
+
+    uint32_t used_after = lvgl_heap_used();
+    slot->root = root;
+    slot->bytes = (used_after > used_before) ? (used_after - used_before) : 0;
+    s_stats.cached_bytes += slot->bytes;
+    s_stats.cached_count++;
+    s_stats.builds++;
+
+    ESP_LOGI(TAG, "🧱 Built %s: %" PRIu32 " bytes, cache %" PRIu32 "/%" PRIu32 " bytes",
+             slot->desc->name, slot->bytes, s_stats.cached_bytes, UI_SCREEN_CACHE_BUDGET);
+    return ESP_OK;
+}
+
+esp_err_t ui_screen_cache_init(lv_obj_t *screen)
+{
+    if (screen == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_screen = screen;
+    memset(s_slots, 0, sizeof(s_slots));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_visible = NULL;
+    s_show_counter = 0;
+
+    ESP_LOGI(TAG, "Screen cache initialized (budget %" PRIu32 " bytes)", UI_SCREEN_CACHE_BUDGET);
+    return ESP_OK;
+}
+
+esp_err_t ui_screen_cache_show(const ui_screen_desc_t *desc, bool *built)
+{
+    if (desc == NULL || desc->build == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_screen == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ui_screen_slot_t *slot = slot_claim(desc);
+    if (slot == NULL) {
+        ESP_LOGE(TAG, "No free slot for %s", desc->name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // A page that was never left properly still gets hidden
+    if (s_visible != NULL && s_visible != slot) {
+        ui_screen_cache_leave(s_visible->desc);
+    }
+
+    bool fresh = (slot->root == NULL);
+    if (fresh) {
+        esp_err_t ret = slot_build_tree(slot);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to build %s: %s", desc->name, esp_err_to_name(ret));
+            slot->desc = NULL;
+            return ret;
+        }
+    } else {
+        lv_obj_clear_flag(slot->root, LV_OBJ_FLAG_HIDDEN);
+        s_stats.reuses++;
+        ESP_LOGD(TAG, "Reactivated cached %s", desc->name);
+    }
+
+    s_visible = slot;
+    slot->last_shown = ++s_show_counter;
+
+    if (fresh) {
+        cache_enforce_budget();
+    }
+
+    if (built) {
+        *built = fresh;
+    }
+    return ESP_OK;
+}
+
+void ui_screen_cache_leave(const ui_screen_desc_t *desc)
+{
+    if (desc == NULL) {
+        return;
+    }
+    ui_screen_slot_t *slot = slot_find(desc);
+    if (slot == NULL || slot->root == NULL) {
+        return;
+    }
+
+    if (desc->policy == UI_SCREEN_DESTROY_ON_LEAVE) {
+        slot_delete_tree(slot);
+    } else {
+        lv_obj_add_flag(slot->root, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    if (s_visible == slot) {
+        s_visible = NULL;
+    }
+}
+
+void ui_screen_cache_clear(void)
+{
+    for (int i = 0; i < UI_SCREEN_CACHE_SLOTS; i++) {
+        if (s_slots[i].desc != NULL) {
+            slot_delete_tree(&s_slots[i]);
+        }
+    }
+    memset(s_slots, 0, sizeof(s_slots));
+    s_visible = NULL;
+}
+
+esp_err_t ui_screen_cache_get_stats(ui_screen_cache_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *stats = s_stats;
+    return ESP_OK;
+}
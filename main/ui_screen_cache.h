@@ -0,0 +1,100 @@
+/*
+ * Screen Cache for M5StickC Plus 1.1
+ * Keeps page object trees alive between visits instead of rebuilding them
+ */
+
+#ifndef UI_SCREEN_CACHE_H
+#define UI_SCREEN_CACHE_H
+
+#include "lvgl.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Screen descriptors each page passes to the cache; the pages static-assert their share
+#define UI_SCREEN_COUNT_ESPNOW      3   // Overview, node detail, bench
+#define UI_SCREEN_COUNT_MONITOR     4   // Monitor, tasks, memory, stacks
+#define UI_SCREEN_CACHE_SLOTS       (UI_SCREEN_COUNT_ESPNOW + UI_SCREEN_COUNT_MONITOR)
+
+/**
+ * @brief What happens to a page's object tree when the page is left
+ */
+typedef enum {
+    UI_SCREEN_DESTROY_ON_LEAVE = 0, // Deleted on leave, rebuilt on every visit
+    UI_SCREEN_LAZY_ONCE,            // Built on first visit, hidden on leave, evicted when over budget
+    UI_SCREEN_KEEP_ALIVE,           // Built on first visit, hidden on leave, never evicted
+} ui_screen_policy_t;
+
+/**
+ * @brief Static description of a cached screen (one const instance per page)
+ *
+ * build() creates the page widgets under root, a full-screen black container
+ * on the active screen. forget() is called right before root is deleted and
+ * must drop every pointer the page holds into the tree.
+ */
+typedef struct {
+    const char *name;                       // Screen name for logging
+    ui_screen_policy_t policy;              // Leave policy
+    esp_err_t (*build)(lv_obj_t *root);     // Create the widgets under root
+    void (*forget)(void);                   // Drop widget pointers before root is deleted
+} ui_screen_desc_t;
+
+/**
+ * @brief Screen cache statistics
+ */
+typedef struct {
+    uint32_t builds;            // Object trees built
+    uint32_t reuses;            // Visits served by a cached tree
+    uint32_t evictions;         // Cached trees deleted to stay within the budget
+    uint32_t cached_bytes;      // LVGL heap held by built trees (visible one included)
+    uint8_t cached_count;       // Built trees (visible one included)
+} ui_screen_cache_stats_t;
+
+/**
+ * @brief Initialize the cache; page roots are created as children of screen
+ * @param screen Screen the pages are shown on
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if screen is NULL
+ */
+esp_err_t ui_screen_cache_init(lv_obj_t *screen);
+
+/**
+ * @brief Show a page, building its tree if it is not cached
+ *
+ * Must be called from the LVGL task. The previous page must have been left.
+ *
+ * @param desc Page description
+ * @param built Set to true if the tree was built, false if a cached tree was
+ *              reactivated and the page should refresh its values (may be NULL)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if no slot or root is available,
+ *         or the error returned by build()
+ */
+esp_err_t ui_screen_cache_show(const ui_screen_desc_t *desc, bool *built);
+
+/**
+ * @brief Leave a page: hide its tree, or delete it for UI_SCREEN_DESTROY_ON_LEAVE
+ *
+ * Does nothing if the page has no tree.
+ */
+void ui_screen_cache_leave(const ui_screen_desc_t *desc);
+
+/**
+ * @brief Delete every cached tree (page_manager_deinit)
+ */
+void ui_screen_cache_clear(void);
+
+/**
+ * @brief Get screen cache statistics
+ * @param stats Pointer to statistics structure to fill
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t ui_screen_cache_get_stats(ui_screen_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_SCREEN_CACHE_H
@@ -1,21 +1,24 @@
 #include "ux_service.h"
 #include "axp192.h"
+#include "red_led.h"
+#include "task_placement.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "driver/gpio.h"
 #include "driver/ledc.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
 #include <string.h>
+#include <inttypes.h>
 
 static const char *TAG = "UX_SERVICE";
 
 // Hardware definitions for M5StickC Plus
-#define RED_LED_PIN     GPIO_NUM_10
 #define BUZZER_PIN      GPIO_NUM_2
 
 // UX Service State
-static QueueHandle_t ux_queue = NULL;
 static TaskHandle_t ux_task_handle = NULL;
 static bool ux_service_running = false;
 static ux_service_stats_t ux_stats = {0};
@@ -24,12 +27,141 @@ static ux_service_stats_t ux_stats = {0};
 static bool led_initialized = false;
 static bool buzzer_initialized = false;
 static bool demo_completed = false;
+static volatile bool demo_requested = false;   // Set by ux_service_start_demo_effects()
+
+// ===== TIMELINE DEFINITIONS =====
+
+// Effect priorities: a higher priority preempts the effect playing on the same device,
+// equal or lower priorities wait in the device's track queue
+#define UX_PRIORITY_AMBIENT     0   // Blinks and breathing
+#define UX_PRIORITY_NORMAL      1   // On/off, melodies, clicks
+#define UX_PRIORITY_ALERT       2   // Error and warning indications
+
+#define UX_TRACK_QUEUE_SIZE     8   // Effects waiting per device
+
+/**
+ * @brief One step of an effect
+ *
+ * The level is applied when the keyframe starts and held for duration_ms.
+ * With UX_KF_FADE the LED instead ramps to the level over duration_ms.
+ * LED: brightness 0-255. Buzzer: tone frequency in Hz, 0 = silent.
+ */
+typedef struct {
+    uint16_t level;
+    uint16_t duration_ms;       // 0 = keep the level and finish the effect
+    uint8_t flags;              // UX_KF_* flags
+} ux_keyframe_t;
+
+#define UX_KF_FADE              0x01    // LED: hardware fade to the level (ignored by the buzzer)
+
+/**
+ * @brief Keyframe program of one effect
+ */
+typedef struct {
+    const ux_keyframe_t *frames;
+    uint8_t frame_count;
+    uint8_t priority;
+    uint16_t default_cycles;    // Cycles when the message gives neither repeat_count nor duration
+    uint16_t cycle_ms;          // Length of one cycle, converts duration_ms to cycles (0 = fixed)
+} ux_program_t;
+
+/**
+ * @brief Playback state of one device
+ */
+typedef struct {
+    ux_device_type_t device;
+    esp_timer_handle_t timer;           // Fires at the end of the current keyframe
+    const ux_program_t *program;        // Effect being played (NULL when idle)
+    ux_effect_t effect;
+    uint8_t frame;                      // Current keyframe index
+    uint32_t cycles_left;               // Cycles still to play after the current one
+    int64_t deadline_us;                // End of the current keyframe
+    ux_message_t queue[UX_TRACK_QUEUE_SIZE];
+    uint8_t queue_head;
+    uint8_t queue_count;
+} ux_track_t;
+
+#define UX_KF(lvl, ms)          { .level = (lvl), .duration_ms = (ms) }
+#define UX_KF_F(lvl, ms, f)     { .level = (lvl), .duration_ms = (ms), .flags = (f) }
+#define UX_FRAMES(...)  ((const ux_keyframe_t[]){ __VA_ARGS__ })
+#define UX_PROGRAM(prio, cycles, cycle_len, ...) {                              \
+        .frames = UX_FRAMES(__VA_ARGS__),                                       \
+        .frame_count = sizeof(UX_FRAMES(__VA_ARGS__)) / sizeof(ux_keyframe_t),  \
+        .priority = (prio), .default_cycles = (cycles), .cycle_ms = (cycle_len) }
+
+static const ux_program_t k_led_programs[UX_LED_EFFECT_MAX] = {
+    [UX_LED_EFFECT_OFF]             = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0, UX_KF(0, 0)),
+    [UX_LED_EFFECT_ON]              = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0, UX_KF(RED_LED_BRIGHTNESS_MAX, 0)),
+    [UX_LED_EFFECT_BLINK_FAST]      = UX_PROGRAM(UX_PRIORITY_AMBIENT, 10, 200, UX_KF(RED_LED_BRIGHTNESS_MAX, 100), UX_KF(0, 100)),
+    [UX_LED_EFFECT_BLINK_SLOW]      = UX_PROGRAM(UX_PRIORITY_AMBIENT, 5, 1000, UX_KF(RED_LED_BRIGHTNESS_MAX, 500), UX_KF(0, 500)),
+    [UX_LED_EFFECT_BREATHING]       = UX_PROGRAM(UX_PRIORITY_AMBIENT, 3, 0,
+                                                 UX_KF_F(RED_LED_BRIGHTNESS_MAX, 800, UX_KF_FADE), UX_KF_F(0, 800, UX_KF_FADE)),
+    [UX_LED_EFFECT_SUCCESS_PATTERN] = UX_PROGRAM(UX_PRIORITY_NORMAL, 3, 0, UX_KF(RED_LED_BRIGHTNESS_MAX, 150), UX_KF(0, 150)),
+    [UX_LED_EFFECT_ERROR_PATTERN]   = UX_PROGRAM(UX_PRIORITY_ALERT, 5, 0, UX_KF(RED_LED_BRIGHTNESS_MAX, 100), UX_KF(0, 100)),
+};
+
+static const ux_program_t k_buzzer_programs[UX_BUZZER_EFFECT_MAX] = {
+    [UX_BUZZER_EFFECT_SILENCE]      = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0, UX_KF(0, 0)),
+    // Startup: ascending A4, C#5, E5
+    [UX_BUZZER_EFFECT_STARTUP]      = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0,
+                                                 UX_KF(440, 200), UX_KF(0, 50), UX_KF(554, 200), UX_KF(0, 50), UX_KF(659, 300)),
+    // Success: C5, E5, G5
+    [UX_BUZZER_EFFECT_SUCCESS]      = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0,
+                                                 UX_KF(523, 150), UX_KF(0, 20), UX_KF(659, 150), UX_KF(0, 20), UX_KF(784, 200)),
+    // Error: descending tones
+    [UX_BUZZER_EFFECT_ERROR]        = UX_PROGRAM(UX_PRIORITY_ALERT, 1, 0,
+                                                 UX_KF(800, 200), UX_KF(0, 20), UX_KF(600, 200), UX_KF(0, 20), UX_KF(400, 300)),
+    // Notification: double beep
+    [UX_BUZZER_EFFECT_NOTIFICATION] = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0, UX_KF(1000, 150), UX_KF(0, 50), UX_KF(1000, 150)),
+    // Warning: alternating tones
+    [UX_BUZZER_EFFECT_WARNING]      = UX_PROGRAM(UX_PRIORITY_ALERT, 1, 0, UX_KF(500, 200), UX_KF(0, 20), UX_KF(400, 200)),
+    // Click: very short high tone
+    [UX_BUZZER_EFFECT_CLICK]        = UX_PROGRAM(UX_PRIORITY_NORMAL, 1, 0, UX_KF(1000, 50)),
+};
+
+// Tracks are advanced by their esp_timer callbacks and fed by the service task
+static ux_track_t s_led_track = { .device = UX_DEVICE_LED };
+static ux_track_t s_buzzer_track = { .device = UX_DEVICE_BUZZER };
+static SemaphoreHandle_t s_timeline_mutex = NULL;
+
+// ===== FRONT-END DEFINITIONS =====
+
+/**
+ * @brief Pending effect of one device, waiting for the service task
+ *
+ * Producers never block: a new effect overwrites the pending one of its device
+ * (latest wins), an identical one merges into it.
+ */
+typedef struct {
+    ux_message_t message;
+    uint8_t priority;           // Priority of the pending effect's program
+    bool valid;
+} ux_pending_slot_t;
+
+// Minimum spacing between accepted identical effects, so bursty producers can't flood a device
+static const uint16_t k_led_rate_limit_ms[UX_LED_EFFECT_MAX] = {
+    [UX_LED_EFFECT_BLINK_FAST]      = 1000,     // Packet reception indication
+    [UX_LED_EFFECT_BLINK_SLOW]      = 1000,
+};
+
+static const uint16_t k_buzzer_rate_limit_ms[UX_BUZZER_EFFECT_MAX] = {
+    [UX_BUZZER_EFFECT_NOTIFICATION] = 500,
+};
+
+static portMUX_TYPE s_frontend_lock = portMUX_INITIALIZER_UNLOCKED;
+static ux_pending_slot_t s_pending[UX_DEVICE_MAX];
+static int64_t s_last_accept_us[UX_DEVICE_MAX];
+static ux_effect_t s_last_accept_effect[UX_DEVICE_MAX];
 
 // Forward declarations
 static void ux_service_task(void *pvParameters);
 static void ux_queue_startup_demo_effects(void);
-static esp_err_t ux_execute_led_effect(ux_led_effect_type_t effect_type, uint32_t duration_ms, uint32_t repeat_count, uint32_t parameter);
-static esp_err_t ux_execute_buzzer_effect(ux_buzzer_effect_type_t effect_type, uint32_t duration_ms, uint32_t repeat_count, uint32_t parameter);
+static esp_err_t ux_timeline_init(void);
+static void ux_timeline_deinit(void);
+static esp_err_t ux_timeline_submit(const ux_message_t *message);
+static esp_err_t ux_frontend_post(const ux_message_t *message, bool from_isr, bool *wake);
+static bool ux_frontend_take(ux_device_type_t device, ux_message_t *message);
+static void ux_track_timer_cb(void *arg);
 static const char* ux_effect_to_string(ux_effect_t effect);
 
 // Hardware initialization functions
@@ -39,9 +171,8 @@ static void ux_deinit_led(void);
 static void ux_deinit_buzzer(void);
 
 // Direct hardware control functions
-static esp_err_t ux_led_set(bool on);
-static esp_err_t ux_led_blink(uint32_t on_time_ms, uint32_t off_time_ms, uint32_t cycles);
-static esp_err_t ux_buzzer_tone(uint32_t frequency_hz, uint32_t duration_ms);
+static esp_err_t ux_led_set(uint8_t brightness, uint32_t fade_ms);
+static esp_err_t ux_buzzer_set_tone(uint32_t frequency_hz);
 static esp_err_t ux_buzzer_stop(void);
 
 esp_err_t ux_service_init(void)
@@ -53,12 +184,12 @@ esp_err_t ux_service_init(void)
         return ESP_OK;
     }
     
-    // Create message queue
-    ux_queue = xQueueCreate(UX_SERVICE_QUEUE_SIZE, sizeof(ux_message_t));
-    if (ux_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create UX message queue");
-        return ESP_ERR_NO_MEM;
-    }
+    // Reset the coalescing front-end
+    taskENTER_CRITICAL(&s_frontend_lock);
+    memset(s_pending, 0, sizeof(s_pending));
+    memset(s_last_accept_us, 0, sizeof(s_last_accept_us));
+    memset(s_last_accept_effect, 0, sizeof(s_last_accept_effect));
+    taskEXIT_CRITICAL(&s_frontend_lock);
     
     // Initialize hardware components
     esp_err_t ret;
@@ -67,7 +198,6 @@ esp_err_t ux_service_init(void)
     ret = ux_init_led();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize LED: %s", esp_err_to_name(ret));
-        vQueueDelete(ux_queue);
         return ret;
     }
     
@@ -79,29 +209,31 @@ esp_err_t ux_service_init(void)
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize buzzer: %s", esp_err_to_name(ret));
         ux_deinit_led();
-        vQueueDelete(ux_queue);
         return ret;
     }
     
-    // Create UX service task
-    BaseType_t task_ret = xTaskCreate(
-        ux_service_task,
-        UX_SERVICE_TASK_NAME,
-        UX_SERVICE_TASK_STACK_SIZE,
-        NULL,
-        UX_SERVICE_TASK_PRIORITY,
-        &ux_task_handle
-    );
+    // Create the per-device playback tracks
+    ret = ux_timeline_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize effect timeline: %s", esp_err_to_name(ret));
+        ux_deinit_buzzer();
+        ux_deinit_led();
+        return ret;
+    }
+    
+    // Create UX service task (dispatch only, effects play from esp_timer)
+    ret = task_placement_create(TASK_PLACEMENT_UX_SERVICE, ux_service_task, NULL, &ux_task_handle);
     
-    if (task_ret != pdPASS) {
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create UX service task");
+        ux_timeline_deinit();
         ux_deinit_buzzer();
         ux_deinit_led();
-        vQueueDelete(ux_queue);
-        return ESP_ERR_NO_MEM;
+        return ret;
     }
     
     ux_service_running = true;
+    demo_requested = false;
     memset(&ux_stats, 0, sizeof(ux_stats));
     
     ESP_LOGI(TAG, "🎨 UX Service initialized successfully");
@@ -125,13 +257,8 @@ esp_err_t ux_service_deinit(void)
         ux_task_handle = NULL;
     }
     
-    // Delete queue
-    if (ux_queue) {
-        vQueueDelete(ux_queue);
-        ux_queue = NULL;
-    }
-    
-    // Deinitialize hardware
+    // Stop playback, then deinitialize hardware
+    ux_timeline_deinit();
     ux_deinit_buzzer();
     ux_deinit_led();
     
@@ -139,12 +266,23 @@ esp_err_t ux_service_deinit(void)
     return ESP_OK;
 }
 
+esp_err_t ux_service_start_demo_effects(void)
+{
+    if (!ux_service_running || ux_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    demo_requested = true;
+    xTaskNotifyGive(ux_task_handle);
+    return ESP_OK;
+}
+
 esp_err_t ux_service_send_effect(ux_effect_t effect, 
                                   uint32_t duration_ms,
                                   uint32_t repeat_count,
                                   uint32_t parameter)
 {
-    if (!ux_service_running || ux_queue == NULL) {
+    if (!ux_service_running || ux_task_handle == NULL) {
         ESP_LOGE(TAG, "UX Service not running");
         return ESP_ERR_INVALID_STATE;
     }
@@ -156,14 +294,37 @@ esp_err_t ux_service_send_effect(ux_effect_t effect,
         .parameter = parameter
     };
     
-    BaseType_t ret = xQueueSend(ux_queue, &message, pdMS_TO_TICKS(100));
-    if (ret != pdTRUE) {
-        ux_stats.queue_full_errors++;
-        ESP_LOGW(TAG, "UX queue full, message dropped");
-        return ESP_ERR_TIMEOUT;
+    bool wake = false;
+    esp_err_t ret = ux_frontend_post(&message, false, &wake);
+    if (wake) {
+        xTaskNotifyGive(ux_task_handle);
+    }
+    return ret;
+}
+
+esp_err_t ux_service_send_effect_from_isr(ux_effect_t effect,
+                                          uint32_t duration_ms,
+                                          uint32_t repeat_count,
+                                          uint32_t parameter,
+                                          BaseType_t *higher_priority_task_woken)
+{
+    if (!ux_service_running || ux_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
     }
     
-    return ESP_OK;
+    ux_message_t message = {
+        .effect = effect,
+        .duration_ms = duration_ms,
+        .repeat_count = repeat_count,
+        .parameter = parameter
+    };
+    
+    bool wake = false;
+    esp_err_t ret = ux_frontend_post(&message, true, &wake);
+    if (wake) {
+        vTaskNotifyGiveFromISR(ux_task_handle, higher_priority_task_woken);
+    }
+    return ret;
 }
 
 esp_err_t ux_service_send_simple_effect(ux_effect_t effect)
@@ -177,7 +338,9 @@ esp_err_t ux_service_get_stats(ux_service_stats_t *stats)
         return ESP_ERR_INVALID_ARG;
     }
     
+    taskENTER_CRITICAL(&s_frontend_lock);
     memcpy(stats, &ux_stats, sizeof(ux_service_stats_t));
+    taskEXIT_CRITICAL(&s_frontend_lock);
     return ESP_OK;
 }
 
@@ -248,11 +411,12 @@ esp_err_t ux_buzzer_notification(void)
  */
 static void ux_queue_startup_demo_effects(void)
 {
-    if (demo_completed || ux_queue == NULL) {
+    if (demo_completed) {
         return;
     }
     
-    ESP_LOGI(TAG, "🎨 Sending startup demo effects to queue...");
+    // Submitted straight to the tracks: the sequence must not coalesce into its last entry
+    ESP_LOGI(TAG, "🎨 Queueing startup demo effects...");
     
     // Send LED demo effects
     ux_message_t led_effects[] = {
@@ -264,7 +428,7 @@ static void ux_queue_startup_demo_effects(void)
     };
     
     for (int i = 0; i < 5; i++) {
-        xQueueSend(ux_queue, &led_effects[i], portMAX_DELAY);
+        ux_timeline_submit(&led_effects[i]);
     }
     
     // Send buzzer demo effects
@@ -277,7 +441,7 @@ static void ux_queue_startup_demo_effects(void)
     };
     
     for (int i = 0; i < 5; i++) {
-        xQueueSend(ux_queue, &buzzer_effects[i], portMAX_DELAY);
+        ux_timeline_submit(&buzzer_effects[i]);
     }
     
     demo_completed = true;
@@ -288,46 +452,30 @@ static void ux_service_task(void *pvParameters)
 {
     ESP_LOGI(TAG, "🎨 UX Service task started");
     
-    // Wait a bit for hardware to stabilize
-    vTaskDelay(pdMS_TO_TICKS(500));
-    
-    // Queue startup demo effects
-    ux_queue_startup_demo_effects();
-    
     ux_message_t message;
     
     while (ux_service_running) {
-        // Wait for messages
-        if (xQueueReceive(ux_queue, &message, pdMS_TO_TICKS(1000)) == pdTRUE) {
-            ux_stats.messages_processed++;
-            
-            ESP_LOGI(TAG, "🎬 Processing: %s", ux_effect_to_string(message.effect));
-            
-            esp_err_t result = ESP_OK;
-            
-            // Route message based on device type
-            if (message.effect.device_type == UX_DEVICE_LED) {
-                result = ux_execute_led_effect(message.effect.led_effect, message.duration_ms, 
-                                             message.repeat_count, message.parameter);
-                if (result == ESP_OK) {
-                    ux_stats.led_effects_count++;
-                }
-            }
-            else if (message.effect.device_type == UX_DEVICE_BUZZER) {
-                result = ux_execute_buzzer_effect(message.effect.buzzer_effect, message.duration_ms, 
-                                                message.repeat_count, message.parameter);
-                if (result == ESP_OK) {
-                    ux_stats.buzzer_effects_count++;
-                }
-            }
-            else {
-                ESP_LOGW(TAG, "Unknown UX device type: %d", message.effect.device_type);
-                result = ESP_ERR_INVALID_ARG;
+        // Only dispatches pending effects; playback runs from the track timers
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    
+        // Startup demo, requested by boot once the first frame is on the screen
+        if (demo_requested) {
+            ux_queue_startup_demo_effects();
+        }
+    
+        for (int device = UX_DEVICE_NONE + 1; device < UX_DEVICE_MAX; device++) {
+            if (!ux_frontend_take((ux_device_type_t)device, &message)) {
+                continue;
             }
-            
+    
+            ESP_LOGI(TAG, "🎬 Processing: %s", ux_effect_to_string(message.effect));
+    
+            esp_err_t result = ux_timeline_submit(&message);
             if (result != ESP_OK) {
+                taskENTER_CRITICAL(&s_frontend_lock);
                 ux_stats.execution_errors++;
-                ESP_LOGE(TAG, "Failed to execute UX effect %s: %s", 
+                taskEXIT_CRITICAL(&s_frontend_lock);
+                ESP_LOGE(TAG, "Failed to schedule UX effect %s: %s",
                          ux_effect_to_string(message.effect), esp_err_to_name(result));
             }
         }
@@ -337,128 +485,348 @@ static void ux_service_task(void *pvParameters)
     vTaskDelete(NULL);
 }
 
-static esp_err_t ux_execute_led_effect(ux_led_effect_type_t effect_type, uint32_t duration_ms, uint32_t repeat_count, uint32_t parameter)
+// ===== FRONT-END IMPLEMENTATION =====
+
+static bool ux_effect_equal(ux_effect_t a, ux_effect_t b)
+{
+    return a.device_type == b.device_type && a.effect_id == b.effect_id;
+}
+
+static uint32_t ux_effect_rate_limit_ms(ux_effect_t effect)
 {
+    if (effect.device_type == UX_DEVICE_LED && effect.led_effect < UX_LED_EFFECT_MAX) {
+        return k_led_rate_limit_ms[effect.led_effect];
+    }
+    if (effect.device_type == UX_DEVICE_BUZZER && effect.buzzer_effect < UX_BUZZER_EFFECT_MAX) {
+        return k_buzzer_rate_limit_ms[effect.buzzer_effect];
+    }
+    return 0;
+}
+
+/**
+ * @brief Merge a message into its device's pending slot (task or ISR context)
+ *
+ * Identical effects inside their rate-limit window, or identical to the pending
+ * one, are merged. A different effect replaces the pending one, unless the
+ * pending effect has a higher priority (an alert is never overwritten by a blink).
+ *
+ * @param wake Set when the service task has to be notified
+ * @return ESP_OK when accepted or merged, ESP_ERR_INVALID_ARG for unknown effects,
+ *         ESP_ERR_INVALID_STATE when a higher priority effect is already pending
+ */
+static esp_err_t ux_frontend_post(const ux_message_t *message, bool from_isr, bool *wake)
+{
+    ux_effect_t effect = message->effect;
+    const ux_program_t *program;
+    
+    if (effect.device_type == UX_DEVICE_LED && effect.led_effect < UX_LED_EFFECT_MAX) {
+        program = &k_led_programs[effect.led_effect];
+    } else if (effect.device_type == UX_DEVICE_BUZZER && effect.buzzer_effect < UX_BUZZER_EFFECT_MAX) {
+        program = &k_buzzer_programs[effect.buzzer_effect];
+    } else {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int device = effect.device_type;
+    uint32_t limit_ms = ux_effect_rate_limit_ms(effect);
+    int64_t now_us = esp_timer_get_time();
     esp_err_t ret = ESP_OK;
     
-    switch (effect_type) {
-        case UX_LED_EFFECT_OFF:
-            ret = ux_led_set(false);
-            break;
-            
-        case UX_LED_EFFECT_ON:
-            ret = ux_led_set(true);
-            break;
-            
-        case UX_LED_EFFECT_BLINK_FAST:
-            if (duration_ms > 0) {
-                uint32_t cycles = duration_ms / 200; // 100ms on + 100ms off = 200ms per cycle
-                ret = ux_led_blink(100, 100, cycles);
-            } else {
-                ret = ux_led_blink(100, 100, 10); // Default 10 cycles (2 seconds)
-            }
-            break;
-            
-        case UX_LED_EFFECT_BLINK_SLOW:
-            if (duration_ms > 0) {
-                uint32_t cycles = duration_ms / 1000; // 500ms on + 500ms off = 1000ms per cycle
-                ret = ux_led_blink(500, 500, cycles);
-            } else {
-                ret = ux_led_blink(500, 500, 5); // Default 5 cycles (5 seconds)
-            }
-            break;
-            
-        case UX_LED_EFFECT_BREATHING:
-            {
-                uint32_t cycles = repeat_count > 0 ? repeat_count : 3; // Default 3 cycles
-                // Simulate breathing effect with slow blink
-                ret = ux_led_blink(800, 800, cycles); // 0.8s on, 0.8s off
-            }
-            break;
-            
-        case UX_LED_EFFECT_SUCCESS_PATTERN:
-            // Success pattern: 3 quick blinks
-            ret = ux_led_blink(150, 150, 3);
-            break;
-            
-        case UX_LED_EFFECT_ERROR_PATTERN:
-            // Error pattern: rapid blink 5 times
-            ret = ux_led_blink(100, 100, 5);
-            break;
-            
-        default:
-            ESP_LOGW(TAG, "Unknown LED effect: %d", effect_type);
-            ret = ESP_ERR_INVALID_ARG;
-            break;
+    if (from_isr) {
+        taskENTER_CRITICAL_ISR(&s_frontend_lock);
+    } else {
+        taskENTER_CRITICAL(&s_frontend_lock);
+    }
+    
+    ux_pending_slot_t *slot = &s_pending[device];
+    bool rate_limited = limit_ms > 0 && s_last_accept_us[device] != 0 &&
+                        ux_effect_equal(s_last_accept_effect[device], effect) &&
+                        (now_us - s_last_accept_us[device]) < (int64_t)limit_ms * 1000;
+    
+    ux_stats.messages_processed++;
+    if (slot->valid && ux_effect_equal(slot->message.effect, effect)) {
+        // Already pending: keep one entry with the newest parameters
+        slot->message = *message;
+        ux_stats.effects_coalesced++;
+    } else if (rate_limited) {
+        ux_stats.effects_coalesced++;
+    } else if (slot->valid && slot->priority > program->priority) {
+        ux_stats.queue_full_errors++;
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        if (slot->valid) {
+            ux_stats.effects_replaced++;
+        }
+        slot->message = *message;
+        slot->priority = program->priority;
+        slot->valid = true;
+        s_last_accept_us[device] = now_us;
+        s_last_accept_effect[device] = effect;
+        *wake = true;
+    }
+    
+    if (from_isr) {
+        taskEXIT_CRITICAL_ISR(&s_frontend_lock);
+    } else {
+        taskEXIT_CRITICAL(&s_frontend_lock);
     }
     
     return ret;
 }
 
-static esp_err_t ux_execute_buzzer_effect(ux_buzzer_effect_type_t effect_type, uint32_t duration_ms, uint32_t repeat_count, uint32_t parameter)
+/**
+ * @brief Take the pending message of a device (service task)
+ */
+static bool ux_frontend_take(ux_device_type_t device, ux_message_t *message)
 {
-    esp_err_t ret = ESP_OK;
+    bool valid;
     
-    switch (effect_type) {
-        case UX_BUZZER_EFFECT_SILENCE:
-            ret = ux_buzzer_stop();
-            break;
-            
-        case UX_BUZZER_EFFECT_STARTUP:
-            // Startup sound: ascending tones
-            ret = ux_buzzer_tone(440, 200); // A4
-            vTaskDelay(pdMS_TO_TICKS(250));
-            ret = ux_buzzer_tone(554, 200); // C#5
-            vTaskDelay(pdMS_TO_TICKS(250));
-            ret = ux_buzzer_tone(659, 300); // E5
-            break;
-            
-        case UX_BUZZER_EFFECT_SUCCESS:
-            // Success sound: happy melody
-            ret = ux_buzzer_tone(523, 150); // C5
-            vTaskDelay(pdMS_TO_TICKS(170));
-            ret = ux_buzzer_tone(659, 150); // E5
-            vTaskDelay(pdMS_TO_TICKS(170));
-            ret = ux_buzzer_tone(784, 200); // G5
-            break;
-            
-        case UX_BUZZER_EFFECT_ERROR:
-            // Error sound: descending tones
-            ret = ux_buzzer_tone(800, 200); // High
-            vTaskDelay(pdMS_TO_TICKS(220));
-            ret = ux_buzzer_tone(600, 200); // Medium
-            vTaskDelay(pdMS_TO_TICKS(220));
-            ret = ux_buzzer_tone(400, 300); // Low
-            break;
-            
-        case UX_BUZZER_EFFECT_NOTIFICATION:
-            // Notification: double beep
-            ret = ux_buzzer_tone(1000, 150);
-            vTaskDelay(pdMS_TO_TICKS(200));
-            ret = ux_buzzer_tone(1000, 150);
-            break;
-            
-        case UX_BUZZER_EFFECT_WARNING:
-            // Warning: alternating tones
-            ret = ux_buzzer_tone(500, 200);
-            vTaskDelay(pdMS_TO_TICKS(220));
-            ret = ux_buzzer_tone(400, 200);
-            break;
-            
-        case UX_BUZZER_EFFECT_CLICK:
-            // Click: very short high tone
-            ret = ux_buzzer_tone(1000, 50);
-            break;
-            
-        default:
-            ESP_LOGW(TAG, "Unknown buzzer effect: %d", effect_type);
-            ret = ESP_ERR_INVALID_ARG;
-            break;
+    taskENTER_CRITICAL(&s_frontend_lock);
+    valid = s_pending[device].valid;
+    if (valid) {
+        *message = s_pending[device].message;
+        s_pending[device].valid = false;
+    }
+    taskEXIT_CRITICAL(&s_frontend_lock);
+    
+    return valid;
+}
+
+// ===== TIMELINE IMPLEMENTATION =====
+
+/**
+ * @brief Look up the track and program for an effect
+ */
+static esp_err_t ux_timeline_resolve(ux_effect_t effect, ux_track_t **track, const ux_program_t **program)
+{
+    if (effect.device_type == UX_DEVICE_LED && effect.led_effect < UX_LED_EFFECT_MAX) {
+        *track = &s_led_track;
+        *program = &k_led_programs[effect.led_effect];
+        return ESP_OK;
+    }
+    if (effect.device_type == UX_DEVICE_BUZZER && effect.buzzer_effect < UX_BUZZER_EFFECT_MAX) {
+        *track = &s_buzzer_track;
+        *program = &k_buzzer_programs[effect.buzzer_effect];
+        return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Unknown UX effect: device %d, effect %" PRIu32, effect.device_type, effect.effect_id);
+    return ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Drive the device output for one keyframe level
+ */
+static void ux_track_apply(const ux_track_t *track, const ux_keyframe_t *kf)
+{
+    uint16_t level = kf->level;
+    
+    if (track->device == UX_DEVICE_LED) {
+        ux_led_set(level > RED_LED_BRIGHTNESS_MAX ? RED_LED_BRIGHTNESS_MAX : level,
+                   (kf->flags & UX_KF_FADE) ? kf->duration_ms : 0);
+    } else if (level != 0) {
+        ux_buzzer_set_tone(level);
+    } else {
+        ux_buzzer_stop();
+    }
+}
+
+/**
+ * @brief Enter the current keyframe and arm the timer for its end (mutex held)
+ */
+static void ux_track_enter_frame(ux_track_t *track)
+{
+    const ux_keyframe_t *kf = &track->program->frames[track->frame];
+    ux_track_apply(track, kf);
+    
+    if (kf->duration_ms == 0) {
+        // Hold the level: a state effect such as ON or OFF is complete
+        track->program = NULL;
+        return;
+    }
+    
+    track->deadline_us = esp_timer_get_time() + (int64_t)kf->duration_ms * 1000;
+    esp_timer_start_once(track->timer, (uint64_t)kf->duration_ms * 1000);
+}
+
+/**
+ * @brief Start playing a message on its track (mutex held, track timer stopped)
+ */
+static void ux_track_start(ux_track_t *track, const ux_program_t *program, const ux_message_t *message)
+{
+    uint32_t cycles = program->default_cycles;
+    if (message->repeat_count > 0) {
+        cycles = message->repeat_count;
+    } else if (message->duration_ms > 0 && program->cycle_ms > 0) {
+        cycles = message->duration_ms / program->cycle_ms;
+        if (cycles == 0) {
+            cycles = 1;
+        }
+    }
+    
+    track->program = program;
+    track->effect = message->effect;
+    track->frame = 0;
+    track->cycles_left = cycles - 1;
+    
+    if (track->device == UX_DEVICE_LED) {
+        ux_stats.led_effects_count++;
+    } else {
+        ux_stats.buzzer_effects_count++;
+    }
+    
+    ux_track_enter_frame(track);
+}
+
+/**
+ * @brief Start queued effects until one keeps playing or the queue is empty (mutex held)
+ */
+static void ux_track_start_next(ux_track_t *track)
+{
+    while (track->program == NULL && track->queue_count > 0) {
+        ux_message_t message = track->queue[track->queue_head];
+        track->queue_head = (track->queue_head + 1) % UX_TRACK_QUEUE_SIZE;
+        track->queue_count--;
+    
+        ux_track_t *queued_track;
+        const ux_program_t *program;
+        if (ux_timeline_resolve(message.effect, &queued_track, &program) == ESP_OK) {
+            ux_track_start(track, program, &message);
+        }
+    }
+}
+
+/**
+ * @brief Keyframe timer: advance the track to its next keyframe (esp_timer task)
+ */
+static void ux_track_timer_cb(void *arg)
+{
+    ux_track_t *track = (ux_track_t *)arg;
+    
+    if (xSemaphoreTake(s_timeline_mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    
+    // A preempted effect's expiry may already be dispatched; only the current deadline counts
+    if (track->program == NULL || esp_timer_get_time() + 1000 < track->deadline_us) {
+        xSemaphoreGive(s_timeline_mutex);
+        return;
     }
     
+    track->frame++;
+    if (track->frame >= track->program->frame_count) {
+        if (track->cycles_left > 0) {
+            track->cycles_left--;
+            track->frame = 0;
+        } else {
+            // Effect complete: return to rest and continue with the track queue
+            static const ux_keyframe_t rest = {0, 0, 0};
+            track->program = NULL;
+            ux_track_apply(track, &rest);
+            ux_track_start_next(track);
+            xSemaphoreGive(s_timeline_mutex);
+            return;
+        }
+    }
+    
+    ux_track_enter_frame(track);
+    xSemaphoreGive(s_timeline_mutex);
+}
+
+/**
+ * @brief Schedule a message on its device track
+ *
+ * A higher priority than the playing effect preempts it immediately; otherwise
+ * the message waits behind the effects already queued for that device.
+ */
+static esp_err_t ux_timeline_submit(const ux_message_t *message)
+{
+    ux_track_t *track;
+    const ux_program_t *program;
+    esp_err_t ret = ux_timeline_resolve(message->effect, &track, &program);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    if (xSemaphoreTake(s_timeline_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    if (track->program == NULL) {
+        ux_track_start(track, program, message);
+        ux_track_start_next(track);
+    } else if (program->priority > track->program->priority) {
+        ESP_LOGD(TAG, "⏭️ %s preempts %s", ux_effect_to_string(message->effect),
+                 ux_effect_to_string(track->effect));
+        esp_timer_stop(track->timer);
+        track->program = NULL;
+        ux_stats.effects_preempted++;
+        ux_track_start(track, program, message);
+        ux_track_start_next(track);
+    } else if (track->queue_count < UX_TRACK_QUEUE_SIZE) {
+        uint8_t tail = (track->queue_head + track->queue_count) % UX_TRACK_QUEUE_SIZE;
+        track->queue[tail] = *message;
+        track->queue_count++;
+    } else {
+        ux_stats.effects_dropped++;
+        ret = ESP_ERR_NO_MEM;
+    }
+    
+    xSemaphoreGive(s_timeline_mutex);
     return ret;
 }
 
+static esp_err_t ux_timeline_init(void)
+{
+    s_timeline_mutex = xSemaphoreCreateMutex();
+    if (s_timeline_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    ux_track_t *tracks[] = { &s_led_track, &s_buzzer_track };
+    const char *names[] = { "ux_led", "ux_buzzer" };
+    
+    for (int i = 0; i < 2; i++) {
+        ux_track_t *track = tracks[i];
+        ux_device_type_t device = track->device;
+        memset(track, 0, sizeof(*track));
+        track->device = device;
+    
+        const esp_timer_create_args_t timer_args = {
+            .callback = ux_track_timer_cb,
+            .arg = track,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = names[i],
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &track->timer);
+        if (ret != ESP_OK) {
+            ux_timeline_deinit();
+            return ret;
+        }
+    }
+    
+    return ESP_OK;
+}
+
+static void ux_timeline_deinit(void)
+{
+    ux_track_t *tracks[] = { &s_led_track, &s_buzzer_track };
+    
+    for (int i = 0; i < 2; i++) {
+        if (tracks[i]->timer != NULL) {
+            esp_timer_stop(tracks[i]->timer);
+            esp_timer_delete(tracks[i]->timer);
+            tracks[i]->timer = NULL;
+        }
+        tracks[i]->program = NULL;
+        tracks[i]->queue_count = 0;
+    }
+    
+    if (s_timeline_mutex != NULL) {
+        vSemaphoreDelete(s_timeline_mutex);
+        s_timeline_mutex = NULL;
+    }
+}
+
 // Hardware initialization functions
 static esp_err_t ux_init_led(void)
 {
@@ -466,20 +834,11 @@ static esp_err_t ux_init_led(void)
         return ESP_OK;
     }
     
-    // Configure LED GPIO (active LOW on M5StickC Plus)
-    gpio_config_t led_conf = {
-        .pin_bit_mask = (1ULL << RED_LED_PIN),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    
-    esp_err_t ret = gpio_config(&led_conf);
+    // LEDC PWM with hardware fades (active LOW handled by the driver)
+    esp_err_t ret = red_led_init();
     if (ret == ESP_OK) {
-        gpio_set_level(RED_LED_PIN, 1); // LED OFF (active LOW)
         led_initialized = true;
-        ESP_LOGI(TAG, "LED initialized on GPIO%d (active LOW)", RED_LED_PIN);
+        ESP_LOGI(TAG, "LED initialized on GPIO%d (LEDC PWM)", RED_LED_PIN);
     }
     
     return ret;
@@ -533,7 +892,7 @@ static esp_err_t ux_init_buzzer(void)
 static void ux_deinit_led(void)
 {
     if (led_initialized) {
-        gpio_set_level(RED_LED_PIN, 1); // LED OFF
+        red_led_deinit();
         led_initialized = false;
         ESP_LOGI(TAG, "LED deinitialized");
     }
@@ -550,36 +909,19 @@ static void ux_deinit_buzzer(void)
 }
 
 // Direct hardware control functions
-static esp_err_t ux_led_set(bool on)
+static esp_err_t ux_led_set(uint8_t brightness, uint32_t fade_ms)
 {
     if (!led_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // M5StickC Plus LED is active LOW
-    gpio_set_level(RED_LED_PIN, on ? 0 : 1);
-    return ESP_OK;
-}
-
-static esp_err_t ux_led_blink(uint32_t on_time_ms, uint32_t off_time_ms, uint32_t cycles)
-{
-    if (!led_initialized) {
-        return ESP_ERR_INVALID_STATE;
+    if (fade_ms > 0) {
+        return red_led_fade_to(brightness, fade_ms);
     }
-    
-    for (uint32_t i = 0; i < cycles; i++) {
-        ux_led_set(true);
-        vTaskDelay(pdMS_TO_TICKS(on_time_ms));
-        ux_led_set(false);
-        if (i < cycles - 1) { // Don't delay after the last cycle
-            vTaskDelay(pdMS_TO_TICKS(off_time_ms));
-        }
-    }
-    
-    return ESP_OK;
+    return red_led_set_brightness(brightness);
 }
 
-static esp_err_t ux_buzzer_tone(uint32_t frequency_hz, uint32_t duration_ms)
+static esp_err_t ux_buzzer_set_tone(uint32_t frequency_hz)
 {
     if (!buzzer_initialized) {
         return ESP_ERR_INVALID_STATE;
@@ -595,14 +937,6 @@ static esp_err_t ux_buzzer_tone(uint32_t frequency_hz, uint32_t duration_ms)
     ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, 4096); // 50% of 8192 (13-bit)
     ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1);
     
-    if (duration_ms > 0) {
-        vTaskDelay(pdMS_TO_TICKS(duration_ms));
-        
-        // Stop buzzer
-        ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, 0);
-        ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1);
-    }
-    
     return ESP_OK;
 }
 
@@ -7,12 +7,6 @@
 #include "freertos/queue.h"
 #include <stdint.h>
 
-// UX Service Configuration
-#define UX_SERVICE_QUEUE_SIZE           20
-#define UX_SERVICE_TASK_STACK_SIZE      4096
-#define UX_SERVICE_TASK_PRIORITY        5
-#define UX_SERVICE_TASK_NAME            "ux_service_task"
-
 /**
  * @brief UX Device Types
  */
@@ -77,18 +71,23 @@ typedef struct {
  * @brief UX Service Statistics
  */
 typedef struct {
-    uint32_t messages_processed;        // Total messages processed
+    uint32_t messages_processed;        // Total messages posted by producers
     uint32_t led_effects_count;         // LED effects executed
     uint32_t buzzer_effects_count;      // Buzzer effects executed
-    uint32_t queue_full_errors;         // Queue full error count
+    uint32_t queue_full_errors;         // Effects rejected because a higher priority one was pending
     uint32_t execution_errors;          // Effect execution error count
+    uint32_t effects_preempted;         // Effects cut short by a higher priority effect
+    uint32_t effects_dropped;           // Effects dropped because the device track queue was full
+    uint32_t effects_coalesced;         // Identical effects merged or rate limited by the front-end
+    uint32_t effects_replaced;          // Pending effects overwritten by a newer one (latest wins)
 } ux_service_stats_t;
 
 /**
  * @brief Initialize UX Service
  * 
- * Creates message queue and starts the UX service task.
- * Must be called early in app_main() before sending any messages.
+ * Sets up the effect front-end and starts the UX service task.
+ * Effects sent before this return ESP_ERR_INVALID_STATE; boot runs it
+ * after the first screen is up, off the display's critical path.
  * 
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
@@ -103,29 +102,57 @@ esp_err_t ux_service_init(void);
  */
 esp_err_t ux_service_deinit(void);
 
+/**
+ * @brief Play the startup demo effects
+ * 
+ * Deferred by boot until the first frame is on the screen; the service task
+ * queues the demo sequence once, later calls do nothing.
+ * 
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the service is not running
+ */
+esp_err_t ux_service_start_demo_effects(void);
+
 /**
  * @brief Send UX Effect Message
  * 
- * Sends a message to the UX service queue for processing.
+ * Posts the effect to its device's pending slot and never blocks. A newer
+ * effect replaces the one still pending for the same device (latest wins);
+ * an identical pending effect, or a repeat inside the effect's rate-limit
+ * window, is merged and counted in effects_coalesced.
  * 
  * @param effect Composite effect specification
  * @param duration_ms Duration in milliseconds (0 = use default)
  * @param repeat_count Number of repetitions (0 = use default)
  * @param parameter Additional parameter (frequency, interval, etc.)
- * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if queue full
+ * @return esp_err_t ESP_OK when accepted or merged, ESP_ERR_INVALID_STATE if the
+ *         service is not running or a higher priority effect is pending
  */
 esp_err_t ux_service_send_effect(ux_effect_t effect, 
                                   uint32_t duration_ms,
                                   uint32_t repeat_count,
                                   uint32_t parameter);
 
+/**
+ * @brief Send UX Effect Message from an ISR
+ * 
+ * Same coalescing as ux_service_send_effect(), safe in interrupt context.
+ * 
+ * @param higher_priority_task_woken Set to pdTRUE if a context switch is needed
+ * @return esp_err_t ESP_OK when accepted or merged, error code otherwise
+ */
+esp_err_t ux_service_send_effect_from_isr(ux_effect_t effect,
+                                          uint32_t duration_ms,
+                                          uint32_t repeat_count,
+                                          uint32_t parameter,
+                                          BaseType_t *higher_priority_task_woken);
+
 /**
  * @brief Send Simple UX Effect Message
  * 
  * Simplified version with default parameters.
  * 
  * @param effect Composite effect specification
- * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if queue full
+ * @return esp_err_t ESP_OK when accepted or merged, error code otherwise
  */
 esp_err_t ux_service_send_simple_effect(ux_effect_t effect);
 